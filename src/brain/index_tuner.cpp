@@ -24,6 +24,7 @@
 #include "common/timer.h"
 #include "index/index_factory.h"
 #include "storage/data_table.h"
+#include "storage/index_builder.h"
 #include "storage/tile_group.h"
 
 namespace peloton {
@@ -93,39 +94,18 @@ static void AddIndex(storage::DataTable* table,
 
 void IndexTuner::BuildIndex(storage::DataTable* table,
                             std::shared_ptr<index::Index> index) {
-  auto table_schema = table->GetSchema();
   auto index_tile_group_offset = index->GetIndexedTileGroupOff();
   auto table_tile_group_count = table->GetTileGroupCount();
   oid_t tile_groups_indexed = 0;
 
-  auto index_schema = index->GetKeySchema();
-  auto indexed_columns = index_schema->GetIndexedColumns();
-  std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+  // Writers maintain the index already, so the builder only has to add the
+  // versions that were there before. The tuples may not be unique.
+  storage::IndexBuilder index_builder(table, index);
 
   while (index_tile_group_offset < table_tile_group_count &&
          (tile_groups_indexed < tile_groups_indexed_per_iteration)) {
-    std::unique_ptr<storage::Tuple> tuple_ptr(
-        new storage::Tuple(table_schema, true));
-
     auto tile_group = table->GetTileGroup(index_tile_group_offset);
-    auto tile_group_id = tile_group->GetTileGroupId();
-    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
-
-    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-      // Setup container tuple
-      ContainerTuple<storage::TileGroup> container_tuple(tile_group.get(),
-                                                         tuple_id);
-
-      // Set the location
-      ItemPointer location(tile_group_id, tuple_id);
-
-      // Set the key
-      key->SetFromTuple(&container_tuple, indexed_columns, index->GetPool());
-
-      // Insert in specific index
-      // TODO: Allocate itempointer ?
-      index->InsertEntry(key.get(), &location);
-    }
+    index_builder.BuildTileGroup(tile_group.get(), false);
 
     // Update indexed tile group offset (set of tgs indexed)
     index->IncrementIndexedTileGroupOffset();
@@ -13,6 +13,7 @@
 #include "brain/layout_tuner.h"
 
 #include <vector>
+#include <set>
 #include <string>
 #include <algorithm>
 
@@ -20,6 +21,7 @@
 #include "common/logger.h"
 #include "common/timer.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
 
 namespace peloton {
 namespace brain {
@@ -150,6 +152,76 @@ void LayoutTuner::UpdateDefaultPartition(storage::DataTable* table) {
   table->SetDefaultLayout(layout);
 }
 
+// Get the # of tiles that the sampled scans access in a layout
+static double GetTilesAccessed(const std::vector<Sample> &samples,
+                               const column_map_type &column_map) {
+  double tiles_accessed = 0;
+  for (auto &sample : samples) {
+    std::set<oid_t> tiles;
+    for (auto column_id : sample.GetColumnsAccessed()) {
+      auto column_map_itr = column_map.find(static_cast<oid_t>(column_id));
+      if (column_map_itr != column_map.end()) {
+        tiles.insert(column_map_itr->second.first);
+      }
+    }
+    tiles_accessed += sample.GetWeight() * tiles.size();
+  }
+  return tiles_accessed;
+}
+
+void LayoutTuner::TransformTileGroup(storage::DataTable* table) {
+  auto tile_group_count = table->GetTileGroupCount();
+  auto tile_group_offset = rand() % tile_group_count;
+  auto tile_group = table->GetTileGroup(tile_group_offset);
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  LOG_TRACE("Transforming tile group at offset: %lu", tile_group_offset);
+  bool busy;
+  auto new_tile_group =
+      table->TransformTileGroup(tile_group_offset, theta, &busy);
+  if (new_tile_group == nullptr) {
+    if (busy) {
+      skipped_tile_group_count++;
+    }
+    return;
+  }
+
+  size_t bytes = new_tile_group->GetAllocatedTupleCount() *
+                 table->GetSchema()->GetLength();
+  transformed_tile_group_count++;
+  transformed_bytes += bytes;
+
+  auto samples = table->GetLayoutSamples();
+  tiles_accessed_before =
+      tiles_accessed_before +
+      GetTilesAccessed(samples, tile_group->GetColumnMap());
+  tiles_accessed_after =
+      tiles_accessed_after +
+      GetTilesAccessed(samples, new_tile_group->GetColumnMap());
+
+  // Pace the copying, checking for the stop signal now and then
+  if (transform_bandwidth == 0) {
+    return;
+  }
+  auto pause = std::chrono::microseconds(bytes * 1000000 / transform_bandwidth);
+  auto step = std::chrono::microseconds(10000);
+  while (pause.count() > 0 && layout_tuning_stop == false) {
+    auto sleep = std::min(pause, step);
+    std::this_thread::sleep_for(sleep);
+    pause -= sleep;
+  }
+}
+
+double LayoutTuner::GetScanSpeedup() const {
+  double tiles_after = tiles_accessed_after;
+  if (tiles_after == 0) {
+    return 1;
+  }
+  return tiles_accessed_before / tiles_after;
+}
+
 void LayoutTuner::Tune() {
   Timer<std::milli> timer;
   // Continue till signal is not false
@@ -157,11 +229,7 @@ void LayoutTuner::Tune() {
     // Go over all tables
     for (auto table : tables) {
       // Transform
-      auto tile_group_count = table->GetTileGroupCount();
-      auto tile_group_offset = rand() % tile_group_count;
-
-      LOG_TRACE("Transforming tile group at offset: %lu", tile_group_offset);
-      table->TransformTileGroup(tile_group_offset, theta);
+      TransformTileGroup(table);
 
       // Update partitioning periodically
       UpdateDefaultPartition(table);
@@ -30,6 +30,8 @@
 #include "function/old_engine_string_functions.h"
 #include "function/timestamp_functions.h"
 #include "index/index_factory.h"
+#include "optimizer/stats/stats_storage.h"
+#include "storage/index_builder.h"
 #include "storage/storage_manager.h"
 #include "storage/table_factory.h"
 #include "type/ephemeral_pool.h"
@@ -399,7 +401,10 @@ ResultType Catalog::CreateIndex(
     oid_t database_oid, oid_t table_oid, const std::vector<oid_t> &key_attrs,
     const std::string &index_name, IndexType index_type,
     IndexConstraintType index_constraint, bool unique_keys,
-    concurrency::TransactionContext *txn, bool is_catalog) {
+    concurrency::TransactionContext *txn, bool is_catalog,
+    std::shared_ptr<expression::AbstractExpression> predicate,
+    const std::vector<std::shared_ptr<expression::AbstractExpression>>
+        &key_expressions) {
   if (txn == nullptr)
     throw CatalogException("Do not have transaction to create index " +
                            index_name);
@@ -434,11 +439,27 @@ ResultType Catalog::CreateIndex(
   auto index_metadata = new index::IndexMetadata(
       index_name, index_oid, table_oid, database_oid, index_type,
       index_constraint, schema, key_schema, key_attrs, unique_keys);
+  if (predicate != nullptr) {
+    index_metadata->SetPredicate(predicate);
+  }
+  if (key_expressions.empty() == false) {
+    index_metadata->SetKeyExpressions(key_expressions);
+  }
 
-  // Add index to table
+  // Add index to table. The tables being initialized are empty, the others
+  // are indexed without blocking their writers
   std::shared_ptr<index::Index> key_index(
       index::IndexFactory::GetIndex(index_metadata));
-  table->AddIndex(key_index);
+  if (is_catalog == true) {
+    table->AddIndex(key_index);
+  } else {
+    storage::IndexBuilder index_builder(table, key_index);
+    if (index_builder.Build(txn) == false) {
+      LOG_TRACE("Failed to build index %s: duplicate keys",
+                index_name.c_str());
+      return ResultType::FAILURE;
+    }
+  }
 
   // Put index object into rw_object_set
   txn->RecordCreate(database_oid, table_oid, index_oid);
@@ -561,6 +582,10 @@ ResultType Catalog::DropTable(oid_t database_oid, oid_t table_oid,
 
   database->GetTableWithOid(table_oid);
   txn->RecordDrop(database_oid, table_oid, INVALID_OID);
+  txn->AddOnCommitCallback([database_oid, table_oid]() {
+    optimizer::StatsStorage::GetInstance()->RemoveTableStats(database_oid,
+                                                             table_oid);
+  });
 
   return ResultType::SUCCESS;
 }
@@ -37,9 +37,9 @@ ColumnStatsCatalog::ColumnStatsCatalog(concurrency::TransactionContext *txn)
                       "num_rows        INT NOT NULL, "
                       "cardinality    DECIMAL NOT NULL, "
                       "frac_null      DECIMAL NOT NULL, "
-                      "most_common_vals  VARCHAR, "
-                      "most_common_freqs VARCHAR, "
-                      "histogram_bounds  VARCHAR, "
+                      "most_common_vals  VARBINARY, "
+                      "most_common_freqs VARBINARY, "
+                      "histogram_bounds  VARBINARY, "
                       "column_name       VARCHAR, "
                       "has_index         BOOLEAN);",
                       txn) {
@@ -73,21 +73,21 @@ bool ColumnStatsCatalog::InsertColumnStats(
 
   type::Value val_common_val, val_common_freq;
   if (!most_common_vals.empty()) {
-    val_common_val = type::ValueFactory::GetVarcharValue(most_common_vals);
-    val_common_freq = type::ValueFactory::GetVarcharValue(most_common_freqs);
+    val_common_val = type::ValueFactory::GetVarbinaryValue(most_common_vals);
+    val_common_freq = type::ValueFactory::GetVarbinaryValue(most_common_freqs);
   } else {
     val_common_val =
-        type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR);
+        type::ValueFactory::GetNullValueByType(type::TypeId::VARBINARY);
     val_common_freq =
-        type::ValueFactory::GetNullValueByType(type::TypeId::DECIMAL);
+        type::ValueFactory::GetNullValueByType(type::TypeId::VARBINARY);
   }
 
   type::Value val_hist_bounds;
   if (!histogram_bounds.empty()) {
-    val_hist_bounds = type::ValueFactory::GetVarcharValue(histogram_bounds);
+    val_hist_bounds = type::ValueFactory::GetVarbinaryValue(histogram_bounds);
   } else {
     val_hist_bounds =
-        type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR);
+        type::ValueFactory::GetNullValueByType(type::TypeId::VARBINARY);
   }
 
   type::Value val_column_name =
@@ -84,17 +84,31 @@ void BufferingConsumer::Prepare(CompilationContext &ctx) {
 void BufferingConsumer::ConsumeResult(ConsumerContext &ctx,
                                       RowBatch::Row &row) const {
   auto &codegen = ctx.GetCodeGen();
+  auto *tuple_buffer_ = MaterializeRow(codegen, row, output_ais_);
+
+  // Append the tuple to the output buffer (by calling BufferTuple(...))
+  auto *consumer_state = GetStateValue(ctx, consumer_state_id_);
+  std::vector<llvm::Value *> args = {consumer_state, tuple_buffer_,
+                                     codegen.Const32(output_ais_.size())};
+  codegen.Call(BufferingConsumerProxy::BufferTuple, args);
+}
+
+// Write the values of the given attributes in the row into an on-stack array
+// of peloton::type::Value, returning a pointer to the array.
+llvm::Value *BufferingConsumer::MaterializeRow(
+    CodeGen &codegen, RowBatch::Row &row,
+    const std::vector<const planner::AttributeInfo *> &output_ais) {
   auto *tuple_buffer_ = codegen.AllocateBuffer(
-      ValueProxy::GetType(codegen), static_cast<uint32_t>(output_ais_.size()),
+      ValueProxy::GetType(codegen), static_cast<uint32_t>(output_ais.size()),
       "output");
   tuple_buffer_ =
       codegen->CreatePointerCast(tuple_buffer_, codegen.CharPtrType());
 
-  for (size_t i = 0; i < output_ais_.size(); i++) {
+  for (size_t i = 0; i < output_ais.size(); i++) {
     // Derive the column's final value
-    Value val = row.DeriveValue(codegen, output_ais_[i]);
+    Value val = row.DeriveValue(codegen, output_ais[i]);
 
-    PL_ASSERT(output_ais_[i]->type == val.GetType());
+    PL_ASSERT(output_ais[i]->type == val.GetType());
     const auto &sql_type = val.GetType().GetSqlType();
 
     // Check if it's NULL
@@ -132,11 +146,7 @@ void BufferingConsumer::ConsumeResult(ConsumerContext &ctx,
     codegen.CallFunc(output_func, args);
   }
 
-  // Append the tuple to the output buffer (by calling BufferTuple(...))
-  auto *consumer_state = GetStateValue(ctx, consumer_state_id_);
-  std::vector<llvm::Value *> args = {consumer_state, tuple_buffer_,
-                                     codegen.Const32(output_ais_.size())};
-  codegen.Call(BufferingConsumerProxy::BufferTuple, args);
+  return tuple_buffer_;
 }
 
 }  // namespace codegen
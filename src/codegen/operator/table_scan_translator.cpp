@@ -13,23 +13,84 @@
 #include "codegen/operator/table_scan_translator.h"
 
 #include "codegen/lang/if.h"
+#include "codegen/lang/loop.h"
 #include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/proxy/storage_manager_proxy.h"
 #include "codegen/proxy/transaction_runtime_proxy.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
-#include "codegen/proxy/zone_map_proxy.h"
 #include "codegen/type/boolean_type.h"
+#include "codegen/type/sql_type.h"
+#include "expression/tuple_value_expression.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
-#include "storage/zone_map_manager.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace codegen {
 
+namespace {
+
+// Is the given type a fixed-width numeric type that SIMD predicates support?
+bool IsSIMDNumericType(peloton::type::TypeId type_id) {
+  switch (type_id) {
+    case peloton::type::TypeId::TINYINT:
+    case peloton::type::TypeId::SMALLINT:
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::BIGINT:
+    case peloton::type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Can a column of the first type be compared to a scalar of the second type?
+bool IsSIMDComparable(peloton::type::TypeId col_type,
+                      peloton::type::TypeId scalar_type) {
+  if (IsSIMDNumericType(col_type) && IsSIMDNumericType(scalar_type)) {
+    return true;
+  }
+  // Dates and timestamps are only compared against values of the same type
+  return col_type == scalar_type &&
+         (col_type == peloton::type::TypeId::DATE ||
+          col_type == peloton::type::TypeId::TIMESTAMP);
+}
+
+bool IsScalarExpression(const expression::AbstractExpression &expr) {
+  return expr.GetExpressionType() == ExpressionType::VALUE_CONSTANT ||
+         expr.GetExpressionType() == ExpressionType::VALUE_PARAMETER;
+}
+
+// The comparison to use when the operands of the given comparison are swapped
+ExpressionType MirrorComparison(ExpressionType cmp_type) {
+  switch (cmp_type) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return cmp_type;
+  }
+}
+
+}  // anonymous namespace
+
 //===----------------------------------------------------------------------===//
 // TABLE SCAN TRANSLATOR
 //===----------------------------------------------------------------------===//
 
+std::atomic<bool> TableScanTranslator::use_simd_predicate{true};
+
+bool TableScanTranslator::UseSIMDPredicate(const planner::SeqScanPlan &scan) {
+  const auto *predicate = scan.GetPredicate();
+  return use_simd_predicate && predicate != nullptr &&
+         IsSIMDFilterable(*predicate);
+}
+
 // Constructor
 TableScanTranslator::TableScanTranslator(const planner::SeqScanPlan &scan,
                                          CompilationContext &context,
@@ -73,22 +134,17 @@ void TableScanTranslator::Produce() const {
       codegen.Int32Type(), Vector::kDefaultVectorSize, "scanSelVector");
   Vector sel_vec{raw_vec, Vector::kDefaultVectorSize, codegen.Int32Type()};
 
-  auto predicate = const_cast<expression::AbstractExpression *>(
-      GetScanPlan().GetPredicate());
-  llvm::Value *predicate_ptr = codegen->CreateIntToPtr(
-      codegen.Const64((int64_t)predicate),
-      AbstractExpressionProxy::GetType(codegen)->getPointerTo());
-  size_t num_preds = 0;
-
-  auto *zone_map_manager = storage::ZoneMapManager::GetInstance();
-  if (predicate != nullptr && zone_map_manager->ZoneMapTableExists()) {
-    if (predicate->IsZoneMappable()) {
-      num_preds = predicate->GetNumberofParsedPredicates();
-    }
+  // The parts of the predicate the zone maps of tile groups are checked
+  // against before scanning them
+  std::vector<Table::ZoneMapPredicate> zone_map_predicates;
+  const auto *predicate = GetScanPlan().GetPredicate();
+  if (predicate != nullptr) {
+    CollectZoneMapPredicates(*predicate, zone_map_predicates);
   }
+
   ScanConsumer scan_consumer{*this, sel_vec};
   table_.GenerateScan(codegen, table_ptr, sel_vec.GetCapacity(), scan_consumer,
-                      predicate_ptr, num_preds);
+                      zone_map_predicates);
   LOG_TRACE("TableScan on [%u] finished producing tuples ...", table.GetOid());
 }
 
@@ -108,6 +164,67 @@ const storage::DataTable &TableScanTranslator::GetTable() const {
   return *scan_.GetTable();
 }
 
+void TableScanTranslator::CollectZoneMapPredicates(
+    const expression::AbstractExpression &expr,
+    std::vector<Table::ZoneMapPredicate> &predicates) const {
+  // Every conjunct must hold, so any of them may rule out a tile group
+  if (expr.GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    CollectZoneMapPredicates(*expr.GetChild(0), predicates);
+    CollectZoneMapPredicates(*expr.GetChild(1), predicates);
+    return;
+  }
+
+  auto cmp_type = expr.GetExpressionType();
+  switch (cmp_type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return;
+  }
+
+  // Normalize the comparison so that the column is on the left
+  const auto *col_expr = expr.GetChild(0);
+  const auto *scalar_expr = expr.GetChild(1);
+  if (IsScalarExpression(*col_expr)) {
+    std::swap(col_expr, scalar_expr);
+    cmp_type = MirrorComparison(cmp_type);
+  }
+  if (col_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      !IsScalarExpression(*scalar_expr)) {
+    return;
+  }
+
+  const auto *ai =
+      static_cast<const expression::TupleValueExpression *>(col_expr)
+          ->GetAttributeRef();
+  auto col_type = GetTable().GetSchema()->GetType(ai->attribute_id);
+  if (!storage::ZoneMap::SupportsType(col_type)) {
+    return;
+  }
+
+  // Constants and parameters live in the cache, so that the bounds are
+  // compared with the values of the current execution
+  auto &compilation_ctx = GetCompilationContext();
+  codegen::Value scalar = compilation_ctx.GetParameterCache().GetValue(
+      compilation_ctx.GetParameterIdx(scalar_expr));
+  auto scalar_type = scalar.GetType().type_id;
+  bool comparable =
+      col_type == peloton::type::TypeId::TIMESTAMP
+          ? scalar_type == peloton::type::TypeId::TIMESTAMP
+          : (scalar_type != peloton::type::TypeId::TIMESTAMP &&
+             storage::ZoneMap::SupportsType(scalar_type));
+  if (!comparable) {
+    return;
+  }
+
+  predicates.push_back(Table::ZoneMapPredicate{ai->attribute_id, col_type,
+                                               cmp_type, scalar});
+}
+
 //===----------------------------------------------------------------------===//
 // VECTORIZED SCAN CONSUMER
 //===----------------------------------------------------------------------===//
@@ -199,15 +316,170 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
     CodeGen &codegen, const TileGroup::TileGroupAccess &access,
     llvm::Value *tid_start, llvm::Value *tid_end,
     Vector &selection_vector) const {
+  const auto *predicate = GetPredicate();
+  std::vector<const expression::AbstractExpression *> dictionary_predicates;
+  bool only_dictionary_predicates =
+      CollectDictionaryPredicates(*predicate, dictionary_predicates);
+  if (dictionary_predicates.empty()) {
+    FilterRowsByValues(codegen, access, tid_start, tid_end, selection_vector);
+    return;
+  }
+
+  // Rule out rows by the codes of the encoded columns first
+  llvm::Value *all_encoded = DictionaryFilterRows(
+      codegen, dictionary_predicates, tid_start, tid_end, selection_vector);
+  if (!only_dictionary_predicates) {
+    FilterRowsByValues(codegen, access, tid_start, tid_end, selection_vector);
+    return;
+  }
+
+  // The codes decided the whole predicate, unless some column isn't encoded
+  llvm::Value *num_valid = selection_vector.GetNumElements();
+  llvm::Value *filtered_num_valid = nullptr;
+  lang::If not_encoded{codegen, codegen->CreateNot(all_encoded),
+                       "valueFilter"};
+  {
+    FilterRowsByValues(codegen, access, tid_start, tid_end, selection_vector);
+    filtered_num_valid = selection_vector.GetNumElements();
+  }
+  not_encoded.EndIf();
+
+  selection_vector.SetNumElements(
+      not_encoded.BuildPHI(filtered_num_valid, num_valid));
+}
+
+void TableScanTranslator::ScanConsumer::FilterRowsByValues(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  const auto *predicate = GetPredicate();
+  LOG_DEBUG("Is Predicate SIMDable : %d", predicate->IsSIMDable());
+
+  if (!UseSIMDPredicate(translator_.GetScanPlan())) {
+    ScalarFilterRows(codegen, access, tid_start, tid_end, selection_vector);
+    return;
+  }
+
+  // The layout of a tile group is only known at runtime. We use the SIMD filter
+  // if all the columns the predicate touches are contiguous in this tile group,
+  // and fall back to the scalar filter otherwise.
+  llvm::Value *num_visible = selection_vector.GetNumElements();
+  llvm::Value *simd_num_valid = nullptr, *scalar_num_valid = nullptr;
+
+  llvm::Value *contiguous = PredicateColumnsContiguous(codegen, access);
+  lang::If is_contiguous{codegen, contiguous, "simdFilter"};
+  {
+    SIMDFilterRows(codegen, access, tid_start, tid_end, selection_vector);
+    simd_num_valid = selection_vector.GetNumElements();
+  }
+  is_contiguous.ElseBlock("scalarFilter");
+  {
+    selection_vector.SetNumElements(num_visible);
+    ScalarFilterRows(codegen, access, tid_start, tid_end, selection_vector);
+    scalar_num_valid = selection_vector.GetNumElements();
+  }
+  is_contiguous.EndIf();
+
+  selection_vector.SetNumElements(
+      is_contiguous.BuildPHI(simd_num_valid, scalar_num_valid));
+}
+
+bool TableScanTranslator::ScanConsumer::CollectDictionaryPredicates(
+    const expression::AbstractExpression &expr,
+    std::vector<const expression::AbstractExpression *> &predicates) const {
+  if (expr.GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    bool left = CollectDictionaryPredicates(*expr.GetChild(0), predicates);
+    bool right = CollectDictionaryPredicates(*expr.GetChild(1), predicates);
+    return left && right;
+  }
+  if (expr.GetExpressionType() != ExpressionType::COMPARE_EQUAL) {
+    return false;
+  }
+
+  const auto *col_expr = expr.GetChild(0);
+  const auto *scalar_expr = expr.GetChild(1);
+  if (IsScalarExpression(*col_expr)) {
+    std::swap(col_expr, scalar_expr);
+  }
+  if (col_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      !IsScalarExpression(*scalar_expr) ||
+      col_expr->GetValueType() != peloton::type::TypeId::VARCHAR ||
+      scalar_expr->GetValueType() != peloton::type::TypeId::VARCHAR) {
+    return false;
+  }
+  predicates.push_back(&expr);
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Here, we filter the rows by equality predicates on VARCHAR columns, using
+// the codes of the columns the tile group dictionary encodes. For every such
+// predicate, we look up the code of the scalar once per batch, and keep the
+// rows whose code is the same. A scalar the tile group doesn't hold gets a
+// code that no row has.
+//===----------------------------------------------------------------------===//
+llvm::Value *TableScanTranslator::ScanConsumer::DictionaryFilterRows(
+    CodeGen &codegen,
+    const std::vector<const expression::AbstractExpression *> &predicates,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  auto &compilation_ctx = translator_.GetCompilationContext();
+  llvm::Value *code_ptr =
+      codegen.AllocateVariable(codegen.Int32Type(), "dictionaryCode");
+
+  llvm::Value *all_encoded = codegen.ConstBool(true);
+  for (const auto *predicate : predicates) {
+    const auto *col_expr = predicate->GetChild(0);
+    const auto *scalar_expr = predicate->GetChild(1);
+    if (IsScalarExpression(*col_expr)) {
+      std::swap(col_expr, scalar_expr);
+    }
+    const auto *ai =
+        static_cast<const expression::TupleValueExpression *>(col_expr)
+            ->GetAttributeRef();
+    codegen::Value scalar = compilation_ctx.GetParameterCache().GetValue(
+        compilation_ctx.GetParameterIdx(scalar_expr));
+
+    llvm::Value *codes = codegen.Call(
+        RuntimeFunctionsProxy::GetDictionaryCodes,
+        {tile_group_ptr_, codegen.Const32(ai->attribute_id), scalar.GetValue(),
+         scalar.GetLength(), code_ptr});
+    llvm::Value *encoded = codegen->CreateIsNotNull(codes);
+
+    llvm::Value *num_valid = selection_vector.GetNumElements();
+    llvm::Value *filtered_num_valid = nullptr;
+    lang::If is_encoded{codegen, encoded, "dictionaryFilter"};
+    {
+      llvm::Value *code = codegen->CreateLoad(code_ptr);
+      RowBatch batch{compilation_ctx, tile_group_id_,   tid_start,
+                     tid_end,         selection_vector, true};
+      batch.Iterate(codegen, [&](RowBatch::Row &row) {
+        llvm::Value *row_code = codegen->CreateLoad(codegen->CreateInBoundsGEP(
+            codegen.Int32Type(), codes, row.GetTID(codegen)));
+        row.SetValidity(codegen, codegen->CreateICmpEQ(row_code, code));
+      });
+      filtered_num_valid = selection_vector.GetNumElements();
+    }
+    is_encoded.EndIf();
+
+    selection_vector.SetNumElements(
+        is_encoded.BuildPHI(filtered_num_valid, num_valid));
+    all_encoded = codegen->CreateAnd(all_encoded, encoded);
+  }
+  return all_encoded;
+}
+
+void TableScanTranslator::ScanConsumer::ScalarFilterRows(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
   // The batch we're filtering
   auto &compilation_ctx = translator_.GetCompilationContext();
   RowBatch batch{compilation_ctx, tile_group_id_,   tid_start,
                  tid_end,         selection_vector, true};
 
-  // First, check if the predicate is SIMDable
-  const auto *predicate = GetPredicate();
-  LOG_DEBUG("Is Predicate SIMDable : %d", predicate->IsSIMDable());
   // Determine the attributes the predicate needs
+  const auto *predicate = GetPredicate();
   std::unordered_set<const planner::AttributeInfo *> used_attributes;
   predicate->GetUsedAttributes(used_attributes);
 
@@ -235,6 +507,257 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
   });
 }
 
+//===----------------------------------------------------------------------===//
+// Here, we evaluate the predicate over all rows in the range [tid_start,
+// tid_end) using vector instructions, kSIMDWidth rows at a time, writing the
+// result of each row into a byte mask. Rows in the tail of the range that don't
+// fill a full vector are evaluated using one-element vectors. The mask is then
+// used to compact the selection vector (which already contains only visible
+// rows) without any branches.
+//===----------------------------------------------------------------------===//
+void TableScanTranslator::ScanConsumer::SIMDFilterRows(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  const auto *predicate = GetPredicate();
+
+  // The mask holding the result of the predicate for every row in the range
+  auto *raw_mask = codegen.AllocateBuffer(
+      codegen.Int8Type(), Vector::kDefaultVectorSize, "simdFilterMask");
+  Vector mask{raw_mask, Vector::kDefaultVectorSize, codegen.Int8Type()};
+
+  llvm::Value *num_rows = codegen->CreateSub(tid_end, tid_start);
+  llvm::Value *num_full_rows =
+      codegen->CreateAnd(num_rows, codegen.Const32(~(kSIMDWidth - 1)));
+
+  auto evaluate_into_mask = [&](llvm::Value *pos, uint32_t width) {
+    llvm::Value *tid = codegen->CreateAdd(tid_start, pos);
+    llvm::Value *valid =
+        SIMDEvaluate(codegen, *predicate, access, tid, width);
+    llvm::Value *valid_bytes = codegen->CreateZExt(
+        valid, llvm::VectorType::get(codegen.Int8Type(), width));
+    llvm::Value *mask_ptr = codegen->CreateBitCast(
+        mask.GetPtrToValue(codegen, pos), valid_bytes->getType()->getPointerTo());
+    codegen->CreateAlignedStore(valid_bytes, mask_ptr, 1);
+  };
+
+  // The vectorized loop over full vectors
+  llvm::Value *pos = codegen.Const32(0);
+  lang::Loop simd_loop{
+      codegen, codegen->CreateICmpULT(pos, num_full_rows), {{"simdPos", pos}}};
+  {
+    pos = simd_loop.GetLoopVar(0);
+    evaluate_into_mask(pos, kSIMDWidth);
+    pos = codegen->CreateAdd(pos, codegen.Const32(kSIMDWidth));
+    simd_loop.LoopEnd(codegen->CreateICmpULT(pos, num_full_rows), {pos});
+  }
+
+  // The scalar loop over the tail
+  pos = num_full_rows;
+  lang::Loop tail_loop{
+      codegen, codegen->CreateICmpULT(pos, num_rows), {{"tailPos", pos}}};
+  {
+    pos = tail_loop.GetLoopVar(0);
+    evaluate_into_mask(pos, 1);
+    pos = codegen->CreateAdd(pos, codegen.Const32(1));
+    tail_loop.LoopEnd(codegen->CreateICmpULT(pos, num_rows), {pos});
+  }
+
+  // Compact the selection vector using the mask
+  RowBatch batch{translator_.GetCompilationContext(), tile_group_id_,
+                 tid_start, tid_end, selection_vector, true};
+  batch.Iterate(codegen, [&](RowBatch::Row &row) {
+    llvm::Value *offset =
+        codegen->CreateSub(row.GetTID(codegen), tid_start);
+    llvm::Value *valid = codegen->CreateICmpNE(mask.GetValue(codegen, offset),
+                                               codegen.Const8(0));
+    row.SetValidity(codegen, valid);
+  });
+}
+
+llvm::Value *TableScanTranslator::ScanConsumer::SIMDEvaluate(
+    CodeGen &codegen, const expression::AbstractExpression &expr,
+    const TileGroup::TileGroupAccess &access, llvm::Value *tid,
+    uint32_t width) const {
+  switch (expr.GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND: {
+      llvm::Value *left =
+          SIMDEvaluate(codegen, *expr.GetChild(0), access, tid, width);
+      llvm::Value *right =
+          SIMDEvaluate(codegen, *expr.GetChild(1), access, tid, width);
+      return codegen->CreateAnd(left, right);
+    }
+    case ExpressionType::CONJUNCTION_OR: {
+      llvm::Value *left =
+          SIMDEvaluate(codegen, *expr.GetChild(0), access, tid, width);
+      llvm::Value *right =
+          SIMDEvaluate(codegen, *expr.GetChild(1), access, tid, width);
+      return codegen->CreateOr(left, right);
+    }
+    default: { break; }
+  }
+
+  // It's a comparison between a column and a scalar. Normalize it so that the
+  // column is on the left.
+  auto cmp_type = expr.GetExpressionType();
+  const auto *col_expr = expr.GetChild(0);
+  const auto *scalar_expr = expr.GetChild(1);
+  if (IsScalarExpression(*col_expr)) {
+    std::swap(col_expr, scalar_expr);
+    cmp_type = MirrorComparison(cmp_type);
+  }
+  const auto *ai =
+      static_cast<const expression::TupleValueExpression *>(col_expr)
+          ->GetAttributeRef();
+
+  // Load a vector of column values
+  const auto &col_sql_type = ai->type.GetSqlType();
+  llvm::Type *col_type = nullptr, *col_len_type = nullptr;
+  col_sql_type.GetTypeForMaterialization(codegen, col_type, col_len_type);
+
+  const auto &layout = access.GetLayout(ai->attribute_id);
+  llvm::Value *col_address = codegen->CreateInBoundsGEP(
+      codegen.ByteType(), layout.col_start_ptr,
+      codegen->CreateMul(tid, layout.col_stride));
+  llvm::Type *col_vec_type = llvm::VectorType::get(col_type, width);
+  llvm::Value *col_vals = codegen->CreateAlignedLoad(
+      codegen->CreateBitCast(col_address, col_vec_type->getPointerTo()), 1);
+
+  // Pull out the scalar value. Constants and parameters live in the cache.
+  auto &compilation_ctx = translator_.GetCompilationContext();
+  codegen::Value scalar = compilation_ctx.GetParameterCache().GetValue(
+      compilation_ctx.GetParameterIdx(scalar_expr));
+
+  // Figure out the domain of the comparison: doubles if either side is a
+  // decimal, 64-bit integers otherwise.
+  bool use_double =
+      ai->type.type_id == peloton::type::TypeId::DECIMAL ||
+      scalar.GetType().type_id == peloton::type::TypeId::DECIMAL;
+  llvm::Type *cmp_elem_type =
+      use_double ? codegen.DoubleType() : codegen.Int64Type();
+  llvm::Type *cmp_vec_type = llvm::VectorType::get(cmp_elem_type, width);
+
+  auto to_domain = [&](llvm::Value *val, llvm::Type *type, bool is_decimal) {
+    if (use_double) {
+      return is_decimal ? val : codegen->CreateSIToFP(val, type);
+    }
+    return codegen->CreateSExt(val, type);
+  };
+
+  bool col_is_decimal = ai->type.type_id == peloton::type::TypeId::DECIMAL;
+  bool scalar_is_decimal =
+      scalar.GetType().type_id == peloton::type::TypeId::DECIMAL;
+  llvm::Value *lhs = to_domain(col_vals, cmp_vec_type, col_is_decimal);
+  llvm::Value *rhs = codegen->CreateVectorSplat(
+      width, to_domain(scalar.GetValue(), cmp_elem_type, scalar_is_decimal));
+
+  llvm::Value *result = nullptr;
+  switch (cmp_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      result = use_double ? codegen->CreateFCmpOEQ(lhs, rhs)
+                          : codegen->CreateICmpEQ(lhs, rhs);
+      break;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      result = use_double ? codegen->CreateFCmpONE(lhs, rhs)
+                          : codegen->CreateICmpNE(lhs, rhs);
+      break;
+    case ExpressionType::COMPARE_LESSTHAN:
+      result = use_double ? codegen->CreateFCmpOLT(lhs, rhs)
+                          : codegen->CreateICmpSLT(lhs, rhs);
+      break;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      result = use_double ? codegen->CreateFCmpOLE(lhs, rhs)
+                          : codegen->CreateICmpSLE(lhs, rhs);
+      break;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      result = use_double ? codegen->CreateFCmpOGT(lhs, rhs)
+                          : codegen->CreateICmpSGT(lhs, rhs);
+      break;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      result = use_double ? codegen->CreateFCmpOGE(lhs, rhs)
+                          : codegen->CreateICmpSGE(lhs, rhs);
+      break;
+    default: {
+      throw Exception{"Unsupported SIMD comparison: " +
+                      ExpressionTypeToString(cmp_type)};
+    }
+  }
+
+  // Comparisons with NULL are never true. Column NULLs are stored as a sentinel
+  // value of the column's type.
+  if (ai->type.nullable) {
+    llvm::Value *null_val = codegen->CreateVectorSplat(
+        width, col_sql_type.GetNullValue(codegen).GetValue());
+    llvm::Value *not_null = col_is_decimal
+                                ? codegen->CreateFCmpONE(col_vals, null_val)
+                                : codegen->CreateICmpNE(col_vals, null_val);
+    result = codegen->CreateAnd(result, not_null);
+  }
+  if (scalar.IsNullable()) {
+    llvm::Value *not_null =
+        codegen->CreateVectorSplat(width, scalar.IsNotNull(codegen));
+    result = codegen->CreateAnd(result, not_null);
+  }
+  return result;
+}
+
+llvm::Value *TableScanTranslator::ScanConsumer::PredicateColumnsContiguous(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access) const {
+  std::unordered_set<const planner::AttributeInfo *> used_attributes;
+  GetPredicate()->GetUsedAttributes(used_attributes);
+
+  llvm::Value *contiguous = codegen.ConstBool(true);
+  for (const auto *ai : used_attributes) {
+    llvm::Type *col_type = nullptr, *col_len_type = nullptr;
+    ai->type.GetSqlType().GetTypeForMaterialization(codegen, col_type,
+                                                    col_len_type);
+    const auto &layout = access.GetLayout(ai->attribute_id);
+    llvm::Value *dense = codegen->CreateICmpEQ(
+        layout.col_stride,
+        codegen.Const32(static_cast<uint32_t>(codegen.SizeOf(col_type))));
+    contiguous = codegen->CreateAnd(contiguous, dense);
+    if (layout.is_packed != nullptr) {
+      // Packed columns are decoded one value at a time
+      contiguous = codegen->CreateAnd(contiguous,
+                                      codegen->CreateNot(layout.is_packed));
+    }
+  }
+  return contiguous;
+}
+
+bool TableScanTranslator::IsSIMDFilterable(
+    const expression::AbstractExpression &expr) {
+  switch (expr.GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR: {
+      return IsSIMDFilterable(*expr.GetChild(0)) &&
+             IsSIMDFilterable(*expr.GetChild(1));
+    }
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+      const auto *left = expr.GetChild(0);
+      const auto *right = expr.GetChild(1);
+      if (IsScalarExpression(*left)) {
+        std::swap(left, right);
+      }
+      if (left->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+          !IsScalarExpression(*right)) {
+        return false;
+      }
+      const auto *ai =
+          static_cast<const expression::TupleValueExpression *>(left)
+              ->GetAttributeRef();
+      return ai != nullptr &&
+             IsSIMDComparable(ai->type.type_id, right->GetValueType());
+    }
+    default: { return false; }
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // ATTRIBUTE ACCESS
 //===----------------------------------------------------------------------===//
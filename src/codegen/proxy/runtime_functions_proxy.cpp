@@ -20,7 +20,8 @@ namespace peloton {
 namespace codegen {
 
 DEFINE_TYPE(ColumnLayoutInfo, "peloton::ColumnLayoutInfo",
-            MEMBER(col_start_ptr), MEMBER(stride), MEMBER(columnar));
+            MEMBER(col_start_ptr), MEMBER(stride), MEMBER(columnar),
+            MEMBER(packed), MEMBER(base), MEMBER(mask));
 
 DEFINE_TYPE(AbstractExpression, "peloton::expression::AbstractExpression",
             MEMBER(opaque));
@@ -29,6 +30,7 @@ DEFINE_METHOD(peloton::codegen, RuntimeFunctions, HashCrc64);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroup);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetTileGroupLayout);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, FillPredicateArray);
+DEFINE_METHOD(peloton::codegen, RuntimeFunctions, GetDictionaryCodes);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ThrowDivideByZeroException);
 DEFINE_METHOD(peloton::codegen, RuntimeFunctions, ThrowOverflowException);
 
@@ -19,6 +19,7 @@ DEFINE_TYPE(TileGroup, "peloton::storage::TileGroup", MEMBER(opaque));
 
 DEFINE_METHOD(peloton::storage, TileGroup, GetNextTupleSlot);
 DEFINE_METHOD(peloton::storage, TileGroup, GetTileGroupId);
+DEFINE_METHOD(peloton::storage, TileGroup, GetColumnZoneMaps);
 
 }  // namespace codegen
 }  // namespace peloton
@@ -30,6 +30,8 @@ namespace codegen {
 
 DEFINE_TYPE(PredicateInfo, "peloton::storage::PredicateInfo", MEMBER(col_id),
             MEMBER(comparison_operator), MEMBER(predicate_value));
+DEFINE_TYPE(ColumnZoneMap, "peloton::storage::ColumnZoneMap", MEMBER(min),
+            MEMBER(max), MEMBER(null_count), MEMBER(tracked));
 DEFINE_TYPE(ZoneMapManager, "peloton::storage::ZoneMapManager", MEMBER(opaque));
 
 DEFINE_METHOD(peloton::storage, ZoneMapManager, ShouldScanTileGroup);
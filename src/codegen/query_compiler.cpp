@@ -15,6 +15,7 @@
 #include "codegen/compilation_context.h"
 #include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
@@ -74,8 +75,16 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan) {
       if (join.GetJoinType() == JoinType::INNER) {
         break;
       }
+      return false;
     }
     case PlanNodeType::HASH: {
+      // DISTINCT is planned as a hash on all output columns
+      auto &hash_plan = static_cast<const planner::HashPlan &>(plan);
+      for (const auto &hash_key : hash_plan.GetHashKeys()) {
+        if (!IsExpressionSupported(*hash_key)) {
+          return false;
+        }
+      }
       break;
     }
     default: { return false; }
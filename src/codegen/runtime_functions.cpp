@@ -19,6 +19,7 @@
 #include "expression/abstract_expression.h"
 #include "expression/expression_util.h"
 #include "storage/data_table.h"
+#include "storage/frozen_block.h"
 #include "storage/tile_group.h"
 #include "storage/tile.h"
 #include "storage/zone_map_manager.h"
@@ -103,7 +104,24 @@ void RuntimeFunctions::FillPredicateArray(
 void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
                                           ColumnLayoutInfo *infos,
                                           uint32_t num_cols) {
+  const storage::FrozenBlock *frozen_block = tile_group->GetFrozenBlock();
   for (uint32_t col_idx = 0; col_idx < num_cols; col_idx++) {
+    // Read the packed copy of the column, if there is one
+    const storage::PackedColumn *packed_column =
+        frozen_block != nullptr ? frozen_block->GetPackedColumn(col_idx)
+                                : nullptr;
+    if (packed_column != nullptr) {
+      infos[col_idx].column = packed_column->data.get();
+      infos[col_idx].stride = packed_column->width;
+      infos[col_idx].is_columnar = true;
+      infos[col_idx].is_packed = true;
+      infos[col_idx].base = packed_column->base;
+      infos[col_idx].mask = packed_column->mask;
+      LOG_TRACE("Col [%u] start: %p, packed width: %u", col_idx,
+                infos[col_idx].column, infos[col_idx].stride);
+      continue;
+    }
+
     // Map the current column to a tile and a column offset in the tile
     oid_t tile_offset, tile_column_offset;
     tile_group->LocateTileAndColumn(col_idx, tile_offset, tile_column_offset);
@@ -115,12 +133,31 @@ void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
         tile->GetTupleLocation(0) + tile_schema->GetOffset(tile_column_offset);
     infos[col_idx].stride = tile_schema->GetLength();
     infos[col_idx].is_columnar = tile_schema->GetColumnCount() == 1;
+    infos[col_idx].is_packed = false;
+    infos[col_idx].base = 0;
+    infos[col_idx].mask = 0;
     LOG_TRACE("Col [%u] start: %p, stride: %u, columnar: %s", col_idx,
               infos[col_idx].column, infos[col_idx].stride,
               infos[col_idx].is_columnar ? "true" : "false");
   }
 }
 
+const uint32_t *RuntimeFunctions::GetDictionaryCodes(
+    const storage::TileGroup *tile_group, uint32_t col_id, const char *data,
+    uint32_t length, uint32_t *code) {
+  const storage::FrozenBlock *frozen_block = tile_group->GetFrozenBlock();
+  if (frozen_block == nullptr) {
+    return nullptr;
+  }
+  const storage::DictionaryColumn *dictionary_column =
+      frozen_block->GetDictionaryColumn(col_id);
+  if (dictionary_column == nullptr) {
+    return nullptr;
+  }
+  *code = dictionary_column->Lookup(data, length);
+  return dictionary_column->codes.get();
+}
+
 void RuntimeFunctions::ThrowDivideByZeroException() {
   throw DivideByZeroException("ERROR: division by zero");
 }
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// streaming_consumer.cpp
+//
+// Identification: src/codegen/streaming_consumer.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/streaming_consumer.h"
+
+#include <algorithm>
+
+#include "codegen/buffering_consumer.h"
+#include "codegen/proxy/proxy.h"
+#include "codegen/proxy/type_builder.h"
+#include "planner/binding_context.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// StreamTuple() Proxy
+//===----------------------------------------------------------------------===//
+
+PROXY(StreamingConsumer) { DECLARE_METHOD(StreamTuple); };
+
+DEFINE_METHOD(peloton::codegen, StreamingConsumer, StreamTuple);
+
+//===----------------------------------------------------------------------===//
+// STREAMING CONSUMER
+//===----------------------------------------------------------------------===//
+
+StreamingConsumer::StreamingConsumer(const std::vector<oid_t> &cols,
+                                     const planner::BindingContext &context,
+                                     BatchSink sink, uint32_t batch_size)
+    : sink_(std::move(sink)),
+      batch_size_(batch_size),
+      num_batch_rows_(0),
+      num_rows_(0) {
+  PL_ASSERT(batch_size_ > 0);
+  for (oid_t col_id : cols) {
+    output_ais_.push_back(context.Find(col_id));
+  }
+  results_.reserve(static_cast<size_t>(batch_size_) * output_ais_.size());
+  state_.consumer = this;
+}
+
+void StreamingConsumer::StreamTuple(char *state, char *tuple,
+                                    uint32_t num_cols) {
+  auto *stream_state = reinterpret_cast<StreamingState *>(state);
+  stream_state->consumer->AppendTuple(
+      reinterpret_cast<peloton::type::Value *>(tuple), num_cols);
+}
+
+void StreamingConsumer::AppendTuple(const peloton::type::Value *vals,
+                                    uint32_t num_cols) {
+  for (uint32_t i = 0; i < num_cols; i++) {
+    const auto &val = vals[i];
+    if (val.IsNull()) {
+      results_.emplace_back();
+    } else if (i < binary_cols_.size() && binary_cols_[i]) {
+      results_.emplace_back(EncodeBinary(val));
+    } else {
+      results_.emplace_back(val.ToString());
+    }
+  }
+  num_rows_++;
+
+  // Hand off the batch if it's full and someone is listening
+  if (++num_batch_rows_ == batch_size_ && sink_ != nullptr) {
+    sink_(results_);
+    results_.clear();
+    num_batch_rows_ = 0;
+  }
+}
+
+void StreamingConsumer::SetResultFormat(const std::vector<int> &result_format) {
+  binary_cols_.assign(output_ais_.size(), false);
+  for (uint32_t i = 0; i < output_ais_.size() && i < result_format.size();
+       i++) {
+    // Variable-length values have the same text and binary representation
+    auto type_id = output_ais_[i]->type.type_id;
+    binary_cols_[i] = result_format[i] != 0 &&
+                      type_id != peloton::type::TypeId::VARCHAR &&
+                      type_id != peloton::type::TypeId::VARBINARY;
+  }
+}
+
+ResultValue StreamingConsumer::EncodeBinary(const peloton::type::Value &val) {
+  // Fixed-length values are serialized in host order, we want network order
+  ResultValue result(peloton::type::Type::GetTypeSize(val.GetTypeId()), '\0');
+  val.SerializeTo(&result[0], false, nullptr);
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+void StreamingConsumer::Finish() {
+  if (sink_ != nullptr && num_batch_rows_ > 0) {
+    sink_(results_);
+    results_.clear();
+    num_batch_rows_ = 0;
+  }
+}
+
+void StreamingConsumer::Prepare(CompilationContext &ctx) {
+  auto &codegen = ctx.GetCodeGen();
+  auto &runtime_state = ctx.GetRuntimeState();
+  consumer_state_id_ =
+      runtime_state.RegisterState("consumerState", codegen.CharPtrType());
+}
+
+// Materialize the output attributes into an on-stack array of values, then
+// call StreamTuple(...) to encode them into the current batch.
+void StreamingConsumer::ConsumeResult(ConsumerContext &ctx,
+                                      RowBatch::Row &row) const {
+  auto &codegen = ctx.GetCodeGen();
+  auto *tuple_buffer =
+      BufferingConsumer::MaterializeRow(codegen, row, output_ais_);
+
+  auto *consumer_state =
+      ctx.GetRuntimeState().LoadStateValue(codegen, consumer_state_id_);
+  std::vector<llvm::Value *> args = {consumer_state, tuple_buffer,
+                                     codegen.Const32(output_ais_.size())};
+  codegen.Call(StreamingConsumerProxy::StreamTuple, args);
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -17,7 +17,9 @@
 #include "codegen/lang/loop.h"
 #include "codegen/lang/if.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
+#include "codegen/proxy/tile_group_proxy.h"
 #include "codegen/proxy/zone_map_proxy.h"
+#include "common/exception.h"
 #include "storage/data_table.h"
 
 namespace peloton {
@@ -40,9 +42,90 @@ llvm::Value *Table::GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                       {table_ptr, tile_group_id});
 }
 
-// We acquire a Zone Map manager instance
-llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
-  return codegen.Call(ZoneMapManagerProxy::GetInstance, {});
+// We check the zone maps of the tile group inline. The bounds of a column
+// are loaded from the array TileGroup::GetColumnZoneMaps() returns, and
+// compared to the scalar of each predicate on the column: as doubles if either
+// is a decimal, and as 64-bit integers otherwise.
+llvm::Value *Table::ShouldScanTileGroup(
+    CodeGen &codegen, llvm::Value *tile_group_ptr,
+    const std::vector<ZoneMapPredicate> &predicates) const {
+  llvm::Value *should_scan = codegen.ConstBool(true);
+  if (predicates.empty()) {
+    return should_scan;
+  }
+
+  llvm::Type *zone_map_type = ColumnZoneMapProxy::GetType(codegen);
+  llvm::Value *zone_maps =
+      codegen.Call(TileGroupProxy::GetColumnZoneMaps, {tile_group_ptr});
+  for (const auto &predicate : predicates) {
+    llvm::Value *zone_map = codegen->CreateConstInBoundsGEP1_32(
+        zone_map_type, zone_maps, predicate.col_id);
+    llvm::Value *min = codegen->CreateLoad(
+        codegen->CreateConstInBoundsGEP2_32(zone_map_type, zone_map, 0, 0));
+    llvm::Value *max = codegen->CreateLoad(
+        codegen->CreateConstInBoundsGEP2_32(zone_map_type, zone_map, 0, 1));
+
+    bool col_is_decimal =
+        predicate.col_type == peloton::type::TypeId::DECIMAL;
+    bool scalar_is_decimal =
+        predicate.value.GetType().type_id == peloton::type::TypeId::DECIMAL;
+    bool use_double = col_is_decimal || scalar_is_decimal;
+
+    llvm::Value *scalar = predicate.value.GetValue();
+    if (use_double) {
+      if (col_is_decimal) {
+        min = codegen->CreateBitCast(min, codegen.DoubleType());
+        max = codegen->CreateBitCast(max, codegen.DoubleType());
+      } else {
+        min = codegen->CreateSIToFP(min, codegen.DoubleType());
+        max = codegen->CreateSIToFP(max, codegen.DoubleType());
+      }
+      if (!scalar_is_decimal) {
+        scalar = codegen->CreateSIToFP(scalar, codegen.DoubleType());
+      }
+    } else {
+      scalar = codegen->CreateSExtOrBitCast(scalar, codegen.Int64Type());
+    }
+
+    llvm::Value *may_match = nullptr;
+    switch (predicate.comparison) {
+      case ExpressionType::COMPARE_EQUAL:
+        may_match = codegen->CreateAnd(
+            use_double ? codegen->CreateFCmpOLE(min, scalar)
+                       : codegen->CreateICmpSLE(min, scalar),
+            use_double ? codegen->CreateFCmpOGE(max, scalar)
+                       : codegen->CreateICmpSGE(max, scalar));
+        break;
+      case ExpressionType::COMPARE_LESSTHAN:
+        may_match = use_double ? codegen->CreateFCmpOLT(min, scalar)
+                               : codegen->CreateICmpSLT(min, scalar);
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        may_match = use_double ? codegen->CreateFCmpOLE(min, scalar)
+                               : codegen->CreateICmpSLE(min, scalar);
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        may_match = use_double ? codegen->CreateFCmpOGT(max, scalar)
+                               : codegen->CreateICmpSGT(max, scalar);
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        may_match = use_double ? codegen->CreateFCmpOGE(max, scalar)
+                               : codegen->CreateICmpSGE(max, scalar);
+        break;
+      default: {
+        throw Exception{"Unsupported zone map comparison: " +
+                        ExpressionTypeToString(predicate.comparison)};
+      }
+    }
+
+    // Don't rely on the bounds when the scalar is NULL
+    if (predicate.value.IsNullable()) {
+      may_match =
+          codegen->CreateOr(may_match, predicate.value.IsNull(codegen));
+    }
+    should_scan = codegen->CreateAnd(should_scan, may_match);
+  }
+  return should_scan;
 }
 
 // Generate a scan over all tile groups.
@@ -50,15 +133,14 @@ llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
 // @code
 // column_layouts := alloca<peloton::ColumnLayoutInfo>(
 //     table.GetSchema().GetColumnCount())
-// predicate_array := alloca<peloton::PredicateInfo>(
-//     num_predicates)
 //
 // oid_t tile_group_idx := 0
 // num_tile_groups = GetTileGroupCount(table_ptr)
 //
 // for (; tile_group_idx < num_tile_groups; ++tile_group_idx) {
-//   if (ShouldScanTileGroup(predicate_array, tile_group_idx)) {
-//      tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
+//   tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
+//   zone_maps := tile_group_ptr->GetColumnZoneMaps()
+//   if (zone_maps[col].min <= value && ...) {
 //      consumer.TileGroupStart(tile_group_ptr);
 //      tile_group.TidScan(tile_group_ptr, column_layouts, vector_size,
 //                         consumer);
@@ -69,24 +151,13 @@ llvm::Value *Table::GetZoneMapManager(CodeGen &codegen) const {
 // @endcode
 void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
                          uint32_t batch_size, ScanCallback &consumer,
-                         llvm::Value *predicate_ptr,
-                         size_t num_predicates) const {
+                         const std::vector<ZoneMapPredicate> &predicates) const {
   // Allocate some space for the column layouts
   const auto num_columns =
       static_cast<uint32_t>(table_.GetSchema()->GetColumnCount());
   llvm::Value *column_layouts = codegen.AllocateBuffer(
       ColumnLayoutInfoProxy::GetType(codegen), num_columns, "columnLayout");
 
-  // Allocate some space for the parsed predicates (if need be!)
-  llvm::Value *predicate_array =
-      codegen.NullPtr(PredicateInfoProxy::GetType(codegen)->getPointerTo());
-  if (num_predicates != 0) {
-    predicate_array = codegen.AllocateBuffer(
-        PredicateInfoProxy::GetType(codegen), num_predicates, "predicateInfo");
-    codegen.Call(RuntimeFunctionsProxy::FillPredicateArray,
-                 {predicate_ptr, predicate_array});
-  }
-
   // Get the number of tile groups in the given table
   llvm::Value *tile_group_idx = codegen.Const64(0);
   llvm::Value *num_tile_groups = GetTileGroupCount(codegen, table_ptr);
@@ -103,10 +174,8 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
         tile_group_.GetTileGroupId(codegen, tile_group_ptr);
 
     // Check zone map
-    llvm::Value *cond = codegen.Call(
-        ZoneMapManagerProxy::ShouldScanTileGroup,
-        {GetZoneMapManager(codegen), predicate_array,
-         codegen.Const32(num_predicates), table_ptr, tile_group_idx});
+    llvm::Value *cond =
+        ShouldScanTileGroup(codegen, tile_group_ptr, predicates);
 
     codegen::lang::If should_scan_tilegroup{codegen, cond};
     {
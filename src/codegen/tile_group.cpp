@@ -22,6 +22,7 @@
 #include "codegen/vector.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "codegen/type/boolean_type.h"
+#include "storage/frozen_block.h"
 
 namespace peloton {
 namespace codegen {
@@ -84,6 +85,7 @@ llvm::Value *TileGroup::GetTileGroupId(CodeGen &codegen,
 // 1. The starting memory address (where the first value of the column is)
 // 2. The stride length
 // 3. Whether the column is in columnar layout
+// 4. For integer columns, whether the column is packed, and how to decode it
 //===----------------------------------------------------------------------===//
 std::vector<TileGroup::ColumnLayout> TileGroup::GetColumnLayouts(
     CodeGen &codegen, llvm::Value *tile_group_ptr,
@@ -94,7 +96,8 @@ std::vector<TileGroup::ColumnLayout> TileGroup::GetColumnLayouts(
       RuntimeFunctionsProxy::GetTileGroupLayout,
       {tile_group_ptr, column_layout_infos, codegen.Const32(num_cols)});
 
-  // Collect <start, stride, is_columnar> triplets of all columns
+  // Collect the <start, stride, is_columnar> triplets of all columns, and the
+  // packing of the columns that may be packed
   std::vector<TileGroup::ColumnLayout> layouts;
   auto *layout_type = ColumnLayoutInfoProxy::GetType(codegen);
   for (uint32_t col_id = 0; col_id < num_cols; col_id++) {
@@ -104,7 +107,17 @@ std::vector<TileGroup::ColumnLayout> TileGroup::GetColumnLayouts(
         layout_type, column_layout_infos, col_id, 1));
     auto *columnar = codegen->CreateLoad(codegen->CreateConstInBoundsGEP2_32(
         layout_type, column_layout_infos, col_id, 2));
-    layouts.push_back(ColumnLayout{col_id, start, stride, columnar});
+    llvm::Value *packed = nullptr, *base = nullptr, *mask = nullptr;
+    if (storage::FrozenBlock::CanPackType(schema_.GetType(col_id))) {
+      packed = codegen->CreateLoad(codegen->CreateConstInBoundsGEP2_32(
+          layout_type, column_layout_infos, col_id, 3));
+      base = codegen->CreateLoad(codegen->CreateConstInBoundsGEP2_32(
+          layout_type, column_layout_infos, col_id, 4));
+      mask = codegen->CreateLoad(codegen->CreateConstInBoundsGEP2_32(
+          layout_type, column_layout_infos, col_id, 5));
+    }
+    layouts.push_back(
+        ColumnLayout{col_id, start, stride, columnar, packed, base, mask});
   }
   return layouts;
 }
@@ -145,10 +158,34 @@ codegen::Value TileGroup::LoadColumn(
     sql_type.GetTypeForMaterialization(codegen, col_type, col_len_type);
     PL_ASSERT(col_type != nullptr && col_len_type == nullptr);
 
-    // val = *(col_type*)col_address;
-    val = codegen->CreateLoad(
-        col_type,
-        codegen->CreateBitCast(col_address, col_type->getPointerTo()));
+    if (layout.is_packed == nullptr) {
+      // val = *(col_type*)col_address;
+      val = codegen->CreateLoad(
+          col_type,
+          codegen->CreateBitCast(col_address, col_type->getPointerTo()));
+    } else {
+      // val = is_packed ? base + (*(uint64_t*)col_address & mask)
+      //                 : *(col_type*)col_address;
+      llvm::Value *packed_val = nullptr, *unpacked_val = nullptr;
+      lang::If is_packed{codegen, layout.is_packed, "isPacked"};
+      {
+        llvm::Value *raw = codegen->CreateAlignedLoad(
+            codegen->CreateBitCast(col_address,
+                                   codegen.Int64Type()->getPointerTo()),
+            1);
+        packed_val = codegen->CreateAdd(layout.base,
+                                        codegen->CreateAnd(raw, layout.mask));
+        packed_val = codegen->CreateTruncOrBitCast(packed_val, col_type);
+      }
+      is_packed.ElseBlock("isNotPacked");
+      {
+        unpacked_val = codegen->CreateLoad(
+            col_type,
+            codegen->CreateBitCast(col_address, col_type->getPointerTo()));
+      }
+      is_packed.EndIf();
+      val = is_packed.BuildPHI(packed_val, unpacked_val);
+    }
 
     if (is_nullable) {
       // To check for NULL, we need to perform a comparison between the value we
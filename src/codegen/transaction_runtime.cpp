@@ -17,6 +17,7 @@
 #include "concurrency/transaction_context.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
+#include "storage/frozen_block.h"
 #include "storage/tile_group.h"
 
 namespace peloton {
@@ -37,13 +38,25 @@ uint32_t TransactionRuntime::PerformVectorizedRead(
   // Check visibility of tuples in the range [tid_start, tid_end), storing all
   // visible tuple IDs in the provided selection vector
   uint32_t out_idx = 0;
-  for (uint32_t i = tid_start; i < tid_end; i++) {
-    // Perform the visibility check
-    auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
-
-    // Update the output position
-    selection_vector[out_idx] = i;
-    out_idx += (visibility == VisibilityType::OK);
+  const storage::FrozenBlock *frozen_block = tile_group.GetFrozenBlock();
+  if (frozen_block != nullptr && frozen_block->IsVisibleTo(txn.GetReadId())) {
+    // The tile group is frozen, so its bitmap tells which tuples are visible
+    out_idx =
+        frozen_block->GetVisibleTuples(tid_start, tid_end, selection_vector);
+
+    // Read-only transactions don't record their reads
+    if (txn.GetIsolationLevel() == IsolationLevelType::READ_ONLY) {
+      return out_idx;
+    }
+  } else {
+    for (uint32_t i = tid_start; i < tid_end; i++) {
+      // Perform the visibility check
+      auto visibility = txn_manager.IsVisible(&txn, tile_group_header, i);
+
+      // Update the output position
+      selection_vector[out_idx] = i;
+      out_idx += (visibility == VisibilityType::OK);
+    }
   }
 
   uint32_t tile_group_idx = tile_group.GetTileGroupId();
@@ -133,10 +133,9 @@ void Updater::Update() {
   // Or, update with a new version
   ContainerTuple<storage::TileGroup> new_tuple(
     table_->GetTileGroupById(new_location_.block).get(), new_location_.offset);
-  ItemPointer *indirection =
-      tile_group_header->GetIndirection(old_location_.offset);
+  ItemPointer *indirection = table_->GetOrCreateIndirection(old_location_);
   auto result = table_->InstallVersion(&new_tuple, target_list_, txn,
-                                       indirection);
+                                       new_location_, indirection);
   if (result == false) {
     TransactionRuntime::YieldOwnership(*txn, tile_group_header,
                                        old_location_.offset);
@@ -22,6 +22,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
 #include "settings/settings_manager.h"
+#include "storage/tile_group_freezer.h"
 #include "threadpool/mono_queue_pool.h"
 
 namespace peloton {
@@ -62,9 +63,18 @@ void PelotonInit::Initialize() {
   // start layout tuner
   if (settings::SettingsManager::GetBool(settings::SettingId::layout_tuner)) {
     auto &layout_tuner = brain::LayoutTuner::GetInstance();
+    layout_tuner.SetTransformBandwidth(
+        static_cast<size_t>(settings::SettingsManager::GetInt(
+            settings::SettingId::layout_tuner_bandwidth)) * 1024);
     layout_tuner.Start();
   }
 
+  // start tile group freezer
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::freeze_cold_tile_groups)) {
+    storage::TileGroupFreezer::GetInstance().Start();
+  }
+
   // Initialize catalog
   auto pg_catalog = catalog::Catalog::GetInstance();
   pg_catalog->Bootstrap();  // Additional catalogs
@@ -94,6 +104,12 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down tile group freezer
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::freeze_cold_tile_groups)) {
+    storage::TileGroupFreezer::GetInstance().Stop();
+  }
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
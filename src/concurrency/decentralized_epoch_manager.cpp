@@ -24,9 +24,11 @@ namespace concurrency {
 
     if (ts_type == TimestampType::SNAPSHOT_READ) {
 
-      local_epochs_.at(thread_id)->EnterEpoch(snapshot_global_epoch_id_, ts_type);
+      eid_t snapshot_epoch_id = snapshot_global_epoch_id_.load();
 
-      return (snapshot_global_epoch_id_ << 32) | 0x0;
+      local_epochs_.at(thread_id)->EnterEpoch(snapshot_epoch_id, ts_type);
+
+      return (snapshot_epoch_id << 32) | 0x0;
 
     } else {
 
@@ -76,13 +78,25 @@ namespace concurrency {
     // if we observe that global_expired_eid is larger than snapshot_global_epoch,
     // then it means the current thread's progress is too slow.
     // we should directly update it to global_expired_eid + 1.
-    if (global_expired_eid != MAX_EID && 
-        global_expired_eid >= snapshot_global_epoch_id_) {
-      snapshot_global_epoch_id_ = global_expired_eid + 1;
+    // several threads may do this at once, so never move it backwards.
+    if (global_expired_eid != MAX_EID) {
+      eid_t snapshot_epoch_id = snapshot_global_epoch_id_.load();
+      while (global_expired_eid >= snapshot_epoch_id &&
+             !snapshot_global_epoch_id_.compare_exchange_weak(
+                 snapshot_epoch_id, global_expired_eid + 1)) {
+      }
     }
 
     return global_expired_eid;
   }
 
+  size_t DecentralizedEpochManager::GetRunningTransactionCount(const eid_t epoch_id) {
+    size_t txn_count = 0;
+    for (auto &local_epoch_itr : local_epochs_) {
+      txn_count += local_epoch_itr.second->GetTransactionCount(epoch_id);
+    }
+    return txn_count;
+  }
+
 }
 }
\ No newline at end of file
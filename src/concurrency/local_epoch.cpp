@@ -111,5 +111,17 @@ namespace concurrency {
     return ret;
   }
 
+  size_t LocalEpoch::GetTransactionCount(const uint64_t epoch_id) {
+    epoch_lock_.Lock();
+    size_t txn_count = 0;
+    for (auto &epoch_itr : epoch_map_) {
+      if (epoch_itr.first <= epoch_id) {
+        txn_count += epoch_itr.second->txn_count_;
+      }
+    }
+    epoch_lock_.Unlock();
+    return txn_count;
+  }
+
 }
 }
@@ -470,7 +470,8 @@ void TimestampOrderingTransactionManager::PerformInsert(
   oid_t tuple_id = location.offset;
 
   auto &manager = catalog::Manager::GetInstance();
-  auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+  auto tile_group = manager.GetTileGroup(tile_group_id);
+  auto tile_group_header = tile_group->GetHeader();
   auto transaction_id = current_txn->GetTransactionId();
 
   // check MVCC info
@@ -481,6 +482,12 @@ void TimestampOrderingTransactionManager::PerformInsert(
 
   tile_group_header->SetTransactionId(tuple_id, transaction_id);
 
+  // widen the zone map of the tile group to cover the new tuple
+  tile_group->GetZoneMap()->UpdateTuple(*tile_group, tuple_id);
+
+  // the frozen copy of the tile group doesn't know the new tuple
+  tile_group->Thaw();
+
   // no need to set next item pointer.
 
   // Add the new tuple into the insert set
@@ -488,8 +495,11 @@ void TimestampOrderingTransactionManager::PerformInsert(
 
   InitTupleReserved(tile_group_header, tuple_id);
 
-  // Write down the head pointer's address in tile group header
-  tile_group_header->SetIndirection(tuple_id, index_entry_ptr);
+  // Write down the head pointer's address in tile group header, unless the
+  // caller didn't keep the one the table wrote there
+  if (index_entry_ptr != nullptr) {
+    tile_group_header->SetIndirection(tuple_id, index_entry_ptr);
+  }
 
   // Increment table insert op stats
   if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) !=
@@ -513,10 +523,10 @@ void TimestampOrderingTransactionManager::PerformUpdate(
 
   auto &manager = catalog::Manager::GetInstance();
 
-  auto tile_group_header =
-      manager.GetTileGroup(old_location.block)->GetHeader();
-  auto new_tile_group_header =
-      manager.GetTileGroup(new_location.block)->GetHeader();
+  auto tile_group = manager.GetTileGroup(old_location.block);
+  auto tile_group_header = tile_group->GetHeader();
+  auto new_tile_group = manager.GetTileGroup(new_location.block);
+  auto new_tile_group_header = new_tile_group->GetHeader();
 
   auto transaction_id = current_txn->GetTransactionId();
   // if we can perform update, then we must have already locked the older
@@ -544,6 +554,14 @@ void TimestampOrderingTransactionManager::PerformUpdate(
 
   new_tile_group_header->SetTransactionId(new_location.offset, transaction_id);
 
+  // widen the zone map of the tile group to cover the new version
+  new_tile_group->GetZoneMap()->UpdateTuple(*new_tile_group,
+                                            new_location.offset);
+
+  // the old version is about to expire, so neither tile group may stay frozen
+  tile_group->Thaw();
+  new_tile_group->Thaw();
+
   // we should guarantee that the newer version is all set before linking the
   // newer version to older version.
   COMPILER_MEMORY_FENCE;
@@ -592,8 +610,8 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   UNUSED_ATTRIBUTE oid_t tuple_id = location.offset;
 
   auto &manager = catalog::Manager::GetInstance();
-  UNUSED_ATTRIBUTE auto tile_group_header =
-      manager.GetTileGroup(tile_group_id)->GetHeader();
+  auto tile_group = manager.GetTileGroup(tile_group_id);
+  UNUSED_ATTRIBUTE auto tile_group_header = tile_group->GetHeader();
 
   PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) ==
             current_txn->GetTransactionId());
@@ -608,6 +626,11 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   // is updating a version that is installed by itself.
   // in this case, nothing needs to be performed.
 
+  // the version was updated in place, so the zone map must cover its new
+  // values as well.
+  tile_group->GetZoneMap()->UpdateTuple(*tile_group, location.offset);
+  tile_group->Thaw();
+
   // Increment table update op stats
   if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) !=
       StatsType::INVALID) {
@@ -630,10 +653,10 @@ void TimestampOrderingTransactionManager::PerformDelete(
 
   auto &manager = catalog::Manager::GetInstance();
 
-  auto tile_group_header =
-      manager.GetTileGroup(old_location.block)->GetHeader();
-  auto new_tile_group_header =
-      manager.GetTileGroup(new_location.block)->GetHeader();
+  auto tile_group = manager.GetTileGroup(old_location.block);
+  auto tile_group_header = tile_group->GetHeader();
+  auto new_tile_group = manager.GetTileGroup(new_location.block);
+  auto new_tile_group_header = new_tile_group->GetHeader();
 
   auto transaction_id = current_txn->GetTransactionId();
 
@@ -665,6 +688,13 @@ void TimestampOrderingTransactionManager::PerformDelete(
 
   new_tile_group_header->SetEndCommitId(new_location.offset, INVALID_CID);
 
+  // the deleted tuple is about to expire, so neither tile group may stay
+  // frozen. Unlike the old version, the empty version was neither acquired
+  // nor published, so order its header before the checks of its tile group.
+  tile_group->Thaw();
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  new_tile_group->Thaw();
+
   // we should guarantee that the newer version is all set before linking the
   // newer version to older version.
   COMPILER_MEMORY_FENCE;
@@ -710,13 +740,15 @@ void TimestampOrderingTransactionManager::PerformDelete(
   oid_t tuple_id = location.offset;
 
   auto &manager = catalog::Manager::GetInstance();
-  auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+  auto tile_group = manager.GetTileGroup(tile_group_id);
+  auto tile_group_header = tile_group->GetHeader();
 
   PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) ==
             current_txn->GetTransactionId());
   PL_ASSERT(tile_group_header->GetBeginCommitId(tuple_id) == MAX_CID);
 
   tile_group_header->SetEndCommitId(tuple_id, INVALID_CID);
+  tile_group->Thaw();
 
   // Add the old tuple into the delete set
   auto old_location = tile_group_header->GetNextItemPointer(tuple_id);
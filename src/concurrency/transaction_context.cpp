@@ -87,6 +87,8 @@ void TransactionContext::Init(const size_t thread_id,
   gc_object_set_.reset(new GCObjectSet());
 
   on_commit_triggers_.reset();
+
+  on_commit_callbacks_.clear();
 }
 
 RWType TransactionContext::GetRWType(const ItemPointer &location) {
@@ -236,5 +238,11 @@ void TransactionContext::ExecOnCommitTriggers() {
   }
 }
 
+void TransactionContext::ExecOnCommitCallbacks() {
+  for (auto &callback : on_commit_callbacks_) {
+    callback();
+  }
+}
+
 }  // namespace concurrency
 }  // namespace peloton
@@ -76,14 +76,18 @@ TransactionContext *TransactionManager::BeginTransaction(
 }
 
 void TransactionManager::EndTransaction(TransactionContext *current_txn) {
-  // fire all on commit triggers
+  // fire all on commit triggers and callbacks
   if (current_txn->GetResult() == ResultType::SUCCESS) {
     current_txn->ExecOnCommitTriggers();
+    current_txn->ExecOnCommitCallbacks();
   }
 
   if(gc::GCManagerFactory::GetGCType() == GarbageCollectionType::ON) {
     gc::GCManagerFactory::GetInstance().RecycleTransaction(current_txn);
   } else {
+    // The GC exits the epoch of the transactions it recycles
+    EpochManagerFactory::GetInstance().ExitEpoch(current_txn->GetThreadId(),
+                                                 current_txn->GetEpochId());
     delete current_txn;
   }
 
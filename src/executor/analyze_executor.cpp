@@ -39,9 +39,9 @@ bool AnalyzeExecutor::DExecute() {
   const planner::AnalyzePlan &node = GetPlanNode<planner::AnalyzePlan>();
 
   storage::DataTable* target_table = node.GetTable();
-  UNUSED_ATTRIBUTE std::vector<char*> target_columns = node.GetColumnNames();
+  std::vector<char*> target_columns = node.GetColumnNames();
 
-  // LOG_TRACE("Analyzing column size %lu", target_columns.size());
+  LOG_TRACE("Analyzing column size %lu", target_columns.size());
 
   auto current_txn = executor_context_->GetTransaction();
 
@@ -49,7 +49,16 @@ bool AnalyzeExecutor::DExecute() {
 
   if (target_table != nullptr) {
     LOG_TRACE("Analyzing table %s", node.GetTableName().c_str());
-    ResultType result = stats->AnalyzeStatsForTable(target_table, current_txn);
+    ResultType result;
+    if (target_columns.empty()) {
+      result = stats->AnalyzeStatsForTable(target_table, current_txn);
+    } else {
+      // Analyzing several columns also keeps their joint stats
+      std::vector<std::string> column_names(target_columns.begin(),
+                                            target_columns.end());
+      result = stats->AnalayzeStatsForColumns(target_table, column_names,
+                                              current_txn);
+    }
     current_txn->SetResult(result);
     if (result == peloton::ResultType::SUCCESS) {
       LOG_TRACE("Successfully analyzed table %s", node.GetTableName().c_str());
@@ -26,6 +26,7 @@
 #include "storage/masked_tuple.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "storage/tile.h"
 #include "common/internal_types.h"
 #include "type/value.h"
 
@@ -82,6 +83,7 @@ bool IndexScanExecutor::DInit() {
   limit_number_ = node.GetLimitNumber();
   limit_offset_ = node.GetLimitOffset();
   descend_ = node.GetDescend();
+  covering_ = node.IsCovering();
 
   if (runtime_keys_.size() != 0) {
     PL_ASSERT(runtime_keys_.size() == values_.size());
@@ -118,7 +120,11 @@ bool IndexScanExecutor::DExecute() {
   LOG_TRACE("Index Scan executor :: 0 child");
 
   if (!done_) {
-    if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+    if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY &&
+        covering_ && !limit_) {
+      auto status = ExecCoveringIndexLookup();
+      if (status == false) return false;
+    } else if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
       auto status = ExecPrimaryIndexLookup();
       if (status == false) return false;
     } else {
@@ -209,110 +215,42 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   for (auto tuple_location_ptr : tuple_location_ptrs) {
     ItemPointer tuple_location = *tuple_location_ptr;
     auto tile_group = manager.GetTileGroup(tuple_location.block);
-    auto tile_group_header = tile_group.get()->GetHeader();
-    size_t chain_length = 0;
 
 #ifdef LOG_TRACE_ENABLED
     num_tuples_examined++;
 #endif
-    // the following code traverses the version chain until a certain visible
-    // version is found.
-    // we should always find a visible version from a version chain.
-    while (true) {
-      ++chain_length;
-
-      auto visibility = transaction_manager.IsVisible(
-          current_txn, tile_group_header, tuple_location.offset);
-
-      // if the tuple is deleted
-      if (visibility == VisibilityType::DELETED) {
-        LOG_TRACE("encounter deleted tuple: %u, %u", tuple_location.block,
-                  tuple_location.offset);
-        break;
-      }
-      // if the tuple is visible.
-      else if (visibility == VisibilityType::OK) {
-        LOG_TRACE("perform read: %u, %u", tuple_location.block,
-                  tuple_location.offset);
-
-        bool eval = true;
-        // if having predicate, then perform evaluation.
-        if (predicate_ != nullptr) {
-          LOG_TRACE("perform predicate evaluate");
-          ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                   tuple_location.offset);
-          eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-        }
-        // if passed evaluation, then perform write.
-        if (eval == true) {
-          LOG_TRACE("perform read operation");
-          auto res = transaction_manager.PerformRead(
-              current_txn, tuple_location, acquire_owner);
-          if (!res) {
-            LOG_TRACE("read nothing");
-            transaction_manager.SetTransactionResult(current_txn,
-                                                     ResultType::FAILURE);
-            return res;
-          }
-          // if perform read is successful, then add to visible tuple vector.
-          visible_tuple_locations.push_back(tuple_location);
-        }
-
-        break;
-      }
-      // if the tuple is not visible.
-      else {
-        PL_ASSERT(visibility == VisibilityType::INVISIBLE);
-
-        LOG_TRACE("Invisible read: %u, %u", tuple_location.block,
-                  tuple_location.offset);
-
-        bool is_acquired = (tile_group_header->GetTransactionId(
-                                tuple_location.offset) == INITIAL_TXN_ID);
-        bool is_alive =
-            (tile_group_header->GetEndCommitId(tuple_location.offset) <=
-             current_txn->GetReadId());
-        if (is_acquired && is_alive) {
-          // See an invisible version that does not belong to any one in the
-          // version chain.
-          // this means that some other transactions have modified the version
-          // chain.
-          // Wire back because the current version is expired. have to search
-          // from scratch.
-          tuple_location =
-              *(tile_group_header->GetIndirection(tuple_location.offset));
-          tile_group = manager.GetTileGroup(tuple_location.block);
-          tile_group_header = tile_group.get()->GetHeader();
-          chain_length = 0;
-          continue;
-        }
+    if (FindVisibleVersion(tuple_location, tile_group) == false) {
+      return false;
+    }
+    if (tuple_location.IsNull()) {
+      continue;
+    }
 
-        ItemPointer old_item = tuple_location;
-        tuple_location = tile_group_header->GetNextItemPointer(old_item.offset);
+    LOG_TRACE("perform read: %u, %u", tuple_location.block,
+              tuple_location.offset);
 
-        // there must exist a visible version.
-        if (tuple_location.IsNull()) {
-          if (chain_length == 1) {
-            break;
-          }
-
-          // in most cases, there should exist a visible version.
-          // if we have traversed through the chain and still can not fulfill
-          // one of the above conditions,
-          // then return result_failure.
-          transaction_manager.SetTransactionResult(current_txn,
-                                                   ResultType::FAILURE);
-          return false;
-        }
-
-        // search for next version.
-        tile_group = manager.GetTileGroup(tuple_location.block);
-        tile_group_header = tile_group.get()->GetHeader();
-        continue;
+    bool eval = true;
+    // if having predicate, then perform evaluation.
+    if (predicate_ != nullptr) {
+      LOG_TRACE("perform predicate evaluate");
+      ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                               tuple_location.offset);
+      eval = predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
+    }
+    // if passed evaluation, then perform write.
+    if (eval == true) {
+      LOG_TRACE("perform read operation");
+      auto res = transaction_manager.PerformRead(current_txn, tuple_location,
+                                                 acquire_owner);
+      if (!res) {
+        LOG_TRACE("read nothing");
+        transaction_manager.SetTransactionResult(current_txn,
+                                                 ResultType::FAILURE);
+        return res;
       }
+      // if perform read is successful, then add to visible tuple vector.
+      visible_tuple_locations.push_back(tuple_location);
     }
-    LOG_TRACE("Traverse length: %d\n", (int)chain_length);
   }
   LOG_TRACE("Examined %d tuples from index %s", num_tuples_examined,
             index_->GetName().c_str());
@@ -354,6 +292,130 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   return true;
 }
 
+bool IndexScanExecutor::ExecCoveringIndexLookup() {
+  PL_ASSERT(!done_);
+  PL_ASSERT(index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY);
+
+  // The keys are allocated from the pool of the query, like the results
+  std::vector<index::IndexEntry> entries;
+  const index::ConjunctionScanPredicate *csp_p = nullptr;
+  if (key_column_ids_.size() != 0) {
+    csp_p = &index_predicate_.GetConjunctionList()[0];
+  }
+  if (!index_->ScanEntries(values_, key_column_ids_, expr_types_,
+                           ScanDirectionType::FORWARD, entries, csp_p,
+                           executor_context_->GetPool())) {
+    return ExecPrimaryIndexLookup();
+  }
+
+  if (entries.size() == 0) {
+    LOG_TRACE("no tuple is retrieved from index.");
+    return false;
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  auto current_txn = executor_context_->GetTransaction();
+  cid_t read_id = current_txn->GetReadId();
+  bool is_read_only =
+      (current_txn->GetIsolationLevel() == IsolationLevelType::READ_ONLY);
+  auto &manager = catalog::Manager::GetInstance();
+
+  // Read the columns of the table from the key
+  std::vector<oid_t> key_column_map(table_->GetSchema()->GetColumnCount(),
+                                    INVALID_OID);
+  auto &key_attrs = index_->GetMetadata()->GetKeyAttrs();
+  for (oid_t key_column_id = 0; key_column_id < key_attrs.size();
+       key_column_id++) {
+    key_column_map[key_attrs[key_column_id]] = key_column_id;
+  }
+  storage::MaskedTuple key(nullptr, key_column_map);
+
+  std::vector<storage::Tuple *> visible_keys;
+  std::shared_ptr<storage::TileGroup> tile_group;
+  size_t num_skipped_chains = 0;
+
+  for (auto &entry : entries) {
+    key.SetTuple(entry.first.get());
+
+    // The key holds all the columns the conditions read, so the tuples that
+    // don't satisfy them are dropped before their headers are read
+    if ((left_open_ || right_open_) && CheckKeyConditions(key) == false) {
+      continue;
+    }
+    if (predicate_ != nullptr &&
+        predicate_->Evaluate(&key, nullptr, executor_context_).IsTrue() ==
+            false) {
+      continue;
+    }
+
+    // Consecutive entries mostly point to the same tile group
+    ItemPointer tuple_location = *entry.second;
+    if (tile_group == nullptr ||
+        tile_group->GetTileGroupId() != tuple_location.block) {
+      tile_group = manager.GetTileGroup(tuple_location.block);
+    }
+    auto tile_group_header = tile_group->GetHeader();
+
+    // If all the tuples of the tile group are visible and the entry points
+    // to the newest version, the transaction sees that version, and the
+    // version has the key
+    if (tile_group_header->IsAllVisibleTo(read_id) &&
+        tile_group_header->GetIndirection(tuple_location.offset) ==
+            entry.second) {
+      num_skipped_chains++;
+
+      // Read-only transactions don't record their reads
+      if (is_read_only) {
+        visible_keys.push_back(entry.first.get());
+        continue;
+      }
+    } else {
+      if (FindVisibleVersion(tuple_location, tile_group) == false) {
+        return false;
+      }
+      if (tuple_location.IsNull()) {
+        continue;
+      }
+    }
+
+    if (!transaction_manager.PerformRead(current_txn, tuple_location, false)) {
+      LOG_TRACE("read nothing");
+      transaction_manager.SetTransactionResult(current_txn,
+                                               ResultType::FAILURE);
+      return false;
+    }
+    visible_keys.push_back(entry.first.get());
+  }
+
+  LOG_TRACE("Skipped the version chains of %lu out of %lu tuples from index %s",
+            num_skipped_chains, entries.size(), index_->GetName().c_str());
+
+  // Materialize the columns of the visible tuples
+  if (visible_keys.size() != 0) {
+    std::unique_ptr<catalog::Schema> output_schema(
+        catalog::Schema::CopySchema(table_->GetSchema(), column_ids_));
+    std::shared_ptr<storage::Tile> output_tile(
+        storage::TileFactory::GetTempTile(*output_schema,
+                                          visible_keys.size()));
+    for (oid_t tuple_id = 0; tuple_id < visible_keys.size(); tuple_id++) {
+      for (oid_t column_id = 0; column_id < column_ids_.size(); column_id++) {
+        output_tile->SetValue(visible_keys[tuple_id]->GetValue(
+                                  key_column_map[column_ids_[column_id]]),
+                              tuple_id, column_id);
+      }
+    }
+    result_.push_back(LogicalTileFactory::WrapTiles({output_tile}));
+  }
+
+  done_ = true;
+
+  LOG_TRACE("Result tiles : %lu", result_.size());
+
+  return true;
+}
+
 bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   LOG_TRACE("ExecSecondaryIndexLookup");
   PL_ASSERT(!done_);
@@ -595,6 +657,88 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   return true;
 }
 
+bool IndexScanExecutor::FindVisibleVersion(
+    ItemPointer &tuple_location,
+    std::shared_ptr<storage::TileGroup> &tile_group) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  auto &manager = catalog::Manager::GetInstance();
+
+  auto tile_group_header = tile_group->GetHeader();
+  size_t chain_length = 0;
+
+  // the following code traverses the version chain until a certain visible
+  // version is found.
+  // we should always find a visible version from a version chain.
+  while (true) {
+    ++chain_length;
+
+    auto visibility = transaction_manager.IsVisible(
+        current_txn, tile_group_header, tuple_location.offset);
+
+    // if the tuple is deleted
+    if (visibility == VisibilityType::DELETED) {
+      LOG_TRACE("encounter deleted tuple: %u, %u", tuple_location.block,
+                tuple_location.offset);
+      tuple_location = INVALID_ITEMPOINTER;
+      return true;
+    }
+    // if the tuple is visible.
+    else if (visibility == VisibilityType::OK) {
+      LOG_TRACE("Traverse length: %d\n", (int)chain_length);
+      return true;
+    }
+    // if the tuple is not visible.
+    PL_ASSERT(visibility == VisibilityType::INVISIBLE);
+
+    LOG_TRACE("Invisible read: %u, %u", tuple_location.block,
+              tuple_location.offset);
+
+    bool is_acquired = (tile_group_header->GetTransactionId(
+                            tuple_location.offset) == INITIAL_TXN_ID);
+    bool is_alive = (tile_group_header->GetEndCommitId(tuple_location.offset) <=
+                     current_txn->GetReadId());
+    if (is_acquired && is_alive) {
+      // See an invisible version that does not belong to any one in the
+      // version chain.
+      // this means that some other transactions have modified the version
+      // chain.
+      // Wire back because the current version is expired. have to search
+      // from scratch.
+      tuple_location =
+          *(tile_group_header->GetIndirection(tuple_location.offset));
+      tile_group = manager.GetTileGroup(tuple_location.block);
+      tile_group_header = tile_group.get()->GetHeader();
+      chain_length = 0;
+      continue;
+    }
+
+    ItemPointer old_item = tuple_location;
+    tuple_location = tile_group_header->GetNextItemPointer(old_item.offset);
+
+    // there must exist a visible version.
+    if (tuple_location.IsNull()) {
+      if (chain_length == 1) {
+        tuple_location = INVALID_ITEMPOINTER;
+        return true;
+      }
+
+      // in most cases, there should exist a visible version.
+      // if we have traversed through the chain and still can not fulfill
+      // one of the above conditions,
+      // then return result_failure.
+      transaction_manager.SetTransactionResult(current_txn,
+                                               ResultType::FAILURE);
+      return false;
+    }
+
+    // search for next version.
+    tile_group = manager.GetTileGroup(tuple_location.block);
+    tile_group_header = tile_group.get()->GetHeader();
+  }
+}
+
 void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
     std::vector<ItemPointer> &tuple_locations) {
   while (left_open_) {
@@ -632,7 +776,10 @@ bool IndexScanExecutor::CheckKeyConditions(const ItemPointer &tuple_location) {
   auto tile_group = manager.GetTileGroup(tuple_location.block);
   ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
                                            tuple_location.offset);
+  return CheckKeyConditions(tuple);
+}
 
+bool IndexScanExecutor::CheckKeyConditions(const AbstractTuple &tuple) {
   // This is the end of loop
   oid_t cond_num = key_column_ids_.size();
 
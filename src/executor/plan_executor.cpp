@@ -12,8 +12,8 @@
 
 #include "executor/plan_executor.h"
 
-#include "codegen/buffering_consumer.h"
 #include "codegen/query_cache.h"
+#include "codegen/streaming_consumer.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executors.h"
 #include "settings/settings_manager.h"
@@ -31,18 +31,24 @@ static void CompileAndExecutePlan(
     std::shared_ptr<planner::AbstractPlan> plan,
     concurrency::TransactionContext *txn,
     const std::vector<type::Value> &params,
+    const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    std::function<void(std::vector<ResultValue> &)> on_result_batch) {
   LOG_TRACE("Compiling and executing query ...");
 
   // Perform binding
   planner::BindingContext context;
   plan->PerformBinding(context);
 
-  // Prepare output buffer
+  // Prepare the consumer. Rows are encoded into their result format as they
+  // are produced by the query, rather than buffered and converted afterwards,
+  // and handed to the sink in batches if there is one.
   std::vector<oid_t> columns;
   plan->GetOutputColumns(columns);
-  codegen::BufferingConsumer consumer{columns, context};
+  codegen::StreamingConsumer consumer{columns, context,
+                                      std::move(on_result_batch)};
+  consumer.SetResultFormat(result_format);
 
   std::unique_ptr<executor::ExecutorContext> executor_context(
       new executor::ExecutorContext(txn,
@@ -60,16 +66,10 @@ static void CompileAndExecutePlan(
 
   auto on_query_result =
       [&on_complete, &consumer](executor::ExecutionResult result) {
-        std::vector<ResultValue> values;
-        for (const auto &tuple : consumer.GetOutputTuples()) {
-          for (uint32_t i = 0; i < tuple.tuple_.size(); i++) {
-            auto column_val = tuple.GetValue(i);
-            auto str = column_val.IsNull() ? "" : column_val.ToString();
-            LOG_TRACE("column content: [%s]", str.c_str());
-            values.push_back(std::move(str));
-          }
-        }
-        on_complete(result, std::move(values));
+        consumer.Finish();
+        LOG_TRACE("Query produced %" PRIu64 " rows", consumer.GetNumRows());
+        // Only rows that no sink has taken are left
+        on_complete(result, consumer.ReleaseResults());
       };
 
   query->Execute(std::move(executor_context), consumer, on_query_result);
@@ -81,7 +81,8 @@ static void InterpretPlan(
     const std::vector<type::Value> &params,
     const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    std::function<void(std::vector<ResultValue> &)> on_result_batch) {
   executor::ExecutionResult result;
   std::vector<ResultValue> values;
 
@@ -119,6 +120,12 @@ static void InterpretPlan(
           values.push_back(std::move(tuple[i]));
         }
       }
+
+      // Every tile is a batch
+      if (on_result_batch != nullptr && !values.empty()) {
+        on_result_batch(values);
+        values.clear();
+      }
     }
   }
 
@@ -134,16 +141,19 @@ void PlanExecutor::ExecutePlan(
     const std::vector<type::Value> &params,
     const std::vector<int> &result_format,
     std::function<void(executor::ExecutionResult, std::vector<ResultValue> &&)>
-        on_complete) {
+        on_complete,
+    std::function<void(std::vector<ResultValue> &)> on_result_batch) {
   PL_ASSERT(plan != nullptr && txn != nullptr);
   LOG_TRACE("PlanExecutor Start (Txn ID=%" PRId64 ")", txn->GetTransactionId());
 
   bool codegen_enabled =
       settings::SettingsManager::GetBool(settings::SettingId::codegen);
   if (codegen_enabled && codegen::QueryCompiler::IsSupported(*plan)) {
-    CompileAndExecutePlan(plan, txn, params, std::move(on_complete));
+    CompileAndExecutePlan(plan, txn, params, result_format,
+                          std::move(on_complete), std::move(on_result_batch));
   } else {
-    InterpretPlan(plan, txn, params, result_format, std::move(on_complete));
+    InterpretPlan(plan, txn, params, result_format, std::move(on_complete),
+                  std::move(on_result_batch));
   }
 }
 
@@ -51,50 +51,16 @@ bool PopulateIndexExecutor::DInit() {
 bool PopulateIndexExecutor::DExecute() {
   LOG_TRACE("Populate Index Executor");
   PL_ASSERT(executor_context_ != nullptr);
-  auto current_txn = executor_context_->GetTransaction();
-  auto executor_pool = executor_context_->GetPool();
   if (done_ == false) {
-    //Get the output from seq_scan
+    // Executing the child creates the index, and the catalog builds it from
+    // the tuples of the table. The scanned tuples are versions the index
+    // already holds.
     while (children_[0]->Execute()) {
-      child_tiles_.emplace_back(children_[0]->GetOutput());
-    }
-
-    if (child_tiles_.size() == 0) {
-      LOG_TRACE("PopulateIndex Executor : false -- no child tiles ");
-      return false;
-    }
-
-    auto target_table_schema = target_table_->GetSchema();
-
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
-
-    // Go over the logical tile and insert in the index the values
-    for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
-         child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      for (oid_t tuple_id : *tile) {
-        ContainerTuple<LogicalTile> cur_tuple(tile, tuple_id);
-
-        // Materialize the logical tile tuple
-        for (oid_t column_itr = 0; column_itr < column_ids_.size();
-             column_itr++) {
-          type::Value val = (cur_tuple.GetValue(column_itr));
-          tuple->SetValue(column_ids_[column_itr], val, executor_pool);
-        }
-
-        ItemPointer location(tile->GetBaseTile(0)->GetTileGroup()->GetTileGroupId(),
-                             tuple_id);
-
-        // insert tuple into the index.
-        ItemPointer *index_entry_ptr = nullptr;
-        target_table_->InsertInIndexes(tuple.get(), location, current_txn,
-                                       &index_entry_ptr);
-      }
+      std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
     }
 
+    LOG_TRACE("Populated the index of table %s",
+              target_table_->GetName().c_str());
     done_ = true;
   }
   LOG_TRACE("Populate Index Executor : false -- done ");
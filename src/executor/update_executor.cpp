@@ -304,11 +304,12 @@ bool UpdateExecutor::DExecute() {
 
           // get indirection.
           ItemPointer *indirection =
-              tile_group_header->GetIndirection(old_location.offset);
+              target_table_->GetOrCreateIndirection(old_location);
           // finally install new version into the table
           ret = target_table_->InstallVersion(&new_tuple,
                                               &(project_info_->GetTargetList()),
-                                              current_txn, indirection);
+                                              current_txn, new_location,
+                                              indirection);
 
           // PerformUpdate() will not be executed if the insertion failed.
           // There is a write lock acquired, but since it is not in the write
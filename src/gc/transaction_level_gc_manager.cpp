@@ -12,12 +12,16 @@
 
 #include "gc/transaction_level_gc_manager.h"
 
+#include "catalog/catalog_defaults.h"
 #include "catalog/manager.h"
 #include "common/container_tuple.h"
 #include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
 #include "storage/database.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/tuple.h"
 #include "storage/storage_manager.h"
 
@@ -36,6 +40,7 @@ bool TransactionLevelGCManager::ResetTuple(const ItemPointer &location) {
   tile_group_header->SetEndCommitId(location.offset, MAX_CID);
   tile_group_header->SetPrevItemPointer(location.offset, INVALID_ITEMPOINTER);
   tile_group_header->SetNextItemPointer(location.offset, INVALID_ITEMPOINTER);
+  tile_group_header->SetIndirection(location.offset, nullptr);
 
   PL_MEMSET(tile_group_header->GetReservedFieldRef(location.offset), 0,
             storage::TileGroupHeader::GetReservedSize());
@@ -62,7 +67,17 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
     }
 
     int reclaimed_count = Reclaim(thread_id, expired_eid);
+
+    // Unlinking deletes index entries, which traverses the indexes. Their
+    // garbage nodes are only freed once the epochs that could reach them have
+    // expired, so the traversals run inside an epoch like transactions do
+    cid_t read_id = epoch_manager.EnterEpoch(0, TimestampType::READ);
     int unlinked_count = Unlink(thread_id, expired_eid);
+    epoch_manager.ExitEpoch(0, read_id >> 32);
+
+    if (thread_id == 0) {
+      MarkAllVisible();
+    }
 
     if (is_running_ == false) {
       return;
@@ -81,6 +96,72 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
   }
 }
 
+void TransactionLevelGCManager::MarkAllVisible() {
+  auto interval = settings::SettingsManager::GetInt(
+      settings::SettingId::all_visible_marking_interval);
+  auto now = std::chrono::steady_clock::now();
+  if (interval <= 0 ||
+      now - last_marking_time_ < std::chrono::milliseconds(interval)) {
+    return;
+  }
+
+  // Unless the horizon moved, the tile groups that failed are still settling
+  cid_t horizon_cid =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredCid();
+  if (horizon_cid == MAX_CID || horizon_cid == last_marking_cid_) {
+    return;
+  }
+  last_marking_time_ = now;
+  last_marking_cid_ = horizon_cid;
+
+  // Other GC threads may drop tables meanwhile, so the tile groups of each
+  // table are taken under the lock of its database, and outlive the table
+  size_t marked_count = 0;
+  auto storage_manager = storage::StorageManager::GetInstance();
+  for (oid_t db_offset = 0; db_offset < storage_manager->GetDatabaseCount();
+       db_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(db_offset);
+    if (database->GetOid() == CATALOG_DATABASE_OID) {
+      continue;
+    }
+    for (auto table_oid : database->GetTableOids()) {
+      marked_count += MarkAllVisible(
+          database->GetTileGroupsWithTableOid(table_oid), horizon_cid);
+    }
+  }
+  LOG_TRACE("Marked %lu tile groups all-visible at %lu", marked_count,
+            horizon_cid);
+}
+
+size_t TransactionLevelGCManager::MarkAllVisible(storage::DataTable *table,
+                                                 cid_t horizon_cid) {
+  std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    if (tile_group != nullptr) {
+      tile_groups.push_back(tile_group);
+    }
+  }
+  return MarkAllVisible(tile_groups, horizon_cid);
+}
+
+size_t TransactionLevelGCManager::MarkAllVisible(
+    const std::vector<std::shared_ptr<storage::TileGroup>> &tile_groups,
+    cid_t horizon_cid) {
+  size_t marked_count = 0;
+  for (auto &tile_group : tile_groups) {
+    auto tile_group_header = tile_group->GetHeader();
+    if (tile_group_header->IsAllVisibleTo(horizon_cid)) {
+      continue;
+    }
+    if (tile_group_header->SetAllVisible(horizon_cid)) {
+      marked_count++;
+    }
+  }
+  return marked_count;
+}
+
 void TransactionLevelGCManager::RecycleTransaction(
     concurrency::TransactionContext *txn) {
   auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
@@ -217,7 +298,6 @@ void TransactionLevelGCManager::AddToRecycleMap(
     oid_t table_id = table->GetOid();
     auto tile_group_header = tile_group->GetHeader();
     PL_ASSERT(tile_group_header != nullptr);
-    bool immutable = tile_group_header->GetImmutability();
 
     for (auto &element : entry.second) {
       // as this transaction has been committed, we should reclaim older
@@ -228,6 +308,13 @@ void TransactionLevelGCManager::AddToRecycleMap(
       if (ResetTuple(location) == false) {
         continue;
       }
+
+      // Check the flag after resetting the tuple: either the layout tuner,
+      // which sets it while transforming the tile group, sees the empty slot,
+      // or the slot isn't recycled into the tile group it is copying
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      bool immutable = tile_group_header->GetImmutability();
+
       // if immutable is false and the entry for table_id exists.
       if ((!immutable) &&
           recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
@@ -371,19 +458,31 @@ void TransactionLevelGCManager::UnlinkVersion(const ItemPointer location,
               type == GCVersionType::COMMIT_INS_DEL ||
               type == GCVersionType::ABORT_INS_DEL);
 
+    // Index builders skip versions without an index entry. Either a builder
+    // sees the cleared entry, or it scanned the version before, and the
+    // entry it found is unlinked below.
+    tile_group_header->SetIndirection(location.offset, nullptr);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
     // attempt to unlink the version from all the indexes.
     for (size_t idx = 0; idx < table->GetIndexCount(); ++idx) {
       auto index = table->GetIndex(idx);
       if (index == nullptr) continue;
+
+      // Partial indexes never had an entry for the version
+      if (index->CoversTuple(&current_tuple) == false) continue;
+
       auto index_schema = index->GetKeySchema();
-      auto indexed_columns = index_schema->GetIndexedColumns();
 
       // build key.
       std::unique_ptr<storage::Tuple> current_key(
           new storage::Tuple(index_schema, true));
-      current_key->SetFromTuple(&current_tuple, indexed_columns,
-                                index->GetPool());
+      index->BuildKey(&current_tuple, current_key.get());
 
+      // The builder of the index removes the entry after loading the tree
+      if (index->LogDeleteEntry(current_key.get(), indirection)) {
+        continue;
+      }
       index->DeleteEntry(current_key.get(), indirection);
     }
   }
@@ -75,6 +75,9 @@ class configuration {
   // tile group layout
   LayoutType layout_mode;
 
+  // max KB per second copied into new layouts by the layout tuner
+  int transform_bandwidth;
+
   double selectivity;
 
   double projectivity;
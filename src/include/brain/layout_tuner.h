@@ -64,10 +64,38 @@ class LayoutTuner {
 
   std::string GetColumnMapInfo(const column_map_type &column_map);
 
+  void SetTransformBandwidth(const size_t &transform_bandwidth_) {
+    transform_bandwidth = transform_bandwidth_;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Tuner Metrics
+  //===--------------------------------------------------------------------===//
+
+  // # of tile groups copied into a new layout
+  size_t GetTransformedTileGroupCount() const {
+    return transformed_tile_group_count;
+  }
+
+  // # of tile groups left in their layout because transactions were writing
+  // into them
+  size_t GetSkippedTileGroupCount() const { return skipped_tile_group_count; }
+
+  // # of bytes copied into new layouts
+  size_t GetTransformedBytes() const { return transformed_bytes; }
+
+  // Estimated speedup of the sampled scans over the transformed tile groups:
+  // the ratio of the # of tiles they access in the old and the new layouts
+  double GetScanSpeedup() const;
+
  protected:
   // Update layout of table
   void UpdateDefaultPartition(storage::DataTable *table);
 
+  // Transform a random tile group of the table, and sleep long enough for the
+  // copying to stay within the bandwidth
+  void TransformTileGroup(storage::DataTable *table);
+
  private:
   // Tables whose layout must be tuned
   std::vector<storage::DataTable *> tables;
@@ -105,6 +133,24 @@ class LayoutTuner {
   // Desired layout tile count
   oid_t tile_count = 2;
 
+  // Max # of bytes copied into new layouts per second, 0 if unlimited
+  size_t transform_bandwidth = 0;
+
+  //===--------------------------------------------------------------------===//
+  // Tuner Metrics
+  //===--------------------------------------------------------------------===//
+
+  std::atomic<size_t> transformed_tile_group_count{0};
+
+  std::atomic<size_t> skipped_tile_group_count{0};
+
+  std::atomic<size_t> transformed_bytes{0};
+
+  // # of tiles the sampled scans access in the transformed tile groups,
+  // before and after the transformation
+  std::atomic<double> tiles_accessed_before{0};
+
+  std::atomic<double> tiles_accessed_after{0};
 };
 
 }  // namespace brain
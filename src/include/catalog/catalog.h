@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 
 #include "catalog/catalog_defaults.h"
@@ -29,6 +30,10 @@ namespace concurrency {
 class TransactionContext;
 }  // namespace concurrency
 
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
 namespace index {
 class Index;
 }  // namespace index
@@ -101,12 +106,16 @@ class Catalog {
                          const std::string &index_name, bool unique_keys,
                          IndexType index_type, concurrency::TransactionContext *txn);
 
-  ResultType CreateIndex(oid_t database_oid, oid_t table_oid,
-                         const std::vector<oid_t> &key_attrs,
-                         const std::string &index_name, IndexType index_type,
-                         IndexConstraintType index_constraint, bool unique_keys,
-                         concurrency::TransactionContext *txn,
-                         bool is_catalog = false);
+  // The predicate makes the index partial, and the key expressions compute
+  // its key columns, see index::IndexMetadata. Neither is kept in pg_index.
+  ResultType CreateIndex(
+      oid_t database_oid, oid_t table_oid, const std::vector<oid_t> &key_attrs,
+      const std::string &index_name, IndexType index_type,
+      IndexConstraintType index_constraint, bool unique_keys,
+      concurrency::TransactionContext *txn, bool is_catalog = false,
+      std::shared_ptr<expression::AbstractExpression> predicate = nullptr,
+      const std::vector<std::shared_ptr<expression::AbstractExpression>>
+          &key_expressions = {});
 
   //===--------------------------------------------------------------------===//
   // DROP FUNCTIONS
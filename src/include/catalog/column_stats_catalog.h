@@ -23,6 +23,11 @@
 // 6: most_common_vals
 // 7: most_common_freqs
 // 8: histogram_bounds
+// 9: column_name
+// 10: has_index
+//
+// The most common values, their frequencies and the histogram bounds are
+// VARBINARY columns, encoded by optimizer::StatsStorage.
 //
 // Indexes: (index offset: indexed columns)
 // 0: name & database_oid (unique & primary key)
@@ -72,6 +72,12 @@ class BufferingConsumer : public QueryResultConsumer {
   // Called from compiled query code to buffer the tuple
   static void BufferTuple(char *state, char *tuple, uint32_t num_cols);
 
+  // Generate code to write the given attributes of the row into an array of
+  // peloton::type::Value, returning a (char *) pointer to the array
+  static llvm::Value *MaterializeRow(
+      CodeGen &codegen, RowBatch::Row &row,
+      const std::vector<const planner::AttributeInfo *> &output_ais);
+
   //===--------------------------------------------------------------------===//
   // ACCESSORS
   //===--------------------------------------------------------------------===//
@@ -35,6 +35,17 @@ namespace codegen {
 //===----------------------------------------------------------------------===//
 class TableScanTranslator : public OperatorTranslator {
  public:
+  // Global/configurable variable controlling whether simple scan predicates
+  // over contiguous (i.e., columnar) tile groups are evaluated using SIMD
+  static std::atomic<bool> use_simd_predicate;
+
+  // The number of rows evaluated per SIMD predicate instruction
+  static constexpr uint32_t kSIMDWidth = 8;
+
+  // Will the predicate of the scan be evaluated using SIMD over the tile groups
+  // whose predicate columns are contiguous?
+  static bool UseSIMDPredicate(const planner::SeqScanPlan &scan);
+
   // Constructor
   TableScanTranslator(const planner::SeqScanPlan &scan,
                       CompilationContext &context, Pipeline &pipeline);
@@ -122,8 +133,53 @@ class TableScanTranslator : public OperatorTranslator {
                                llvm::Value *tid_start, llvm::Value *tid_end,
                                Vector &selection_vector) const;
 
-    llvm::Value *SIMDFilterRows(RowBatch &batch,
-                                const TileGroup::TileGroupAccess &access) const;
+    // Filter rows by the values of the predicate columns, with SIMD or the
+    // scalar predicate translators
+    void FilterRowsByValues(CodeGen &codegen,
+                            const TileGroup::TileGroupAccess &access,
+                            llvm::Value *tid_start, llvm::Value *tid_end,
+                            Vector &selection_vector) const;
+
+    // Filter rows by the given equality predicates on VARCHAR columns,
+    // comparing the dictionary codes of the columns the current tile group
+    // encodes. Returns whether all of the columns were encoded.
+    llvm::Value *DictionaryFilterRows(
+        CodeGen &codegen,
+        const std::vector<const expression::AbstractExpression *> &predicates,
+        llvm::Value *tid_start, llvm::Value *tid_end,
+        Vector &selection_vector) const;
+
+    // Collect the conjuncts of the predicate that compare a VARCHAR column
+    // for equality with a scalar. Returns true if these are all conjuncts.
+    bool CollectDictionaryPredicates(
+        const expression::AbstractExpression &expr,
+        std::vector<const expression::AbstractExpression *> &predicates) const;
+
+    // Filter rows one-at-a-time using the scalar predicate translators
+    void ScalarFilterRows(CodeGen &codegen,
+                          const TileGroup::TileGroupAccess &access,
+                          llvm::Value *tid_start, llvm::Value *tid_end,
+                          Vector &selection_vector) const;
+
+    // Filter rows by evaluating the predicate over vectors of kSIMDWidth rows
+    // at a time. Only valid when all columns the predicate uses are stored
+    // contiguously in the tile group.
+    void SIMDFilterRows(CodeGen &codegen,
+                        const TileGroup::TileGroupAccess &access,
+                        llvm::Value *tid_start, llvm::Value *tid_end,
+                        Vector &selection_vector) const;
+
+    // Evaluate the predicate over the given number of consecutive rows
+    // starting at the provided TID, returning a vector of booleans
+    llvm::Value *SIMDEvaluate(CodeGen &codegen,
+                              const expression::AbstractExpression &expr,
+                              const TileGroup::TileGroupAccess &access,
+                              llvm::Value *tid, uint32_t width) const;
+
+    // Generate a check if every column used by the predicate is stored
+    // contiguously in the current tile group
+    llvm::Value *PredicateColumnsContiguous(
+        CodeGen &codegen, const TileGroup::TileGroupAccess &access) const;
 
    private:
     // The translator instance the consumer is generating code for
@@ -145,6 +201,15 @@ class TableScanTranslator : public OperatorTranslator {
   // Table accessor
   const storage::DataTable &GetTable() const;
 
+  // Collect the conjuncts of the predicate that compare a column to a scalar,
+  // and that the zone maps of tile groups can rule out
+  void CollectZoneMapPredicates(
+      const expression::AbstractExpression &expr,
+      std::vector<Table::ZoneMapPredicate> &predicates) const;
+
+  // Can the given predicate be evaluated with ScanConsumer::SIMDEvaluate()?
+  static bool IsSIMDFilterable(const expression::AbstractExpression &expr);
+
  private:
   // The scan
   const planner::SeqScanPlan &scan_;
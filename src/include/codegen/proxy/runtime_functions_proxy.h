@@ -26,6 +26,9 @@ PROXY(ColumnLayoutInfo) {
   DECLARE_MEMBER(0, char *, col_start_ptr);
   DECLARE_MEMBER(1, uint32_t, stride);
   DECLARE_MEMBER(2, bool, columnar);
+  DECLARE_MEMBER(3, bool, packed);
+  DECLARE_MEMBER(4, int64_t, base);
+  DECLARE_MEMBER(5, uint64_t, mask);
   DECLARE_TYPE;
 };
 
@@ -39,6 +42,7 @@ PROXY(RuntimeFunctions) {
   DECLARE_METHOD(GetTileGroup);
   DECLARE_METHOD(GetTileGroupLayout);
   DECLARE_METHOD(FillPredicateArray);
+  DECLARE_METHOD(GetDictionaryCodes);
   DECLARE_METHOD(ThrowDivideByZeroException);
   DECLARE_METHOD(ThrowOverflowException);
 };
@@ -14,6 +14,7 @@
 
 #include "codegen/proxy/proxy.h"
 #include "codegen/proxy/type_builder.h"
+#include "codegen/proxy/zone_map_proxy.h"
 #include "storage/tile_group.h"
 
 namespace peloton {
@@ -25,6 +26,7 @@ PROXY(TileGroup) {
 
   DECLARE_METHOD(GetNextTupleSlot);
   DECLARE_METHOD(GetTileGroupId);
+  DECLARE_METHOD(GetColumnZoneMaps);
 };
 
 TYPE_BUILDER(TileGroup, storage::TileGroup);
@@ -15,6 +15,7 @@
 
 #include "codegen/proxy/proxy.h"
 #include "codegen/proxy/type_builder.h"
+#include "storage/zone_map.h"
 #include "storage/zone_map_manager.h"
 #include "concurrency/transaction_context.h"
 #include "codegen/proxy/value_proxy.h"
@@ -32,6 +33,14 @@ PROXY(PredicateInfo) {
   DECLARE_TYPE;
 };
 
+PROXY(ColumnZoneMap) {
+  DECLARE_MEMBER(0, int64_t, min);
+  DECLARE_MEMBER(1, int64_t, max);
+  DECLARE_MEMBER(2, uint32_t, null_count);
+  DECLARE_MEMBER(3, uint32_t, tracked);
+  DECLARE_TYPE;
+};
+
 PROXY(ZoneMapManager) {
   DECLARE_MEMBER(0, char[sizeof(storage::ZoneMapManager)], opaque);
   DECLARE_TYPE;
@@ -40,6 +49,7 @@ PROXY(ZoneMapManager) {
 };
 
 TYPE_BUILDER(PredicateInfo, storage::PredicateInfo);
+TYPE_BUILDER(ColumnZoneMap, storage::ColumnZoneMap);
 TYPE_BUILDER(ZoneMapManager, storage::ZoneMapManager);
 
 }  // namespace codegen
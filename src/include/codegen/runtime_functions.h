@@ -58,16 +58,30 @@ class RuntimeFunctions {
   // doing strided accesses to mimic columnar storage.  In a pure row-store,
   // the stride is equivalent to the size of the tuple. In a pure column-store
   // (without compression), the stride is equivalent to the size of data type.
+  //
+  // The integer columns of a frozen tile group are read from its packed copy,
+  // where the stride is the width of the packed values. A value is decoded as
+  // base + (the eight bytes at its address & mask).
   struct ColumnLayoutInfo {
     char *column;
     uint32_t stride;
     bool is_columnar;
+    bool is_packed;
+    int64_t base;
+    uint64_t mask;
   };
 
   // Get the column configuration for every column in the tile group
   static void GetTileGroupLayout(const storage::TileGroup *tile_group,
                                  ColumnLayoutInfo *infos, uint32_t num_cols);
 
+  // Get the codes of a dictionary encoded column of the tile group, and the
+  // code of the given value in them. Returns nullptr if the column isn't
+  // encoded.
+  static const uint32_t *GetDictionaryCodes(const storage::TileGroup *tile_group,
+                                            uint32_t col_id, const char *data,
+                                            uint32_t length, uint32_t *code);
+
   static void ThrowDivideByZeroException();
 
   static void ThrowOverflowException();
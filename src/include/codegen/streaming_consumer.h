@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// streaming_consumer.h
+//
+// Identification: src/include/codegen/streaming_consumer.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "codegen/compilation_context.h"
+#include "codegen/query_result_consumer.h"
+#include "common/statement.h"
+
+namespace peloton {
+
+namespace planner {
+class BindingContext;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A query consumer that encodes output tuples directly into their final
+// (string) result format as they are produced, without buffering intermediate
+// copies of the tuples. Encoded rows are accumulated in batches. If a sink is
+// provided, every full batch is handed to the sink and then discarded. The sink
+// is invoked on the thread executing the query, so a sink that blocks (e.g.,
+// waiting for a slow client to drain its buffer) throttles query execution.
+// Without a sink, all rows are kept and can be released after execution.
+//===----------------------------------------------------------------------===//
+class StreamingConsumer : public QueryResultConsumer {
+ public:
+  // The callback invoked with a batch of encoded rows. Each row contributes
+  // one value per output column, in order. NULLs are encoded as empty values.
+  using BatchSink = std::function<void(std::vector<ResultValue> &batch)>;
+
+  // The default number of rows in a batch
+  static constexpr uint32_t kDefaultBatchSize = 1024;
+
+  struct StreamingState {
+    StreamingConsumer *consumer;
+  };
+
+  // Constructor
+  StreamingConsumer(const std::vector<oid_t> &cols,
+                    const planner::BindingContext &context,
+                    BatchSink sink = nullptr,
+                    uint32_t batch_size = kDefaultBatchSize);
+
+  void Prepare(CompilationContext &compilation_context) override;
+  void InitializeState(CompilationContext &) override {}
+  void TearDownState(CompilationContext &) override {}
+  void ConsumeResult(ConsumerContext &ctx, RowBatch::Row &row) const override;
+
+  // Called from compiled query code to encode the tuple into the batch
+  static void StreamTuple(char *state, char *tuple, uint32_t num_cols);
+
+  // Set the per-column format codes the client requested: 0 for text, 1 for
+  // binary. Columns without a format code use text.
+  void SetResultFormat(const std::vector<int> &result_format);
+
+  // Hand any remaining rows to the sink. Must be called after the query has
+  // finished executing.
+  void Finish();
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  char *GetConsumerState() final { return reinterpret_cast<char *>(&state_); }
+
+  // The total number of rows produced by the query
+  uint64_t GetNumRows() const { return num_rows_; }
+
+  // Release the encoded rows not yet handed to a sink
+  std::vector<ResultValue> ReleaseResults() { return std::move(results_); }
+
+ private:
+  void AppendTuple(const peloton::type::Value *vals, uint32_t num_cols);
+
+  // Encode the value in the Postgres binary format (network byte order)
+  static ResultValue EncodeBinary(const peloton::type::Value &val);
+
+ private:
+  // The attributes we want to output
+  std::vector<const planner::AttributeInfo *> output_ais_;
+
+  // Which columns are encoded in binary
+  std::vector<bool> binary_cols_;
+
+  // Where full batches go, and how many rows make up a batch
+  BatchSink sink_;
+  uint32_t batch_size_;
+
+  // The encoded rows in the current batch
+  std::vector<ResultValue> results_;
+  uint32_t num_batch_rows_;
+  uint64_t num_rows_;
+
+  // Running streaming state
+  StreamingState state_;
+
+  // The slot in the runtime state to find our state context
+  RuntimeState::StateID consumer_state_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -15,6 +15,7 @@
 #include "codegen/codegen.h"
 #include "codegen/scan_callback.h"
 #include "codegen/tile_group.h"
+#include "codegen/value.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -34,15 +35,25 @@ namespace codegen {
 //===----------------------------------------------------------------------===//
 class Table {
  public:
+  // A comparison of a column with a scalar, which tile groups are skipped on
+  // if their zone maps show that no tuple satisfies it
+  struct ZoneMapPredicate {
+    oid_t col_id;
+    peloton::type::TypeId col_type;
+    ExpressionType comparison;
+    codegen::Value value;
+  };
+
   // Constructor
   Table(storage::DataTable &table);
 
   // Generate code to perform a scan over the given table. The table pointer
   // is provided as the second argument. The scan consumer (third argument)
-  // should be notified when ready to generate the scan loop body.
+  // should be notified when ready to generate the scan loop body. Tile groups
+  // whose zone maps rule out any of the predicates are skipped.
   void GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
                     uint32_t batch_size, ScanCallback &consumer,
-                    llvm::Value *predicate_array, size_t num_predicates) const;
+                    const std::vector<ZoneMapPredicate> &predicates) const;
 
   // Given a table instance, return the number of tile groups in the table.
   llvm::Value *GetTileGroupCount(CodeGen &codegen,
@@ -53,7 +64,13 @@ class Table {
   llvm::Value *GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
                             llvm::Value *tile_group_id) const;
 
-  llvm::Value *GetZoneMapManager(CodeGen &codegen) const;
+ private:
+  // Generate a check of the zone maps of the tile group against the
+  // predicates. The result is false if no tuple in the tile group can satisfy
+  // all of them.
+  llvm::Value *ShouldScanTileGroup(
+      CodeGen &codegen, llvm::Value *tile_group_ptr,
+      const std::vector<ZoneMapPredicate> &predicates) const;
 
  private:
   // The table associated with this generator
@@ -53,6 +53,10 @@ class TileGroup {
     llvm::Value *col_start_ptr;
     llvm::Value *col_stride;
     llvm::Value *is_columnar;
+    // Only set for columns that may be packed
+    llvm::Value *is_packed;
+    llvm::Value *base;
+    llvm::Value *mask;
   };
 
   /*
@@ -121,6 +121,8 @@ public:
     return current_global_epoch_id_.load();
   }  
 
+  virtual size_t GetRunningTransactionCount(const eid_t epoch_id) override;
+
 private:
 
 
@@ -152,8 +154,9 @@ private:
   std::atomic<uint32_t> next_txn_id_;
   
   // snapshot epoch is an epoch where the corresponding tuples may be still
-  // visible to on-the-fly transactions
-  eid_t snapshot_global_epoch_id_;
+  // visible to on-the-fly transactions.
+  // it only moves forward, and may be advanced by any thread reclaiming.
+  std::atomic<eid_t> snapshot_global_epoch_id_;
 
   bool is_running_;
 
@@ -59,6 +59,10 @@ public:
 
   virtual cid_t GetExpiredCid() = 0;
 
+  // The number of running transactions that entered the given epoch or an
+  // older one
+  virtual size_t GetRunningTransactionCount(const eid_t epoch_id) = 0;
+
 };
 
 }
@@ -59,6 +59,9 @@ public:
   
   uint64_t GetExpiredEpochId(const uint64_t current_epoch_id);
 
+  // the number of transactions in the given epoch or an older one.
+  size_t GetTransactionCount(const uint64_t epoch_id);
+
 private:
   common::synchronization::SpinLatch epoch_lock_;
   
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
@@ -104,6 +105,14 @@ class TransactionContext : public Printable {
 
   void ExecOnCommitTriggers();
 
+  // Add a function that is called once the transaction has committed, e.g., to
+  // publish in-memory state that must not be visible before the commit
+  void AddOnCommitCallback(std::function<void()> callback) {
+    on_commit_callbacks_.push_back(std::move(callback));
+  }
+
+  void ExecOnCommitCallbacks();
+
   bool IsInRWSet(const ItemPointer &location) {
     oid_t tile_group_id = location.block;
     oid_t tuple_id = location.offset;
@@ -190,6 +199,8 @@ class TransactionContext : public Printable {
   IsolationLevelType isolation_level_;
 
   std::unique_ptr<trigger::TriggerSet> on_commit_triggers_;
+
+  std::vector<std::function<void()>> on_commit_callbacks_;
 };
 
 }  // namespace concurrency
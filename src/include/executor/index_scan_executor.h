@@ -25,6 +25,7 @@ class Index;
 
 namespace storage {
 class AbstractTable;
+class TileGroup;
 }
 
 namespace executor {
@@ -61,6 +62,17 @@ class IndexScanExecutor : public AbstractScanExecutor {
   bool ExecPrimaryIndexLookup();
   bool ExecSecondaryIndexLookup();
 
+  // Read the columns from the keys of the primary index, skipping the version
+  // chains of the tuples in tile groups whose tuples are all visible
+  bool ExecCoveringIndexLookup();
+
+  // Walk the version chain from the version at the location, in the tile
+  // group, to the version the transaction sees. Returns false if the
+  // transaction has to abort. Otherwise the location is the visible version,
+  // or INVALID_ITEMPOINTER if there is none.
+  bool FindVisibleVersion(ItemPointer &tuple_location,
+                          std::shared_ptr<storage::TileGroup> &tile_group);
+
   // When the required scan range has open boundaries, the tuples found by the
   // index might not be exact since the index can only give back tuples in a
   // close range. This function prune the head and the tail of the returned
@@ -72,6 +84,8 @@ class IndexScanExecutor : public AbstractScanExecutor {
   // conditions on key columns
   bool CheckKeyConditions(const ItemPointer &tuple_location);
 
+  bool CheckKeyConditions(const AbstractTuple &tuple);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -134,6 +148,9 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   // whether order by is descending
   bool descend_ = false;
+
+  // whether the index key holds all the columns the scan reads
+  bool covering_ = false;
 };
 
 }  // namespace executor
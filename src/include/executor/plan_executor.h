@@ -50,6 +50,10 @@ class PlanExecutor {
    * for network
    * Before ExecutePlan, a node first receives value list, so we should
    * pass value list directly rather than passing Postgres's ParamListInfo
+   *
+   * If on_result_batch is given, the result rows are handed to it in batches
+   * while the plan executes, on the executing thread, and on_complete gets
+   * no rows. Otherwise on_complete gets all of them.
    */
   static void ExecutePlan(
       std::shared_ptr<planner::AbstractPlan> plan,
@@ -57,7 +61,9 @@ class PlanExecutor {
       const std::vector<type::Value> &params,
       const std::vector<int> &result_format,
       std::function<void(executor::ExecutionResult,
-                         std::vector<ResultValue> &&)> on_complete);
+                         std::vector<ResultValue> &&)> on_complete,
+      std::function<void(std::vector<ResultValue> &)> on_result_batch =
+          nullptr);
 
   /*
    * @brief When a peloton node recvs a query plan, this function is invoked
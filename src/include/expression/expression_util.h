@@ -663,10 +663,12 @@ class ExpressionUtil {
                expr_type == ExpressionType::COMPARE_LESSTHANOREQUALTO ||
                expr_type == ExpressionType::COMPARE_GREATERTHAN ||
                expr_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
-      // The right child should be a constant.
+      // The right child should be a constant, and the left one a column.
       auto right_child = expr->GetModifiableChild(1);
 
-      if (right_child->GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
+      if (right_child->GetExpressionType() == ExpressionType::VALUE_CONSTANT &&
+          expr->GetChild(0)->GetExpressionType() ==
+              ExpressionType::VALUE_TUPLE) {
         auto right_exp = (const expression::ConstantValueExpression
                               *)(expr->GetModifiableChild(1));
         auto predicate_val = right_exp->GetValue();
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <chrono>
 #include <list>
 #include <map>
+#include <memory>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -28,6 +30,12 @@
 #include "common/container/lock_free_queue.h"
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+class TileGroup;
+}
+
 namespace gc {
 
 #define MAX_QUEUE_LENGTH 100000
@@ -66,6 +74,7 @@ class TransactionLevelGCManager : public GCManager {
     reclaim_maps_.clear();
     reclaim_maps_.resize(gc_thread_count_);
     recycle_queue_map_.clear();
+    last_marking_cid_ = INVALID_CID;
 
     is_running_ = false;
   }
@@ -129,6 +138,10 @@ class TransactionLevelGCManager : public GCManager {
 
   int Reclaim(const int &thread_id, const eid_t &expired_eid);
 
+  // Set the all-visible bit of the tile groups of the table whose tuples are
+  // all visible at the horizon. Returns the number of tile groups marked.
+  size_t MarkAllVisible(storage::DataTable *table, cid_t horizon_cid);
+
  private:
   inline unsigned int HashToThread(const size_t &thread_id) {
     return (unsigned int)thread_id % gc_thread_count_;
@@ -144,6 +157,14 @@ class TransactionLevelGCManager : public GCManager {
 
   void Running(const int &thread_id);
 
+  // Mark the tile groups of all tables whose tuples are all visible to the
+  // transactions that haven't expired, at most once per marking interval
+  void MarkAllVisible();
+
+  size_t MarkAllVisible(
+      const std::vector<std::shared_ptr<storage::TileGroup>> &tile_groups,
+      cid_t horizon_cid);
+
   void AddToRecycleMap(concurrency::TransactionContext *txn_ctx);
 
   bool ResetTuple(const ItemPointer &);
@@ -186,6 +207,10 @@ class TransactionLevelGCManager : public GCManager {
   std::unordered_map<oid_t,
                      std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>>
       recycle_queue_map_;
+
+  // when the tile groups were last marked, and at which horizon
+  std::chrono::steady_clock::time_point last_marking_time_;
+  cid_t last_marking_cid_ = INVALID_CID;
 };
 }
 }  // namespace peloton
@@ -29,11 +29,14 @@
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <mutex>
 #include <thread>
 #include <unordered_set>
 // offsetof() is defined here
 #include <cstddef>
 #include <vector>
+#include <new>
+#include <type_traits>
 
 /*
  * BWTREE_PELOTON - Specifies whether Peloton-specific features are
@@ -51,6 +54,7 @@
 
 #ifdef BWTREE_PELOTON
 
+#include "concurrency/epoch_manager_factory.h"
 #include "index/index.h"
 
 #endif
@@ -85,6 +89,16 @@ using NodeID = uint64_t;
  */
 #define USE_OLD_EPOCH
 
+/*
+ * USE_PELOTON_EPOCH - This flag makes the epoch manager reclaim garbage nodes
+ *                     once the epochs of Peloton's transactions that could
+ *                     see them have expired, instead of maintaining epochs of
+ *                     its own. It takes precedence over USE_OLD_EPOCH
+ */
+#ifdef BWTREE_PELOTON
+#define USE_PELOTON_EPOCH
+#endif
+
 /*
  * BWTREE_TEMPLATE_ARGUMENTS - Save some key strokes
  */
@@ -121,7 +135,30 @@ extern bool print_flag;
 
 // If the length of delta chain exceeds ( >= ) this then we consolidate the node
 #define INNER_DELTA_CHAIN_LENGTH_THRESHOLD ((int)8)
-#define LEAF_DELTA_CHAIN_LENGTH_THRESHOLD ((int)8)
+
+// Leaf nodes adapt this threshold to how often they are read: it is the
+// maximum for nodes that are only written, and halves every time the number
+// of reads per delta doubles, down to the minimum
+#define LEAF_DELTA_CHAIN_LENGTH_MIN_THRESHOLD ((int)2)
+#define LEAF_DELTA_CHAIN_LENGTH_MAX_THRESHOLD ((int)16)
+
+// Lookups only count one in this many reads of leaf nodes, and sample the
+// delta chain length in one of this many counted reads
+#define LEAF_READ_SAMPLE_INTERVAL ((uint32_t)16)
+
+// The number of read counters of leaf nodes, which share them by NodeID
+#define LEAF_READ_COUNTER_NUM ((size_t)(1 << 14))
+
+// Read counters are allocated in chunks of this many on the first counted
+// read of a node that maps to the chunk
+#define LEAF_READ_COUNTER_CHUNK_SIZE ((size_t)(1 << 10))
+
+// Read counters stop at this value, from which on the consolidation
+// threshold of any delta chain is at its minimum
+#define LEAF_READ_COUNT_MAX                                             \
+  ((uint8_t)(LEAF_DELTA_CHAIN_LENGTH_MAX_THRESHOLD *                    \
+             LEAF_DELTA_CHAIN_LENGTH_MAX_THRESHOLD /                    \
+             LEAF_DELTA_CHAIN_LENGTH_MIN_THRESHOLD / LEAF_READ_SAMPLE_INTERVAL))
 
 // If node size goes above this then we split it
 #define INNER_NODE_SIZE_UPPER_THRESHOLD ((int)128)
@@ -130,6 +167,14 @@ extern bool print_flag;
 #define LEAF_NODE_SIZE_UPPER_THRESHOLD ((int)128)
 #define LEAF_NODE_SIZE_LOWER_THRESHOLD ((int)32)
 
+// Nodes built by BulkLoad() hold this many items, which leaves room for
+// inserts before they split
+#define INNER_NODE_BULK_LOAD_SIZE ((int)96)
+#define LEAF_NODE_BULK_LOAD_SIZE ((int)96)
+
+// GetValueBatch() interleaves the traversals of this many keys
+#define BATCH_LOOKUP_GROUP_SIZE ((size_t)8)
+
 #define PREALLOCATE_THREAD_NUM ((size_t)1024)
 
 /*
@@ -2464,6 +2509,15 @@ class BwTree : public BwTreeBase {
         update_op_count{0},
         update_abort_count{0},
 
+        // Maintenance counters
+        delta_chain_length_sum{0},
+        delta_chain_sample_count{0},
+        max_delta_chain_length{0},
+        consolidation_count{0},
+        split_count{0},
+        reclaimed_node_count{0},
+        reclaimed_byte_count{0},
+
         // Epoch Manager that does garbage collection
         epoch_manager{this} {
     LOG_TRACE(
@@ -2473,6 +2527,10 @@ class BwTree : public BwTreeBase {
     InitMappingTable();
     InitNodeLayout();
 
+    for (auto &leaf_read_count_chunk : leaf_read_count_chunk_list) {
+      leaf_read_count_chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
     LOG_TRACE("sizeof(NodeMetaData) = %lu is the overhead for each node",
               sizeof(NodeMetaData));
     LOG_TRACE("sizeof(KeyType) = %lu is the size of key", sizeof(KeyType));
@@ -2508,6 +2566,10 @@ class BwTree : public BwTreeBase {
     (void)node_count;
     LOG_TRACE("Freed %lu tree nodes", node_count);
 
+    for (auto &leaf_read_count_chunk : leaf_read_count_chunk_list) {
+      delete[] leaf_read_count_chunk.load();
+    }
+
     return;
   }
 
@@ -5380,6 +5442,8 @@ class BwTree : public BwTreeBase {
           goto abort_traverse;
         }
 
+        RecordLeafRead(GetLatestNodeSnapshot(context_p));
+
 #ifdef BWTREE_DEBUG
 
         LOG_TRACE("Found leaf node (RO). Abort count = %d, level = %d",
@@ -5985,6 +6049,13 @@ class BwTree : public BwTreeBase {
                                     snapshot_p->node_p);
 
     if (ret == true) {
+      consolidation_count.fetch_add(1);
+      std::atomic<uint8_t> *read_count_p =
+          GetLeafReadCounter(snapshot_p->node_id, false);
+      if (read_count_p != nullptr) {
+        read_count_p->store(0, std::memory_order_relaxed);
+      }
+
       epoch_manager.AddGarbageNode(snapshot_p->node_p);
 
       snapshot_p->node_p = leaf_node_p;
@@ -6009,6 +6080,8 @@ class BwTree : public BwTreeBase {
                                     snapshot_p->node_p);
 
     if (ret == true) {
+      consolidation_count.fetch_add(1);
+
       epoch_manager.AddGarbageNode(snapshot_p->node_p);
 
       snapshot_p->node_p = inner_node_p;
@@ -6082,7 +6155,8 @@ class BwTree : public BwTreeBase {
     int depth = node_p->GetDepth();
 
     if (snapshot_p->IsLeaf() == true) {
-      if (depth < LEAF_DELTA_CHAIN_LENGTH_THRESHOLD) {
+      if (depth < LEAF_DELTA_CHAIN_LENGTH_MIN_THRESHOLD ||
+          depth < GetLeafConsolidationThreshold(snapshot_p->node_id, depth)) {
         return;
       }
     } else {
@@ -6098,6 +6172,115 @@ class BwTree : public BwTreeBase {
     return;
   }
 
+  /*
+   * GetLeafConsolidationThreshold() - Returns the delta chain length from which
+   *                                   on a leaf node is consolidated
+   *
+   * Every delta makes each read of the node one step longer, while the
+   * consolidation costs about as much as a few reads. So nodes that are read
+   * often are consolidated early, and nodes that are mostly written late.
+   * The reads are the ones RecordLeafRead() sampled since the node was last
+   * consolidated, and the depth of the node is the number of its deltas
+   */
+  int GetLeafConsolidationThreshold(NodeID node_id, int depth) {
+    std::atomic<uint8_t> *read_count_p = GetLeafReadCounter(node_id, false);
+    if (read_count_p == nullptr) {
+      return LEAF_DELTA_CHAIN_LENGTH_MAX_THRESHOLD;
+    }
+
+    uint64_t read_count =
+        read_count_p->load(std::memory_order_relaxed) *
+        LEAF_READ_SAMPLE_INTERVAL;
+    uint64_t reads_per_delta = read_count / std::max(depth, 1);
+
+    int threshold = LEAF_DELTA_CHAIN_LENGTH_MAX_THRESHOLD;
+    while (reads_per_delta > 0 &&
+           threshold > LEAF_DELTA_CHAIN_LENGTH_MIN_THRESHOLD) {
+      threshold /= 2;
+      reads_per_delta /= 2;
+    }
+
+    return threshold;
+  }
+
+  /*
+   * GetLeafReadCounter() - Returns the read counter of a leaf node
+   *
+   * Trees that are small or only written do not pay for all counters. If the
+   * chunk of the counter has not been allocated yet, it is allocated when
+   * allocate is set, and otherwise nullptr is returned
+   */
+  std::atomic<uint8_t> *GetLeafReadCounter(NodeID node_id, bool allocate) {
+    size_t counter_id = node_id % LEAF_READ_COUNTER_NUM;
+    auto &chunk = leaf_read_count_chunk_list[counter_id /
+                                             LEAF_READ_COUNTER_CHUNK_SIZE];
+
+    std::atomic<uint8_t> *chunk_p = chunk.load(std::memory_order_acquire);
+    if (chunk_p == nullptr) {
+      if (allocate == false) {
+        return nullptr;
+      }
+
+      std::atomic<uint8_t> *new_chunk_p =
+          new std::atomic<uint8_t>[LEAF_READ_COUNTER_CHUNK_SIZE];
+      for (size_t i = 0; i < LEAF_READ_COUNTER_CHUNK_SIZE; i++) {
+        new_chunk_p[i].store(0, std::memory_order_relaxed);
+      }
+
+      // If another thread installed the chunk first then use that one
+      if (chunk.compare_exchange_strong(chunk_p, new_chunk_p) == true) {
+        chunk_p = new_chunk_p;
+      } else {
+        delete[] new_chunk_p;
+      }
+    }
+
+    return &chunk_p[counter_id % LEAF_READ_COUNTER_CHUNK_SIZE];
+  }
+
+  /*
+   * RecordLeafRead() - Samples a lookup that has read a leaf node
+   *
+   * One in LEAF_READ_SAMPLE_INTERVAL lookups of a thread counts as a read of
+   * the node for GetLeafConsolidationThreshold(), and one in
+   * LEAF_READ_SAMPLE_INTERVAL of those records the length of the delta chain
+   * it went through.
+   *
+   * The counter is not incremented atomically, since losing a read only
+   * delays the consolidation a bit. Once it reaches LEAF_READ_COUNT_MAX it is
+   * only read, so that the threads reading a hot node share its cache line
+   */
+  inline void RecordLeafRead(const NodeSnapshot *snapshot_p) {
+    static thread_local uint32_t read_count = 0;
+    if (++read_count % LEAF_READ_SAMPLE_INTERVAL != 0) {
+      return;
+    }
+
+    std::atomic<uint8_t> *read_count_p =
+        GetLeafReadCounter(snapshot_p->node_id, true);
+    uint8_t node_read_count = read_count_p->load(std::memory_order_relaxed);
+    if (node_read_count < LEAF_READ_COUNT_MAX) {
+      read_count_p->store(node_read_count + 1, std::memory_order_relaxed);
+    }
+
+    if (read_count % (LEAF_READ_SAMPLE_INTERVAL * LEAF_READ_SAMPLE_INTERVAL) !=
+        0) {
+      return;
+    }
+
+    uint64_t depth = static_cast<uint64_t>(snapshot_p->node_p->GetDepth());
+    delta_chain_length_sum.fetch_add(depth, std::memory_order_relaxed);
+    delta_chain_sample_count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max_depth = max_delta_chain_length.load(std::memory_order_relaxed);
+    while (depth > max_depth &&
+           max_delta_chain_length.compare_exchange_weak(max_depth, depth) ==
+               false) {
+    }
+
+    return;
+  }
+
   /*
    * AdjustNodeSize() - Post split or merge delta if a node becomes overflow
    *                    or underflow
@@ -6192,6 +6375,8 @@ class BwTree : public BwTreeBase {
           LOG_TRACE("Leaf split delta (from %" PRIu64 " to %" PRIu64 ") CAS succeeds. ABORT",
                     node_id, new_node_id);
 
+          split_count.fetch_add(1);
+
           // TODO: WE ABORT HERE TO AVOID THIS THREAD POSTING ANYTHING
           // ON TOP OF IT WITHOUT HELPING ALONG AND ALSO BLOCKING OTHER
           // THREAD TO HELP ALONG
@@ -6342,6 +6527,8 @@ class BwTree : public BwTreeBase {
               " ABORT",
               node_id, new_node_id);
 
+          split_count.fetch_add(1);
+
           // Same reason as in leaf node
           context_p->abort_flag = true;
 
@@ -7069,6 +7256,143 @@ class BwTree : public BwTreeBase {
     return true;
   }
 
+  /*
+   * BulkLoad() - Builds the tree bottom-up from a list of key-value pairs
+   *
+   * The leaf nodes are filled with the sorted items directly, and the inner
+   * nodes with the low keys of their children, level by level until a single
+   * node is left, which becomes the root. All values of a key go into the
+   * same leaf node, like they do when a leaf node splits.
+   *
+   * The items are sorted by key if they aren't, and must not hold the same
+   * key-value pair twice.
+   *
+   * NOTE: The tree must be empty, and no other thread may access it until
+   * this function returns. If the tree is not empty then nothing is loaded
+   * and the return value is false
+   */
+  bool BulkLoad(std::vector<KeyValuePair> &items) {
+    // The tree must still have the layout set up by InitNodeLayout()
+    NodeID root_node_id = root_id.load();
+    const BaseNode *root_node_p = GetNode(root_node_id);
+    if (root_node_p->GetType() != NodeType::InnerType) {
+      return false;
+    }
+    const InnerNode *root_inner_p = static_cast<const InnerNode *>(root_node_p);
+    if (root_inner_p->GetSize() != 1 ||
+        root_inner_p->At(0).second != first_leaf_id) {
+      return false;
+    }
+    const BaseNode *first_leaf_p = GetNode(first_leaf_id);
+    if (first_leaf_p->GetType() != NodeType::LeafType ||
+        static_cast<const LeafNode *>(first_leaf_p)->GetSize() != 0) {
+      return false;
+    }
+
+    if (items.empty() == true) {
+      return true;
+    }
+
+    auto key_less = [this](const KeyValuePair &kvp1, const KeyValuePair &kvp2) {
+      return KeyCmpLess(kvp1.first, kvp2.first);
+    };
+    if (std::is_sorted(items.begin(), items.end(), key_less) == false) {
+      std::stable_sort(items.begin(), items.end(), key_less);
+    }
+
+    // Split the items into leaf nodes without separating equal keys
+    std::vector<size_t> leaf_starts;
+    for (size_t start = 0; start < items.size();) {
+      leaf_starts.push_back(start);
+      size_t end =
+          std::min(start + LEAF_NODE_BULK_LOAD_SIZE, items.size());
+      while (end < items.size() &&
+             KeyCmpEqual(items[end].first, items[end - 1].first) == true) {
+        end++;
+      }
+      start = end;
+    }
+    leaf_starts.push_back(items.size());
+
+    // The leftmost leaf keeps its NodeID since iterators start from it
+    size_t leaf_count = leaf_starts.size() - 1;
+    std::vector<NodeID> leaf_ids(leaf_count);
+    leaf_ids[0] = first_leaf_id;
+    for (size_t i = 1; i < leaf_count; i++) {
+      leaf_ids[i] = GetNextNodeID();
+    }
+
+    // Free the empty root and leaf, which also clears their mapping
+    FreeNodeByNodeID(root_node_id);
+
+    // The separators of the current level for the level above; the low key
+    // of the leftmost node is never compared
+    std::vector<KeyNodeIDPair> children;
+    for (size_t i = 0; i < leaf_count; i++) {
+      const KeyValuePair *start_p = items.data() + leaf_starts[i];
+      int size = static_cast<int>(leaf_starts[i + 1] - leaf_starts[i]);
+      KeyNodeIDPair low_key_pair =
+          (i == 0) ? std::make_pair(KeyType(), INVALID_NODE_ID)
+                   : std::make_pair(start_p->first, ~INVALID_NODE_ID);
+      KeyNodeIDPair high_key_pair =
+          (i + 1 < leaf_count)
+              ? std::make_pair(items[leaf_starts[i + 1]].first, leaf_ids[i + 1])
+              : std::make_pair(KeyType(), INVALID_NODE_ID);
+
+      LeafNode *leaf_node_p =
+          reinterpret_cast<LeafNode *>(ElasticNode<KeyValuePair>::Get(
+              size, NodeType::LeafType, 0, size, low_key_pair, high_key_pair));
+      leaf_node_p->PushBack(start_p, start_p + size);
+      InstallNewNode(leaf_ids[i], leaf_node_p);
+
+      children.push_back(std::make_pair(
+          (i == 0) ? KeyType() : start_p->first, leaf_ids[i]));
+    }
+
+    // Build the inner levels. The single node of the top level is the root,
+    // which keeps its NodeID
+    while (true) {
+      size_t node_count =
+          (children.size() + INNER_NODE_BULK_LOAD_SIZE - 1) /
+          INNER_NODE_BULK_LOAD_SIZE;
+      std::vector<NodeID> node_ids(node_count);
+      for (size_t i = 0; i < node_count; i++) {
+        node_ids[i] = (node_count == 1) ? root_node_id : GetNextNodeID();
+      }
+
+      std::vector<KeyNodeIDPair> parents;
+      for (size_t i = 0; i < node_count; i++) {
+        size_t start = i * INNER_NODE_BULK_LOAD_SIZE;
+        size_t end = std::min(start + INNER_NODE_BULK_LOAD_SIZE,
+                              children.size());
+        int size = static_cast<int>(end - start);
+        KeyNodeIDPair high_key_pair =
+            (i + 1 < node_count)
+                ? std::make_pair(children[end].first, node_ids[i + 1])
+                : std::make_pair(KeyType(), INVALID_NODE_ID);
+
+        InnerNode *inner_node_p =
+            reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::Get(
+                size, NodeType::InnerType, 0, size, children[start],
+                high_key_pair));
+        inner_node_p->PushBack(children.data() + start, children.data() + end);
+        InstallNewNode(node_ids[i], inner_node_p);
+
+        parents.push_back(std::make_pair(children[start].first, node_ids[i]));
+      }
+
+      if (node_count == 1) {
+        break;
+      }
+      children = std::move(parents);
+    }
+
+    LOG_TRACE("Bulk loaded %lu items into %lu leaf nodes", items.size(),
+              leaf_count);
+
+    return true;
+  }
+
 #ifdef BWTREE_PELOTON
 
   /*
@@ -7290,6 +7614,122 @@ class BwTree : public BwTreeBase {
     return value_set;
   }
 
+  /*
+   * GetValueBatch() - Fill a value list for each key of a batch
+   *
+   * The keys are looked up in sorted order, such that consecutive lookups
+   * go through the same nodes, and in groups of BATCH_LOOKUP_GROUP_SIZE
+   * whose traversals are interleaved level by level: the group first finds
+   * the next NodeID of every key and prefetches its mapping table entry, then
+   * prefetches the nodes, and only then loads them. This way the cache misses
+   * of the keys in a group overlap, instead of each key waiting for a chain
+   * of dependent misses on its own.
+   *
+   * The values of keys[i] are appended to value_lists[i]
+   */
+  void GetValueBatch(const std::vector<KeyType> &keys,
+                     std::vector<std::vector<ValueType>> &value_lists) {
+    LOG_TRACE("GetValueBatch()");
+
+    value_lists.resize(keys.size());
+
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(),
+              [this, &keys](const size_t index1, const size_t index2) {
+                return KeyCmpLess(keys[index1], keys[index2]);
+              });
+
+    // Context can't be moved, so the contexts of a group are constructed
+    // in place
+    using ContextStorage =
+        typename std::aligned_storage<sizeof(Context), alignof(Context)>::type;
+    ContextStorage context_storage[BATCH_LOOKUP_GROUP_SIZE];
+    Context *context_p_list[BATCH_LOOKUP_GROUP_SIZE];
+    NodeID node_id_list[BATCH_LOOKUP_GROUP_SIZE];
+    bool done_list[BATCH_LOOKUP_GROUP_SIZE];
+
+    for (size_t group_start = 0; group_start < keys.size();
+         group_start += BATCH_LOOKUP_GROUP_SIZE) {
+      size_t group_size =
+          std::min(BATCH_LOOKUP_GROUP_SIZE, keys.size() - group_start);
+
+      EpochNode *epoch_node_p = epoch_manager.JoinEpoch();
+
+      // This is the serialization point for reading the root node
+      NodeID root_node_id = root_id.load();
+      for (size_t i = 0; i < group_size; i++) {
+        context_p_list[i] =
+            new (&context_storage[i]) Context{keys[order[group_start + i]]};
+        node_id_list[i] = root_node_id;
+        done_list[i] = false;
+      }
+
+      size_t remaining = group_size;
+      while (remaining > 0) {
+        for (size_t i = 0; i < group_size; i++) {
+          if (done_list[i] == false) {
+            __builtin_prefetch(&mapping_table[node_id_list[i]]);
+          }
+        }
+
+        for (size_t i = 0; i < group_size; i++) {
+          if (done_list[i] == false) {
+            __builtin_prefetch(GetNode(node_id_list[i]));
+          }
+        }
+
+        // Load the nodes, and either collect the values of the key from the
+        // leaf or find the next node, like TraverseReadOptimized() does
+        for (size_t i = 0; i < group_size; i++) {
+          if (done_list[i] == true) {
+            continue;
+          }
+
+          Context *context_p = context_p_list[i];
+          LoadNodeIDReadOptimized(node_id_list[i], context_p);
+          if (context_p->abort_flag == false) {
+            if (GetLatestNodeSnapshot(context_p)->IsLeaf() == true) {
+              NavigateLeafNode(context_p, value_lists[order[group_start + i]]);
+              if (context_p->abort_flag == false) {
+                RecordLeafRead(GetLatestNodeSnapshot(context_p));
+                done_list[i] = true;
+                remaining--;
+                continue;
+              }
+            } else {
+              node_id_list[i] = NavigateInnerNode(context_p);
+              if (context_p->abort_flag == false) {
+                continue;
+              }
+            }
+          }
+
+          LOG_TRACE("Batched traversal aborts (RO). Retry from the root");
+
+#ifdef BWTREE_DEBUG
+          context_p->current_level = -1;
+          context_p->abort_counter++;
+#endif
+
+          context_p->current_snapshot.node_id = INVALID_NODE_ID;
+          context_p->abort_flag = false;
+          node_id_list[i] = root_id.load();
+        }
+      }
+
+      for (size_t i = 0; i < group_size; i++) {
+        context_p_list[i]->~Context();
+      }
+
+      epoch_manager.LeaveEpoch(epoch_node_p);
+    }
+
+    return;
+  }
+
   ///////////////////////////////////////////////////////////////////
   // Garbage Collection Interface
   ///////////////////////////////////////////////////////////////////
@@ -7324,6 +7764,28 @@ class BwTree : public BwTreeBase {
     return;
   }
 
+#ifdef BWTREE_PELOTON
+
+  /*
+   * GetMaintenanceStats() - Returns a snapshot of the maintenance counters
+   *
+   * The delta chain lengths are those of the sampled leaf reads
+   */
+  IndexMaintenanceStats GetMaintenanceStats() const {
+    IndexMaintenanceStats stats;
+    stats.delta_chain_length_sum = delta_chain_length_sum.load();
+    stats.delta_chain_sample_count = delta_chain_sample_count.load();
+    stats.max_delta_chain_length = max_delta_chain_length.load();
+    stats.consolidation_count = consolidation_count.load();
+    stats.split_count = split_count.load();
+    stats.reclaimed_node_count = reclaimed_node_count.load();
+    stats.reclaimed_byte_count = reclaimed_byte_count.load();
+
+    return stats;
+  }
+
+#endif
+
 /*
  * Private Method Implementation
  */
@@ -7388,6 +7850,21 @@ class BwTree : public BwTreeBase {
   std::atomic<uint64_t> update_op_count;
   std::atomic<uint64_t> update_abort_count;
 
+  // Sampled reads of leaf nodes since their last consolidation, see
+  // GetLeafReadCounter()
+  std::array<std::atomic<std::atomic<uint8_t> *>,
+             LEAF_READ_COUNTER_NUM / LEAF_READ_COUNTER_CHUNK_SIZE>
+      leaf_read_count_chunk_list;
+
+  // Maintenance counters, see GetMaintenanceStats()
+  std::atomic<uint64_t> delta_chain_length_sum;
+  std::atomic<uint64_t> delta_chain_sample_count;
+  std::atomic<uint64_t> max_delta_chain_length;
+  std::atomic<uint64_t> consolidation_count;
+  std::atomic<uint64_t> split_count;
+  std::atomic<uint64_t> reclaimed_node_count;
+  std::atomic<uint64_t> reclaimed_byte_count;
+
   // InteractiveDebugger idb;
 
   EpochManager epoch_manager;
@@ -7415,6 +7892,12 @@ class BwTree : public BwTreeBase {
       // This does not have to be atomic, since we only
       // insert at the head of garbage list
       GarbageNode *next_p;
+
+#ifdef USE_PELOTON_EPOCH
+      // The Peloton epoch in which the node was unlinked. Transactions of
+      // later epochs cannot reach it
+      uint64_t delete_epoch;
+#endif
     };
 
     /*
@@ -7458,6 +7941,27 @@ class BwTree : public BwTreeBase {
     // Otherwise it points to a thread created by EpochManager internally
     std::thread *thread_p;
 
+#ifdef USE_PELOTON_EPOCH
+    // Garbage nodes added since the last reclamation; worker threads CAS new
+    // ones onto the head
+    std::atomic<GarbageNode *> garbage_list_p;
+
+    // Garbage nodes that have been moved off the garbage list, oldest first.
+    // Only the thread that holds reclaim_latch accesses them
+    GarbageNode *reclaim_head_p;
+    GarbageNode *reclaim_tail_p;
+
+    // Number of nodes in the garbage list
+    std::atomic<size_t> garbage_count;
+
+    // The worker thread whose garbage node brings the garbage list to this
+    // size reclaims the nodes of expired epochs
+    std::atomic<size_t> reclaim_garbage_count;
+
+    // Only one thread reclaims garbage at a time
+    std::mutex reclaim_latch;
+#endif
+
 // The counter that counts how many free is called
 // inside the epoch manager
 // NOTE: We cannot precisely count the size of memory freed
@@ -7503,6 +8007,14 @@ class BwTree : public BwTreeBase {
       // This is used to notify the cleaner thread that it has ended
       exited_flag.store(false);
 
+#ifdef USE_PELOTON_EPOCH
+      garbage_list_p.store(nullptr);
+      reclaim_head_p = nullptr;
+      reclaim_tail_p = nullptr;
+      garbage_count.store(0);
+      reclaim_garbage_count.store(GC_NODE_COUNT_THREADHOLD);
+#endif
+
 // Initialize atomic counter to record how many
 // freed has been called inside epoch manager
 #ifdef BWTREE_DEBUG
@@ -7558,6 +8070,11 @@ class BwTree : public BwTreeBase {
         LOG_TRACE("Thread stops");
       }
 
+#ifdef USE_PELOTON_EPOCH
+      // No thread accesses the tree any more
+      ReclaimGarbage(MAX_EID);
+#endif
+
       // So that in the following function the comparison
       // would always fail, until we have cleaned all epoch nodes
       current_epoch_p = nullptr;
@@ -7632,7 +8149,128 @@ class BwTree : public BwTreeBase {
       return;
     }
 
-#ifdef USE_OLD_EPOCH
+#if defined(USE_PELOTON_EPOCH)
+
+    /*
+     * AddGarbageNode() - Add garbage node tagged with the current Peloton
+     *                    epoch
+     *
+     * Every thread that reads or writes the tree does so inside a Peloton
+     * transaction, or an epoch it entered itself, so the node may be freed
+     * once the epoch it was unlinked in has expired. The thread that adds
+     * enough garbage nodes reclaims the expired ones, so no cleaner thread is
+     * needed
+     *
+     * NOTE: This function is called by worker threads so it has
+     * to consider race conditions
+     */
+    void AddGarbageNode(const BaseNode *node_p) {
+      GarbageNode *garbage_node_p = new GarbageNode;
+      garbage_node_p->node_p = node_p;
+      garbage_node_p->delete_epoch =
+          concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+
+      garbage_node_p->next_p = garbage_list_p.load();
+      while (garbage_list_p.compare_exchange_strong(garbage_node_p->next_p,
+                                                    garbage_node_p) == false) {
+        LOG_TRACE("Add garbage node CAS failed. Retry");
+      }
+
+      if (garbage_count.fetch_add(1) + 1 >= reclaim_garbage_count.load()) {
+        PerformGarbageCollection();
+      }
+
+      return;
+    }
+
+    /*
+     * JoinEpoch() - Readers are protected by the epoch of their transaction
+     */
+    inline EpochNode *JoinEpoch() { return nullptr; }
+
+    inline void LeaveEpoch(EpochNode *epoch_p) {
+      (void)epoch_p;
+      return;
+    }
+
+    /*
+     * PerformGarbageCollection() - Free the garbage nodes of expired epochs
+     *
+     * If another thread is reclaiming garbage then this returns immediately
+     */
+    void PerformGarbageCollection() {
+      std::unique_lock<std::mutex> lock(reclaim_latch, std::try_to_lock);
+      if (lock.owns_lock() == false) {
+        return;
+      }
+
+      uint64_t expired_epoch =
+          concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+      if (expired_epoch == MAX_EID) {
+        // No thread has entered an epoch yet
+        return;
+      }
+
+      ReclaimGarbage(expired_epoch);
+
+      return;
+    }
+
+    /*
+     * ReclaimGarbage() - Free the garbage nodes deleted on or before the epoch
+     *
+     * The nodes added since the last call are reversed onto the tail of the
+     * reclaim list, which keeps it ordered by the epoch the nodes were deleted
+     * in, so freeing stops at the first node that is still protected. A node
+     * that was added after one of a later epoch is freed a bit late, never
+     * early. Must not run concurrently with itself
+     */
+    void ReclaimGarbage(uint64_t expired_epoch) {
+      GarbageNode *garbage_node_p = garbage_list_p.exchange(nullptr);
+      GarbageNode *added_head_p = nullptr;
+      GarbageNode *added_tail_p = garbage_node_p;
+
+      while (garbage_node_p != nullptr) {
+        GarbageNode *next_garbage_node_p = garbage_node_p->next_p;
+        garbage_node_p->next_p = added_head_p;
+        added_head_p = garbage_node_p;
+        garbage_node_p = next_garbage_node_p;
+      }
+
+      if (added_head_p != nullptr) {
+        if (reclaim_tail_p == nullptr) {
+          reclaim_head_p = added_head_p;
+        } else {
+          reclaim_tail_p->next_p = added_head_p;
+        }
+        reclaim_tail_p = added_tail_p;
+      }
+
+      size_t freed_count = 0;
+      while (reclaim_head_p != nullptr &&
+             reclaim_head_p->delete_epoch <= expired_epoch) {
+        GarbageNode *next_garbage_node_p = reclaim_head_p->next_p;
+        FreeEpochDeltaChain(reclaim_head_p->node_p);
+        delete reclaim_head_p;
+        reclaim_head_p = next_garbage_node_p;
+        freed_count++;
+      }
+
+      if (reclaim_head_p == nullptr) {
+        reclaim_tail_p = nullptr;
+      }
+
+      size_t remaining_count = garbage_count.fetch_sub(freed_count) -
+                               freed_count;
+      reclaim_garbage_count.store(remaining_count + GC_NODE_COUNT_THREADHOLD);
+
+      LOG_TRACE("Reclaimed %lu garbage nodes; %lu remaining", freed_count,
+                remaining_count);
+
+      return;
+    }
+
+#elif defined(USE_OLD_EPOCH)
 
     /*
      * AddGarbageNode() - Add garbage node into the current epoch
@@ -7751,7 +8389,7 @@ class BwTree : public BwTreeBase {
       return;
     }
 
-#else  // #ifdef USE_OLD_EPOCH
+#else  // #if defined(USE_PELOTON_EPOCH)
 
     /*
      * AddGarbageNode() - This encapsulates BwTree::AddGarbageNode()
@@ -7781,7 +8419,7 @@ class BwTree : public BwTreeBase {
       return;
     }
 
-#endif  // #ifdef USE_OLD_EPOCH
+#endif  // #if defined(USE_PELOTON_EPOCH)
 
     /*
      * FreeEpochDeltaChain() - Free a delta chain (used by EpochManager)
@@ -7853,6 +8491,7 @@ class BwTree : public BwTreeBase {
             tree_p->InvalidateNodeID(((LeafRemoveNode *)node_p)->removed_id);
 
             delete ((LeafRemoveNode *)node_p);
+            RecordReclaimedNode(sizeof(LeafRemoveNode));
 
 #ifdef BWTREE_DEBUG
             freed_count++;
@@ -7864,6 +8503,8 @@ class BwTree : public BwTreeBase {
             // merge node
             return;
           case NodeType::LeafType:
+            RecordReclaimedNode(GetAllocatedSize((const LeafNode *)node_p));
+
             ((LeafNode *)node_p)->~LeafNode();
             ((LeafNode *)node_p)->Destroy();
 
@@ -7922,6 +8563,7 @@ class BwTree : public BwTreeBase {
             tree_p->InvalidateNodeID(((InnerRemoveNode *)node_p)->removed_id);
 
             delete ((InnerRemoveNode *)node_p);
+            RecordReclaimedNode(sizeof(InnerRemoveNode));
 
 #ifdef BWTREE_DEBUG
             freed_count++;
@@ -7931,6 +8573,8 @@ class BwTree : public BwTreeBase {
             // We never free nodes under remove node
             return;
           case NodeType::InnerType:
+            RecordReclaimedNode(GetAllocatedSize((const InnerNode *)node_p));
+
             ((InnerNode *)node_p)->~InnerNode();
             ((InnerNode *)node_p)->Destroy();
 
@@ -7946,6 +8590,7 @@ class BwTree : public BwTreeBase {
             // list (if we delete it directly then this will be
             // a problem)
             delete ((InnerAbortNode *)node_p);
+            RecordReclaimedNode(sizeof(InnerAbortNode));
 
 #ifdef BWTREE_DEBUG
             freed_count++;
@@ -7966,6 +8611,28 @@ class BwTree : public BwTreeBase {
       return;
     }
 
+    /*
+     * GetAllocatedSize() - Size of the chunk a base node was allocated in
+     *
+     * The deltas of the node live in the chunk, but the chunks GrowChunk()
+     * adds are not counted
+     */
+    template <typename ElasticNodeType>
+    static size_t GetAllocatedSize(const ElasticNodeType *node_p) {
+      return sizeof(ElasticNodeType) +
+             node_p->GetSize() * sizeof(*node_p->Begin()) +
+             AllocationMeta::CHUNK_SIZE();
+    }
+
+    /*
+     * RecordReclaimedNode() - Count a base node or NodeID holder freed here
+     */
+    inline void RecordReclaimedNode(size_t byte_count) {
+      tree_p->reclaimed_node_count.fetch_add(1, std::memory_order_relaxed);
+      tree_p->reclaimed_byte_count.fetch_add(byte_count,
+                                             std::memory_order_relaxed);
+    }
+
     /*
      * ClearEpoch() - Sweep the chain of epoch and free memory
      *
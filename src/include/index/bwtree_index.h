@@ -75,6 +75,8 @@ class BWTreeIndex : public Index {
                        ItemPointer *value,
                        std::function<bool(const void *)> predicate);
 
+  bool BulkLoad(const std::vector<IndexEntryRef> &entries);
+
   void Scan(const std::vector<type::Value> &values,
             const std::vector<oid_t> &key_column_ids,
             const std::vector<ExpressionType> &expr_types,
@@ -91,15 +93,30 @@ class BWTreeIndex : public Index {
                  uint64_t limit,
                  uint64_t offset);
 
+  bool ScanEntries(const std::vector<type::Value> &values,
+                   const std::vector<oid_t> &key_column_ids,
+                   const std::vector<ExpressionType> &expr_types,
+                   ScanDirectionType scan_direction,
+                   std::vector<IndexEntry> &result,
+                   const ConjunctionScanPredicate *csp_p,
+                   type::AbstractPool *pool);
+
   void ScanAllKeys(std::vector<ValueType> &result);
 
   void ScanKey(const storage::Tuple *key,
                std::vector<ValueType> &result);
 
+  void ScanKeyBatch(const std::vector<const storage::Tuple *> &keys,
+                    std::vector<std::vector<ValueType>> &results);
+
   std::string GetTypeName() const;
 
   // TODO: Implement this
   size_t GetMemoryFootprint() { return 0; }
+
+  IndexMaintenanceStats GetMaintenanceStats() const {
+    return container.GetMaintenanceStats();
+  }
   
   bool NeedGC() {
     return container.NeedGarbageCollection();
@@ -15,6 +15,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -34,6 +35,10 @@ namespace catalog {
 class Schema;
 }
 
+namespace expression {
+class AbstractExpression;
+}
+
 namespace storage {
 class Tuple;
 }
@@ -131,6 +136,50 @@ class IndexMetadata : public Printable {
 
   inline void SetVisibility(bool visibile) { visible_ = visibile; }
 
+  /*
+   * SetPredicate() - Makes the index partial
+   *
+   * Only the tuples for which the predicate over the table columns is true
+   * are indexed. Like the key expressions, the predicate has to be set
+   * before the index is added to its table.
+   */
+  void SetPredicate(std::shared_ptr<expression::AbstractExpression> predicate);
+
+  inline const expression::AbstractExpression *GetPredicate() const {
+    return predicate_.get();
+  }
+
+  inline bool IsPartial() const { return predicate_ != nullptr; }
+
+  /*
+   * SetKeyExpressions() - Computes key columns from expressions over the
+   *                       table columns
+   *
+   * The i-th expression computes the i-th key column, and a nullptr keeps it
+   * a copy of the table column in key_attrs. Scans address an expression key
+   * column by the table column it is mapped to in key_attrs, which should be
+   * one the expression reads and no other key column is mapped to.
+   */
+  void SetKeyExpressions(
+      std::vector<std::shared_ptr<expression::AbstractExpression>>
+          key_expressions);
+
+  // Returns nullptr if the key column is a plain table column
+  const expression::AbstractExpression *GetKeyExpression(
+      oid_t key_column_id) const;
+
+  inline bool HasKeyExpressions() const {
+    return key_expressions_.empty() == false;
+  }
+
+  /*
+   * GetReferencedColumns() - Returns the table columns that the key and the
+   *                          predicate of the index are computed from
+   */
+  inline const std::set<oid_t> &GetReferencedColumns() const {
+    return referenced_columns_;
+  }
+
   /*
    * GetInfo() - Get a string representation for debugging
    */
@@ -188,10 +237,41 @@ class IndexMetadata : public Printable {
   // If set to true, then this index is visible to the planner
   bool visible_;
 
+  // The predicate of a partial index, nullptr if every tuple is indexed
+  std::shared_ptr<expression::AbstractExpression> predicate_;
+
+  // The expressions that compute the key columns, empty if all of them are
+  // plain table columns
+  std::vector<std::shared_ptr<expression::AbstractExpression>> key_expressions_;
+
+  // The table columns read by the key and the predicate
+  std::set<oid_t> referenced_columns_;
+
   // This is a magic flag that tells us whether new
   static bool index_default_visibility;
 };
 
+// An index entry that owns its key
+using IndexEntry = std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>;
+
+// An entry whose key is owned by the caller
+using IndexEntryRef = std::pair<const storage::Tuple *, ItemPointer *>;
+
+// Counters of the structural maintenance an index does in the background
+struct IndexMaintenanceStats {
+  // Length of the delta chains that sampled reads went through
+  uint64_t delta_chain_length_sum = 0;
+  uint64_t delta_chain_sample_count = 0;
+  uint64_t max_delta_chain_length = 0;
+
+  uint64_t consolidation_count = 0;
+  uint64_t split_count = 0;
+
+  // Nodes freed once no reader could reach them any more
+  uint64_t reclaimed_node_count = 0;
+  uint64_t reclaimed_byte_count = 0;
+};
+
 /////////////////////////////////////////////////////////////////////
 // Index class definition
 /////////////////////////////////////////////////////////////////////
@@ -251,6 +331,13 @@ class Index : public Printable {
   virtual bool CondInsertEntry(const storage::Tuple *key, ItemPointer *location,
                                std::function<bool(const void *)> predicate) = 0;
 
+  // Insert the entries, in any order, into the index at once. Nobody else may
+  // access the index meanwhile, and no entry may be there twice. Indexes that
+  // can't build themselves from the entries, or that aren't empty, insert the
+  // entries one by one, and return false if some entry was there already.
+  // The keys are copied into the index, so the caller may free them after.
+  virtual bool BulkLoad(const std::vector<IndexEntryRef> &entries);
+
   ///////////////////////////////////////////////////////////////////
   // Index Scan
   ///////////////////////////////////////////////////////////////////
@@ -279,11 +366,28 @@ class Index : public Printable {
                         const ScanDirectionType &scan_direction,
                         std::vector<ItemPointer *> &result);
 
+  // Scan like Scan() does, but also return a copy of the key of every entry,
+  // whose varlen values are allocated from the pool. Indexes that don't keep
+  // their keys return false.
+  virtual bool ScanEntries(const std::vector<type::Value> &value_list,
+                           const std::vector<oid_t> &tuple_column_id_list,
+                           const std::vector<ExpressionType> &expr_list,
+                           ScanDirectionType scan_direction,
+                           std::vector<IndexEntry> &result,
+                           const ConjunctionScanPredicate *csp_p,
+                           type::AbstractPool *pool);
+
   virtual void ScanAllKeys(std::vector<ItemPointer *> &result) = 0;
 
   virtual void ScanKey(const storage::Tuple *key,
                        std::vector<ItemPointer *> &result) = 0;
 
+  // Look up a batch of keys at once, appending the entries of keys[i] to
+  // results[i]. Indexes that can't overlap the lookups look the keys up one
+  // by one.
+  virtual void ScanKeyBatch(const std::vector<const storage::Tuple *> &keys,
+                            std::vector<std::vector<ItemPointer *>> &results);
+
   ///////////////////////////////////////////////////////////////////
   // Garbage Collection
   ///////////////////////////////////////////////////////////////////
@@ -304,6 +408,46 @@ class Index : public Printable {
   // virtual void *JoinEpoch() = 0;
   // virtual void LeaveEpoch(void *) = 0;
 
+  //===--------------------------------------------------------------------===//
+  // Online Build
+  //===--------------------------------------------------------------------===//
+
+  // Start building the index from the tuples of its table. Until the build
+  // finishes, writers log their entries instead of inserting them, and the
+  // optimizer doesn't pick the index. Without log_entries, writers skip the
+  // index altogether, which is only right for loads that are done before the
+  // table is scanned.
+  void StartBuild(bool log_entries = true);
+
+  bool IsBuilding() const { return building.load(); }
+
+  // Log the entry of a writer if the index is being built. Returns false if
+  // it isn't, and the writer has to insert the entry itself.
+  bool LogEntry(const storage::Tuple *key, ItemPointer *location_ptr);
+
+  // Log the removal of an entry by GC if the index is being built, since the
+  // builder may replace the whole tree when it loads the scanned entries.
+  // Returns false if it isn't, and GC has to delete the entry itself.
+  bool LogDeleteEntry(const storage::Tuple *key, ItemPointer *location_ptr);
+
+  // Apply the logged entries and removals in their order and stop logging.
+  // Writers wait while the entries are applied, so that none of them inserts
+  // into the index before an entry it raced with. Returns false if the entry
+  // of some writer could not be applied.
+  bool FinishBuild(
+      const std::function<bool(const storage::Tuple *, ItemPointer *)> &apply);
+
+  //===--------------------------------------------------------------------===//
+  // Keys
+  //===--------------------------------------------------------------------===//
+
+  // Whether the tuple belongs into the index, i.e. it satisfies the predicate
+  // of a partial index
+  bool CoversTuple(const AbstractTuple *tuple) const;
+
+  // Fill in the key of the tuple, computing the expression key columns
+  void BuildKey(const AbstractTuple *tuple, storage::Tuple *key) const;
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -363,6 +507,11 @@ class Index : public Printable {
   // Get the memory footprint
   virtual size_t GetMemoryFootprint() = 0;
 
+  // Get the counters of the index's background maintenance
+  virtual IndexMaintenanceStats GetMaintenanceStats() const {
+    return IndexMaintenanceStats();
+  }
+
   // Get the indexed tile group offset
   virtual size_t GetIndexedTileGroupOff() {
     return indexed_tile_group_offset.load();
@@ -402,6 +551,23 @@ class Index : public Printable {
 
   // This is used by index tuner
   std::atomic<size_t> indexed_tile_group_offset;
+
+  // An entry that a writer inserted or GC removed while the index was built
+  struct LoggedEntry {
+    IndexEntry entry;
+    bool is_delete;
+  };
+
+  // Log the entry if the index is being built
+  bool LogBuildEntry(const storage::Tuple *key, ItemPointer *location_ptr,
+                     bool is_delete);
+
+  // Whether the index is being built, and the entries that writers and GC
+  // logged meanwhile
+  std::atomic<bool> building;
+  bool log_entries = true;
+  std::mutex build_log_latch;
+  std::vector<LoggedEntry> build_log;
 };
 
 }  // namespace index
@@ -179,6 +179,10 @@ extern void PacketPutStringWithTerminator(OutputPacket *pkt,
 /* packet_put_int - used to write a single int into a packet */
 extern void PacketPutInt(OutputPacket *pkt, int n, int base);
 
+/* packet_put_int_at - used to overwrite a 4 byte int previously written into
+ * a packet at the given offset, e.g., to fill in a message length */
+extern void PacketPutIntAt(OutputPacket *pkt, size_t offset, int n);
+
 /* packet_put_cbytes - used to write a uchar* into a packet */
 extern void PacketPutCbytes(OutputPacket *pkt, const uchar *b, int len);
 
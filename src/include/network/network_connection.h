@@ -21,6 +21,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
 #include <arpa/inet.h>
@@ -68,6 +71,19 @@ class NetworkConnection {
   Client client_;
   bool ssl_sent_ = false;
 
+  // While a query runs on a worker thread, the worker writes its rows to the
+  // socket itself, once the state machine waits for the result and leaves
+  // the buffers alone
+  std::mutex result_mutex_;
+  std::condition_variable result_cv_;
+  bool waiting_for_result_ = false;
+  // Set while the worker writes. Its writes wait for the socket instead of
+  // the event loop, and release the lock while they wait
+  std::unique_lock<std::mutex> *result_lock_ = nullptr;
+  bool result_write_error_ = false;
+  // Number of times the write buffer has been sent to the socket
+  std::atomic<size_t> flush_count_{0};
+
 
  public:
   inline NetworkConnection(int sock_fd, short event_flags, NetworkThread *thread,
@@ -94,6 +110,9 @@ class NetworkConnection {
 
   WriteState WritePackets();
 
+  // How many times responses have been flushed to the client
+  inline size_t GetFlushCount() const { return flush_count_.load(); }
+
   std::string WriteBufferToString();
 
   void CloseSocket();
@@ -102,6 +121,10 @@ class NetworkConnection {
 
   static void TriggerStateMachine(void* arg);
 
+  /* Writes a batch of result rows of the running query to the socket. Invoked
+   * on the worker thread executing the query */
+  static void SendResultBatch(void *arg, std::vector<ResultValue> &batch);
+
   /* Runs the state machine for the protocol. Invoked by event handler callback */
   static void StateMachine(NetworkConnection *conn);
 
@@ -110,6 +133,9 @@ class NetworkConnection {
 
   ProcessResult ProcessInitial();
 
+  // Let the worker write rows, or take the buffers back once it has finished
+  void SetWaitingForResult(bool waiting);
+
   // Extracts the header of a Postgres start up packet from the read socket buffer
   static bool ReadStartupPacketHeader(Buffer &rbuf, InputPacket &rpkt);
 
@@ -122,6 +148,10 @@ class NetworkConnection {
   /* Routine to deal with SSL request message */
   bool ProcessSSLRequestPacket(InputPacket *pkt);
 
+  // Writes the queued responses into the write buffer, which is flushed only
+  // if it fills up
+  WriteState BufferPackets();
+
   // Writes a packet's header (type, size) into the write buffer
   WriteState BufferWriteBytesHeader(OutputPacket *pkt);
 
@@ -55,6 +55,10 @@ class NetworkManager {
 
   uint64_t port_;             // port number
   size_t max_connections_;    // maximum number of connections
+  bool reuse_port_;           // does every worker thread listen on its own
+
+  // The listening sockets of the worker threads, when reuse_port_ is set
+  std::vector<int> listen_fds_;
 
   std::string private_key_file_;
   std::string certificate_file_;
@@ -98,6 +102,9 @@ class NetworkManager {
   event_base *GetEventBase() { return base_; }
 
  private:
+  // Create a socket listening on the given address
+  static int CreateListenSocket(const struct sockaddr_in &sin, bool reuse_port);
+
   /* Maintain a global list of connections.
    * Helps reuse connection objects when possible
    */
@@ -31,6 +31,9 @@
 #include "common/container/lock_free_queue.h"
 #include "network_state.h"
 
+// The thread id of the master thread, worker threads are numbered from 0
+#define MASTER_THREAD_ID -1
+
 namespace peloton {
 namespace network {
 
@@ -44,6 +44,10 @@ class NetworkWorkerThread : public NetworkThread {
   // Notify new connection pipe(receive end)
   int new_conn_receive_fd_;
 
+  // The socket this thread listens on when it accepts its own connections,
+  // -1 otherwise
+  int listen_fd_;
+
  public:
   /* The queue for new connection requests */
   LockFreeQueue<std::shared_ptr<NewConnQueueItem>> new_conn_queue;
@@ -51,6 +55,10 @@ class NetworkWorkerThread : public NetworkThread {
  public:
   NetworkWorkerThread(const int thread_id);
 
+  // Take ownership of a newly accepted connection, creating (or reusing) its
+  // connection object on this thread's event base
+  void HandleNewConnection(int new_conn_fd, short event_flags);
+
   // Getters and setters
   event *GetNewConnEvent() { return this->new_conn_event_; }
 
@@ -59,6 +67,10 @@ class NetworkWorkerThread : public NetworkThread {
   int GetNewConnSendFd() { return this->new_conn_send_fd_; }
 
   int GetNewConnReceiveFd() { return this->new_conn_receive_fd_; }
+
+  int GetListenFd() { return this->listen_fd_; }
+
+  void SetListenFd(int fd) { this->listen_fd_ = fd; }
 };
 
 }  // namespace network
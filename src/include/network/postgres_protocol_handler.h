@@ -66,6 +66,8 @@ class PostgresProtocolHandler: public ProtocolHandler {
 
   void GetResult();
 
+  void SendResultBatch(std::vector<ResultValue> &batch);
+
   //===--------------------------------------------------------------------===//
   // STATIC HELPERS
   //===--------------------------------------------------------------------===//
@@ -109,7 +111,8 @@ class PostgresProtocolHandler: public ProtocolHandler {
   // Sends the attribute headers required by SELECT queries
   void PutTupleDescriptor(const std::vector<FieldInfo>& tuple_descriptor);
 
-  // Send each row, one packet at a time, used by SELECT queries
+  // Send the rows as DataRow messages, batched into as few packets as
+  // possible, used by SELECT queries
   void SendDataRows(std::vector<ResultValue>& results, int colcount);
 
   // Used to send a packet that indicates the completion of a query. Also has
@@ -167,6 +170,10 @@ class PostgresProtocolHandler: public ProtocolHandler {
   // global txn state
   NetworkTransactionStateType txn_state_;
 
+  // whether the row description of the running simple query was sent ahead
+  // of its first rows
+  bool rows_described_ = false;
+
   // state to mang skipped queries
   bool skipped_stmt_ = false;
   std::string skipped_query_string_;
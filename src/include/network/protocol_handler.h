@@ -43,6 +43,10 @@ class ProtocolHandler {
 
   virtual void GetResult();
 
+  // Add a batch of result rows of the running query to the responses. Called
+  // on the thread executing the query, before GetResult().
+  virtual void SendResultBatch(std::vector<ResultValue> &batch);
+
   void SetFlushFlag(bool flush) {force_flush_ = flush;}
 
   bool GetFlushFlag() {return force_flush_;}
@@ -16,6 +16,8 @@
 #include <unordered_set>
 #include <vector>
 
+#include "common/synchronization/readwrite_latch.h"
+#include "common/synchronization/spin_latch.h"
 #include "operator_expression.h"
 #include "optimizer/group.h"
 
@@ -35,6 +37,11 @@ struct GExprPtrEq {
 
 //===--------------------------------------------------------------------===//
 // Memo
+//
+// Disjoint sub-plans may be optimized by several threads at once, so inserting
+// expressions and groups is thread-safe: the group expression set is split
+// into lock-striped partitions, and the group list is guarded by a read-write
+// latch. Each group is only modified by the thread optimizing it.
 //===--------------------------------------------------------------------===//
 class Memo {
  public:
@@ -54,7 +61,12 @@ class Memo {
   GroupExpression* InsertExpression(std::shared_ptr<GroupExpression> gexpr,
                                     GroupID target_group, bool enforced);
 
-  const std::vector<std::unique_ptr<Group>>& Groups() const;
+  // A snapshot of the groups, new groups may be added concurrently
+  std::vector<Group*> Groups() const;
+
+  size_t GetNumGroups() const;
+
+  size_t GetNumGroupExpressions() const;
 
   Group* GetGroupByID(GroupID id);
 
@@ -66,27 +78,46 @@ class Memo {
   // For rewrite phase: remove and add expression directly for the set
   //===--------------------------------------------------------------------===//
   void RemoveParExpressionForRewirte(GroupExpression* gexpr) {
-    group_expressions_.erase(gexpr);
+    EraseGroupExpression(gexpr);
   }
   void AddParExpressionForRewrite(GroupExpression* gexpr) {
-    group_expressions_.insert(gexpr);
+    auto& partition = GetPartition(gexpr);
+    partition.latch.Lock();
+    partition.group_expressions.insert(gexpr);
+    partition.latch.Unlock();
   }
   // When a rewrite rule is applied, we need to replace the original gexpr with
   // a new one, which reqires us to first remove the original gexpr from the
   // memo
   void EraseExpression(GroupID group_id) {
-    auto gexpr = groups_[group_id]->GetLogicalExpression();
-    group_expressions_.erase(gexpr);
-    groups_[group_id]->EraseLogicalExpression();
+    auto group = GetGroupByID(group_id);
+    EraseGroupExpression(group->GetLogicalExpression());
+    group->EraseLogicalExpression();
   }
 
  private:
+  // The number of lock-striped partitions of the group expression set
+  static constexpr size_t kNumPartitions = 16;
+
+  struct Partition {
+    common::synchronization::SpinLatch latch;
+    std::unordered_set<GroupExpression*, GExprPtrHash, GExprPtrEq>
+        group_expressions;
+  };
+
+  inline Partition& GetPartition(GroupExpression* gexpr) const {
+    return partitions_[gexpr->Hash() % kNumPartitions];
+  }
+
+  void EraseGroupExpression(GroupExpression* gexpr);
+
   GroupID AddNewGroup(std::shared_ptr<GroupExpression> gexpr);
 
-  // The group owns the group expressions, not the memo
-  std::unordered_set<GroupExpression*, GExprPtrHash, GExprPtrEq>
-      group_expressions_;
+  // The group owns the group expressions, not the memo. The partitions are
+  // heap allocated so that the memo stays movable.
+  std::unique_ptr<Partition[]> partitions_;
   std::vector<std::unique_ptr<Group>> groups_;
+  std::unique_ptr<common::synchronization::ReadWriteLatch> groups_latch_;
   size_t rule_set_size_;
 };
 
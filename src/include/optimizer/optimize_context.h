@@ -25,14 +25,24 @@ class OptimizeContext {
  public:
   OptimizeContext(OptimizerMetadata *metadata,
                   std::shared_ptr<PropertySet> required_prop,
-                  double cost_upper_bound = std::numeric_limits<double>::max())
+                  double cost_upper_bound = std::numeric_limits<double>::max(),
+                  OptimizerTaskPool *task_pool = nullptr, int parallelism = 1)
       : metadata(metadata),
         required_prop(required_prop),
-        cost_upper_bound(cost_upper_bound) {}
+        cost_upper_bound(cost_upper_bound),
+        task_pool(task_pool),
+        parallelism(parallelism) {}
 
   OptimizerMetadata *metadata;
   std::shared_ptr<PropertySet> required_prop;
   double cost_upper_bound;
+
+  // The pool that tasks spawned under this context go to. If not set, they go
+  // to the task pool of the metadata.
+  OptimizerTaskPool *task_pool;
+
+  // The number of threads that may optimize the sub-plan of this context
+  int parallelism;
 };
 
 }  // namespace optimizer
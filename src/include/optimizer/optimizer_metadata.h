@@ -31,6 +31,11 @@ class OptimizerMetadata {
   OptimizerTaskPool *task_pool;
   catalog::CatalogCache* catalog_cache;
 
+  // Set once the optimization budget is used up. From then on no more
+  // logical alternatives are explored, the remaining tasks only finish costing
+  // the expressions already in the memo.
+  bool budget_exhausted = false;
+
   void SetTaskPool(OptimizerTaskPool *task_pool) {
     this->task_pool = task_pool;
   }
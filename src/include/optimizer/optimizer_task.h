@@ -26,6 +26,7 @@ class RuleSet;
 class Group;
 class GroupExpression;
 class OptimizerMetadata;
+class OptimizerTaskPool;
 class PropertySet;
 enum class RewriteRuleSetName : uint32_t;
 using GroupID = int32_t;
@@ -73,6 +74,9 @@ class OptimizerTask {
 
   void PushTask(OptimizerTask *task);
 
+  // The pool the tasks spawned by this task go to
+  OptimizerTaskPool *GetTaskPool() const;
+
   inline Memo &GetMemo() const;
 
   inline RuleSet &GetRuleSet() const;
@@ -198,6 +202,11 @@ class OptimizeInputs : public OptimizerTask {
   virtual void execute() override;
 
  private:
+  // If the child groups cover disjoint sets of tables, they share no groups in
+  // the memo. Optimize them for all the input properties concurrently, split
+  // over the threads this context may use.
+  void OptimizeChildrenInParallel();
+
   std::vector<std::pair<std::shared_ptr<PropertySet>,
                         std::vector<std::shared_ptr<PropertySet>>>>
       output_input_properties_;
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "optimizer/optimizer_task.h"
+#include <cstdint>
 #include <stack>
 #include <memory>
 
@@ -26,9 +27,19 @@ namespace optimizer {
  */
 class OptimizerTaskPool {
  public:
+  virtual ~OptimizerTaskPool() {}
   virtual std::unique_ptr<OptimizerTask> Pop() = 0;
   virtual void Push(OptimizerTask *task) = 0;
   virtual bool Empty() = 0;
+
+  // The number of tasks taken from the pool, plus the ones other pools ran on
+  // behalf of this one
+  uint64_t GetNumTasks() const { return num_tasks_; }
+
+  void AddNumTasks(uint64_t num_tasks) { num_tasks_ += num_tasks; }
+
+ protected:
+  uint64_t num_tasks_ = 0;
 };
 
 /**
@@ -39,6 +50,7 @@ class OptimizerTaskStack : public OptimizerTaskPool {
   virtual std::unique_ptr<OptimizerTask> Pop() {
     auto task = std::move(task_stack_.top());
     task_stack_.pop();
+    num_tasks_++;
     return task;
   }
 
@@ -48,6 +60,14 @@ class OptimizerTaskStack : public OptimizerTaskPool {
 
   virtual bool Empty() { return task_stack_.empty(); }
 
+  // Execute tasks until the stack is empty
+  void Run() {
+    while (!Empty()) {
+      auto task = Pop();
+      task->execute();
+    }
+  }
+
  private:
   std::stack<std::unique_ptr<OptimizerTask>> task_stack_;
 };
@@ -38,6 +38,33 @@ class InnerJoinCommutativity : public Rule {
                  OptimizeContext *context) const override;
 };
 
+/**
+ * @brief ((A join B) join C) -> (A join (B join C))
+ *
+ * Together with commutativity this enumerates all bushy join trees. Join
+ * predicates are redistributed to the lowest join covering their tables, and
+ * the rule does not fire if the new join of B and C would be a cross product.
+ */
+class InnerJoinAssociativity : public Rule {
+ public:
+  InnerJoinAssociativity();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan,
+             OptimizeContext *context) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+                 OptimizeContext *context) const override;
+
+ private:
+  // Split the predicates of both joins into the ones evaluated by the new
+  // (B join C) and the ones left for the new top join
+  static void SplitJoinPredicates(std::shared_ptr<OperatorExpression> input,
+                                  OptimizeContext *context,
+                                  std::vector<AnnotatedExpression> &top_preds,
+                                  std::vector<AnnotatedExpression> &child_preds);
+};
+
 //===--------------------------------------------------------------------===//
 // Implementation rules
 //===--------------------------------------------------------------------===//
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/internal_types.h"
@@ -30,7 +32,8 @@ class ColumnStats {
               double cardinality, double frac_null,
               std::vector<double> most_common_vals,
               std::vector<double> most_common_freqs,
-              std::vector<double> histogram_bounds)
+              std::vector<double> histogram_bounds,
+              std::vector<std::string> most_common_strs = {})
       : database_id(database_id),
         table_id(table_id),
         column_id(column_id),
@@ -42,6 +45,7 @@ class ColumnStats {
         most_common_vals(most_common_vals),
         most_common_freqs(most_common_freqs),
         histogram_bounds(histogram_bounds),
+        most_common_strs(most_common_strs),
         is_basetable{true} {}
 
   oid_t database_id;
@@ -56,6 +60,8 @@ class ColumnStats {
   std::vector<double> most_common_vals;
   std::vector<double> most_common_freqs;
   std::vector<double> histogram_bounds;
+  // The most common values of string columns, in place of most_common_vals
+  std::vector<std::string> most_common_strs;
 
   bool is_basetable;
 
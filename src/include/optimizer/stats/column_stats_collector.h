@@ -17,6 +17,7 @@
 #include <libcount/hll.h>
 
 #include "common/internal_types.h"
+#include "common/macros.h"
 #include "optimizer/stats/count_min_sketch.h"
 #include "optimizer/stats/top_k_elements.h"
 #include "optimizer/stats/histogram.h"
@@ -46,13 +47,28 @@ class ColumnStatsCollector {
 
   void AddValue(const type::Value& value);
 
-  double GetFracNull();
+  // Add a value as it is stored in a tuple, without boxing it into a
+  // type::Value. Only for the types SupportsRawValues() accepts.
+  void AddRawValue(const char* data);
+
+  // Whether values of the type can be added with AddRawValue()
+  static bool SupportsRawValues(type::TypeId type_id);
 
-  inline std::vector<ValueFrequencyPair> GetCommonValueAndFrequency() {
-    return topk_.GetAllOrderedMaxFirst();
+  // Merge the stats another collector of the same column collected from
+  // different tuples
+  void Merge(ColumnStatsCollector& other);
+
+  // Set the fraction of the table's tuples the stats are collected from
+  inline void SetSampleRatio(double sample_ratio) {
+    PL_ASSERT(sample_ratio > 0 && sample_ratio <= 1);
+    sample_ratio_ = sample_ratio;
   }
 
-  inline uint64_t GetCardinality() { return hll_.EstimateCardinality(); }
+  double GetFracNull();
+
+  std::vector<ValueFrequencyPair> GetCommonValueAndFrequency();
+
+  uint64_t GetCardinality();
 
   inline double GetCardinalityError() { return hll_.RelativeError(); }
 
@@ -79,6 +95,10 @@ class ColumnStatsCollector {
 
   size_t null_count_ = 0;
   size_t total_count_ = 0;
+  double sample_ratio_ = 1.0;
+
+  template <typename T>
+  void AddNumericValue(T value, T null_value);
 
   ColumnStatsCollector(const ColumnStatsCollector&);
   void operator=(const ColumnStatsCollector&);
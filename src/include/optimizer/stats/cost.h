@@ -64,6 +64,15 @@ class Cost {
       const ValueCondition& condition,
       std::shared_ptr<TableStats>& output_stats);
 
+  /*
+   * Cost of scan for the conjunction of several conditions. Correlated
+   * equality conditions are estimated with the joint stats of their columns.
+   */
+  static double MultiConditionSeqScanCost(
+      const std::shared_ptr<TableStats>& input_stats,
+      const std::vector<ValueCondition>& conditions,
+      std::shared_ptr<TableStats>& output_stats);
+
   static double SingleConditionIndexScanCost(
       const std::shared_ptr<TableStats>& input_stats,
       const ValueCondition& condition,
@@ -147,7 +156,8 @@ class Cost {
 
   /*
    * Return estimated number of rows after group by operation.
-   * This function is used by HashGroupBy and SortGroupBy.
+   * This function is used by HashGroupBy and SortGroupBy. Groups of columns
+   * with joint stats count as single columns.
    */
   static size_t GetEstimatedGroupByRows(
       const std::shared_ptr<TableStats>& input_stats,
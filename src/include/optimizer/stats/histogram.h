@@ -89,6 +89,21 @@ class Histogram {
     }
   }
 
+  /*
+   * Merge another histogram into this one (Algorithm 2): add all of its
+   * bins, then merge the closest bins until at most max_bins are left.
+   */
+  void Merge(const Histogram &other) {
+    for (const Bin &bin : other.bins) {
+      InsertBin(bin);
+    }
+    while (bins.size() > max_bins_) {
+      MergeTwoBinsWithMinGap();
+    }
+    minimum_ = std::min(minimum_, other.minimum_);
+    maximum_ = std::max(maximum_, other.maximum_);
+  }
+
   /*
    * Input: a point b such that p1 < b < pB
    *
@@ -41,6 +41,15 @@ class HyperLogLog {
     hll_->Update(StatsUtil::HashValue(value));
   }
 
+  // Update with the hash of a value, see StatsUtil::HashValue()
+  void UpdateHash(uint64_t hash) { hll_->Update(hash); }
+
+  // Merge the observations of another HyperLogLog with the same precision
+  void Merge(const HyperLogLog& other) {
+    PL_ASSERT(precision_ == other.precision_);
+    hll_->Merge(other.hll_);
+  }
+
   uint64_t EstimateCardinality() {
     uint64_t cardinality = hll_->Estimate();
     LOG_TRACE("Estimated cardinality: %" PRId64, cardinality);
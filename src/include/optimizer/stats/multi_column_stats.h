@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// multi_column_stats.h
+//
+// Identification: src/include/optimizer/stats/multi_column_stats.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "optimizer/stats/stats_util.h"
+#include "type/value.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// MultiColumnStats
+//
+// The joint stats of a group of columns of a table: the number of distinct
+// combinations of their values, and the most common combinations. They
+// capture correlations between the columns, which the stats of the single
+// columns can't.
+//===--------------------------------------------------------------------===//
+class MultiColumnStats {
+ public:
+  MultiColumnStats(oid_t database_id, oid_t table_id,
+                   std::vector<oid_t> column_ids, size_t num_rows,
+                   double cardinality,
+                   std::vector<std::string> most_common_vals,
+                   std::vector<double> most_common_freqs)
+      : database_id(database_id),
+        table_id(table_id),
+        column_ids(column_ids),
+        num_rows(num_rows),
+        cardinality(cardinality),
+        most_common_vals(most_common_vals),
+        most_common_freqs(most_common_freqs) {}
+
+  oid_t database_id;
+  oid_t table_id;
+  // Sorted by id
+  std::vector<oid_t> column_ids;
+
+  size_t num_rows;
+  // The number of distinct combinations of values
+  double cardinality;
+  // The most common combinations of values, as keys made by MakeKey()
+  std::vector<std::string> most_common_vals;
+  std::vector<double> most_common_freqs;
+
+  // Whether the group consists of exactly the given (sorted) columns
+  bool HasColumns(const std::vector<oid_t>& ids) const {
+    return column_ids == ids;
+  }
+
+  // Make the key of a combination of values of the columns, in the order of
+  // column_ids. Numeric values of any type map to the same key, so that
+  // constants compare equal to column values of another numeric type.
+  static std::string MakeKey(const std::vector<type::Value>& values) {
+    std::string key;
+    for (size_t i = 0; i < values.size(); i++) {
+      if (i > 0) {
+        key.push_back(kKeySeparator);
+      }
+      const type::Value& value = values[i];
+      if (value.IsNull()) {
+        key.push_back(kNullMarker);
+        continue;
+      }
+      double numeric_value = StatsUtil::PelotonValueToNumericValue(value);
+      if (std::isnan(numeric_value)) {
+        key.append(value.ToString());
+      } else {
+        key.append(StringUtil::Format("%.17g", numeric_value));
+      }
+    }
+    return key;
+  }
+
+ private:
+  static constexpr char kKeySeparator = '\x1f';
+  static constexpr char kNullMarker = '\x1e';
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// multi_column_stats_collector.h
+//
+// Identification: src/include/optimizer/stats/multi_column_stats_collector.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "optimizer/stats/count_min_sketch.h"
+#include "optimizer/stats/hyperloglog.h"
+#include "optimizer/stats/top_k_elements.h"
+
+namespace peloton {
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// MultiColumnStatsCollector
+//
+// Collects the joint stats of a group of columns. Every combination of
+// values is reduced to a key (see MultiColumnStats::MakeKey), whose distinct
+// count and most common occurrences are tracked like the values of a single
+// column.
+//===--------------------------------------------------------------------===//
+class MultiColumnStatsCollector {
+ public:
+  /* Default parameters for probabilistic stats collector */
+  int hll_precision = 8;
+  double cmsketch_eps = 0.01;
+  double cmsketch_gamma = 0.01;
+  uint8_t top_k = 10;
+
+  using ValueFrequencyPair = std::pair<type::Value, double>;
+
+  // The column ids must be sorted
+  MultiColumnStatsCollector(oid_t database_id, oid_t table_id,
+                            std::vector<oid_t> column_ids);
+
+  // Add the values of the columns in one tuple, in the order of the column
+  // ids
+  void AddValues(const std::vector<type::Value>& values);
+
+  // Merge the stats another collector of the same columns collected from
+  // different tuples
+  void Merge(MultiColumnStatsCollector& other);
+
+  // Set the fraction of the table's tuples the stats are collected from
+  inline void SetSampleRatio(double sample_ratio) {
+    PL_ASSERT(sample_ratio > 0 && sample_ratio <= 1);
+    sample_ratio_ = sample_ratio;
+  }
+
+  // The most common keys, as VARCHAR values, and their frequencies
+  std::vector<ValueFrequencyPair> GetCommonValueAndFrequency();
+
+  uint64_t GetCardinality();
+
+  inline const std::vector<oid_t>& GetColumnIDs() const { return column_ids_; }
+
+ private:
+  const oid_t database_id_;
+  const oid_t table_id_;
+  const std::vector<oid_t> column_ids_;
+  HyperLogLog hll_;
+  CountMinSketch sketch_;
+  TopKElements topk_;
+
+  size_t total_count_ = 0;
+  double sample_ratio_ = 1.0;
+
+  MultiColumnStatsCollector(const MultiColumnStatsCollector&);
+  void operator=(const MultiColumnStatsCollector&);
+};
+
+}  // namespace optimizer
+}  // namespace peloton
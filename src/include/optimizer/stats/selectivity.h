@@ -29,6 +29,7 @@
 #include "optimizer/stats/table_stats.h"
 #include "optimizer/stats/value_condition.h"
 #include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/multi_column_stats.h"
 
 namespace peloton {
 namespace optimizer {
@@ -41,6 +42,13 @@ class Selectivity {
       const std::shared_ptr<TableStats>& table_stats,
       const ValueCondition& condition);
 
+  // Selectivity of the conjunction of the conditions. Equality conditions on
+  // a group of columns with joint stats are estimated together, the others
+  // are assumed to be independent.
+  static double ComputeConjunctionSelectivity(
+      const std::shared_ptr<TableStats>& table_stats,
+      const std::vector<ValueCondition>& conditions);
+
   static double LessThan(const std::shared_ptr<TableStats>& table_stats,
                          const ValueCondition& condition);
 
@@ -66,6 +74,11 @@ class Selectivity {
   static double Equal(const std::shared_ptr<TableStats>& table_stats,
                       const ValueCondition& condition);
 
+  // Selectivity of equality conditions on all the columns of the group, in
+  // the order of its column ids
+  static double Equal(const MultiColumnStats& group_stats,
+                      const std::vector<const ValueCondition*>& conditions);
+
   static double NotEqual(const std::shared_ptr<TableStats>& table_stats,
                          const ValueCondition& condition) {
     return 1 - Equal(table_stats, condition);
@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_maintainer.h
+//
+// Identification: src/include/optimizer/stats/stats_maintainer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/internal_types.h"
+#include "common/singleton.h"
+#include "optimizer/stats/table_stats_collector.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace optimizer {
+
+//===----------------------------------------------------------------------===//
+// Keeps the stats of tables up to date without explicit ANALYZEs.
+//
+// The stats aggregator reports the number of tuples inserted, updated and
+// deleted in every table. Once the tuples modified since the last analysis of
+// a table exceed auto_analyze_threshold plus auto_analyze_scale_factor times
+// its size, the table is analyzed again in a batch task. Analyses only read
+// the table, so they never block writers.
+//
+// The collector of the last analysis of each table is kept. A table that
+// mostly grew since then is analyzed incrementally: only the new tuples are
+// scanned, and their sketches are merged into the kept ones. Updated and
+// deleted tuples can't be removed from the sketches, so enough of them lead
+// to a full analysis.
+//===----------------------------------------------------------------------===//
+class StatsMaintainer : public Singleton<StatsMaintainer> {
+ public:
+  // Record the total number of tuples inserted, updated and deleted in the
+  // table so far. Returns true if this schedules an analysis of the table.
+  bool RecordModifications(storage::DataTable *table, int64_t inserts,
+                           int64_t updates, int64_t deletes);
+
+  // Record an analysis of the table. The collector is kept, so that the next
+  // analysis may extend its stats, and modifications may schedule an analysis
+  // again.
+  void SetAnalyzed(oid_t table_oid,
+                   std::unique_ptr<TableStatsCollector> table_stats_collector);
+
+  // Analyze the table and store its stats, incrementally if possible.
+  // Returns true if the analysis was incremental.
+  bool AnalyzeTable(storage::DataTable *table);
+
+  // Forget everything about the table
+  void RemoveTable(oid_t table_oid);
+
+  // Run the scheduled analyses with the scheduler instead of submitting them
+  // to the batch workers. nullptr restores the workers.
+  void SetScheduler(std::function<void(std::function<void()>)> scheduler);
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  uint64_t GetNumAnalyses() const { return num_analyses_; }
+
+  uint64_t GetNumIncrementalAnalyses() const {
+    return num_incremental_analyses_;
+  }
+
+ private:
+  friend class Singleton<StatsMaintainer>;
+
+  StatsMaintainer() {}
+
+  struct TableEntry {
+    // The counters in the latest report
+    int64_t inserts = 0;
+    int64_t updates = 0;
+    int64_t deletes = 0;
+    // The counters when the table was last analyzed
+    int64_t analyzed_inserts = 0;
+    int64_t analyzed_updates = 0;
+    int64_t analyzed_deletes = 0;
+    // The number of tuples updated or deleted when the table was last
+    // analyzed in full
+    int64_t fully_analyzed_removals = 0;
+    // The collector of the last analysis, or nullptr while it is extended
+    std::unique_ptr<TableStatsCollector> table_stats_collector;
+    bool analysis_pending = false;
+  };
+
+  // The number of modified tuples that triggers an analysis of a table with
+  // num_rows rows
+  static double GetThreshold(size_t num_rows);
+
+  // Make the counters in the latest report the baseline of future reports
+  static void ResetBaseline(TableEntry &entry, bool full_analysis);
+
+ private:
+  std::mutex mutex_;
+
+  std::unordered_map<oid_t, TableEntry> table_entries_;
+
+  // Runs the scheduled analyses, if they aren't submitted to the workers
+  std::function<void(std::function<void()>)> scheduler_;
+
+  std::atomic<uint64_t> num_analyses_{0};
+  std::atomic<uint64_t> num_incremental_analyses_{0};
+};
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -15,10 +15,16 @@
 #include "optimizer/stats/table_stats_collector.h"
 #include "optimizer/stats/column_stats_collector.h"
 
-#include <sstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "common/macros.h"
 #include "common/internal_types.h"
+#include "common/synchronization/readwrite_latch.h"
 #include "type/value_factory.h"
 
 namespace peloton {
@@ -32,8 +38,24 @@ namespace optimizer {
 using ValueFrequencyPair = std::pair<type::Value, double>;
 
 class ColumnStats;
+class MultiColumnStats;
 class TableStats;
 
+//===--------------------------------------------------------------------===//
+// StatsStorage
+//
+// The column stats are stored in the 'pg_column_stats' catalog table. The
+// most common values, their frequencies and the histogram bounds are stored
+// in a compact binary form (see EncodeDoubles and EncodeCommonValues).
+//
+// The joint stats of groups of columns (see AnalayzeStatsForColumns) are only
+// kept in memory, and refreshed by every analysis of their table.
+//
+// Decoded stats are cached per table. Every write of the stats of a table
+// bumps its version, and replaces or invalidates the cached stats, once the
+// writing transaction commits, so that lookups don't go through the catalog
+// (and decode the stats) every time.
+//===--------------------------------------------------------------------===//
 class StatsStorage {
  public:
   // Global Singleton
@@ -53,10 +75,10 @@ class StatsStorage {
 
   void InsertOrUpdateColumnStats(
       oid_t database_id, oid_t table_id, oid_t column_id, int num_rows,
-      double cardinality, double frac_null, std::string most_common_vals,
-      std::string most_common_freqs, std::string histogram_bounds,
-      std::string column_name, bool has_index = false,
-      concurrency::TransactionContext *txn = nullptr);
+      double cardinality, double frac_null,
+      const std::vector<ValueFrequencyPair> &most_common_val_freqs,
+      const std::vector<double> &histogram_bounds, std::string column_name,
+      bool has_index = false, concurrency::TransactionContext *txn = nullptr);
 
   std::shared_ptr<ColumnStats> GetColumnStatsByID(oid_t database_id,
                                                   oid_t table_id,
@@ -67,6 +89,28 @@ class StatsStorage {
   std::shared_ptr<TableStats> GetTableStats(oid_t database_id, oid_t table_id,
                                             std::vector<oid_t> column_ids);
 
+  // The joint stats of the groups of columns of the table
+  std::vector<std::shared_ptr<MultiColumnStats>> GetMultiColumnStats(
+      oid_t database_id, oid_t table_id);
+
+  // The version of the stats of the table, which changes whenever they are
+  // written
+  uint64_t GetTableStatsVersion(oid_t database_id, oid_t table_id);
+
+  // Forget the cached stats of the table, once it is dropped
+  void RemoveTableStats(oid_t database_id, oid_t table_id);
+
+  // Set the function that is called with the oid of a table and its number of
+  // rows whenever new stats of the table are stored, e.g., to invalidate the
+  // plans built for a very different table size. nullptr removes it. Doesn't
+  // create the stats storage.
+  static void SetTableStatsHook(std::function<void(oid_t, size_t)> hook);
+
+  // Make the collector also collect the joint stats of the groups of columns
+  // of the table that have stats
+  void AddColumnGroups(storage::DataTable *table,
+                       TableStatsCollector *table_stats_collector);
+
   /* Functions for triggerring stats collection */
 
   ResultType AnalyzeStatsForAllTables(concurrency::TransactionContext *txn = nullptr);
@@ -74,69 +118,93 @@ class StatsStorage {
   ResultType AnalyzeStatsForTable(storage::DataTable *table,
                                   concurrency::TransactionContext *txn = nullptr);
 
-  ResultType AnalayzeStatsForColumns(storage::DataTable *table,
-                                     std::vector<std::string> column_names);
+  // Analyze the table, and keep the joint stats of the given columns from now
+  // on if there are more than one. Fails if a column doesn't exist.
+  ResultType AnalayzeStatsForColumns(
+      storage::DataTable *table, std::vector<std::string> column_names,
+      concurrency::TransactionContext *txn = nullptr);
+
+  /* Functions for encoding stats */
+
+  // Encode an array of doubles (frequencies or histogram bounds)
+  static std::string EncodeDoubles(const std::vector<double> &double_array);
+
+  static std::vector<double> DecodeDoubles(const char *data, size_t length);
+
+  // Encode the most common values and their frequencies. Numeric values are
+  // stored as doubles and string values as strings. Returns the encoded
+  // values and the encoded frequencies.
+  static std::pair<std::string, std::string> EncodeCommonValues(
+      const std::vector<ValueFrequencyPair> &val_freqs);
+
+  static void DecodeCommonValues(const char *data, size_t length,
+                                 std::vector<double> &numeric_vals,
+                                 std::vector<std::string> &string_vals);
 
  private:
+  // The version of the binary stats format
+  static constexpr int8_t kStatsFormatVersion = 1;
+
+  // The kinds of values in an encoded array
+  static constexpr int8_t kNumericValues = 0;
+  static constexpr int8_t kStringValues = 1;
+
+  // String values longer than this are never stored as common values
+  static constexpr size_t kMaxCommonValueLength = 1024;
+
+  using TableKey = std::pair<oid_t, oid_t>;
+  using ColumnStatsMap = std::map<oid_t, std::shared_ptr<ColumnStats>>;
+
+  struct CachedTableStats {
+    uint64_t version;
+    std::shared_ptr<const ColumnStatsMap> column_stats;
+  };
+
   std::unique_ptr<type::AbstractPool> pool_;
 
+  // The decoded stats of each table, keyed by (database id, table id)
+  std::map<TableKey, CachedTableStats> stats_cache_;
+
+  // The current version of the stats of each table
+  std::map<TableKey, uint64_t> stats_versions_;
+
+  // The joint stats of the groups of columns of each table
+  std::map<TableKey, std::vector<std::shared_ptr<MultiColumnStats>>>
+      multi_column_stats_;
+
+  common::synchronization::ReadWriteLatch cache_lock_;
+
+  static std::mutex hook_mutex_;
+  static std::function<void(oid_t, size_t)> table_stats_hook_;
+
+  // Write the stats of a column into the catalog. Returns the stats as they
+  // are read back.
+  std::shared_ptr<ColumnStats> WriteColumnStats(
+      oid_t database_id, oid_t table_id, oid_t column_id, int num_rows,
+      double cardinality, double frac_null,
+      const std::vector<ValueFrequencyPair> &most_common_val_freqs,
+      const std::vector<double> &histogram_bounds, std::string column_name,
+      bool has_index, concurrency::TransactionContext *txn);
+
+  // Make the committed stats of the table visible to lookups, and tell the
+  // hook about them
+  void PublishTableStats(
+      oid_t database_id, oid_t table_id, size_t num_rows,
+      std::shared_ptr<const ColumnStatsMap> column_stats_map,
+      const std::vector<std::shared_ptr<MultiColumnStats>>
+          &new_multi_column_stats);
+
+  // Replace the committed stats of a column in the cached stats of its table
+  void PublishColumnStats(oid_t database_id, oid_t table_id,
+                          std::shared_ptr<ColumnStats> column_stats);
+
+  // Get the decoded stats of all the columns of the table
+  std::shared_ptr<const ColumnStatsMap> GetColumnStatsMap(oid_t database_id,
+                                                          oid_t table_id);
+
   std::shared_ptr<ColumnStats> ConvertVectorToColumnStats(
       oid_t database_id, oid_t table_id, oid_t column_id,
       std::unique_ptr<std::vector<type::Value>> &column_stats_vector);
-
-  std::string ConvertDoubleArrayToString(std::vector<double> &double_array) {
-    if (double_array.size() == 0) {
-      return std::string();
-    }
-    std::stringstream ss;
-    for (size_t i = 0; i < double_array.size(); ++i) {
-      if (i != 0) {
-        ss << ",";
-      }
-      ss << double_array[i];
-    }
-    return ss.str();
-  }
-
-  std::vector<double> ConvertStringToDoubleArray(std::string str) {
-    std::vector<double> double_array;
-    std::stringstream ss(str);
-    double num;
-
-    while (ss >> num) {
-      double_array.push_back(num);
-
-      if (ss.peek() == ',') {
-        ss.ignore();
-      }
-    }
-
-    return double_array;
-  }
-
-  std::pair<std::string, std::string> ConvertValueFreqArrayToStrings(
-      std::vector<ValueFrequencyPair> &val_freqs) {
-    size_t array_size = val_freqs.size();
-    if (array_size == 0) {
-      return std::make_pair("", "");
-    }
-    auto type_id = val_freqs[0].first.GetTypeId();
-    if (type_id == type::TypeId::VARBINARY ||
-        type_id == type::TypeId::VARCHAR) {
-      return std::make_pair("", "");
-    }
-    std::stringstream ss_value;
-    std::stringstream ss_freq;
-    for (size_t i = 0; i < array_size; ++i) {
-      if (i != 0) {
-        ss_value << ",";
-        ss_freq << ",";
-      }
-      ss_value << val_freqs[i].first.ToString();
-      ss_freq << val_freqs[i].second;
-    }
-    return std::make_pair(ss_value.str(), ss_freq.str());
-  }
 };
 }
 }
@@ -25,6 +25,7 @@ namespace optimizer {
 #define DEFAULT_HAS_INDEX false
 
 class ColumnStats;
+class MultiColumnStats;
 
 //===--------------------------------------------------------------------===//
 // TableStats
@@ -81,6 +82,15 @@ class TableStats : public Stats {
 
   size_t GetColumnCount();
 
+  void AddMultiColumnStats(std::shared_ptr<MultiColumnStats> stats) {
+    multi_col_stats_list_.push_back(stats);
+  }
+
+  // The joint stats of groups of columns, if any were collected
+  const std::vector<std::shared_ptr<MultiColumnStats>>& GetMultiColumnStats() {
+    return multi_col_stats_list_;
+  }
+
   std::string ToCSV();
 
   size_t num_rows;
@@ -90,6 +100,7 @@ class TableStats : public Stats {
   std::vector<std::shared_ptr<ColumnStats>> col_stats_list_;
   std::unordered_map<std::string, std::shared_ptr<ColumnStats>>
       col_name_to_stats_map_;
+  std::vector<std::shared_ptr<MultiColumnStats>> multi_col_stats_list_;
 };
 
 }  // namespace optimizer
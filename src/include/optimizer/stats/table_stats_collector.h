@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "optimizer/stats/column_stats_collector.h"
+#include "optimizer/stats/multi_column_stats_collector.h"
 #include "catalog/schema.h"
 #include "storage/data_table.h"
 
@@ -30,25 +31,68 @@ class TableStatsCollector {
 
   ~TableStatsCollector();
 
+  // Also collect the joint stats of the given columns in the next collection
+  void AddColumnGroup(std::vector<oid_t> column_ids);
+
+  // Collect the stats of the table, using analyze_parallelism threads. Large
+  // tables are sampled by tile group (see analyze_sample_tile_groups) and the
+  // sample is scaled up to the whole table.
   void CollectColumnStats();
 
+  // Collect the stats of the tuples inserted since the last collection and
+  // merge them into the current stats. Returns false, without collecting
+  // anything, if the current stats can't be extended (e.g., they come from a
+  // sample of the table, or tuples were inserted into recycled slots).
+  bool CollectNewColumnStats();
+
   inline size_t GetActiveTupleCount() { return active_tuple_count_; }
 
   inline size_t GetColumnCount() { return column_count_; }
 
   ColumnStatsCollector* GetColumnStats(oid_t column_id);
 
+  inline const std::vector<std::vector<oid_t>>& GetColumnGroups() {
+    return column_groups_;
+  }
+
+  // The joint stats of the column group with the given offset
+  MultiColumnStatsCollector* GetColumnGroupStats(size_t group_offset);
+
  private:
   storage::DataTable* table_;
   catalog::Schema* schema_;
   std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors_;
+  // Sorted column ids of each group
+  std::vector<std::vector<oid_t>> column_groups_;
+  std::vector<std::unique_ptr<MultiColumnStatsCollector>>
+      column_group_stats_collectors_;
   size_t active_tuple_count_;
   size_t column_count_;
+  // Whether the stats come from a sample of the tile groups
+  bool sampled_;
+  // The number of tuple slots used in each tile group, and the number of
+  // recycled slots the table had handed out, when the stats were collected.
+  // Inserts are spread over the active tile groups, so any of them may grow.
+  std::vector<oid_t> collected_tuple_slots_;
+  size_t collected_recycled_slots_;
 
   TableStatsCollector(const TableStatsCollector&);
   void operator=(const TableStatsCollector&);
 
-  void InitColumnStatsCollectors();
+  void InitColumnStatsCollectors(
+      std::vector<std::unique_ptr<ColumnStatsCollector>>& collectors);
+
+  void InitColumnGroupStatsCollectors(
+      std::vector<std::unique_ptr<MultiColumnStatsCollector>>& collectors);
+
+  // Collect the stats of the active tuples in the given range of tuple slots
+  // of the tile group. Returns the number of active tuples.
+  size_t CollectTileGroupStats(
+      storage::TileGroup* tile_group, oid_t begin_tuple_id,
+      oid_t end_tuple_id,
+      std::vector<std::unique_ptr<ColumnStatsCollector>>& collectors,
+      std::vector<std::unique_ptr<MultiColumnStatsCollector>>&
+          group_collectors);
 };
 
 }  // namespace optimizer
@@ -611,6 +611,25 @@ class TopKElements {
     }
   }
 
+  /*
+   * Merge the sketch and the top items of another TopKElements. The counts
+   * of the top items of both are re-estimated from the merged sketch.
+   */
+  void Merge(const TopKElements& other) {
+    cmsketch.Merge(other.cmsketch);
+    std::vector<ApproxTopEntry> entries = tkq.retrieve_all();
+    std::vector<ApproxTopEntry> other_entries = other.tkq.retrieve_all();
+    entries.insert(entries.end(), other_entries.begin(), other_entries.end());
+    for (auto& entry : entries) {
+      const auto& elem = entry.approx_top_elem;
+      entry.approx_count =
+          elem.item_type == ApproxTopEntryElem::ElemType::INT_TYPE
+              ? cmsketch.EstimateItemCount(elem.int_item)
+              : cmsketch.EstimateItemCount(elem.str_item.c_str());
+      AddFreqItem(entry);
+    }
+  }
+
   // TODO:
   // Need to retrieve new elements after eviction of current element(s)
 
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/internal_types.h"
 #include "type/ephemeral_pool.h"
 
@@ -35,6 +37,11 @@ class TupleSampler {
   }
 
   size_t AcquireSampleTuples(size_t target_sample_count);
+
+  // Block-level sampling: choose sample_count tile groups uniformly at
+  // random. Returns their offsets in ascending order.
+  std::vector<oid_t> SampleTileGroups(size_t sample_count);
+
   bool GetTupleInTileGroup(storage::TileGroup *tile_group, size_t tuple_offset,
                            std::unique_ptr<storage::Tuple> &tuple);
 
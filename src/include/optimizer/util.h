@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <string>
+#include <unordered_map>
 
 #include "expression/abstract_expression.h"
 #include "parser/copy_statement.h"
@@ -24,6 +25,11 @@ namespace peloton {
 
 namespace catalog {
 class Schema;
+class TableCatalogObject;
+}
+
+namespace index {
+class Index;
 }
 
 namespace storage {
@@ -101,6 +107,27 @@ void ExtractEquiJoinKeys(const std::vector<AnnotatedExpression> join_predicates,
                          std::vector<std::unique_ptr<expression::AbstractExpression>>& right_keys,
                          const std::unordered_set<std::string>& left_alias, const std::unordered_set<std::string>& right_alias);
 
+// Get the storage indexes of a table in the catalog by their oids, looking
+// the table up once. Only the storage indexes know the predicates and the key
+// expressions of the indexes. Indexes the storage layer doesn't have (any
+// more) are missing.
+std::unordered_map<oid_t, std::shared_ptr<index::Index>> GetStorageIndexes(
+    const std::shared_ptr<catalog::TableCatalogObject>& table);
+
+// Whether the expression of a query computes what the expression of an index
+// on the table does. The column references of index expressions are table
+// column offsets.
+bool EqualIndexExpressions(const expression::AbstractExpression* expr,
+                           const expression::AbstractExpression* index_expr,
+                           oid_t table_oid);
+
+// Whether every conjunct of the predicate of a partial index on the table is
+// one of the predicates of a query, so that the index has all the tuples it
+// selects
+bool ImpliesIndexPredicate(const std::vector<AnnotatedExpression>& predicates,
+                           const expression::AbstractExpression* index_predicate,
+                           oid_t table_oid);
+
 }  // namespace util
 }  // namespace optimizer
 }  // namespace peloton
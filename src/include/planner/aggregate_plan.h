@@ -124,7 +124,9 @@ class AggregatePlan : public AbstractPlan {
     std::shared_ptr<const catalog::Schema> output_schema_copy(
         catalog::Schema::CopySchema(GetOutputSchema()));
     AggregatePlan *new_plan = new AggregatePlan(
-        project_info_->Copy(), std::unique_ptr<const expression::AbstractExpression>(predicate_->Copy()),
+        project_info_ != nullptr ? project_info_->Copy() : nullptr,
+        std::unique_ptr<const expression::AbstractExpression>(
+            predicate_ != nullptr ? predicate_->Copy() : nullptr),
         std::move(copied_agg_terms), std::move(copied_groupby_col_ids),
         output_schema_copy, agg_strategy_);
     return std::unique_ptr<AbstractPlan>(new_plan);
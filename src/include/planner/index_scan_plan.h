@@ -149,6 +149,8 @@ class IndexScanPlan : public AbstractScan {
 
   inline bool GetDescend() const { return descend_; }
 
+  inline bool IsCovering() const { return covering_; }
+
   const std::string GetInfo() const { return "IndexScan"; }
 
   void SetLimit(bool limit) { limit_ = limit; }
@@ -159,6 +161,8 @@ class IndexScanPlan : public AbstractScan {
 
   void SetDescend(bool descend) { descend_ = descend; }
 
+  void SetCovering(bool covering) { covering_ = covering; }
+
   void SetParameterValues(std::vector<type::Value> *values);
 
   std::unique_ptr<AbstractPlan> Copy() const {
@@ -167,10 +171,13 @@ class IndexScanPlan : public AbstractScan {
       new_runtime_keys.push_back(key->Copy());
     }
 
-    IndexScanDesc desc(index_, key_column_ids_, expr_types_, values_,
-                       new_runtime_keys);
+    IndexScanDesc desc(index_, key_column_ids_, expr_types_,
+                       values_with_params_, new_runtime_keys);
+    auto *predicate = GetPredicate();
     IndexScanPlan *new_plan = new IndexScanPlan(
-        GetTable(), GetPredicate()->Copy(), GetColumnIds(), desc, false);
+        GetTable(), predicate != nullptr ? predicate->Copy() : nullptr,
+        GetColumnIds(), desc, IsForUpdate());
+    new_plan->SetCovering(covering_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -228,6 +235,10 @@ class IndexScanPlan : public AbstractScan {
   // whether order by is descending
   bool descend_ = false;
 
+  // whether the index key holds all the columns the scan reads, so that the
+  // scan may read them from the key instead of from the table
+  bool covering_ = false;
+
  private:
   DISALLOW_COPY_AND_MOVE(IndexScanPlan);
 };
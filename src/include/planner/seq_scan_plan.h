@@ -69,8 +69,10 @@ class SeqScanPlan : public AbstractScan {
   oid_t GetColumnID(std::string col_name);
 
   std::unique_ptr<AbstractPlan> Copy() const override {
+    auto *predicate = this->GetPredicate();
     AbstractPlan *new_plan = new SeqScanPlan(
-        this->GetTable(), this->GetPredicate()->Copy(), this->GetColumnIds());
+        this->GetTable(), predicate != nullptr ? predicate->Copy() : nullptr,
+        this->GetColumnIds(), this->IsForUpdate());
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
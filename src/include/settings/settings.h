@@ -37,6 +37,20 @@ SETTING_string(socket_family,
               "AF_INET",
               false, false)
 
+// Per-thread listening sockets
+SETTING_bool(reuse_port_listeners,
+            "Give each network thread its own SO_REUSEPORT listening socket "
+            "instead of dispatching connections from one listener (default: false)",
+            false,
+            false, false)
+
+// Run-to-completion query execution
+SETTING_bool(inline_execution,
+            "Execute queries on the network thread that owns the connection "
+            "instead of handing them to the worker pool (default: false)",
+            false,
+            true, true)
+
 // Added for SSL only begins
 
 // Peloton private key file
@@ -63,6 +77,58 @@ SETTING_double(bnlj_buffer_size,
              1.0 * 1024.0 * 1024.0,
              true, true)
 
+// Worker pool sizes
+SETTING_int(worker_pool_size,
+           "Number of workers executing latency-sensitive tasks, "
+           "0 to use one per hardware thread (default: 0)",
+           0,
+           false, false)
+
+SETTING_int(batch_worker_pool_size,
+           "Number of workers executing batch tasks, 0 to run them with the "
+           "latency-sensitive workers (default: 1)",
+           1,
+           false, false)
+
+SETTING_int(batch_task_min_tuples,
+           "Number of tuples a statement may read from which on it is "
+           "executed by the batch workers (default: 100000)",
+           100000,
+           true, true)
+
+SETTING_int(task_queue_size,
+           "Initial capacity of each worker pool task queue (default: 32)",
+           32,
+           false, false)
+
+// Number of threads that build an index
+SETTING_int(index_build_parallelism,
+           "Number of threads that scan a table to build an index "
+           "(default: 4)",
+           4,
+           true, true)
+
+// Keep read-optimized copies of cold tile groups
+SETTING_bool(freeze_cold_tile_groups,
+            "Build compressed, read-optimized copies of the tile groups that "
+            "no running transaction can see change (default: false)",
+            false,
+            false, false)
+
+SETTING_int(tile_group_freezer_interval,
+           "Milliseconds between two passes of the tile group freezer "
+           "(default: 1000)",
+           1000,
+           true, true)
+
+// Let index-only scans skip the version chains of settled tile groups
+SETTING_int(all_visible_marking_interval,
+           "Milliseconds between two passes of the garbage collector that "
+           "mark the tile groups whose tuples are all visible, 0 to not mark "
+           "them (default: 100)",
+           100,
+           true, true)
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
@@ -91,6 +157,41 @@ SETTING_int(stats_mode,
            static_cast<int>(peloton::StatsType::INVALID),
            true, true)
 
+// Number of tile groups that ANALYZE samples
+SETTING_int(analyze_sample_tile_groups,
+           "Number of randomly chosen tile groups that ANALYZE collects "
+           "statistics from, 0 to scan the whole table (default: 300)",
+           300,
+           true, true)
+
+// Number of threads that ANALYZE uses
+SETTING_int(analyze_parallelism,
+           "Number of threads that collect the statistics of a table "
+           "(default: 4)",
+           4,
+           true, true)
+
+// Re-analyze tables whose contents drifted
+SETTING_bool(auto_analyze,
+            "Analyze tables again in the background once enough of their "
+            "tuples were inserted, updated or deleted. Requires statistics "
+            "collection (default: false)",
+            false,
+            true, true)
+
+SETTING_int(auto_analyze_threshold,
+           "Number of modified tuples, on top of auto_analyze_scale_factor "
+           "times the size of the table, that triggers an analysis "
+           "(default: 50)",
+           50,
+           true, true)
+
+SETTING_double(auto_analyze_scale_factor,
+              "Fraction of the size of a table that must be modified to "
+              "trigger an analysis (default: 0.1)",
+              0.1,
+              true, true)
+
 //===----------------------------------------------------------------------===//
 // AI
 //===----------------------------------------------------------------------===//
@@ -107,6 +208,13 @@ SETTING_bool(layout_tuner,
             false,
             true, true)
 
+// Cap the memory bandwidth of the layout tuner
+SETTING_int(layout_tuner_bandwidth,
+           "Max KB per second that the layout tuner copies into new layouts, "
+           "or 0 for no limit (default: 0)",
+           0,
+           true, true)
+
 //===----------------------------------------------------------------------===//
 // CODEGEN
 //===----------------------------------------------------------------------===//
@@ -116,6 +224,17 @@ SETTING_bool(codegen,
             true,
             true, true)
 
+SETTING_bool(plan_cache,
+             "Cache the plans of simple queries that differ only in the "
+             "literals they compare against (default: false)",
+             false,
+             true, true)
+
+SETTING_int(plan_cache_size,
+            "Maximum number of plans kept in the plan cache (default: 1024)",
+            1024,
+            true, true)
+
 
 //===----------------------------------------------------------------------===//
 // Optimizer
@@ -130,6 +249,37 @@ SETTING_bool(hash_join_bloom_filter,
              true,
              true, true)
 
+SETTING_int(optimizer_task_limit,
+            "Number of optimizer tasks after which the optimizer stops "
+            "exploring alternatives for a query, 0 for no limit (default: 0)",
+            0,
+            true, true)
+
+SETTING_int(optimizer_timeout,
+            "Time in milliseconds after which the optimizer stops exploring "
+            "alternatives for a query, 0 for no limit (default: 5000)",
+            5000,
+            true, true)
+
+SETTING_int(optimizer_memo_group_limit,
+            "Number of memo groups after which the optimizer stops exploring "
+            "alternatives for a query, 0 for no limit (default: 0)",
+            0,
+            true, true)
+
+SETTING_int(optimizer_parallelism,
+            "Number of threads that may optimize independent sub-plans of "
+            "a query concurrently (default: 1)",
+            1,
+            true, true)
+
+SETTING_int(max_join_reorder_tables,
+            "Maximum number of tables in a join for which the optimizer "
+            "explores all join orders, larger joins keep their FROM clause "
+            "order (default: 12)",
+            12,
+            true, true)
+
 //===----------------------------------------------------------------------===//
 // GENERAL
 //===----------------------------------------------------------------------===//
@@ -24,6 +24,7 @@
 #include "statistics/table_metric.h"
 #include "statistics/index_metric.h"
 #include "statistics/latency_metric.h"
+#include "statistics/optimizer_metric.h"
 #include "statistics/database_metric.h"
 #include "statistics/query_metric.h"
 
@@ -79,6 +80,12 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric& GetTxnLatencyMetric();
 
+  // Returns the metric for the time tasks wait in the worker pool's queues
+  LatencyMetric& GetQueueWaitLatencyMetric();
+
+  // Returns the metric for the work done by the optimizer
+  OptimizerMetric& GetOptimizerMetric();
+
   // Increment the read stat for given tile group
   void IncrementTableReads(oid_t tile_group_id);
 
@@ -110,6 +117,11 @@ class BackendStatsContext {
   // Increment the abortion stat for given database
   void IncrementTxnAborted(oid_t database_id);
 
+  // Record the counters of a query optimization. They are also attributed to
+  // the next query started on this thread.
+  void RecordOptimization(int64_t num_tasks, int64_t num_groups,
+                          int64_t num_group_exprs, bool budget_exhausted);
+
   // Initialize the query stat
   void InitQueryMetric(const std::shared_ptr<Statement> statement,
                        const std::shared_ptr<QueryMetric::QueryParams> params);
@@ -170,6 +182,15 @@ class BackendStatsContext {
   // Latencies recorded by this worker
   LatencyMetric txn_latencies_;
 
+  // Queue wait times of the tasks run by this worker
+  LatencyMetric queue_wait_latencies_;
+
+  // Work done by the optimizer on this thread
+  OptimizerMetric optimizer_metric_{MetricType::OPTIMIZER};
+
+  // Optimizer work not yet attributed to a query
+  OptimizerMetric pending_optimizer_metric_{MetricType::OPTIMIZER};
+
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
 
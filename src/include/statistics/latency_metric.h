@@ -43,7 +43,8 @@ struct LatencyMeasurements {
  */
 class LatencyMetric : public AbstractMetric {
  public:
-  LatencyMetric(MetricType type, size_t max_history);
+  LatencyMetric(MetricType type, size_t max_history,
+                const std::string &name = "TXN LATENCY");
 
   //===--------------------------------------------------------------------===//
   // HELPER METHODS
@@ -63,7 +64,11 @@ class LatencyMetric : public AbstractMetric {
   // Stops the latency timer and records the total time elapsed
   inline void RecordLatency() {
     timer_ms_.Stop();
-    double latency_value = timer_ms_.GetDuration();
+    RecordLatency(timer_ms_.GetDuration());
+  }
+
+  // Records a latency (in ms) measured elsewhere
+  inline void RecordLatency(double latency_value) {
     // Record this latency only if we can do so without blocking.
     // Occasionally losing single latency measurements is fine.
     {
@@ -108,6 +113,9 @@ class LatencyMetric : public AbstractMetric {
   // Stores result of last call to ComputeLatencies()
   LatencyMeasurements latency_measurements_;
 
+  // The name of the measured latency, used in GetInfo()
+  std::string name_;
+
   // The maximum number of latencies that can be stored
   // (the capacity size N of the circular buffer)
   size_t max_history_;
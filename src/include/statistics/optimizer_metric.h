@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimizer_metric.h
+//
+// Identification: src/statistics/optimizer_metric.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <sstream>
+
+#include "common/internal_types.h"
+#include "statistics/abstract_metric.h"
+#include "statistics/counter_metric.h"
+
+namespace peloton {
+namespace stats {
+
+/**
+ * Metric for the work done by the query optimizer: the number of optimizer
+ * tasks executed, and the number of memo groups and group expressions created.
+ */
+class OptimizerMetric : public AbstractMetric {
+ public:
+  OptimizerMetric(MetricType type) : AbstractMetric(type) {}
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  // Record the counters of one optimization
+  inline void RecordOptimization(int64_t num_tasks, int64_t num_groups,
+                                 int64_t num_group_exprs,
+                                 bool budget_exhausted) {
+    num_optimizations_.Increment();
+    num_tasks_.Increment(num_tasks);
+    num_groups_.Increment(num_groups);
+    num_group_exprs_.Increment(num_group_exprs);
+    if (budget_exhausted) {
+      num_budget_exhausted_.Increment();
+    }
+  }
+
+  inline int64_t GetNumOptimizations() {
+    return num_optimizations_.GetCounter();
+  }
+
+  inline int64_t GetNumTasks() { return num_tasks_.GetCounter(); }
+
+  inline int64_t GetNumGroups() { return num_groups_.GetCounter(); }
+
+  inline int64_t GetNumGroupExpressions() {
+    return num_group_exprs_.GetCounter();
+  }
+
+  // The number of optimizations stopped early by the optimization budget
+  inline int64_t GetNumBudgetExhausted() {
+    return num_budget_exhausted_.GetCounter();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // HELPER METHODS
+  //===--------------------------------------------------------------------===//
+
+  void Reset();
+
+  void Aggregate(AbstractMetric &source);
+
+  inline const std::string GetInfo() const {
+    std::stringstream ss;
+    ss << "[optimizer] optimizations: " << num_optimizations_.GetInfo()
+       << ", tasks: " << num_tasks_.GetInfo()
+       << ", groups: " << num_groups_.GetInfo()
+       << ", group expressions: " << num_group_exprs_.GetInfo()
+       << ", budget exhausted: " << num_budget_exhausted_.GetInfo();
+    return ss.str();
+  }
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  CounterMetric num_optimizations_{MetricType::COUNTER};
+
+  CounterMetric num_tasks_{MetricType::COUNTER};
+
+  CounterMetric num_groups_{MetricType::COUNTER};
+
+  CounterMetric num_group_exprs_{MetricType::COUNTER};
+
+  CounterMetric num_budget_exhausted_{MetricType::COUNTER};
+};
+
+}  // namespace stats
+}  // namespace peloton
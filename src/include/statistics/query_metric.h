@@ -19,6 +19,7 @@
 #include "statistics/abstract_metric.h"
 #include "statistics/access_metric.h"
 #include "statistics/latency_metric.h"
+#include "statistics/optimizer_metric.h"
 #include "statistics/processor_metric.h"
 #include "util/string_util.h"
 
@@ -77,6 +78,10 @@ class QueryMetric : public AbstractMetric {
 
   inline ProcessorMetric &GetProcessorMetric() { return processor_metric_; }
 
+  // The work the optimizer did to plan this query. Empty if the plan was
+  // reused from an earlier preparation of the statement.
+  inline OptimizerMetric &GetOptimizerMetric() { return optimizer_metric_; }
+
   inline std::string GetName() const { return query_name_; }
 
   inline oid_t GetDatabaseId() const { return database_id_; }
@@ -99,6 +104,7 @@ class QueryMetric : public AbstractMetric {
     ss << "  QUERY " << query_name_ << std::endl;
     ss << peloton::GETINFO_SINGLE_LINE << std::endl;
     ss << query_access_.GetInfo();
+    ss << optimizer_metric_.GetInfo() << std::endl;
     return ss.str();
   }
 
@@ -124,6 +130,9 @@ class QueryMetric : public AbstractMetric {
 
   // Processor metric
   ProcessorMetric processor_metric_{MetricType::PROCESSOR};
+
+  // Optimizer metric
+  OptimizerMetric optimizer_metric_{MetricType::OPTIMIZER};
 };
 
 }  // namespace stats
@@ -109,10 +109,10 @@ class DataTable : public AbstractTable {
 
   // install an version in table. designed for update operation.
   // as we implement logical-pointer indexing mechanism, targets_ptr is
-  // required.
+  // required. location is the slot of the new version.
   bool InstallVersion(const AbstractTuple *tuple, const TargetList *targets_ptr,
                       concurrency::TransactionContext *transaction,
-                      ItemPointer *index_entry_ptr);
+                      ItemPointer location, ItemPointer *index_entry_ptr);
 
   // insert tuple in table. the pointer to the index entry is returned as
   // index_entry_ptr.
@@ -146,6 +146,9 @@ class DataTable : public AbstractTable {
 
   size_t GetTileGroupCount() const;
 
+  // The number of tuple slots reclaimed by GC that were handed out again
+  size_t GetRecycledSlotCount() const { return recycled_slot_count_; }
+
   // Get a tile group with given layout
   TileGroup *GetTileGroupWithLayout(const column_map_type &partitioning);
 
@@ -189,6 +192,21 @@ class DataTable : public AbstractTable {
     return indexes_columns_;
   }
 
+  // While an index is built (see IndexBuilder), every new version gets an
+  // index entry, which is written into its header before the indexes are read
+  void BeginIndexBuild() { index_build_count_++; }
+
+  void EndIndexBuild() { index_build_count_--; }
+
+  bool IsIndexBuildActive() const {
+    return index_build_count_.load(std::memory_order_acquire) > 0;
+  }
+
+  // Get the index entry of the version. A version without one, i.e., one that
+  // was written while the table had no indexes, gets one if the table has
+  // indexes or one is being built.
+  ItemPointer *GetOrCreateIndirection(ItemPointer location);
+
   //===--------------------------------------------------------------------===//
   // FOREIGN KEYS
   //===--------------------------------------------------------------------===//
@@ -209,8 +227,13 @@ class DataTable : public AbstractTable {
   // TRANSFORMERS
   //===--------------------------------------------------------------------===//
 
+  // Copy the tile group into the default layout, if its layout differs by at
+  // least theta, while transactions keep running on it. Returns the new tile
+  // group, or nullptr if it was left alone. Sets busy if the tile group was
+  // left alone because it holds free slots or uncommitted versions.
   storage::TileGroup *TransformTileGroup(const oid_t &tile_group_offset,
-                                         const double &theta);
+                                         const double &theta,
+                                         bool *busy = nullptr);
 
   //===--------------------------------------------------------------------===//
   // STATS
@@ -272,7 +295,9 @@ class DataTable : public AbstractTable {
 
   // try to insert into all indexes.
   // the last argument is the index entry in primary index holding the new
-  // tuple.
+  // tuple. the entry is written into the header of the tuple before the
+  // indexes are read, so that an index builder that misses the tuple's
+  // entries finds the tuple (see IndexBuilder).
   bool InsertInIndexes(const AbstractTuple *tuple, ItemPointer location,
                        concurrency::TransactionContext *transaction,
                        ItemPointer **index_entry_ptr);
@@ -330,8 +355,22 @@ class DataTable : public AbstractTable {
   bool InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                 const TargetList *targets_ptr,
                                 concurrency::TransactionContext *transaction,
+                                ItemPointer location,
                                 ItemPointer *index_entry_ptr);
 
+  // Insert a tuple whose index entry is allocated into all indexes
+  bool InsertInIndexes(const AbstractTuple *tuple,
+                       concurrency::TransactionContext *transaction,
+                       ItemPointer **index_entry_ptr);
+
+  // Allocate the index entry of a new version, pointing to its location. If
+  // publish is set, the entry is also written into the version's header.
+  ItemPointer *AllocateIndirection(ItemPointer location, bool publish);
+
+  // Write the index entry of a new version into its header, before the
+  // indexes are read
+  void PublishIndirection(ItemPointer location, ItemPointer *index_entry_ptr);
+
   // check the foreign key constraints
   bool CheckForeignKeyConstraints(const AbstractTuple *tuple);
 
@@ -392,6 +431,13 @@ class DataTable : public AbstractTable {
   // concurrently.
   std::atomic<size_t> number_of_tuples_ = ATOMIC_VAR_INIT(0);
 
+  // # of index builds running on the table
+  std::atomic<size_t> index_build_count_ = ATOMIC_VAR_INIT(0);
+
+  // # of recycled tuple slots handed out. unlike the others, these slots
+  // are not at the end of a tile group.
+  std::atomic<size_t> recycled_slot_count_ = ATOMIC_VAR_INIT(0);
+
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
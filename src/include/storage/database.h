@@ -61,6 +61,14 @@ class Database : public Printable {
 
   void DropTableWithOid(const oid_t table_oid);
 
+  // Get the oids of the tables
+  std::vector<oid_t> GetTableOids();
+
+  // Get the tile groups of the table, or none if it was dropped. Background
+  // tasks scan them without the table, which may be dropped meanwhile.
+  std::vector<std::shared_ptr<storage::TileGroup>> GetTileGroupsWithTableOid(
+      const oid_t table_oid);
+
   //===--------------------------------------------------------------------===//
   // UTILITIES
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_block.h
+//
+// Identification: src/include/storage/frozen_block.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "type/type_id.h"
+
+namespace peloton {
+namespace storage {
+
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// A frame-of-reference encoded column
+//
+// Every value is stored as its unsigned difference from the smallest value of
+// the column, in width bytes. A value is decoded by loading eight bytes at its
+// offset, masking them and adding the base, so the data is padded with eight
+// bytes to keep the loads of the last values in bounds.
+//===--------------------------------------------------------------------===//
+struct PackedColumn {
+  int64_t base;
+  uint64_t mask;
+  uint32_t width;
+  std::unique_ptr<char[]> data;
+};
+
+//===--------------------------------------------------------------------===//
+// A dictionary encoded VARCHAR column
+//
+// The dictionary holds the distinct values of the column in sorted order, so
+// codes compare like the values they stand for. Every tuple slot has a code:
+// NULLs and empty slots get kNullCode, which no lookup returns.
+//===--------------------------------------------------------------------===//
+struct DictionaryColumn {
+  static constexpr uint32_t kInvalidCode = std::numeric_limits<uint32_t>::max();
+  static constexpr uint32_t kNullCode = kInvalidCode - 1;
+
+  // Get the code of a value, or kInvalidCode if the column doesn't hold it
+  uint32_t Lookup(const char *data, uint32_t length) const;
+
+  std::vector<std::string> dictionary;
+  std::unique_ptr<uint32_t[]> codes;
+};
+
+//===--------------------------------------------------------------------===//
+// FrozenBlock
+//
+// A read-optimized copy of a cold tile group: one that holds no version newer
+// than the GC horizon and can't take new tuples. Every tuple of a frozen tile
+// group is either visible to all transactions at or above the horizon, or to
+// none of them, so scans read the visibility of a tuple from a bitmap instead
+// of checking its MVCC header. The fixed-width integer columns without NULLs
+// are frame-of-reference encoded, so that scans read fewer bytes, and the
+// VARCHAR columns with few distinct values are dictionary encoded, so that
+// equality predicates compare codes instead of strings.
+//
+// Writers thaw the tile group (drop the block) before their changes to it can
+// commit.
+//
+// The block doesn't replace the tiles: the interpreted executors, index
+// lookups and writers still read them, so it adds to the memory of its tile
+// group, and only saves scan bandwidth.
+//===--------------------------------------------------------------------===//
+class FrozenBlock {
+ public:
+  // Build a frozen block of the tile group. Returns nullptr if it isn't cold
+  // with respect to the horizon.
+  static std::unique_ptr<FrozenBlock> Create(const TileGroup &tile_group,
+                                             cid_t horizon_cid);
+
+  // Whether the block still describes the tuples of the tile group, i.e.
+  // no tuple was written since it was built
+  bool IsValidFor(const TileGroup &tile_group) const;
+
+  // Whether the visibility of the tuples holds for a transaction with the
+  // given read id
+  inline bool IsVisibleTo(cid_t read_id) const {
+    return read_id >= horizon_cid_;
+  }
+
+  inline bool IsVisible(oid_t tuple_id) const {
+    return (visible_[tuple_id / 64] >> (tuple_id % 64)) & 1;
+  }
+
+  // Store the ids of the visible tuples in [tid_start, tid_end) into the
+  // selection vector, and return their number
+  uint32_t GetVisibleTuples(uint32_t tid_start, uint32_t tid_end,
+                            uint32_t *selection_vector) const;
+
+  // The encoded column, or nullptr if it isn't encoded
+  inline const PackedColumn *GetPackedColumn(oid_t column_id) const {
+    PL_ASSERT(column_id < packed_columns_.size());
+    return packed_columns_[column_id].get();
+  }
+
+  // Decode a value of an encoded column
+  int64_t GetPackedValue(oid_t column_id, oid_t tuple_id) const;
+
+  // The dictionary encoded column, or nullptr if it isn't encoded
+  inline const DictionaryColumn *GetDictionaryColumn(oid_t column_id) const {
+    PL_ASSERT(column_id < dictionary_columns_.size());
+    return dictionary_columns_[column_id].get();
+  }
+
+  inline oid_t GetTupleCount() const { return tuple_count_; }
+
+  inline oid_t GetVisibleTupleCount() const { return visible_count_; }
+
+  // The number of bytes of the encoded columns, and of the same columns in
+  // the tiles
+  inline size_t GetPackedSize() const { return packed_size_; }
+  inline size_t GetUnpackedSize() const { return unpacked_size_; }
+
+  // Whether columns of the type are frame-of-reference encoded
+  static bool CanPackType(type::TypeId type_id);
+
+ private:
+  FrozenBlock(oid_t tuple_count, cid_t horizon_cid);
+
+  // Classify the tuples of the tile group into the bitmap. Returns false if
+  // some tuple may still change visibility.
+  static bool ClassifyTuples(const TileGroup &tile_group, cid_t horizon_cid,
+                             std::vector<uint64_t> &visible);
+
+  // Encode a column, if all its values are non-null and their range fits in
+  // four bytes
+  void PackColumn(const TileGroup &tile_group, oid_t column_id);
+
+  // Dictionary encode a VARCHAR column, if it has at most kMaxDictionarySize
+  // distinct values
+  void EncodeColumn(const TileGroup &tile_group, oid_t column_id);
+
+  static constexpr size_t kMaxDictionarySize = 256;
+
+  oid_t tuple_count_;
+  oid_t visible_count_;
+  cid_t horizon_cid_;
+  // One bit per tuple slot
+  std::vector<uint64_t> visible_;
+  std::vector<std::unique_ptr<PackedColumn>> packed_columns_;
+  std::vector<std::unique_ptr<DictionaryColumn>> dictionary_columns_;
+  size_t packed_size_;
+  size_t unpacked_size_;
+};
+
+}  // namespace storage
+}  // namespace peloton
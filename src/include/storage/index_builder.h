@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_builder.h
+//
+// Identification: src/include/storage/index_builder.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/item_pointer.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+
+namespace concurrency {
+class TransactionContext;
+}
+
+namespace index {
+class Index;
+}
+
+namespace storage {
+
+class DataTable;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Index Builder
+//
+// Builds an index from the tuples of its table without blocking writers. The
+// index is added to the table in the building state, in which writers log
+// their entries into it instead of inserting them. The builder then scans the
+// tile groups of the table in parallel, collecting an entry for every version
+// in sorted runs whose keys are built back to back into one buffer per run,
+// merges the runs at once, checks the uniqueness of the keys on the merged
+// entries and bulk loads them into the index. Finally it applies the
+// entries the writers logged meanwhile.
+//
+// Writers only write the index entry of a new version into its header before
+// reading the indexes of the table while an index build is active. The
+// builder marks the build active and waits for the transactions that started
+// before, which may not have seen the mark, before adding the index. A writer
+// that read the indexes before the index was added doesn't log its entries,
+// but the scan, which starts after the index was added, finds its version.
+// The newest versions written while the table had no indexes get their index
+// entries from the scan.
+//===--------------------------------------------------------------------===//
+
+class IndexBuilder {
+ public:
+  IndexBuilder(DataTable *table, std::shared_ptr<index::Index> index);
+
+  // Add the index to the table and build it, using index_build_parallelism
+  // threads. Returns false if the tuples of the table violate the uniqueness
+  // of the index, in which case the index is dropped from the table again.
+  // The transaction creating the index, if any, isn't waited for.
+  bool Build(concurrency::TransactionContext *txn = nullptr);
+
+  // Build the index, which is already in the table and in the building state,
+  // like Build() does
+  bool Populate();
+
+  // Loaders defer the indexes of a table while they insert its tuples, and
+  // build them afterwards. Writers skip deferred indexes, so no other
+  // transaction may write the table until its indexes are built.
+  static void DeferIndexes(DataTable *table);
+
+  static bool BuildDeferredIndexes(DataTable *table);
+
+  // Insert the entries of the versions in the tile group into the index. The
+  // uniqueness of the keys is only checked if check_unique is set, and the
+  // entries that violate it aren't inserted.
+  bool BuildTileGroup(TileGroup *tile_group, bool check_unique);
+
+  size_t GetIndexedVersionCount() const { return indexed_version_count_; }
+
+ private:
+  // The entry of a version found by the scan
+  struct ScannedEntry {
+    // Points into the key data of the run that found the version
+    Tuple key;
+    ItemPointer *index_entry_ptr;
+    // Whether the version is the newest one of its tuple
+    bool is_head;
+  };
+
+  // The entries one thread collects. The key of the i-th entry is the i-th
+  // key in the key data.
+  struct ScannedRun {
+    std::vector<char> key_data;
+    std::vector<ScannedEntry> entries;
+  };
+
+  // Collect the entries of the versions in the tile group. The keys of the
+  // new entries only point into the key data once FinishRun() is called.
+  void ScanTileGroup(TileGroup *tile_group, ScannedRun &run);
+
+  // Point the keys of the run into its key data, which doesn't grow anymore
+  void FinishRun(ScannedRun &run) const;
+
+  // Whether the merged entries violate the uniqueness of the index
+  bool HasDuplicateKeys(const std::vector<ScannedEntry> &entries) const;
+
+  // Insert the entry of a version. If check_unique is set and the index is
+  // unique, fails if another live tuple has the same key.
+  bool InsertEntry(const Tuple *key, ItemPointer *index_entry_ptr,
+                   bool check_unique);
+
+  DataTable *table_;
+
+  std::shared_ptr<index::Index> index_;
+
+  std::atomic<size_t> indexed_version_count_;
+};
+
+}  // namespace storage
+}  // namespace peloton
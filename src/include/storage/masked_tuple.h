@@ -42,6 +42,8 @@ class MaskedTuple : public AbstractTuple {
       // We don't own it. That's not on us!
   }
 
+  inline void SetTuple(AbstractTuple *rhs) { tuple_ = rhs; }
+
   inline void SetMask(const std::vector<oid_t> &mask) {
     // PL_ASSERT(mask_ == nullptr);
     mask_ = mask;
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <functional>
+#include <mutex>
 #include <vector>
 
 #include "common/internal_types.h"
@@ -86,11 +88,26 @@ class StorageManager {
 
   void DestroyDatabases();
 
+  //===--------------------------------------------------------------------===//
+  // INVALIDATION
+  //===--------------------------------------------------------------------===//
+
+  // Set the function that is called with the oid of a table when the table
+  // or one of its indexes is dropped, so that what the layers above derived
+  // from them (e.g., cached plans) can be invalidated. nullptr removes it.
+  void SetTableInvalidationHook(std::function<void(oid_t)> hook);
+
+  // Call the table invalidation hook, if any
+  void InvalidateTable(oid_t table_oid);
+
  private:
   StorageManager();
 
   // A vector of the database pointers in the catalog
   std::vector<storage::Database *> databases_;
+
+  std::mutex hook_mutex_;
+  std::function<void(oid_t)> table_invalidation_hook_;
 };
 
 }  // namespace
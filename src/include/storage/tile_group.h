@@ -23,6 +23,7 @@
 #include "planner/project_info.h"
 #include "type/abstract_pool.h"
 #include "common/internal_types.h"
+#include "storage/zone_map.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -49,6 +50,7 @@ namespace storage {
 class Tuple;
 class Tile;
 class TileGroupHeader;
+class FrozenBlock;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
@@ -74,7 +76,8 @@ class TileGroup : public Printable {
 
  public:
   // Tile group constructor
-  TileGroup(BackendType backend_type, TileGroupHeader *tile_group_header,
+  TileGroup(BackendType backend_type,
+            std::shared_ptr<TileGroupHeader> tile_group_header,
             AbstractTable *table, const std::vector<catalog::Schema> &schemas,
             const column_map_type &column_map, int tuple_count);
 
@@ -123,9 +126,7 @@ class TileGroup : public Printable {
 
   oid_t GetAllocatedTupleCount() const { return num_tuple_slots; }
 
-  TileGroupHeader *GetHeader() const { return tile_group_header; }
-
-  void SetHeader(TileGroupHeader *header) { tile_group_header = header; }
+  TileGroupHeader *GetHeader() const { return tile_group_header.get(); }
 
   unsigned int NumTiles() const { return tiles.size(); }
 
@@ -161,6 +162,26 @@ class TileGroup : public Printable {
 
   size_t GetTileCount() const { return tile_count; }
 
+  // Get the zone map maintained over the tuples of the tile group
+  ZoneMap *GetZoneMap() const { return zone_map.get(); }
+
+  // Get the bounds of all columns, for the generated scans
+  ColumnZoneMap *GetColumnZoneMaps() const {
+    return zone_map->GetColumnZoneMaps();
+  }
+
+  // Get the read-optimized copy of the tile group, or nullptr if it isn't
+  // frozen
+  FrozenBlock *GetFrozenBlock() const;
+
+  // Freeze the tile group if none of its tuples is newer than the horizon.
+  // Returns true if the tile group was frozen.
+  bool Freeze(cid_t horizon_cid);
+
+  // Drop the frozen copy of the tile group. Writers call this after changing
+  // the header of a tuple, and before the change commits.
+  void Thaw();
+
   // Sets the tile id and column id w.r.t that tile corresponding to
   // the specified tile group column id.
   inline void LocateTileAndColumn(oid_t column_offset, oid_t &tile_offset,
@@ -204,8 +225,9 @@ class TileGroup : public Printable {
   // set of tiles
   std::vector<std::shared_ptr<Tile>> tiles;
 
-  // associated tile group
-  TileGroupHeader *tile_group_header;
+  // associated tile group header, shared with the other layouts of the tile
+  // group
+  std::shared_ptr<TileGroupHeader> tile_group_header;
 
   // associated table
   AbstractTable *table;  // this design is fantastic!!!
@@ -221,6 +243,9 @@ class TileGroup : public Printable {
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
+
+  // min/max bounds of the columns, widened by every write
+  std::unique_ptr<ZoneMap> zone_map;
 };
 
 }  // namespace storage
@@ -34,6 +34,13 @@ class TileGroupFactory {
                                  const std::vector<catalog::Schema> &schemas,
                                  const column_map_type &column_map,
                                  int tuple_count);
+
+  // Get a tile group with the same tuples as the given one in another layout.
+  // The two share the header, so that transactions changing the versions of
+  // either one are seen by both.
+  static TileGroup *GetTransformedTileGroup(
+      const TileGroup &tile_group, const std::vector<catalog::Schema> &schemas,
+      const column_map_type &column_map);
 };
 
 }  // namespace storage
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.h
+//
+// Identification: src/include/storage/tile_group_freezer.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/internal_types.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Freezer
+//
+// Periodically builds frozen blocks of the tile groups of all user tables that
+// have become cold, i.e. hold no version newer than the GC horizon.
+//===--------------------------------------------------------------------===//
+
+class TileGroupFreezer {
+ public:
+  TileGroupFreezer(const TileGroupFreezer &) = delete;
+  TileGroupFreezer &operator=(const TileGroupFreezer &) = delete;
+  TileGroupFreezer(TileGroupFreezer &&) = delete;
+  TileGroupFreezer &operator=(TileGroupFreezer &&) = delete;
+
+  TileGroupFreezer();
+
+  // Singleton
+  static TileGroupFreezer &GetInstance();
+
+  // Start freezing
+  void Start();
+
+  // Stop freezing
+  void Stop();
+
+  // Freeze the cold tile groups of all user tables once, and free the frozen
+  // blocks of their thawed tile groups that no transaction can read any more
+  void FreezeAll();
+
+  // Freeze the tile groups of the table that are cold with respect to the
+  // horizon. Returns the number of tile groups frozen.
+  size_t FreezeTable(DataTable *table, cid_t horizon_cid);
+
+  size_t GetFrozenCount() const { return frozen_count_; }
+
+  // The number of bytes of the encoded columns, and of the same columns in
+  // the tiles
+  size_t GetPackedSize() const { return packed_size_; }
+  size_t GetUnpackedSize() const { return unpacked_size_; }
+
+ private:
+  void Run();
+
+  size_t FreezeTileGroups(
+      const std::vector<std::shared_ptr<TileGroup>> &tile_groups,
+      cid_t horizon_cid);
+
+  // Stop signal
+  std::atomic<bool> freezer_stop_;
+
+  // Freezer thread
+  std::thread freezer_thread_;
+
+  std::atomic<size_t> frozen_count_;
+  std::atomic<size_t> packed_size_;
+  std::atomic<size_t> unpacked_size_;
+};
+
+}  // namespace storage
+}  // namespace peloton
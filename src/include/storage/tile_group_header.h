@@ -14,6 +14,10 @@
 
 #include <atomic>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #include "common/item_pointer.h"
 #include "common/macros.h"
@@ -27,6 +31,7 @@ namespace peloton {
 namespace storage {
 
 class TileGroup;
+class FrozenBlock;
 
 //===--------------------------------------------------------------------===//
 // Tile Group Header
@@ -213,6 +218,16 @@ class TileGroupHeader : public Printable {
         indirection;
   }
 
+  // Set the indirection if it is the expected one. Returns the previous one.
+  inline ItemPointer *SetAtomicIndirection(const oid_t &tuple_slot_id,
+                                           ItemPointer *old_indirection,
+                                           ItemPointer *new_indirection) const {
+    ItemPointer **indirection_ptr =
+        (ItemPointer **)(TUPLE_HEADER_LOCATION + indirection_offset);
+    return __sync_val_compare_and_swap(indirection_ptr, old_indirection,
+                                       new_indirection);
+  }
+
   inline txn_id_t SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                          const txn_id_t &old_txn_id,
                                          const txn_id_t &new_txn_id) const {
@@ -245,6 +260,67 @@ class TileGroupHeader : public Printable {
 
   inline bool GetImmutability() const { return immutable; }
 
+  //===--------------------------------------------------------------------===//
+  // Frozen block
+  //
+  // The frozen block lives in the header, so that it is shared by all the
+  // layouts of the tile group, just like the MVCC state it is built from.
+  //===--------------------------------------------------------------------===//
+
+  inline FrozenBlock *GetFrozenBlock() const { return frozen_block.load(); }
+
+  // Install a frozen block, unless one is already installed. Takes ownership
+  // of the block if it returns true.
+  inline bool InstallFrozenBlock(FrozenBlock *block) {
+    FrozenBlock *expected = nullptr;
+    return frozen_block.compare_exchange_strong(expected, block);
+  }
+
+  // Drop the frozen block, keeping it alive for the scans that may still
+  // read it, and clear the all-visible bit. Neither is likely to be set, so
+  // this doesn't fence: the writer's change of the header must already be
+  // ordered before the call, like acquiring the ownership of a version or
+  // publishing its indirection does, so that either the writer sees the
+  // block, or TileGroup::Freeze() sees the change.
+  void Thaw();
+
+  // Free the thawed blocks that no running transaction can read any more.
+  // Returns the number of blocks freed.
+  size_t ReclaimThawedBlocks(eid_t expired_eid);
+
+  //===--------------------------------------------------------------------===//
+  // All-visible bit
+  //
+  // Set by the GC once every tuple in the tile group is the newest, committed
+  // version of its tuple and older than a horizon, so that index-only scans of
+  // transactions that started after the horizon can skip the version chains.
+  // Writers clear it before they change the header, like they thaw the frozen
+  // block.
+  //===--------------------------------------------------------------------===//
+
+  inline bool IsAllVisibleTo(cid_t read_id) const {
+    cid_t horizon_cid = all_visible_cid.load();
+    return horizon_cid != INVALID_CID && read_id >= horizon_cid;
+  }
+
+  // Set the bit if all tuples are visible at the horizon. Returns false if
+  // some tuple isn't. A tile group with a tuple that was committed after the
+  // horizon isn't scanned again until the horizon reaches its commit.
+  bool SetAllVisible(cid_t horizon_cid);
+
+  inline void ClearAllVisible() {
+    if (all_visible_cid.load() != INVALID_CID) {
+      all_visible_cid.store(INVALID_CID);
+    }
+  }
+
+  // Clear the bit without reading it first. Writers that don't fence after
+  // changing the header rely on this store being ordered after their writes:
+  // SetAllVisible() either sees the writes or has its bit overwritten.
+  inline void ResetAllVisible() {
+    all_visible_cid.store(INVALID_CID, std::memory_order_release);
+  }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Getter for spin lock
@@ -307,6 +383,22 @@ class TileGroupHeader : public Printable {
   // Immmutable Flag. Should be set by the brain to be true.
   // By default it will be set to false.
   bool immutable;
+
+  // the read-optimized copy of a cold tile group
+  std::atomic<FrozenBlock *> frozen_block;
+
+  // copies that were thawed while scans may still read them, with the epoch
+  // in which they were thawed
+  typedef std::pair<eid_t, std::unique_ptr<FrozenBlock>> ThawedBlock;
+  std::vector<ThawedBlock> thawed_blocks;
+
+  std::mutex thawed_blocks_mutex;
+
+  // the horizon at which all tuples are visible, INVALID_CID if unknown
+  std::atomic<cid_t> all_visible_cid;
+
+  // the horizon before which SetAllVisible() fails without scanning the tuples
+  std::atomic<cid_t> all_visible_retry_cid;
 };
 
 }  // namespace storage
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.h
+//
+// Identification: src/include/storage/zone_map.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/macros.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class TileGroup;
+struct PredicateInfo;
+
+//===--------------------------------------------------------------------===//
+// The zone map of one column of a tile group
+//
+// The bounds of integral columns (and timestamps) are stored as int64_t, and
+// those of decimal columns as the bits of a double. A column without non-null
+// values has min > max, so that no comparison can match it.
+//===--------------------------------------------------------------------===//
+struct ColumnZoneMap {
+  int64_t min;
+  int64_t max;
+  // The number of NULLs written into the column
+  uint32_t null_count;
+  // Whether the bounds of the column are tracked at all
+  uint32_t tracked;
+};
+
+//===--------------------------------------------------------------------===//
+// ZoneMap
+//
+// The min/max bounds of the fixed-width numeric columns of a tile group.
+//
+// The bounds are widened whenever a tuple is written, so they always cover
+// every version in the tile group. Writers widen them with CAS, and never
+// shrink them. Once the tile group becomes immutable, Freeze() recomputes
+// tight bounds from the tuples it still holds.
+//===--------------------------------------------------------------------===//
+class ZoneMap {
+ public:
+  ZoneMap(const TileGroup &tile_group);
+
+  // Widen the bounds to cover the tuple in the given slot
+  void UpdateTuple(TileGroup &tile_group, oid_t tuple_id);
+
+  // Recompute tight bounds, if the tile group is immutable
+  void Freeze(TileGroup &tile_group);
+
+  inline bool IsFrozen() const { return frozen_; }
+
+  // Take over the bounds of the same columns in another layout
+  void CopyBounds(const ZoneMap &other);
+
+  // Whether any tuple in the tile group may satisfy the conjunction of the
+  // predicates
+  bool ShouldScan(const PredicateInfo *predicates,
+                  int32_t num_predicates) const;
+
+  // Get the bounds of a tracked column. Returns false if the column has no
+  // non-null values or isn't tracked.
+  bool GetBounds(oid_t column_id, type::Value &min, type::Value &max) const;
+
+  uint32_t GetNullCount(oid_t column_id) const {
+    PL_ASSERT(column_id < column_types_.size());
+    return column_zone_maps_[column_id].null_count;
+  }
+
+  inline ColumnZoneMap *GetColumnZoneMaps() const {
+    return column_zone_maps_.get();
+  }
+
+  // Whether the bounds of columns of the type are tracked
+  static bool SupportsType(type::TypeId type_id);
+
+  // Convert a numeric constant into the bound it compares against. Returns
+  // false if the value is NULL or not numeric.
+  static bool GetNumericConstant(const type::Value &value, bool &is_decimal,
+                                 int64_t &integer_value,
+                                 double &decimal_value);
+
+ private:
+  // Reset the bounds of all columns to empty ones
+  static void ResetBounds(ColumnZoneMap *column_zone_maps,
+                          const std::vector<type::TypeId> &column_types);
+
+  // Widen the bounds with a value as it is stored in a tuple
+  static void WidenBounds(ColumnZoneMap &column_zone_map, type::TypeId type_id,
+                          const char *data);
+
+  // Whether a column with the bounds may satisfy the comparison
+  bool MayMatch(oid_t column_id, ExpressionType comparison,
+                const type::Value &value) const;
+
+  const char *GetColumnData(TileGroup &tile_group, oid_t tuple_id,
+                            oid_t column_id) const;
+
+  std::vector<type::TypeId> column_types_;
+  // The tile, and the offset in its tuples, of every column
+  std::vector<std::pair<oid_t, size_t>> column_locations_;
+  std::unique_ptr<ColumnZoneMap[]> column_zone_maps_;
+  bool frozen_;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -4,7 +4,7 @@
 //
 // mono_queue_pool.h
 //
-// Identification: test/threadpool/mono_queue_pool.h
+// Identification: src/include/threadpool/mono_queue_pool.h
 //
 // Copyright (c) 2015-17, Carnegie Mellon University Database Group
 //
@@ -17,20 +17,32 @@
 namespace peloton {
 namespace threadpool {
 
-// TODO: tune these variables
+// Defaults for the pool's settings
 constexpr static size_t kDefaultTaskQueueSize = 32;
 constexpr static size_t kDefaultWorkerPoolSize = 4;
 
+// The lane a task is submitted to
+enum class TaskPriority {
+  // Short statements that somebody is waiting on (the default)
+  LATENCY_SENSITIVE,
+  // Long-running or background work (e.g., ANALYZE, COPY, index builds)
+  BATCH,
+};
+
 /**
- * @brief Wrapper class for single queue and single pool.
+ * @brief Wrapper class for the system's task queues and worker pools.
  * One should use this if possible.
+ *
+ * Tasks are submitted to one of two lanes. The latency-sensitive lane is
+ * served by its own workers, which never pick up batch tasks, so a long batch
+ * task can't hold up short statements. The batch lane has its own (smaller)
+ * group of workers, which also steal latency-sensitive tasks when there is no
+ * batch work. The size of each group is configured through the
+ * worker_pool_size and batch_worker_pool_size settings.
  */
 class MonoQueuePool {
  public:
-  MonoQueuePool()
-      : task_queue_(kDefaultTaskQueueSize),
-        worker_pool_(kDefaultWorkerPoolSize, &task_queue_),
-        is_running_(false) {}
+  MonoQueuePool();
 
   ~MonoQueuePool() {
     if (is_running_) {
@@ -39,20 +51,23 @@ class MonoQueuePool {
   }
 
   void Startup() {
-    worker_pool_.Startup();
+    latency_workers_.Startup();
+    batch_workers_.Startup();
     is_running_ = true;
   }
 
   void Shutdown() {
-    worker_pool_.Shutdown();
+    latency_workers_.Shutdown();
+    batch_workers_.Shutdown();
     is_running_ = false;
   }
 
-  void SubmitTask(std::function<void()> func) {
-    if (!is_running_) {
-      Startup();
-    }
-    task_queue_.Enqueue(std::move(func));
+  void SubmitTask(std::function<void()> func,
+                  TaskPriority priority = TaskPriority::LATENCY_SENSITIVE);
+
+  size_t GetNumWorkers(TaskPriority priority) const {
+    return priority == TaskPriority::BATCH ? batch_workers_.GetNumWorkers()
+                                           : latency_workers_.GetNumWorkers();
   }
 
   static MonoQueuePool &GetInstance() {
@@ -61,8 +76,10 @@ class MonoQueuePool {
   }
 
  private:
-  TaskQueue task_queue_;
-  WorkerPool worker_pool_;
+  TaskQueue latency_queue_;
+  TaskQueue batch_queue_;
+  WorkerPool latency_workers_;
+  WorkerPool batch_workers_;
   bool is_running_;
 };
 
@@ -12,7 +12,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <thread>
 #include <vector>
 
 #include "common/container/lock_free_queue.h"
@@ -22,21 +24,30 @@ namespace threadpool {
 
 using TaskQueue = peloton::LockFreeQueue<std::function<void()>>;
 
-void WorkerFunc(std::atomic_bool *should_shutdown, TaskQueue *task_queue);
+// Workers poll the queues in the given order, taking the first task found
+void WorkerFunc(std::atomic_bool *should_shutdown,
+                const std::vector<TaskQueue *> *task_queues);
 
 /**
  * @brief A worker pool that maintains a group of worker threads.
+ * The workers serve one or more task queues. A task is only taken from a queue
+ * when all queues before it are empty, which lets a group of workers steal
+ * work from other groups' queues when their own queue runs dry.
  */
 class WorkerPool {
  public:
   WorkerPool(size_t num_workers, TaskQueue *task_queue)
+      : WorkerPool(num_workers, std::vector<TaskQueue *>{task_queue}) {}
+
+  WorkerPool(size_t num_workers, std::vector<TaskQueue *> task_queues)
       : num_workers_(num_workers),
         should_shutdown_(false),
-        task_queue_(task_queue) {}
+        task_queues_(std::move(task_queues)) {}
 
   void Startup() {
+    should_shutdown_ = false;
     for (size_t i = 0; i < num_workers_; i++) {
-      workers_.emplace_back(WorkerFunc, &should_shutdown_, task_queue_);
+      workers_.emplace_back(WorkerFunc, &should_shutdown_, &task_queues_);
     }
   }
 
@@ -48,11 +59,13 @@ class WorkerPool {
     workers_.clear();
   }
 
+  size_t GetNumWorkers() const { return num_workers_; }
+
  private:
   std::vector<std::thread> workers_;
   size_t num_workers_;
   std::atomic_bool should_shutdown_;
-  TaskQueue *task_queue_;
+  std::vector<TaskQueue *> task_queues_;
 };
 
 }  // namespace threadpool
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.h
+//
+// Identification: src/include/traffic_cop/plan_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/internal_types.h"
+#include "common/singleton.h"
+#include "common/statement.h"
+#include "common/synchronization/readwrite_latch.h"
+#include "planner/abstract_plan.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace tcop {
+
+//===----------------------------------------------------------------------===//
+// A server-wide cache of the plans of simple (i.e., not prepared) queries.
+//
+// Queries on the same database that differ only in the literals they compare
+// columns against share a single entry. The query text is normalized by replacing those literals
+// with parameter placeholders ($1, $2, ...). The normalized text is what gets
+// parsed and planned on a miss, so the cached plan is parameterized and the
+// extracted literals become its parameter values. Since the plan no longer
+// depends on the literals, the compiled query in the codegen::QueryCache is
+// reused as well.
+//
+// Cached plans are never executed directly: every hit gets its own copy of
+// the plan, which may be bound to parameters without affecting other users.
+// Hits only take the cache lock for reading, so the eviction order is an
+// approximation of LRU (CLOCK): a hit marks the entry as referenced, and
+// referenced entries get a second chance when they are up for eviction.
+//
+// Entries are invalidated when a table they reference is dropped or altered,
+// when an index of such a table is dropped, and when new statistics report a
+// table size that changed by more than kReplanRowRatio since the plan was
+// built. DDL clears the cache both when it starts and once its transaction has
+// finished, and plans that were built while the cache was cleared are not
+// added, so that no plan of the old catalog survives the DDL. The storage
+// layer and the statistics notify the cache through the hooks it registers.
+//===----------------------------------------------------------------------===//
+class PlanCache : public Singleton<PlanCache> {
+ public:
+  // Re-plan a query when the number of rows of a table it references grew or
+  // shrank by more than this factor
+  static constexpr double kReplanRowRatio = 2.0;
+
+  // Normalize the query text by replacing the literals that are compared
+  // against (or assigned to) a column with parameter placeholders. Returns
+  // false if the query can't be cached. On success, the normalized text is
+  // stored in normalized_query and the literals in param_values.
+  static bool Normalize(const std::string &query,
+                        std::string &normalized_query,
+                        std::vector<type::Value> &param_values);
+
+  // Find the plan of a normalized query on the database, given the parameter
+  // values that were extracted from it. Returns a new statement owning a copy
+  // of the cached plan, or nullptr if there is no (valid) cached plan.
+  std::shared_ptr<Statement> Find(
+      const std::string &database_name, const std::string &normalized_query,
+      const std::vector<type::Value> &param_values,
+      const std::string &statement_name, const std::string &query_string);
+
+  // Add the plan of a prepared (but not yet bound) statement for the
+  // normalized query on the database. The version is the one of the cache before planning
+  // started. Plans that can't be copied, or that were built while the cache
+  // was cleared, are not cached.
+  void Add(const std::string &database_name,
+           const std::string &normalized_query,
+           const std::vector<type::Value> &param_values,
+           const Statement &statement, uint64_t version);
+
+  // Remove all the plans in the cache
+  void Clear();
+
+  // Get the version of the cache, which changes whenever it is cleared
+  uint64_t GetVersion() const { return version_.load(); }
+
+  // Remove all the plans that reference the table
+  void Remove(oid_t table_oid);
+
+  // Record the number of rows in the table reported by new statistics, and
+  // remove the plans that were built when the table had a very different size
+  void UpdateTableStats(oid_t table_oid, size_t num_rows);
+
+  // Copy a plan tree, including all its children. Returns nullptr if some
+  // plan in the tree doesn't support copying.
+  static std::unique_ptr<planner::AbstractPlan> CopyPlanTree(
+      const planner::AbstractPlan *plan);
+
+  //===--------------------------------------------------------------------===//
+  // ACCESSORS
+  //===--------------------------------------------------------------------===//
+
+  // Get the number of plans currently cached
+  size_t GetCount() const;
+
+  uint64_t GetNumHits() const { return num_hits_; }
+
+  uint64_t GetNumMisses() const { return num_misses_; }
+
+ private:
+  friend class Singleton<PlanCache>;
+
+  PlanCache();
+
+  ~PlanCache();
+
+  struct Entry {
+    std::string key;
+    // Whether the entry was found since it was added or given a second chance
+    std::atomic<bool> referenced{false};
+    QueryType query_type;
+    // The parameterized plan, as produced by the optimizer
+    std::unique_ptr<planner::AbstractPlan> plan;
+    std::vector<FieldInfo> tuple_descriptor;
+    std::set<oid_t> table_oids;
+    // The number of rows in the referenced tables when the plan was built.
+    // Tables without statistics at that time are missing.
+    std::unordered_map<oid_t, size_t> table_rows;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  // The normalized query text, qualified by the database and the types of its
+  // parameters
+  static std::string MakeKey(const std::string &database_name,
+                             const std::string &normalized_query,
+                             const std::vector<type::Value> &param_values);
+
+  // Whether a plan built for a table of planned_rows rows should be rebuilt
+  // for a table of num_rows rows
+  static bool NeedsReplan(size_t planned_rows, size_t num_rows);
+
+  // Remove the entry. Must hold the cache lock for writing.
+  void Erase(EntryList::iterator it);
+
+  // Remove the first entry from the back of the list that wasn't referenced,
+  // moving the referenced ones to the front. Must hold the cache lock for
+  // writing.
+  void EvictOne();
+
+ private:
+  // The entries, in the order they were added or given a second chance
+  EntryList entry_list_;
+
+  std::unordered_map<std::string, EntryList::iterator> cache_map_;
+
+  // The number of rows of each table in its latest statistics
+  std::unordered_map<oid_t, size_t> table_rows_;
+
+  common::synchronization::ReadWriteLatch cache_lock_;
+
+  std::atomic<uint64_t> version_{0};
+
+  std::atomic<uint64_t> num_hits_{0};
+  std::atomic<uint64_t> num_misses_{0};
+};
+
+}  // namespace tcop
+}  // namespace peloton
@@ -34,6 +34,10 @@ namespace concurrency {
 class TransactionContext;
 }  // namespace concurrency
 
+namespace threadpool {
+enum class TaskPriority;
+}  // namespace threadpool
+
 namespace tcop {
 
 //===--------------------------------------------------------------------===//
@@ -72,6 +76,16 @@ class TrafficCop {
       const std::vector<int> &result_format, std::vector<ResultValue> &result,
       std::string &error_message, size_t thread_id = 0);
 
+  // Whether the plan is cheap enough to run to completion on the network
+  // thread when inline_execution is set: inserts of literal rows, and index
+  // lookups, updates and deletes by equality on all the key columns
+  static bool IsInlinePlan(const planner::AbstractPlan *plan);
+
+  // The worker pool lane of the plan. Maintenance statements, and plans that
+  // may read at least batch_task_min_tuples tuples, go to the batch lane.
+  static threadpool::TaskPriority GetTaskPriority(
+      const planner::AbstractPlan *plan);
+
   // Helper to handle txn-specifics for the plan-tree of a statement.
   executor::ExecutionResult ExecuteHelper(
       std::shared_ptr<planner::AbstractPlan> plan,
@@ -88,6 +102,14 @@ class TrafficCop {
       const std::vector<std::unique_ptr<expression::AbstractExpression>> &,
       std::string &error_message, const size_t thread_id = 0);
 
+  // Prepare a simple query using the plan cache. Returns false if the query
+  // can't be cached. Otherwise the prepared statement (nullptr on error) and
+  // the literals extracted from the query become the current statement and
+  // parameter values.
+  bool PrepareCachedStatement(const std::string &query_string,
+                              std::string &error_message,
+                              const size_t thread_id = 0);
+
   std::vector<FieldInfo> GenerateTupleDescriptor(
       parser::SQLStatement *select_stmt);
 
@@ -109,6 +131,16 @@ class TrafficCop {
     task_callback_arg_ = task_callback_arg;
   }
 
+  // Set the callback that the result rows of queries executed by the worker
+  // pool are handed to in batches, on the worker thread, instead of being
+  // returned once the query has finished
+  void SetResultCallback(
+      void (*result_callback)(void *, std::vector<ResultValue> &),
+      void *result_callback_arg) {
+    result_callback_ = result_callback;
+    result_callback_arg_ = result_callback_arg;
+  }
+
   void setRowsAffected(int rows_affected) { rows_affected_ = rows_affected; }
 
   void ProcessInvalidStatement();
@@ -176,12 +208,20 @@ class TrafficCop {
   // flag of single statement txn
   bool single_statement_txn_;
 
+  // whether the current txn ran DDL, so that the plan cache must be cleared
+  // once it has finished
+  bool clear_plan_cache_ = false;
+
   std::vector<ResultValue> result_;
 
   // The current callback to be invoked after execution completes.
   void (*task_callback_)(void *);
   void *task_callback_arg_;
 
+  // The callback invoked with each batch of result rows
+  void (*result_callback_)(void *, std::vector<ResultValue> &) = nullptr;
+  void *result_callback_arg_ = nullptr;
+
   // pair of txn ptr and the result so-far for that txn
   // use a stack to support nested-txns
   using TcopTxnState = std::pair<concurrency::TransactionContext *, ResultType>;
@@ -195,6 +235,9 @@ class TrafficCop {
 
   ResultType AbortQueryHelper();
 
+  // Clear the plan cache if the txn that just finished ran DDL
+  void ClearPlanCacheAfterDDL();
+
   // Get all data tables from a TableRef.
   // For multi-way join
   // still a HACK
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 #include "index/bwtree_index.h"
 
+#include <type_traits>
+
 #include "common/logger.h"
 #include "index/index_key.h"
 #include "index/scan_optimizer.h"
@@ -116,6 +118,32 @@ bool BWTREE_INDEX_TYPE::CondInsertEntry(
   return ret;
 }
 
+/*
+ * BulkLoad() - Builds the tree from the entries bottom-up
+ *
+ * If the tree is not empty then the entries are inserted one by one
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+bool BWTREE_INDEX_TYPE::BulkLoad(const std::vector<IndexEntryRef> &entries) {
+  std::vector<std::pair<KeyType, ValueType>> items(entries.size());
+  for (size_t i = 0; i < entries.size(); i++) {
+    items[i].first.SetFromKey(entries[i].first);
+    items[i].second = entries[i].second;
+  }
+
+  if (container.BulkLoad(items) == false) {
+    return Index::BulkLoad(entries);
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    for (size_t i = 0; i < entries.size(); i++) {
+      stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+    }
+  }
+
+  return true;
+}
+
 /*
  * Scan() - Scans a range inside the index using index scan optimizer
  *
@@ -191,6 +219,82 @@ void BWTREE_INDEX_TYPE::Scan(
   return;
 }
 
+/*
+ * ScanEntries() - Scan the index like Scan() does, copying the keys
+ *
+ * Index-only scans read the values of the key columns from the copies,
+ * instead of from the tuples in the table
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+bool BWTREE_INDEX_TYPE::ScanEntries(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<IndexEntry> &result,
+    const ConjunctionScanPredicate *csp_p, type::AbstractPool *pool) {
+  // A tuple key only points to the tuple it was built from
+  if (std::is_same<KeyType, TupleKey>::value) {
+    return false;
+  }
+
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  const catalog::Schema *key_schema = metadata->GetKeySchema();
+  oid_t column_count = key_schema->GetColumnCount();
+  auto add_entry = [&result, key_schema, column_count, pool](
+      const storage::Tuple &key, ItemPointer *value) {
+    std::unique_ptr<storage::Tuple> key_copy(
+        new storage::Tuple(key_schema, true));
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      key_copy->SetValue(column_id, key.GetValue(column_id), pool);
+    }
+    result.emplace_back(std::move(key_copy), value);
+  };
+
+  size_t old_size = result.size();
+  if (csp_p == nullptr || csp_p->IsFullIndexScan() == true) {
+    for (auto scan_itr = container.Begin(); (scan_itr.IsEnd() == false);
+         scan_itr++) {
+      KeyType key = scan_itr->first;
+      add_entry(key.GetTupleForComparison(key_schema), scan_itr->second);
+    }
+  } else if (csp_p->IsPointQuery() == true) {
+    // All the entries have the point query key
+    const storage::Tuple *point_query_key_p = csp_p->GetPointQueryKey();
+
+    KeyType point_query_key;
+    point_query_key.SetFromKey(point_query_key_p);
+
+    std::vector<ValueType> values;
+    container.GetValue(point_query_key, values);
+    for (auto value : values) {
+      add_entry(*point_query_key_p, value);
+    }
+  } else {
+    KeyType index_low_key;
+    KeyType index_high_key;
+    index_low_key.SetFromKey(csp_p->GetLowKey());
+    index_high_key.SetFromKey(csp_p->GetHighKey());
+
+    for (auto scan_itr = container.Begin(index_low_key);
+         (scan_itr.IsEnd() == false) &&
+             (container.KeyCmpLessEqual(scan_itr->first, index_high_key));
+         scan_itr++) {
+      KeyType key = scan_itr->first;
+      add_entry(key.GetTupleForComparison(key_schema), scan_itr->second);
+    }
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size() - old_size, metadata);
+  }
+
+  return true;
+}
+
 /*
  * ScanLimit() - Scan the index with predicate and limit/offset
  *
@@ -274,6 +378,28 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
   return;
 }
 
+/*
+ * ScanKeyBatch() - Looks the keys up with interleaved traversals
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_INDEX_TYPE::ScanKeyBatch(
+    const std::vector<const storage::Tuple *> &keys,
+    std::vector<std::vector<ValueType>> &results) {
+  std::vector<KeyType> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+  }
+
+  container.GetValueBatch(index_keys, results);
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    for (auto &result : results) {
+      stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+          result.size(), metadata);
+    }
+  }
+}
+
 BWTREE_TEMPLATE_ARGUMENTS
 std::string BWTREE_INDEX_TYPE::GetTypeName() const { return "BWTree"; }
 
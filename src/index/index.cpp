@@ -15,6 +15,8 @@
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
+#include "expression/abstract_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "index/scan_optimizer.h"
 #include "storage/tuple.h"
 #include "type/ephemeral_pool.h"
@@ -78,6 +80,7 @@ IndexMetadata::IndexMetadata(std::string index_name, oid_t index_oid,
     PL_ASSERT(tuple_column_id < tuple_attrs.size());
 
     tuple_attrs[tuple_column_id] = i;
+    referenced_columns_.insert(tuple_column_id);
   }
 
   // Just in case somebody forgets they set our flag to default and
@@ -100,6 +103,47 @@ IndexMetadata::~IndexMetadata() {
   return;
 }
 
+// Collect the table columns the expression reads
+static void GetExpressionColumns(const expression::AbstractExpression *expr,
+                                 std::set<oid_t> &columns) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    columns.insert(
+        static_cast<const expression::TupleValueExpression *>(expr)
+            ->GetColumnId());
+  }
+  for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+    GetExpressionColumns(expr->GetChild(i), columns);
+  }
+}
+
+void IndexMetadata::SetPredicate(
+    std::shared_ptr<expression::AbstractExpression> predicate) {
+  PL_ASSERT(predicate != nullptr);
+  predicate_ = predicate;
+  GetExpressionColumns(predicate_.get(), referenced_columns_);
+}
+
+void IndexMetadata::SetKeyExpressions(
+    std::vector<std::shared_ptr<expression::AbstractExpression>>
+        key_expressions) {
+  PL_ASSERT(key_expressions.size() == key_attrs.size());
+  key_expressions_ = std::move(key_expressions);
+  for (auto &key_expression : key_expressions_) {
+    if (key_expression != nullptr) {
+      GetExpressionColumns(key_expression.get(), referenced_columns_);
+    }
+  }
+}
+
+const expression::AbstractExpression *IndexMetadata::GetKeyExpression(
+    oid_t key_column_id) const {
+  if (key_expressions_.empty()) {
+    return nullptr;
+  }
+  PL_ASSERT(key_column_id < key_expressions_.size());
+  return key_expressions_[key_column_id].get();
+}
+
 const std::string IndexMetadata::GetInfo() const {
   std::stringstream os;
 
@@ -110,7 +154,9 @@ const std::string IndexMetadata::GetInfo() const {
      << "ConstraintType=" << IndexConstraintTypeToString(index_constraint_type_)
      << ", "
      << "UtilityRatio=" << utility_ratio << ", "
-     << "Visible=" << visible_ << "]";
+     << "Visible=" << visible_ << ", "
+     << "Partial=" << IsPartial() << ", "
+     << "KeyExpressions=" << HasKeyExpressions() << "]";
 
   os << " -> " << key_schema->GetInfo();
 
@@ -129,7 +175,7 @@ const std::string IndexMetadata::GetInfo() const {
  * for destructing the metadata object on its own destruction
  */
 Index::Index(IndexMetadata *metadata)
-    : metadata(metadata), indexed_tile_group_offset(0) {
+    : metadata(metadata), indexed_tile_group_offset(0), building(false) {
   // This is redundant
   index_oid = metadata->GetOid();
 
@@ -157,6 +203,164 @@ Index::~Index() {
   return;
 }
 
+/*
+ * StartBuild() - Makes writers log their entries until FinishBuild()
+ */
+void Index::StartBuild(bool log_entries) {
+  std::lock_guard<std::mutex> lock(build_log_latch);
+  PL_ASSERT(building.load() == false);
+  this->log_entries = log_entries;
+  building.store(true);
+}
+
+/*
+ * LogEntry() - Logs the entry of a writer while the index is being built
+ *
+ * The key is copied, since writers build their keys in temporary tuples.
+ * Writers only take the latch while the index is building.
+ */
+bool Index::LogEntry(const storage::Tuple *key, ItemPointer *location_ptr) {
+  return LogBuildEntry(key, location_ptr, false);
+}
+
+/*
+ * LogDeleteEntry() - Logs the removal of an entry while the index is being
+ *                    built
+ *
+ * Indexes that are loaded later from a scan of their table skip the removal,
+ * since GC clears the entry of the version before it removes it.
+ */
+bool Index::LogDeleteEntry(const storage::Tuple *key,
+                           ItemPointer *location_ptr) {
+  return LogBuildEntry(key, location_ptr, true);
+}
+
+bool Index::LogBuildEntry(const storage::Tuple *key, ItemPointer *location_ptr,
+                          bool is_delete) {
+  if (building.load() == false) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(build_log_latch);
+  // The build may have finished while we waited
+  if (building.load() == false) {
+    return false;
+  }
+  if (log_entries == false) {
+    return true;
+  }
+  std::unique_ptr<storage::Tuple> key_copy(
+      new storage::Tuple(metadata->GetKeySchema(), true));
+  key_copy->Copy(key->GetData(), pool);
+  build_log.push_back(LoggedEntry{IndexEntry(std::move(key_copy), location_ptr),
+                                  is_delete});
+  return true;
+}
+
+/*
+ * FinishBuild() - Applies the logged entries and removals and stops logging
+ *
+ * Every entry is applied, even after one failed, so that the index stays
+ * consistent with the table if the caller keeps it.
+ */
+bool Index::FinishBuild(
+    const std::function<bool(const storage::Tuple *, ItemPointer *)> &apply) {
+  std::lock_guard<std::mutex> lock(build_log_latch);
+  bool success = true;
+  for (auto &logged_entry : build_log) {
+    auto &entry = logged_entry.entry;
+    if (logged_entry.is_delete) {
+      DeleteEntry(entry.first.get(), entry.second);
+    } else if (apply(entry.first.get(), entry.second) == false) {
+      success = false;
+    }
+  }
+  build_log.clear();
+  building.store(false);
+  return success;
+}
+
+/*
+ * BulkLoad() - Inserts the entries one by one
+ */
+bool Index::BulkLoad(const std::vector<IndexEntryRef> &entries) {
+  bool success = true;
+  for (auto &entry : entries) {
+    if (InsertEntry(entry.first, entry.second) == false) {
+      success = false;
+    }
+  }
+  return success;
+}
+
+/*
+ * ScanEntries() - Returns false, since the keys aren't kept
+ */
+bool Index::ScanEntries(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
+    UNUSED_ATTRIBUTE std::vector<IndexEntry> &result,
+    UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p,
+    UNUSED_ATTRIBUTE type::AbstractPool *pool) {
+  return false;
+}
+
+/*
+ * CoversTuple() - Evaluates the predicate of a partial index on the tuple
+ *
+ * A predicate that evaluates to NULL doesn't cover the tuple, like a WHERE
+ * clause doesn't select it.
+ */
+bool Index::CoversTuple(const AbstractTuple *tuple) const {
+  auto predicate = metadata->GetPredicate();
+  if (predicate == nullptr) {
+    return true;
+  }
+  return predicate->Evaluate(tuple, nullptr, nullptr).IsTrue();
+}
+
+/*
+ * BuildKey() - Copies the indexed columns of the tuple into the key, and
+ *              evaluates the key expressions on it
+ */
+void Index::BuildKey(const AbstractTuple *tuple, storage::Tuple *key) const {
+  auto key_schema = metadata->GetKeySchema();
+  if (metadata->HasKeyExpressions() == false) {
+    key->SetFromTuple(tuple, key_schema->GetIndexedColumns(), pool);
+    return;
+  }
+
+  auto &key_attrs = metadata->GetKeyAttrs();
+  for (oid_t key_column_id = 0; key_column_id < key_attrs.size();
+       key_column_id++) {
+    auto key_expression = metadata->GetKeyExpression(key_column_id);
+    if (key_expression == nullptr) {
+      key->SetValue(key_column_id, tuple->GetValue(key_attrs[key_column_id]),
+                    pool);
+      continue;
+    }
+    type::Value value = key_expression->Evaluate(tuple, nullptr, nullptr);
+    type::TypeId key_type = key_schema->GetType(key_column_id);
+    if (value.GetTypeId() != key_type) {
+      value = value.CastAs(key_type);
+    }
+    key->SetValue(key_column_id, value, pool);
+  }
+}
+
+/*
+ * ScanKeyBatch() - Looks the keys up one by one
+ */
+void Index::ScanKeyBatch(const std::vector<const storage::Tuple *> &keys,
+                         std::vector<std::vector<ItemPointer *>> &results) {
+  results.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    ScanKey(keys[i], results[i]);
+  }
+}
+
 /*
  * TupleColumnToKeyColumn() - Converts a column ID in the table to a column ID
  *                            in the index key
@@ -49,7 +49,8 @@ void Usage() {
       "   -w --write_ratio                    :  Fraction of writes\n"
       "   -x --index_count_threshold          :  Index count threshold\n"
       "   -y --index_utility_threshold        :  Index utility threshold\n"
-      "   -z --write_ratio_threshold          :  Write ratio threshold\n");
+      "   -z --write_ratio_threshold          :  Write ratio threshold\n"
+      "   -B --transform_bandwidth            :  Layout tuner KB per second\n");
 
   exit(EXIT_FAILURE);
 }
@@ -78,6 +79,7 @@ static struct option opts[] = {
     {"index_utility_threshold", optional_argument, NULL, 'y'},
     {"write_ratio_threshold", optional_argument, NULL, 'z'},
     {"multi_stage", optional_argument, NULL, 'n'},
+    {"transform_bandwidth", optional_argument, NULL, 'B'},
     {"holistic_indexing", optional_argument, NULL, 'r'},
     {NULL, 0, NULL, 0}};
 
@@ -194,6 +196,15 @@ static void ValidateLayout(const configuration &state) {
   }
 }
 
+static void ValidateTransformBandwidth(const configuration &state) {
+  if (state.transform_bandwidth < 0) {
+    LOG_ERROR("Invalid transform_bandwidth :: %d", state.transform_bandwidth);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %d", "transform_bandwidth", state.transform_bandwidth);
+}
+
 static void ValidateProjectivity(const configuration &state) {
   if (state.projectivity < 0 || state.projectivity > 1) {
     LOG_ERROR("Invalid projectivity :: %.1lf", state.projectivity);
@@ -399,6 +410,7 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
 
   // Layout parameter
   state.layout_mode = LayoutType::ROW;
+  state.transform_bandwidth = 0;
 
   // Learning rate
   state.analyze_sample_count_threshold = 100;
@@ -425,13 +437,13 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   while (1) {
     int idx = 0;
     int c = getopt_long(argc, argv,
-                        "a:b:c:d:e:f:g:hi:j:k:l:m:n:o:p:q:r:s:t:u:v:w:x:y:z:",
+                        "a:b:c:d:e:f:g:hi:j:k:l:m:n:o:p:q:r:s:t:u:v:w:x:y:z:B:",
                         opts, &idx);
 
     if (c == -1) break;
 
     switch (c) {
-      // AVAILABLE FLAGS: rABCDEFGHIJKLMNOPQRSTUVWXYZ
+      // AVAILABLE FLAGS: rACDEFGHIJKLMNOPQRSTUVWXYZ
       case 'a':
         state.attribute_count = atoi(optarg);
         break;
@@ -510,6 +522,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'z':
         state.write_ratio_threshold = atof(optarg);
         break;
+      case 'B':
+        state.transform_bandwidth = atoi(optarg);
+        break;
 
       default:
         LOG_ERROR("Unknown option: -%c-", c);
@@ -547,6 +562,7 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   ValidateSelectivity(state);
   ValidateProjectivity(state);
   ValidateLayout(state);
+  ValidateTransformBandwidth(state);
   ValidateIndexCountThreshold(state);
   ValidateIndexUtilityThreshold(state);
   ValidateWriteRatioThreshold(state);
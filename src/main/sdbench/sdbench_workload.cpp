@@ -1392,6 +1392,8 @@ void BenchmarkPrepare() {
   // Start layout tuner
   if (state.layout_mode == LayoutType::HYBRID) {
     layout_tuner.AddTable(sdbench_table.get());
+    layout_tuner.SetTransformBandwidth(
+        static_cast<size_t>(state.transform_bandwidth) * 1024);
 
     // Start layout tuner
     layout_tuner.Start();
@@ -1411,6 +1413,13 @@ void BenchmarkCleanUp() {
   if (state.layout_mode == LayoutType::HYBRID) {
     layout_tuner.Stop();
     layout_tuner.ClearTables();
+
+    LOG_INFO("Tile groups transformed : %lu",
+             layout_tuner.GetTransformedTileGroupCount());
+    LOG_INFO("Tile groups skipped : %lu",
+             layout_tuner.GetSkippedTileGroupCount());
+    LOG_INFO("Bytes transformed : %lu", layout_tuner.GetTransformedBytes());
+    LOG_INFO("Scan speedup : %.2lf", layout_tuner.GetScanSpeedup());
   }
 
   // Drop Indexes
@@ -36,6 +36,7 @@
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/data_table.h"
+#include "storage/index_builder.h"
 #include "storage/table_factory.h"
 #include "storage/database.h"
 #include "common/internal_types.h"
@@ -1707,6 +1708,15 @@ void LoadTPCCDatabase() {
   std::chrono::steady_clock::time_point start_time;
   start_time = std::chrono::steady_clock::now();
 
+  // Bulk load the indexes once the tuples are in
+  std::vector<storage::DataTable *> tables = {
+      warehouse_table, district_table, item_table,
+      customer_table, history_table, stock_table,
+      orders_table, new_order_table, order_line_table};
+  for (auto table : tables) {
+    storage::IndexBuilder::DeferIndexes(table);
+  }
+
   LoadItems();
 
   if (state.warehouse_count < state.loader_count) {
@@ -1739,6 +1749,14 @@ void LoadTPCCDatabase() {
     }
   }
 
+  for (auto table : tables) {
+    if (storage::IndexBuilder::BuildDeferredIndexes(table) == false) {
+      LOG_ERROR("Loaded tuples violate the indexes of table %s",
+                table->GetName().c_str());
+      exit(EXIT_FAILURE);
+    }
+  }
+
   std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
   UNUSED_ATTRIBUTE double diff = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
   LOG_INFO("database loading time = %lf ms", diff);
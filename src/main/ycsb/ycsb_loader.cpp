@@ -34,6 +34,7 @@
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/data_table.h"
+#include "storage/index_builder.h"
 #include "storage/table_factory.h"
 #include "storage/database.h"
 
@@ -178,6 +179,9 @@ void LoadYCSBDatabase() {
   const int tuple_count = state.scale_factor * 1000;
   int row_per_thread = tuple_count / state.loader_count;
   
+  // Bulk load the indexes once the tuples are in
+  storage::IndexBuilder::DeferIndexes(user_table);
+
   std::vector<std::unique_ptr<std::thread>> load_threads(state.loader_count);
 
   for (int thread_id = 0; thread_id < state.loader_count - 1; ++thread_id) {
@@ -195,6 +199,12 @@ void LoadYCSBDatabase() {
     load_threads[thread_id]->join();
   }
 
+  if (storage::IndexBuilder::BuildDeferredIndexes(user_table) == false) {
+    LOG_ERROR("Loaded tuples violate the indexes of table %s",
+              user_table->GetName().c_str());
+    exit(EXIT_FAILURE);
+  }
+
   std::chrono::steady_clock::time_point end_time = std::chrono::steady_clock::now();
   double diff = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
   LOG_INFO("database table loading time = %lf ms", diff);
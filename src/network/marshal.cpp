@@ -166,6 +166,12 @@ void PacketPutInt(OutputPacket *pkt, int n, int base) {
   PacketPutCbytes(pkt, reinterpret_cast<uchar *>(&n), base);
 }
 
+void PacketPutIntAt(OutputPacket *pkt, size_t offset, int n) {
+  PL_ASSERT(offset + sizeof(int32_t) <= pkt->len);
+  n = htonl(n);
+  PL_MEMCPY(&pkt->buf[offset], &n, sizeof(int32_t));
+}
+
 void PacketPutCbytes(OutputPacket *pkt, const uchar *b, int len) {
   pkt->buf.insert(std::end(pkt->buf), b, b + len);
   pkt->len += len;
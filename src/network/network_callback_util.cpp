@@ -23,7 +23,6 @@ void CallbackUtil::WorkerHandleNewConn(evutil_socket_t new_conn_recv_fd,
   // buffer used to receive messages from the main thread
   char m_buf[1];
   std::shared_ptr<NewConnQueueItem> item;
-  NetworkConnection *conn;
   NetworkWorkerThread *thread = static_cast<NetworkWorkerThread *>(arg);
 
   // pipe fds should match
@@ -40,20 +39,7 @@ void CallbackUtil::WorkerHandleNewConn(evutil_socket_t new_conn_recv_fd,
     case 'c': {
       // fetch the new connection fd from the queue
       thread->new_conn_queue.Dequeue(item);
-      conn = NetworkManager::GetConnection(item->new_conn_fd);
-      if (conn == nullptr) {
-        LOG_DEBUG("Creating new socket fd:%d", item->new_conn_fd);
-        /* create a new connection object */
-        NetworkManager::CreateNewConnection(item->new_conn_fd, item->event_flags,
-                                            static_cast<NetworkThread *>(thread),
-                                            ConnState::CONN_READ);
-      } else {
-        LOG_DEBUG("Reusing socket fd:%d", item->new_conn_fd);
-        /* otherwise reset and reuse the existing conn object */
-        conn->Reset();
-        conn->Init(item->event_flags, static_cast<NetworkThread *>(thread),
-                   ConnState::CONN_READ);
-      }
+      thread->HandleNewConnection(item->new_conn_fd, item->event_flags);
       break;
     }
 
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <poll.h>
 #include <unistd.h>
 #include "network/postgres_protocol_handler.h"
 #include "network/network_connection.h"
@@ -76,6 +77,7 @@ void NetworkConnection::Init(short event_flags, NetworkThread *thread,
 
   //TODO:: should put the initialization else where.. check correctness first.
   traffic_cop_.SetTaskCallback(TriggerStateMachine, workpool_event);
+  traffic_cop_.SetResultCallback(SendResultBatch, this);
 }
 
 void NetworkConnection::TriggerStateMachine(void* arg) {
@@ -83,6 +85,42 @@ void NetworkConnection::TriggerStateMachine(void* arg) {
   event_active(event, EV_WRITE, 0);
 }
 
+void NetworkConnection::SendResultBatch(void *arg,
+                                        std::vector<ResultValue> &batch) {
+  auto conn = static_cast<NetworkConnection *>(arg);
+
+  // The query may produce rows before the state machine has handed over
+  std::unique_lock<std::mutex> lock(conn->result_mutex_);
+  conn->result_cv_.wait(lock, [conn] { return conn->waiting_for_result_; });
+  if (conn->result_write_error_) {
+    // The connection is going to be closed anyway
+    return;
+  }
+
+  // Send the rows after whatever responses are still queued, waiting for a
+  // slow client rather than buffering the whole result. Rows of a pipelined
+  // extended-protocol batch stay in the buffer until its Sync, the flag is
+  // left for the final responses of the query
+  conn->protocol_handler_->SendResultBatch(batch);
+  conn->result_lock_ = &lock;
+  auto result = conn->BufferPackets();
+  if (result == WriteState::WRITE_COMPLETE &&
+      conn->protocol_handler_->GetFlushFlag()) {
+    result = conn->FlushWriteBuffer();
+  }
+  conn->result_lock_ = nullptr;
+  if (result != WriteState::WRITE_COMPLETE) {
+    LOG_ERROR("Error while sending result rows");
+    conn->result_write_error_ = true;
+  }
+}
+
+void NetworkConnection::SetWaitingForResult(bool waiting) {
+  std::lock_guard<std::mutex> lock(result_mutex_);
+  waiting_for_result_ = waiting;
+  result_cv_.notify_all();
+}
+
 void NetworkConnection::TransitState(ConnState next_state) {
 #ifdef LOG_TRACE_ENABLED
   if (next_state != state)
@@ -123,6 +161,22 @@ bool NetworkConnection::UpdateEvent(short flags) {
  */
 
 WriteState NetworkConnection::WritePackets() {
+  auto result = BufferPackets();
+  if (result != WriteState::WRITE_COMPLETE) return result;
+
+  if (protocol_handler_->GetFlushFlag()) {
+    result = FlushWriteBuffer();
+    if (result == WriteState::WRITE_COMPLETE) {
+      // we have flushed, disable force flush now
+      protocol_handler_->SetFlushFlag(false);
+    }
+    return result;
+  }
+
+  return WriteState::WRITE_COMPLETE;
+}
+
+WriteState NetworkConnection::BufferPackets() {
   // iterate through all the packets
   for (; next_response_ < protocol_handler_->responses.size(); next_response_++) {
     auto pkt = protocol_handler_->responses[next_response_].get();
@@ -138,13 +192,6 @@ WriteState NetworkConnection::WritePackets() {
   protocol_handler_->responses.clear();
   next_response_ = 0;
 
-  if (protocol_handler_->GetFlushFlag()) {
-    return FlushWriteBuffer();
-  }
-
-  // we have flushed, disable force flush now
-  protocol_handler_->SetFlushFlag(false);
-
   return WriteState::WRITE_COMPLETE;
 }
 
@@ -253,6 +300,8 @@ ReadState NetworkConnection::FillReadBuffer() {
 
 WriteState NetworkConnection::FlushWriteBuffer() {
   ssize_t written_bytes = 0;
+  // counted before the client can see the bytes
+  if (wbuf_.buf_size > 0) flush_count_++;
   // while we still have outstanding bytes to write
   while (wbuf_.buf_size > 0) {
     written_bytes = 0;
@@ -311,6 +360,21 @@ WriteState NetworkConnection::FlushWriteBuffer() {
           // Write would have blocked if the socket was
           // in blocking mode. Wait till it's readable
         } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          if (result_lock_ != nullptr) {
+            // The worker must not touch the events of the event loop. The
+            // state machine leaves the buffers alone until the query is
+            // done, so the lock need not be held while the client is slow
+            struct pollfd poll_fd = {sock_fd, POLLOUT, 0};
+            result_lock_->unlock();
+            auto ready = poll(&poll_fd, 1, -1);
+            auto poll_errno = errno;
+            result_lock_->lock();
+            if (ready < 0 && poll_errno != EINTR) {
+              return WriteState::WRITE_ERROR;
+            }
+            written_bytes = 0;
+            continue;
+          }
           // Listen for socket being enabled for write
           if (!UpdateEvent(EV_WRITE | EV_PERSIST)) {
             return WriteState::WRITE_ERROR;
@@ -619,6 +683,8 @@ void NetworkConnection::Reset() {
   traffic_cop_.Reset();
   next_response_ = 0;
   ssl_sent_ = false;
+  waiting_for_result_ = false;
+  result_write_error_ = false;
 }
 
 void NetworkConnection::StateMachine(NetworkConnection *conn) {
@@ -634,9 +700,18 @@ void NetworkConnection::StateMachine(NetworkConnection *conn) {
             accept(conn->sock_fd, (struct sockaddr *)&addr, &addrlen);
         if (new_conn_fd == -1) {
           LOG_ERROR("Failed to accept");
+          done = true;
+          break;
+        }
+        if (conn->thread->GetThreadID() == MASTER_THREAD_ID) {
+          // The master hands the connection off to one of the workers
+          (static_cast<NetworkMasterThread *>(conn->thread))
+              ->DispatchConnection(new_conn_fd, EV_READ | EV_PERSIST);
+        } else {
+          // A worker with its own listening socket keeps the connection
+          (static_cast<NetworkWorkerThread *>(conn->thread))
+              ->HandleNewConnection(new_conn_fd, EV_READ | EV_PERSIST);
         }
-        (static_cast<NetworkMasterThread *>(conn->thread))
-            ->DispatchConnection(new_conn_fd, EV_READ | EV_PERSIST);
         done = true;
         break;
       }
@@ -745,6 +820,7 @@ void NetworkConnection::StateMachine(NetworkConnection *conn) {
             }
             LOG_TRACE("ProcessResult: queueing");
             conn->TransitState(ConnState::CONN_GET_RESULT);
+            conn->SetWaitingForResult(true);
             done = true;
             break;
           }
@@ -754,12 +830,19 @@ void NetworkConnection::StateMachine(NetworkConnection *conn) {
       }
 
       case ConnState::CONN_GET_RESULT: {
+        // The worker has sent its last rows before it triggered us
+        conn->SetWaitingForResult(false);
         if (event_add(conn->network_event, nullptr) < 0) {
           LOG_ERROR("Failed to add event");
           PL_ASSERT(false);
         }
         conn->protocol_handler_->GetResult();
         conn->traffic_cop_.SetQueuing(false);
+        if (conn->result_write_error_) {
+          conn->result_write_error_ = false;
+          conn->TransitState(ConnState::CONN_CLOSING);
+          break;
+        }
         conn->TransitState(ConnState::CONN_WRITE);
         break;
       }
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 #include "event2/thread.h"
 #include <fstream>
+#include <mutex>
 
 #include "network/network_manager.h"
 
@@ -31,7 +32,15 @@ NetworkManager::GetGlobalSocketList() {
   return global_socket_list;
 }
 
+// Connections are created by every thread that accepts them, so accesses to
+// the socket list are serialized. The connection objects themselves don't move.
+static std::mutex &GetGlobalSocketListLock() {
+  static std::mutex global_socket_list_lock;
+  return global_socket_list_lock;
+}
+
 NetworkConnection *NetworkManager::GetConnection(const int &connfd) {
+  std::lock_guard<std::mutex> lock(GetGlobalSocketListLock());
   auto &global_socket_list = GetGlobalSocketList();
   if (global_socket_list.find(connfd) != global_socket_list.end()) {
     return global_socket_list.at(connfd).get();
@@ -43,13 +52,15 @@ NetworkConnection *NetworkManager::GetConnection(const int &connfd) {
 void NetworkManager::CreateNewConnection(const int &connfd, short ev_flags,
                                          NetworkThread *thread,
                                          ConnState init_state) {
+  std::unique_ptr<NetworkConnection> conn(
+      new NetworkConnection(connfd, ev_flags, thread, init_state));
+  std::lock_guard<std::mutex> lock(GetGlobalSocketListLock());
   auto &global_socket_list = GetGlobalSocketList();
   recent_connfd = connfd;
   if (global_socket_list.find(connfd) == global_socket_list.end()) {
     LOG_INFO("Create new connection: id = %d", connfd);
   }
-  global_socket_list[connfd].reset(
-      new NetworkConnection(connfd, ev_flags, thread, init_state));
+  global_socket_list[connfd] = std::move(conn);
   thread->SetThreadSockFd(connfd);
 }
 
@@ -80,6 +91,8 @@ NetworkManager::NetworkManager() {
 
   port_ = settings::SettingsManager::GetInt(settings::SettingId::port);
   max_connections_ = settings::SettingsManager::GetInt(settings::SettingId::max_connections);
+  reuse_port_ = settings::SettingsManager::GetBool(
+      settings::SettingId::reuse_port_listeners);
   private_key_file_ = settings::SettingsManager::GetString(settings::SettingId::private_key_file);
   certificate_file_ = settings::SettingsManager::GetString(settings::SettingId::certificate_file);
 
@@ -104,18 +117,6 @@ void NetworkManager::StartServer() {
     sin.sin_addr.s_addr = INADDR_ANY;
     sin.sin_port = htons(port_);
 
-    int listen_fd;
-
-    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
-
-    if (listen_fd < 0) {
-      throw ConnectionException("Failed to create listen socket");
-    }
-
-    int conn_backlog = 12;
-    int reuse = 1;
-    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
-
     /* Initialize SSL listener connection */
     SSL_load_error_strings();
     SSL_library_init();
@@ -149,34 +150,56 @@ void NetworkManager::StartServer() {
     }
     * Temporarily commented to pass tests END
     */
-    if (bind(listen_fd, (struct sockaddr *) &sin, sizeof(sin)) < 0) {
-      SSL_CTX_free(ssl_context);
-      throw ConnectionException("Failed binding socket.");
-    }
-
-    if (listen(listen_fd, conn_backlog) < 0) {
+    int listen_fd = -1;
+    try {
+      if (reuse_port_) {
+        // Every worker thread listens on its own socket and accepts its own
+        // connections; the kernel spreads incoming connections among them.
+        master_thread_->Start();
+        for (auto &worker : master_thread_->GetWorkerThreads()) {
+          int worker_fd = CreateListenSocket(sin, true);
+          listen_fds_.push_back(worker_fd);
+          worker->SetListenFd(worker_fd);
+          NetworkManager::CreateNewConnection(worker_fd, EV_READ | EV_PERSIST,
+                                              worker.get(),
+                                              ConnState::CONN_LISTENING);
+        }
+      } else {
+        listen_fd = CreateListenSocket(sin, false);
+
+        master_thread_->Start();
+
+        NetworkManager::CreateNewConnection(listen_fd, EV_READ | EV_PERSIST,
+                                            master_thread_.get(), ConnState::CONN_LISTENING);
+      }
+    } catch (ConnectionException &) {
       SSL_CTX_free(ssl_context);
-      throw ConnectionException("Error listening onsocket.");
+      throw;
     }
 
-    master_thread_->Start();
-
-    NetworkManager::CreateNewConnection(listen_fd, EV_READ | EV_PERSIST,
-                                        master_thread_.get(), ConnState::CONN_LISTENING);
-
     LOG_INFO("Listening on port %llu", (unsigned long long) port_);
     event_base_dispatch(base_);
     LOG_INFO("Closing server");
-    NetworkManager::GetConnection(listen_fd)->CloseSocket();
+    if (listen_fd != -1) {
+      NetworkManager::GetConnection(listen_fd)->CloseSocket();
 
-    // Free events and event base
-    event_free(NetworkManager::GetConnection(listen_fd)->network_event);
-    event_free(NetworkManager::GetConnection(listen_fd)->workpool_event);
+      // Free events
+      event_free(NetworkManager::GetConnection(listen_fd)->network_event);
+      event_free(NetworkManager::GetConnection(listen_fd)->workpool_event);
+    }
+
+    // Free event base
     event_free(ev_stop_);
     event_free(ev_timeout_);
     event_base_free(base_);
 
     master_thread_->Stop();
+
+    // The worker threads freed their listeners' events on exit
+    for (int worker_fd : listen_fds_) {
+      close(worker_fd);
+    }
+    listen_fds_.clear();
     LOG_INFO("Server Closed");
   }
 
@@ -186,6 +209,37 @@ void NetworkManager::StartServer() {
   }
 }
 
+int NetworkManager::CreateListenSocket(const struct sockaddr_in &sin,
+                                       bool reuse_port) {
+  int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+
+  if (listen_fd < 0) {
+    throw ConnectionException("Failed to create listen socket");
+  }
+
+  int conn_backlog = 12;
+  int reuse = 1;
+  setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (reuse_port &&
+      setsockopt(listen_fd, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) <
+          0) {
+    close(listen_fd);
+    throw ConnectionException("Failed to set SO_REUSEPORT on listen socket");
+  }
+
+  if (bind(listen_fd, (struct sockaddr *) &sin, sizeof(sin)) < 0) {
+    close(listen_fd);
+    throw ConnectionException("Failed binding socket.");
+  }
+
+  if (listen(listen_fd, conn_backlog) < 0) {
+    close(listen_fd);
+    throw ConnectionException("Error listening onsocket.");
+  }
+
+  return listen_fd;
+}
+
 void NetworkManager::CloseServer() {
   LOG_INFO("Begin to stop server");
   this->SetIsClosed(true);
@@ -13,8 +13,6 @@
 
 #include "network/network_master_thread.h"
 
-#define MASTER_THREAD_ID -1
-
 namespace peloton {
 namespace network {
 /*
@@ -97,13 +95,22 @@ void NetworkMasterThread::StartWorker(NetworkWorkerThread *worker_thread) {
   worker_thread->SetThreadIsClosed(false);
 
   // Free events and event base
-  if (worker_thread->GetThreadSockFd() != -1) {
+  if (worker_thread->GetThreadSockFd() != -1 &&
+      worker_thread->GetThreadSockFd() != worker_thread->GetListenFd()) {
     NetworkConnection *connection =
         NetworkManager::GetConnection(worker_thread->GetThreadSockFd());
 
     event_free(connection->network_event);
     event_free(connection->workpool_event);
   }
+  // The thread's own listener is not necessarily its latest connection
+  if (worker_thread->GetListenFd() != -1) {
+    NetworkConnection *listener =
+        NetworkManager::GetConnection(worker_thread->GetListenFd());
+
+    event_free(listener->network_event);
+    event_free(listener->workpool_event);
+  }
   event_free(worker_thread->GetNewConnEvent());
   event_free(worker_thread->GetTimeoutEvent());
   event_base_free(worker_thread->GetEventBase());
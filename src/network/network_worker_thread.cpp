@@ -12,6 +12,8 @@
 
 #include "network/network_worker_thread.h"
 
+#include "network/network_manager.h"
+
 namespace peloton {
 namespace network {
 
@@ -20,7 +22,9 @@ namespace network {
 * constructor.
 */
 NetworkWorkerThread::NetworkWorkerThread(const int thread_id)
-    : NetworkThread(thread_id, event_base_new()), new_conn_queue(QUEUE_SIZE) {
+    : NetworkThread(thread_id, event_base_new()),
+      listen_fd_(-1),
+      new_conn_queue(QUEUE_SIZE) {
   int fds[2];
   if (pipe(fds)) {
     LOG_ERROR("Can't create notify pipe to accept connections");
@@ -48,5 +52,23 @@ NetworkWorkerThread::NetworkWorkerThread(const int thread_id)
   }
 }
 
+void NetworkWorkerThread::HandleNewConnection(int new_conn_fd,
+                                              short event_flags) {
+  NetworkConnection *conn = NetworkManager::GetConnection(new_conn_fd);
+  if (conn == nullptr) {
+    LOG_DEBUG("Creating new socket fd:%d", new_conn_fd);
+    /* create a new connection object */
+    NetworkManager::CreateNewConnection(new_conn_fd, event_flags,
+                                        static_cast<NetworkThread *>(this),
+                                        ConnState::CONN_READ);
+  } else {
+    LOG_DEBUG("Reusing socket fd:%d", new_conn_fd);
+    /* otherwise reset and reuse the existing conn object */
+    conn->Reset();
+    conn->Init(event_flags, static_cast<NetworkThread *>(this),
+               ConnState::CONN_READ);
+  }
+}
+
 }  // namespace network
 }  // namespace peloton
\ No newline at end of file
@@ -150,13 +150,26 @@ void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
 
   size_t numrows = results.size() / colcount;
 
-  // 1 packet per row
+  // Rather than allocating one packet per row, many DataRow messages are
+  // encoded back-to-back into a single packet that carries their headers
+  // inline. Packets are cut once they fill a socket buffer.
+  std::unique_ptr<OutputPacket> pkt;
   for (size_t i = 0; i < numrows; i++) {
-    std::unique_ptr<OutputPacket> pkt(new OutputPacket());
-    pkt->msg_type = NetworkMessageType::DATA_ROW;
+    if (pkt == nullptr) {
+      pkt.reset(new OutputPacket());
+      pkt->msg_type = NetworkMessageType::DATA_ROW;
+      pkt->skip_header_write = true;
+      pkt->buf.reserve(SOCKET_BUFFER_SIZE);
+    }
+
+    // Message header, the length is filled in once the row is written
+    size_t msg_start = pkt->len;
+    PacketPutByte(pkt.get(), static_cast<uchar>(NetworkMessageType::DATA_ROW));
+    PacketPutInt(pkt.get(), 0, 4);
+
     PacketPutInt(pkt.get(), colcount, 2);
     for (int j = 0; j < colcount; j++) {
-      auto content = results[i * colcount + j];
+      const auto &content = results[i * colcount + j];
       if (content.size() == 0) {
         // content is NULL
         PacketPutInt(pkt.get(), NULL_CONTENT_SIZE, 4);
@@ -168,6 +181,15 @@ void PostgresProtocolHandler::SendDataRows(std::vector<ResultValue> &results,
         PacketPutString(pkt.get(), content);
       }
     }
+
+    // The message length includes itself, but not the type byte
+    PacketPutIntAt(pkt.get(), msg_start + 1, pkt->len - msg_start - 1);
+
+    if (pkt->len >= SOCKET_BUFFER_SIZE) {
+      responses.push_back(std::move(pkt));
+    }
+  }
+  if (pkt != nullptr) {
     responses.push_back(std::move(pkt));
   }
   traffic_cop_->setRowsAffected(numrows);
@@ -243,6 +265,29 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(InputPacket *pkt, const
   std::string error_message;
   PacketGetString(pkt, pkt->len, query);
   LOG_TRACE("Execute query: %s", query.c_str());
+
+  // Queries that differ from an earlier one only in their literals reuse its
+  // plan without being parsed and optimized again
+  if (traffic_cop_->PrepareCachedStatement(query, error_message, thread_id)) {
+    protocol_type_ = NetworkProtocolType::POSTGRES_PSQL;
+    if (traffic_cop_->GetStatement().get() == nullptr) {
+      SendErrorResponse(
+          {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message}});
+      SendReadyForQuery(NetworkTransactionStateType::IDLE);
+      return ProcessResult::COMPLETE;
+    }
+    bool unnamed = false;
+    result_format_ = std::vector<int>(traffic_cop_->GetStatement()->GetTupleDescriptor().size(), 0);
+    auto status =
+        traffic_cop_->ExecuteStatement(traffic_cop_->GetStatement(), traffic_cop_->GetParamVal(), unnamed, nullptr, result_format_,
+                                       traffic_cop_->GetResult(), traffic_cop_->GetErrorMessage(), thread_id);
+    if (traffic_cop_->GetQueuing()) {
+      return ProcessResult::PROCESSING;
+    }
+    ExecQueryMessageGetResult(status);
+    return ProcessResult::COMPLETE;
+  }
+
   std::unique_ptr<parser::SQLStatementList> sql_stmt_list;
   try {
     auto &peloton_parser = parser::PostgresParser::GetInstance();
@@ -372,6 +417,8 @@ ProcessResult PostgresProtocolHandler::ExecQueryMessage(InputPacket *pkt, const
 }
 
 void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
+  bool rows_described = rows_described_;
+  rows_described_ = false;
   std::vector<FieldInfo> tuple_descriptor;
   if (status == ResultType::SUCCESS) {
     tuple_descriptor = traffic_cop_->GetStatement()->GetTupleDescriptor();
@@ -387,8 +434,10 @@ void PostgresProtocolHandler::ExecQueryMessageGetResult(ResultType status) {
     return;
   }
 
-  // send the attribute names
-  PutTupleDescriptor(tuple_descriptor);
+  // send the attribute names, unless they went ahead of streamed rows
+  if (!rows_described) {
+    PutTupleDescriptor(tuple_descriptor);
+  }
 
   // send the result rows
   SendDataRows(traffic_cop_->GetResult(), tuple_descriptor.size());
@@ -919,6 +968,20 @@ void PostgresProtocolHandler::ExecExecuteMessageGetResult(ResultType status) {
   }
 }
 
+void PostgresProtocolHandler::SendResultBatch(
+    std::vector<ResultValue> &batch) {
+  const auto &tuple_descriptor =
+      traffic_cop_->GetStatement()->GetTupleDescriptor();
+  // The simple query protocol describes the rows right before the first one,
+  // the extended protocol did so when the portal was described
+  if (protocol_type_ == NetworkProtocolType::POSTGRES_PSQL &&
+      !rows_described_) {
+    PutTupleDescriptor(tuple_descriptor);
+    rows_described_ = true;
+  }
+  SendDataRows(batch, tuple_descriptor.size());
+}
+
 void PostgresProtocolHandler::GetResult() {
   traffic_cop_->ExecuteStatementPlanGetResult();
   auto status = traffic_cop_->ExecuteStatementGetResult();
@@ -1041,32 +1104,44 @@ bool PostgresProtocolHandler::ReadPacket(Buffer &rbuf, InputPacket &rpkt) {
   return true;
 }
 
+// Process all the complete messages available in the read buffer. Clients
+// that pipeline the extended protocol send many Parse/Bind/Execute/Sync
+// messages at once; their responses are buffered and written out together.
+// We stop early only if a message has to wait for a query to execute, or the
+// session is to be closed.
 ProcessResult PostgresProtocolHandler::Process(Buffer &rbuf, const size_t thread_id) {
-  if (request.header_parsed == false) {
-    // parse out the header first
-    if (ReadPacketHeader(rbuf, request) == false) {
-      // need more data
-      return ProcessResult::MORE_DATA_REQUIRED;
+  bool processed_any = false;
+  while (true) {
+    if (request.header_parsed == false) {
+      // parse out the header first
+      if (ReadPacketHeader(rbuf, request) == false) {
+        // need more data, but first send whatever we have responses for
+        return processed_any ? ProcessResult::COMPLETE
+                             : ProcessResult::MORE_DATA_REQUIRED;
+      }
     }
-  }
-  PL_ASSERT(request.header_parsed == true);
-
-  if (request.is_initialized == false) {
-    // packet needs to be initialized with rest of the contents
-    if (PostgresProtocolHandler::ReadPacket(rbuf, request) == false) {
-      // need more data
-      return ProcessResult::MORE_DATA_REQUIRED;
+    PL_ASSERT(request.header_parsed == true);
+
+    if (request.is_initialized == false) {
+      // packet needs to be initialized with rest of the contents
+      if (PostgresProtocolHandler::ReadPacket(rbuf, request) == false) {
+        // need more data, but first send whatever we have responses for
+        return processed_any ? ProcessResult::COMPLETE
+                             : ProcessResult::MORE_DATA_REQUIRED;
+      }
     }
-  }
 
-  auto process_status = ProcessPacket(&request, thread_id);
+    auto process_status = ProcessPacket(&request, thread_id);
 
-  request.Reset();
+    request.Reset();
+    processed_any = true;
 
-  return process_status;
+    if (process_status != ProcessResult::COMPLETE) {
+      return process_status;
+    }
+  }
 }
 
-
 /*
  * process_packet - Main switch block; process incoming packets,
  *  Returns false if the session needs to be closed.
@@ -1163,6 +1238,7 @@ void PostgresProtocolHandler::Reset() {
   result_format_.clear();
   traffic_cop_->Reset();
   txn_state_ = NetworkTransactionStateType::IDLE;
+  rows_described_ = false;
   skipped_stmt_ = false;
   skipped_query_string_.clear();
   statement_cache_.clear();
@@ -40,6 +40,9 @@ namespace network {
   }
   
   void ProtocolHandler::GetResult() {}
+
+  void ProtocolHandler::SendResultBatch(
+      UNUSED_ATTRIBUTE std::vector<ResultValue> &batch) {}
 }  // namespace network
 }  // namespace peloton
 
@@ -12,11 +12,13 @@
 
 #include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
+#include "index/index.h"
 #include "optimizer/child_property_deriver.h"
 #include "optimizer/properties.h"
 #include "optimizer/group_expression.h"
 #include "optimizer/property_set.h"
 #include "optimizer/memo.h"
+#include "optimizer/util.h"
 #include "storage/data_table.h"
 
 using std::move;
@@ -69,8 +71,20 @@ void ChildPropertyDeriver::Visit(const PhysicalIndexScan *op) {
         }
       }
       if (!can_fulfill) break;
+      auto storage_indexes = util::GetStorageIndexes(target_table);
       for (auto &index : target_table->GetIndexObjects()) {
         auto key_oids = index.second->GetKeyAttrs();
+        // Partial indexes miss tuples, and expression indexes are sorted by
+        // their expressions
+        auto storage_index = storage_indexes.find(index.first);
+        if (storage_index == storage_indexes.end()) {
+          continue;
+        }
+        auto index_metadata = storage_index->second->GetMetadata();
+        if (index_metadata->IsPartial() ||
+            index_metadata->HasKeyExpressions()) {
+          continue;
+        }
         // If the sort column size is larger, then can't be fulfill by the index
         if (sort_col_size > key_oids.size()) {
           break;
@@ -21,7 +21,9 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 // Memo
 //===--------------------------------------------------------------------===//
-Memo::Memo() {}
+Memo::Memo()
+    : partitions_(new Partition[kNumPartitions]),
+      groups_latch_(new common::synchronization::ReadWriteLatch()) {}
 
 GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
                                         bool enforced) {
@@ -40,15 +42,20 @@ GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
   }
 
   // Lookup in hash table
-  auto it = group_expressions_.find(gexpr.get());
+  auto &partition = GetPartition(gexpr.get());
+  partition.latch.Lock();
+  auto it = partition.group_expressions.find(gexpr.get());
 
-  if (it != group_expressions_.end()) {
+  if (it != partition.group_expressions.end()) {
+    auto existing_gexpr = *it;
+    partition.latch.Unlock();
     assert(target_group == UNDEFINED_GROUP ||
-           target_group == (*it)->GetGroupID());
-    gexpr->SetGroupID((*it)->GetGroupID());
-    return *it;
+           target_group == existing_gexpr->GetGroupID());
+    gexpr->SetGroupID(existing_gexpr->GetGroupID());
+    return existing_gexpr;
   } else {
-    group_expressions_.insert(gexpr.get());
+    partition.group_expressions.insert(gexpr.get());
+    partition.latch.Unlock();
     // New expression, so try to insert into an existing group or
     // create a new group if none specified
     GroupID group_id;
@@ -63,14 +70,50 @@ GroupExpression *Memo::InsertExpression(std::shared_ptr<GroupExpression> gexpr,
   }
 }
 
-const std::vector<std::unique_ptr<Group>> &Memo::Groups() const {
-  return groups_;
+std::vector<Group *> Memo::Groups() const {
+  std::vector<Group *> groups;
+  groups_latch_->ReadLock();
+  groups.reserve(groups_.size());
+  for (auto &group : groups_) {
+    groups.push_back(group.get());
+  }
+  groups_latch_->Unlock();
+  return groups;
+}
+
+size_t Memo::GetNumGroups() const {
+  groups_latch_->ReadLock();
+  auto num_groups = groups_.size();
+  groups_latch_->Unlock();
+  return num_groups;
 }
 
-Group *Memo::GetGroupByID(GroupID id) { return groups_[id].get(); }
+size_t Memo::GetNumGroupExpressions() const {
+  size_t num_group_exprs = 0;
+  for (size_t i = 0; i < kNumPartitions; i++) {
+    auto &partition = partitions_[i];
+    partition.latch.Lock();
+    num_group_exprs += partition.group_expressions.size();
+    partition.latch.Unlock();
+  }
+  return num_group_exprs;
+}
+
+Group *Memo::GetGroupByID(GroupID id) {
+  groups_latch_->ReadLock();
+  auto group = groups_[id].get();
+  groups_latch_->Unlock();
+  return group;
+}
+
+void Memo::EraseGroupExpression(GroupExpression *gexpr) {
+  auto &partition = GetPartition(gexpr);
+  partition.latch.Lock();
+  partition.group_expressions.erase(gexpr);
+  partition.latch.Unlock();
+}
 
 GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
-  GroupID new_group_id = groups_.size();
   // Find out the table alias that this group represents
   std::unordered_set<std::string> table_aliases;
   auto op_type = gexpr->Op().type();
@@ -95,8 +138,11 @@ GroupID Memo::AddNewGroup(std::shared_ptr<GroupExpression> gexpr) {
   StatsCalculator stats_calculator;
   auto stats = stats_calculator.CalculateStats(gexpr);
 
+  groups_latch_->WriteLock();
+  GroupID new_group_id = groups_.size();
   groups_.emplace_back(
       new Group(new_group_id, std::move(table_aliases), stats));
+  groups_latch_->Unlock();
   return new_group_id;
 }
 
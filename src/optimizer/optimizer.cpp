@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>
+#include <limits>
 #include <memory>
 
 #include "optimizer/optimizer.h"
@@ -40,6 +42,9 @@
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+
 #include "storage/data_table.h"
 
 #include "binder/bind_node_visitor.h"
@@ -62,11 +67,30 @@ Optimizer::Optimizer() {}
 
 void Optimizer::OptimizeLoop(int root_group_id,
                              std::shared_ptr<PropertySet> required_props) {
-  std::shared_ptr<OptimizeContext> root_context =
-      std::make_shared<OptimizeContext>(&metadata_, required_props);
+  auto parallelism = std::max(settings::SettingsManager::GetInt(
+                                  settings::SettingId::optimizer_parallelism),
+                              1);
+  if (parallelism > 1) {
+    // Catalog objects are loaded lazily through the (single-threaded)
+    // transaction, load everything the rules may look at up front
+    for (auto group : metadata_.memo.Groups()) {
+      for (auto &gexpr : group->GetLogicalExpressions()) {
+        if (gexpr->Op().type() != OpType::Get) continue;
+        auto table = gexpr->Op().As<LogicalGet>()->table;
+        if (table == nullptr) continue;
+        table->GetIndexObjects();
+        table->GetColumnObjects();
+      }
+    }
+  }
+
   auto task_stack =
       std::unique_ptr<OptimizerTaskStack>(new OptimizerTaskStack());
   metadata_.SetTaskPool(task_stack.get());
+  std::shared_ptr<OptimizeContext> root_context =
+      std::make_shared<OptimizeContext>(
+          &metadata_, required_props, std::numeric_limits<double>::max(),
+          task_stack.get(), parallelism);
 
   // Perform optimization after the rewrite
   task_stack->Push(new OptimizeGroup(metadata_.memo.GetGroupByID(root_group_id),
@@ -78,10 +102,45 @@ void Optimizer::OptimizeLoop(int root_group_id,
   task_stack->Push(new BottomUpRewrite(root_group_id, root_context,
                                       RewriteRuleSetName::UNNEST_SUBQUERY, false));
 
-  // TODO: Add timer for early stop
+  // The optimization budget, 0 means unlimited
+  auto task_limit = static_cast<uint64_t>(std::max(
+      settings::SettingsManager::GetInt(
+          settings::SettingId::optimizer_task_limit),
+      0));
+  auto timeout = std::chrono::milliseconds(std::max(
+      settings::SettingsManager::GetInt(settings::SettingId::optimizer_timeout),
+      0));
+  auto group_limit = static_cast<size_t>(std::max(
+      settings::SettingsManager::GetInt(
+          settings::SettingId::optimizer_memo_group_limit),
+      0));
+  auto start_time = std::chrono::steady_clock::now();
+
+  // Sub-plans optimized in parallel run to completion, the budget is only
+  // checked between the tasks of this loop
   while (!task_stack->Empty()) {
     auto task = task_stack->Pop();
     task->execute();
+
+    // Once the budget is used up, the remaining tasks only cost what is
+    // already in the memo so that we still end up with the best plan found
+    auto num_tasks = task_stack->GetNumTasks();
+    if (!metadata_.budget_exhausted &&
+        ((task_limit > 0 && num_tasks >= task_limit) ||
+         (group_limit > 0 && metadata_.memo.GetNumGroups() >= group_limit) ||
+         (timeout.count() > 0 &&
+          std::chrono::steady_clock::now() - start_time >= timeout))) {
+      LOG_DEBUG("Optimization budget exhausted after %lu tasks, %lu groups",
+                num_tasks, metadata_.memo.GetNumGroups());
+      metadata_.budget_exhausted = true;
+    }
+  }
+
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    stats::BackendStatsContext::GetInstance()->RecordOptimization(
+        task_stack->GetNumTasks(), metadata_.memo.GetNumGroups(),
+        metadata_.memo.GetNumGroupExpressions(), metadata_.budget_exhausted);
   }
 }
 
@@ -10,6 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 #include "optimizer/optimizer_task.h"
 #include "optimizer/property_enforcer.h"
 #include "optimizer/optimizer_metadata.h"
@@ -45,7 +49,12 @@ void OptimizerTask::ConstructValidRules(
 }
 
 void OptimizerTask::PushTask(OptimizerTask *task) {
-  context_->metadata->task_pool->Push(task);
+  GetTaskPool()->Push(task);
+}
+
+OptimizerTaskPool *OptimizerTask::GetTaskPool() const {
+  if (context_->task_pool != nullptr) return context_->task_pool;
+  return context_->metadata->task_pool;
 }
 
 Memo &OptimizerTask::GetMemo() const { return context_->metadata->memo; }
@@ -120,7 +129,7 @@ void OptimizeExpression::execute() {
 // ExploreGroup
 //===--------------------------------------------------------------------===//
 void ExploreGroup::execute() {
-  if (group_->HasExplored()) return;
+  if (group_->HasExplored() || context_->metadata->budget_exhausted) return;
   LOG_DEBUG("ExploreGroup::execute() ");
 
   for (auto &logical_expr : group_->GetLogicalExpressions()) {
@@ -170,6 +179,8 @@ void ExploreExpression::execute() {
 void ApplyRule::execute() {
   // LOG_DEBUG("ApplyRule::execute() ");
   if (group_expr_->HasRuleExplored(rule_)) return;
+  // Out of budget, stop adding logical alternatives to the memo
+  if (rule_->IsLogical() && context_->metadata->budget_exhausted) return;
 
   GroupExprBindingIterator iterator(GetMemo(), group_expr_,
                                     rule_->GetMatchPattern());
@@ -227,6 +238,8 @@ void OptimizeInputs::execute() {
         group_expr_, context_->required_prop, &context_->metadata->memo);
     cur_child_idx_ = 0;
 
+    if (context_->parallelism > 1) OptimizeChildrenInParallel();
+
     // TODO: If later on we support properties that may not be enforced in some
     // cases,
     // we can check whether it is the case here to do the pruning
@@ -263,9 +276,11 @@ void OptimizeInputs::execute() {
         pre_child_idx_ = cur_child_idx_;
         PushTask(new OptimizeInputs(this));
         PushTask(new OptimizeGroup(
-            child_group, std::make_shared<OptimizeContext>(
-                             context_->metadata, i_prop,
-                             context_->cost_upper_bound - cur_total_cost_)));
+            child_group,
+            std::make_shared<OptimizeContext>(
+                context_->metadata, i_prop,
+                context_->cost_upper_bound - cur_total_cost_,
+                context_->task_pool, context_->parallelism)));
         return;
       } else {  // If we return from OptimizeGroup, then there is no expr for
                 // the context
@@ -351,6 +366,79 @@ void OptimizeInputs::execute() {
   }
 }
 
+void OptimizeInputs::OptimizeChildrenInParallel() {
+  auto &memo = GetMemo();
+  size_t num_children = group_expr_->GetChildrenGroupsSize();
+  if (num_children < 2) return;
+
+  std::unordered_set<std::string> child_aliases;
+  for (size_t child_idx = 0; child_idx < num_children; child_idx++) {
+    auto child_group = memo.GetGroupByID(group_expr_->GetChildGroupId(child_idx));
+    if (child_group->GetTableAliases().empty()) return;
+    for (auto &alias : child_group->GetTableAliases()) {
+      if (!child_aliases.insert(alias).second) return;
+    }
+  }
+
+  // Child i is optimized by thread (i % num_threads) on that thread's stack.
+  // Thread 0 is the current thread. The threads of this context are split
+  // among the children, so that they can optimize their own inputs in
+  // parallel again.
+  auto parallelism = static_cast<size_t>(context_->parallelism);
+  auto num_threads = std::min(num_children, parallelism);
+  std::vector<std::unique_ptr<OptimizerTaskStack>> task_stacks;
+  for (size_t thread_idx = 0; thread_idx < num_threads; thread_idx++) {
+    task_stacks.emplace_back(new OptimizerTaskStack());
+  }
+
+  // Push in reverse so that the stacks optimize the children, and the inputs
+  // properties for each child, in order
+  for (size_t child_idx = num_children; child_idx-- > 0;) {
+    auto thread_idx = child_idx % num_threads;
+    auto thread_parallelism = static_cast<int>(
+        parallelism / num_threads +
+        (thread_idx < parallelism % num_threads ? 1 : 0));
+    auto child_group = memo.GetGroupByID(group_expr_->GetChildGroupId(child_idx));
+    for (size_t pair_idx = output_input_properties_.size(); pair_idx-- > 0;) {
+      auto &i_prop = output_input_properties_[pair_idx].second[child_idx];
+      task_stacks[thread_idx]->Push(new OptimizeGroup(
+          child_group, std::make_shared<OptimizeContext>(
+                           context_->metadata, i_prop,
+                           context_->cost_upper_bound,
+                           task_stacks[thread_idx].get(), thread_parallelism)));
+    }
+  }
+
+  LOG_TRACE("Optimizing %lu child groups with %lu threads", num_children,
+            num_threads);
+  std::vector<std::exception_ptr> errors(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t thread_idx = 1; thread_idx < num_threads; thread_idx++) {
+    threads.emplace_back([&task_stacks, &errors, thread_idx] {
+      try {
+        task_stacks[thread_idx]->Run();
+      } catch (...) {
+        errors[thread_idx] = std::current_exception();
+      }
+    });
+  }
+  try {
+    task_stacks[0]->Run();
+  } catch (...) {
+    errors[0] = std::current_exception();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (size_t thread_idx = 0; thread_idx < num_threads; thread_idx++) {
+    GetTaskPool()->AddNumTasks(task_stacks[thread_idx]->GetNumTasks());
+  }
+  for (auto &error : errors) {
+    if (error != nullptr) std::rethrow_exception(error);
+  }
+}
+
 void TopDownRewrite::execute() {
   std::vector<RuleWithPromise> valid_rules;
 
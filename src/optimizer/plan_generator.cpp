@@ -12,11 +12,14 @@
 
 #include "optimizer/plan_generator.h"
 
+#include <algorithm>
+
 #include "catalog/column_catalog.h"
 #include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
 #include "concurrency/transaction_context.h"
 #include "expression/expression_util.h"
+#include "index/index.h"
 #include "optimizer/operator_expression.h"
 #include "optimizer/properties.h"
 #include "planner/aggregate_plan.h"
@@ -94,16 +97,42 @@ void PlanGenerator::Visit(const PhysicalIndexScan *op) {
   vector<expression::AbstractExpression *> runtime_keys;
 
   // Create index scan desc
+  auto index = storage::StorageManager::GetInstance()
+                   ->GetTableWithOid(op->table_->GetDatabaseOid(),
+                                     op->table_->GetTableOid())
+                   ->GetIndexWithOid(op->index_id);
   planner::IndexScanPlan::IndexScanDesc index_scan_desc(
-      storage::StorageManager::GetInstance()
-          ->GetTableWithOid(op->table_->GetDatabaseOid(),
-                            op->table_->GetTableOid())
-          ->GetIndexWithOid(op->index_id),
-      op->key_column_id_list, op->expr_type_list, op->value_list, runtime_keys);
-  output_plan_.reset(new planner::IndexScanPlan(
-      storage::StorageManager::GetInstance()->GetTableWithOid(
-          op->table_->GetDatabaseOid(), op->table_->GetTableOid()),
-      predicate.release(), column_ids, index_scan_desc, false));
+      index, op->key_column_id_list, op->expr_type_list, op->value_list,
+      runtime_keys);
+
+  // The scan is covered by the index if it only reads key columns, which
+  // the keys of expression indexes don't hold
+  bool covering = (op->is_for_update == false && column_ids.empty() == false &&
+                   index->GetMetadata()->HasKeyExpressions() == false);
+  auto &key_attrs = index->GetMetadata()->GetKeyAttrs();
+  auto is_key_column = [&key_attrs](oid_t column_id) {
+    return std::find(key_attrs.begin(), key_attrs.end(), column_id) !=
+           key_attrs.end();
+  };
+  for (auto column_id : column_ids) {
+    covering = covering && is_key_column(column_id);
+  }
+  ExprSet predicate_columns;
+  expression::ExpressionUtil::GetTupleValueExprs(predicate_columns,
+                                                 predicate.get());
+  for (auto column : predicate_columns) {
+    covering = covering &&
+               is_key_column(reinterpret_cast<expression::TupleValueExpression *>(
+                                 column)->GetColumnId());
+  }
+
+  std::unique_ptr<planner::IndexScanPlan> index_scan_plan(
+      new planner::IndexScanPlan(
+          storage::StorageManager::GetInstance()->GetTableWithOid(
+              op->table_->GetDatabaseOid(), op->table_->GetTableOid()),
+          predicate.release(), column_ids, index_scan_desc, false));
+  index_scan_plan->SetCovering(covering);
+  output_plan_ = move(index_scan_plan);
 }
 
 void PlanGenerator::Visit(const QueryDerivedScan *) {
@@ -295,6 +324,12 @@ void PlanGenerator::Visit(const PhysicalDelete *op) {
           op->target_table->GetDatabaseOid(),
           op->target_table->GetTableOid())));
 
+  // Deleting needs the tuples in the table, not copies of their keys
+  if (children_plans_[0]->GetPlanNodeType() == PlanNodeType::INDEXSCAN) {
+    static_cast<planner::IndexScanPlan *>(children_plans_[0].get())
+        ->SetCovering(false);
+  }
+
   // Add child
   delete_plan->AddChild(move(children_plans_[0]));
   output_plan_ = move(delete_plan);
@@ -10,17 +10,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 
 #include "catalog/index_catalog.h"
 #include "catalog/table_catalog.h"
 #include "catalog/column_catalog.h"
+#include "index/index.h"
 #include "optimizer/rule_impls.h"
 #include "optimizer/util.h"
 #include "optimizer/operators.h"
 #include "storage/data_table.h"
 #include "optimizer/properties.h"
 #include "optimizer/optimizer_metadata.h"
+#include "settings/settings_manager.h"
 
 namespace peloton {
 namespace optimizer {
@@ -68,6 +71,112 @@ void InnerJoinCommutativity::Transform(
   transformed.push_back(result_plan);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinAssociativity
+InnerJoinAssociativity::InnerJoinAssociativity() {
+  type_ = RuleType::INNER_JOIN_ASSOCIATE;
+
+  // (A join B) join C
+  std::shared_ptr<Pattern> left_child(
+      std::make_shared<Pattern>(OpType::InnerJoin));
+  left_child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  left_child->AddChild(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+}
+
+void InnerJoinAssociativity::SplitJoinPredicates(
+    std::shared_ptr<OperatorExpression> input, OptimizeContext *context,
+    std::vector<AnnotatedExpression> &top_preds,
+    std::vector<AnnotatedExpression> &child_preds) {
+  auto &memo = context->metadata->memo;
+  auto left_join = input->Children()[0];
+  auto b_group_id =
+      left_join->Children()[1]->Op().As<LeafOperator>()->origin_group;
+  auto c_group_id = input->Children()[1]->Op().As<LeafOperator>()->origin_group;
+
+  // The tables produced by the new (B join C)
+  std::unordered_set<std::string> child_aliases(
+      memo.GetGroupByID(b_group_id)->GetTableAliases());
+  for (auto &alias : memo.GetGroupByID(c_group_id)->GetTableAliases()) {
+    child_aliases.insert(alias);
+  }
+
+  // Predicates only referencing B and C are pushed down into the new join
+  for (auto *join : {input->Op().As<LogicalInnerJoin>(),
+                     left_join->Op().As<LogicalInnerJoin>()}) {
+    for (auto &predicate : join->join_predicates) {
+      if (util::IsSubset(child_aliases, predicate.table_alias_set)) {
+        child_preds.emplace_back(predicate);
+      } else {
+        top_preds.emplace_back(predicate);
+      }
+    }
+  }
+}
+
+bool InnerJoinAssociativity::Check(std::shared_ptr<OperatorExpression> expr,
+                                   OptimizeContext *context) const {
+  // Exhaustive enumeration grows exponentially with the number of tables, so
+  // large joins keep the join order they were written in
+  auto &memo = context->metadata->memo;
+  auto a_group_id = expr->Children()[0]
+                        ->Children()[0]
+                        ->Op()
+                        .As<LeafOperator>()
+                        ->origin_group;
+  auto b_group_id = expr->Children()[0]
+                        ->Children()[1]
+                        ->Op()
+                        .As<LeafOperator>()
+                        ->origin_group;
+  auto c_group_id = expr->Children()[1]->Op().As<LeafOperator>()->origin_group;
+  auto num_tables = memo.GetGroupByID(a_group_id)->GetTableAliases().size() +
+                    memo.GetGroupByID(b_group_id)->GetTableAliases().size() +
+                    memo.GetGroupByID(c_group_id)->GetTableAliases().size();
+  auto max_tables = settings::SettingsManager::GetInt(
+      settings::SettingId::max_join_reorder_tables);
+  if (num_tables > static_cast<size_t>(std::max(max_tables, 0))) {
+    return false;
+  }
+
+  // Never introduce a cross product between B and C
+  std::vector<AnnotatedExpression> top_preds;
+  std::vector<AnnotatedExpression> child_preds;
+  SplitJoinPredicates(expr, context, top_preds, child_preds);
+  return !child_preds.empty();
+}
+
+void InnerJoinAssociativity::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed,
+    OptimizeContext *context) const {
+  std::vector<AnnotatedExpression> top_preds;
+  std::vector<AnnotatedExpression> child_preds;
+  SplitJoinPredicates(input, context, top_preds, child_preds);
+
+  auto left_join = input->Children()[0];
+  PL_ASSERT(left_join->Children().size() == 2);
+  LOG_TRACE("Reassociate inner join, %lu predicates pushed to the new child",
+            child_preds.size());
+
+  // B join C
+  auto child_join = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(child_preds));
+  child_join->PushChild(left_join->Children()[1]);
+  child_join->PushChild(input->Children()[1]);
+
+  // A join (B join C)
+  auto result_plan = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(top_preds));
+  result_plan->PushChild(left_join->Children()[0]);
+  result_plan->PushChild(child_join);
+
+  transformed.push_back(result_plan);
+}
+
 //===--------------------------------------------------------------------===//
 // Implementation rules
 //===--------------------------------------------------------------------===//
@@ -130,6 +239,27 @@ void GetToSeqScan::Transform(
 
 ///////////////////////////////////////////////////////////////////////////////
 /// GetToIndexScan
+
+// Get the value a predicate compares a key column to, which is a constant or
+// the offset of a parameter
+static type::Value GetIndexScanValue(
+    expression::AbstractExpression *value_expr) {
+  if (value_expr->GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
+    return reinterpret_cast<expression::ConstantValueExpression *>(value_expr)
+        ->GetValue();
+  }
+  return type::ValueFactory::GetParameterOffsetValue(
+             reinterpret_cast<expression::ParameterValueExpression *>(
+                 value_expr)->GetValueIdx()).Copy();
+}
+
+// Whether the expression is a constant or a parameter
+static bool IsIndexScanValue(const expression::AbstractExpression *expr) {
+  auto expr_type = expr->GetExpressionType();
+  return expr_type == ExpressionType::VALUE_CONSTANT ||
+         expr_type == ExpressionType::VALUE_PARAMETER;
+}
+
 GetToIndexScan::GetToIndexScan() {
   type_ = RuleType::GET_TO_INDEX_SCAN;
 
@@ -159,6 +289,7 @@ void GetToIndexScan::Transform(
   PL_ASSERT(children.size() == 0);
 
   const LogicalGet *get = input->Op().As<LogicalGet>();
+  auto storage_indexes = util::GetStorageIndexes(get->table);
 
   // Get sort columns if they are all base columns and all in asc order
   auto sort = context->required_prop->GetPropertyOfType(PropertyType::SORT);
@@ -184,6 +315,17 @@ void GetToIndexScan::Transform(
         auto &index_id = index_id_object_pair.first;
         auto &index = index_id_object_pair.second;
         auto &index_col_ids = index->GetKeyAttrs();
+        // Partial indexes miss tuples, and expression indexes are sorted by
+        // their expressions
+        auto storage_index = storage_indexes.find(index_id);
+        if (storage_index == storage_indexes.end()) {
+          continue;
+        }
+        auto index_metadata = storage_index->second->GetMetadata();
+        if (index_metadata->IsPartial() ||
+            index_metadata->HasKeyExpressions()) {
+          continue;
+        }
         // We want to ensure that Sort(a, b, c, d, e) can fit Sort(a, b, c)
         size_t l_num_sort_columns = index_col_ids.size();
         size_t r_num_sort_columns = sort_col_ids.size();
@@ -254,25 +396,8 @@ void GetToIndexScan::Transform(
         key_column_id_list.push_back(column_id);
         expr_type_list.push_back(expr_type);
 
-        if (value_expr->GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
-          value_list.push_back(
-              reinterpret_cast<expression::ConstantValueExpression *>(
-                  value_expr)
-                  ->GetValue());
-          LOG_TRACE("Value Type: %d",
-                    reinterpret_cast<expression::ConstantValueExpression *>(
-                        expr->GetModifiableChild(1))
-                        ->GetValueType());
-        } else {
-          value_list.push_back(
-              type::ValueFactory::GetParameterOffsetValue(
-                  reinterpret_cast<expression::ParameterValueExpression *>(
-                      value_expr)
-                      ->GetValueIdx())
-                  .Copy());
-          LOG_TRACE("Parameter offset: %s",
-                    (*values.rbegin()).GetInfo().c_str());
-        }
+        value_list.push_back(GetIndexScanValue(value_expr));
+        LOG_TRACE("Value: %s", value_list.back().GetInfo().c_str());
       }
     }  // Loop predicates end
 
@@ -284,17 +409,72 @@ void GetToIndexScan::Transform(
       std::vector<oid_t> index_key_column_id_list;
       std::vector<ExpressionType> index_expr_type_list;
       std::vector<type::Value> index_value_list;
-      std::unordered_set<oid_t> index_col_set(
-          index_object->GetKeyAttrs().begin(),
-          index_object->GetKeyAttrs().end());
+
+      // A partial index only has the tuples its predicate selects, so the
+      // query has to select no others
+      auto storage_index = storage_indexes.find(index_id);
+      if (storage_index == storage_indexes.end()) {
+        continue;
+      }
+      auto index_metadata = storage_index->second->GetMetadata();
+      if (index_metadata->IsPartial() &&
+          !util::ImpliesIndexPredicate(get->predicates,
+                                       index_metadata->GetPredicate(),
+                                       get->table->GetTableOid())) {
+        continue;
+      }
+
+      // The key columns computed by expressions are matched by their
+      // expressions, and the others by their table columns
+      auto &key_attrs = index_object->GetKeyAttrs();
+      std::unordered_set<oid_t> index_col_set;
+      for (oid_t key_col_id = 0; key_col_id < key_attrs.size(); key_col_id++) {
+        if (index_metadata->GetKeyExpression(key_col_id) == nullptr) {
+          index_col_set.insert(key_attrs[key_col_id]);
+        }
+      }
       for (size_t offset = 0; offset < key_column_id_list.size(); offset++) {
         auto col_id = key_column_id_list[offset];
+        // Scans only look expression key columns up, so the other conditions
+        // on an expression index must be lookups as well
+        if (index_metadata->HasKeyExpressions() &&
+            expr_type_list[offset] != ExpressionType::COMPARE_EQUAL) {
+          continue;
+        }
         if (index_col_set.find(col_id) != index_col_set.end()) {
           index_key_column_id_list.push_back(col_id);
           index_expr_type_list.push_back(expr_type_list[offset]);
           index_value_list.push_back(value_list[offset]);
         }
       }
+      for (oid_t key_col_id = 0; key_col_id < key_attrs.size(); key_col_id++) {
+        auto key_expr = index_metadata->GetKeyExpression(key_col_id);
+        if (key_expr == nullptr) {
+          continue;
+        }
+        for (auto &pred : get->predicates) {
+          auto expr = pred.expr.get();
+          if (expr->GetExpressionType() != ExpressionType::COMPARE_EQUAL) {
+            continue;
+          }
+          expression::AbstractExpression *value_expr = nullptr;
+          if (IsIndexScanValue(expr->GetChild(1)) &&
+              util::EqualIndexExpressions(expr->GetChild(0), key_expr,
+                                          get->table->GetTableOid())) {
+            value_expr = expr->GetModifiableChild(1);
+          } else if (IsIndexScanValue(expr->GetChild(0)) &&
+                     util::EqualIndexExpressions(expr->GetChild(1), key_expr,
+                                                 get->table->GetTableOid())) {
+            value_expr = expr->GetModifiableChild(0);
+          }
+          if (value_expr != nullptr) {
+            index_key_column_id_list.push_back(key_attrs[key_col_id]);
+            index_expr_type_list.push_back(ExpressionType::COMPARE_EQUAL);
+            index_value_list.push_back(GetIndexScanValue(value_expr));
+            break;
+          }
+        }
+      }
       // Add transformed plan
       if (!index_key_column_id_list.empty()) {
         auto index_scan_op = PhysicalIndexScan::make(
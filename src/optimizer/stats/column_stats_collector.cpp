@@ -13,6 +13,9 @@
 #include "optimizer/stats/column_stats_collector.h"
 
 #include "common/macros.h"
+#include "murmur3/MurmurHash3.h"
+#include "type/limits.h"
+#include "util/string_util.h"
 
 namespace peloton {
 namespace optimizer {
@@ -51,6 +54,126 @@ void ColumnStatsCollector::AddValue(const type::Value &value) {
   topk_.Add(value);
 }
 
+bool ColumnStatsCollector::SupportsRawValues(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Same updates as AddValue(), which hashes the value the same way and also
+// counts NULLs towards the cardinality and top values
+template <typename T>
+void ColumnStatsCollector::AddNumericValue(T value, T null_value) {
+  total_count_++;
+  bool is_null = value == null_value;
+  if (is_null) {
+    null_count_++;
+  }
+
+  uint64_t hash[2];
+  MurmurHash3_x64_128(&value, sizeof(value), 0, hash);
+  hll_.UpdateHash(hash[0]);
+  if (!is_null) {
+    hist_.Update(static_cast<double>(value));
+  }
+  topk_.Add(static_cast<int64_t>(value));
+}
+
+template <>
+void ColumnStatsCollector::AddNumericValue(double value, double null_value) {
+  total_count_++;
+  bool is_null = value == null_value;
+  if (is_null) {
+    null_count_++;
+  }
+
+  uint64_t hash[2];
+  MurmurHash3_x64_128(&value, sizeof(value), 0, hash);
+  hll_.UpdateHash(hash[0]);
+  if (!is_null) {
+    hist_.Update(value);
+  }
+  // Decimals are kept as strings, formatted like DecimalType::ToString()
+  topk_.Add(is_null ? std::string("decimal_null")
+                    : StringUtil::Format("%g", value),
+            1, TopKElements::ApproxTopEntryElem::ElemType::DEC_TYPE);
+}
+
+void ColumnStatsCollector::AddRawValue(const char *data) {
+  switch (column_type_) {
+    case type::TypeId::TINYINT:
+      AddNumericValue(*reinterpret_cast<const int8_t *>(data),
+                      type::PELOTON_INT8_NULL);
+      break;
+    case type::TypeId::SMALLINT:
+      AddNumericValue(*reinterpret_cast<const int16_t *>(data),
+                      type::PELOTON_INT16_NULL);
+      break;
+    case type::TypeId::INTEGER:
+      AddNumericValue(*reinterpret_cast<const int32_t *>(data),
+                      type::PELOTON_INT32_NULL);
+      break;
+    case type::TypeId::BIGINT:
+      AddNumericValue(*reinterpret_cast<const int64_t *>(data),
+                      type::PELOTON_INT64_NULL);
+      break;
+    case type::TypeId::DECIMAL:
+      AddNumericValue(*reinterpret_cast<const double *>(data),
+                      type::PELOTON_DECIMAL_NULL);
+      break;
+    case type::TypeId::TIMESTAMP:
+      AddNumericValue(*reinterpret_cast<const uint64_t *>(data),
+                      type::PELOTON_TIMESTAMP_NULL);
+      break;
+    default:
+      PL_ASSERT(false);
+      break;
+  }
+}
+
+void ColumnStatsCollector::Merge(ColumnStatsCollector &other) {
+  PL_ASSERT(column_type_ == other.column_type_);
+  total_count_ += other.total_count_;
+  null_count_ += other.null_count_;
+  hll_.Merge(other.hll_);
+  hist_.Merge(other.hist_);
+  topk_.Merge(other.topk_);
+}
+
+std::vector<ColumnStatsCollector::ValueFrequencyPair>
+ColumnStatsCollector::GetCommonValueAndFrequency() {
+  auto val_freqs = topk_.GetAllOrderedMaxFirst();
+  // Scale the sample frequencies up to the whole table
+  for (auto &val_freq : val_freqs) {
+    val_freq.second /= sample_ratio_;
+  }
+  return val_freqs;
+}
+
+uint64_t ColumnStatsCollector::GetCardinality() {
+  uint64_t cardinality = hll_.EstimateCardinality();
+  if (sample_ratio_ >= 1.0) {
+    return cardinality;
+  }
+
+  // Like Postgres, assume that a column whose sampled values are all distinct
+  // is unique, and that the sample saw all the distinct values otherwise
+  double sampled = static_cast<double>(total_count_ - null_count_);
+  if (sampled > 0 &&
+      cardinality >= sampled * (1.0 - hll_.RelativeError())) {
+    return static_cast<uint64_t>(cardinality / sample_ratio_);
+  }
+  return cardinality;
+}
+
 double ColumnStatsCollector::GetFracNull() {
   if (total_count_ == 0) {
     LOG_TRACE("Cannot calculate stats for table size 0.");
@@ -12,10 +12,13 @@
 
 #include "optimizer/stats/cost.h"
 #include "expression/comparison_expression.h"
+#include "optimizer/stats/multi_column_stats.h"
 #include "optimizer/stats/selectivity.h"
 #include "type/value.h"
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
 
 namespace peloton {
 namespace optimizer {
@@ -35,6 +38,19 @@ double Cost::SingleConditionSeqScanCost(
   return input_stats->num_rows * DEFAULT_TUPLE_COST;
 }
 
+double Cost::MultiConditionSeqScanCost(
+    const std::shared_ptr<TableStats> &input_stats,
+    const std::vector<ValueCondition> &conditions,
+    std::shared_ptr<TableStats> &output_stats) {
+  if (output_stats != nullptr) {
+    double selectivity =
+        Selectivity::ComputeConjunctionSelectivity(input_stats, conditions);
+    output_stats->num_rows = input_stats->num_rows * selectivity;
+  }
+
+  return input_stats->num_rows * DEFAULT_TUPLE_COST;
+}
+
 double Cost::SingleConditionIndexScanCost(
     const std::shared_ptr<TableStats> &input_stats,
     const ValueCondition &condition,
@@ -221,9 +237,35 @@ size_t Cost::GetEstimatedGroupByRows(
   // overestimation.
   // Then use max cardinality among all columns as underestimation.
   // And combine them together.
+  // The joint cardinality of a group of columns replaces the product of
+  // theirs, largest groups first.
   double rows = 1;
   double max_cardinality = 0;
-  for (oid_t column : columns) {
+  std::vector<oid_t> remaining(columns);
+  std::sort(remaining.begin(), remaining.end());
+  std::vector<std::shared_ptr<MultiColumnStats>> groups =
+      input_stats->GetMultiColumnStats();
+  std::sort(groups.begin(), groups.end(),
+            [](const std::shared_ptr<MultiColumnStats> &lhs,
+               const std::shared_ptr<MultiColumnStats> &rhs) {
+              return lhs->column_ids.size() > rhs->column_ids.size();
+            });
+  for (auto &group_stats : groups) {
+    auto &group_columns = group_stats->column_ids;
+    if (!std::includes(remaining.begin(), remaining.end(),
+                       group_columns.begin(), group_columns.end())) {
+      continue;
+    }
+    max_cardinality = std::max(max_cardinality, group_stats->cardinality);
+    rows *= group_stats->cardinality;
+    std::vector<oid_t> rest;
+    std::set_difference(remaining.begin(), remaining.end(),
+                        group_columns.begin(), group_columns.end(),
+                        std::back_inserter(rest));
+    remaining = std::move(rest);
+  }
+
+  for (oid_t column : remaining) {
     double cardinality = input_stats->GetCardinality(column);
     max_cardinality = std::max(max_cardinality, cardinality);
     rows *= cardinality;
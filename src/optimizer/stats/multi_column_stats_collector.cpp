@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// multi_column_stats_collector.cpp
+//
+// Identification: src/optimizer/stats/multi_column_stats_collector.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/multi_column_stats_collector.h"
+
+#include "murmur3/MurmurHash3.h"
+#include "optimizer/stats/multi_column_stats.h"
+
+namespace peloton {
+namespace optimizer {
+
+MultiColumnStatsCollector::MultiColumnStatsCollector(
+    oid_t database_id, oid_t table_id, std::vector<oid_t> column_ids)
+    : database_id_{database_id},
+      table_id_{table_id},
+      column_ids_{column_ids},
+      hll_{hll_precision},
+      sketch_{cmsketch_eps, cmsketch_gamma, 0},
+      topk_{sketch_, top_k} {}
+
+void MultiColumnStatsCollector::AddValues(
+    const std::vector<type::Value> &values) {
+  PL_ASSERT(values.size() == column_ids_.size());
+  total_count_++;
+  std::string key = MultiColumnStats::MakeKey(values);
+  uint64_t hash[2];
+  MurmurHash3_x64_128(key.data(), static_cast<int>(key.size()), 0, hash);
+  hll_.UpdateHash(hash[0]);
+  topk_.Add(std::move(key));
+}
+
+void MultiColumnStatsCollector::Merge(MultiColumnStatsCollector &other) {
+  PL_ASSERT(column_ids_ == other.column_ids_);
+  total_count_ += other.total_count_;
+  hll_.Merge(other.hll_);
+  topk_.Merge(other.topk_);
+}
+
+std::vector<MultiColumnStatsCollector::ValueFrequencyPair>
+MultiColumnStatsCollector::GetCommonValueAndFrequency() {
+  auto val_freqs = topk_.GetAllOrderedMaxFirst();
+  // Scale the sample frequencies up to the whole table
+  for (auto &val_freq : val_freqs) {
+    val_freq.second /= sample_ratio_;
+  }
+  return val_freqs;
+}
+
+// Scaled up from a sample the same way as the cardinality of single columns
+uint64_t MultiColumnStatsCollector::GetCardinality() {
+  uint64_t cardinality = hll_.EstimateCardinality();
+  if (sample_ratio_ >= 1.0) {
+    return cardinality;
+  }
+  double sampled = static_cast<double>(total_count_);
+  if (sampled > 0 &&
+      cardinality >= sampled * (1.0 - hll_.RelativeError())) {
+    return static_cast<uint64_t>(cardinality / sample_ratio_);
+  }
+  return cardinality;
+}
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -48,6 +48,50 @@ double Selectivity::ComputeSelectivity(const std::shared_ptr<TableStats> &stats,
   }
 }
 
+double Selectivity::ComputeConjunctionSelectivity(
+    const std::shared_ptr<TableStats> &table_stats,
+    const std::vector<ValueCondition> &conditions) {
+  std::vector<bool> estimated(conditions.size(), false);
+  double res = 1;
+
+  // Cover the equality conditions with the largest groups of columns first
+  std::vector<std::shared_ptr<MultiColumnStats>> groups =
+      table_stats->GetMultiColumnStats();
+  std::sort(groups.begin(), groups.end(),
+            [](const std::shared_ptr<MultiColumnStats> &lhs,
+               const std::shared_ptr<MultiColumnStats> &rhs) {
+              return lhs->column_ids.size() > rhs->column_ids.size();
+            });
+  for (auto &group_stats : groups) {
+    std::vector<const ValueCondition *> group_conditions;
+    std::vector<size_t> condition_offsets;
+    for (oid_t column_id : group_stats->column_ids) {
+      for (size_t i = 0; i < conditions.size(); i++) {
+        if (!estimated[i] && conditions[i].column_id == column_id &&
+            conditions[i].type == ExpressionType::COMPARE_EQUAL) {
+          group_conditions.push_back(&conditions[i]);
+          condition_offsets.push_back(i);
+          break;
+        }
+      }
+    }
+    if (group_conditions.size() != group_stats->column_ids.size()) {
+      continue;
+    }
+    res *= Equal(*group_stats, group_conditions);
+    for (size_t offset : condition_offsets) {
+      estimated[offset] = true;
+    }
+  }
+
+  for (size_t i = 0; i < conditions.size(); i++) {
+    if (!estimated[i]) {
+      res *= ComputeSelectivity(table_stats, conditions[i]);
+    }
+  }
+  return res;
+}
+
 double Selectivity::LessThan(const std::shared_ptr<TableStats> &table_stats,
                              const ValueCondition &condition) {
   // Convert peloton value type to raw value (double)
@@ -65,7 +109,7 @@ double Selectivity::LessThan(const std::shared_ptr<TableStats> &table_stats,
     return DEFAULT_SELECTIVITY;
   }
   // Use histogram to estimate selectivity
-  std::vector<double> histogram = column_stats->histogram_bounds;
+  const std::vector<double> &histogram = column_stats->histogram_bounds;
   size_t n = histogram.size();
   PL_ASSERT(n > 0);
   // find correspond bin using binary search
@@ -78,61 +122,106 @@ double Selectivity::LessThan(const std::shared_ptr<TableStats> &table_stats,
 
 double Selectivity::Equal(const std::shared_ptr<TableStats> &table_stats,
                           const ValueCondition &condition) {
-  double value = StatsUtil::PelotonValueToNumericValue(condition.value);
   auto column_stats = table_stats->GetColumnStats(condition.column_id);
+  bool is_string = condition.value.GetTypeId() == type::TypeId::VARCHAR;
+  double value = is_string
+                     ? 0
+                     : StatsUtil::PelotonValueToNumericValue(condition.value);
 
-  if (std::isnan(value) || column_stats == nullptr) {
+  if (std::isnan(value) || column_stats == nullptr ||
+      (is_string && condition.value.IsNull())) {
     LOG_DEBUG("Calculate selectivity: return null");
     return DEFAULT_SELECTIVITY;
   }
 
   size_t numrows = column_stats->num_rows;
-  // For now only double is supported in stats storage
-  std::vector<double> most_common_vals = column_stats->most_common_vals;
-  std::vector<double> most_common_freqs = column_stats->most_common_freqs;
-  std::vector<double>::iterator first = most_common_vals.begin(),
-                                last = most_common_vals.end();
-
-  while (first != last) {
-    // For now only double is supported in stats storage
-    if (*first == value) {
-      break;
+  const std::vector<double> &most_common_freqs =
+      column_stats->most_common_freqs;
+  size_t num_common_vals = most_common_freqs.size();
+
+  // Look the value up in the most common values of its kind
+  size_t idx = num_common_vals;
+  if (is_string) {
+    const std::vector<std::string> &most_common_strs =
+        column_stats->most_common_strs;
+    std::string str_value = condition.value.ToString();
+    for (size_t i = 0; i < most_common_strs.size(); i++) {
+      if (most_common_strs[i] == str_value) {
+        idx = i;
+        break;
+      }
+    }
+  } else {
+    const std::vector<double> &most_common_vals =
+        column_stats->most_common_vals;
+    for (size_t i = 0; i < most_common_vals.size(); i++) {
+      if (most_common_vals[i] == value) {
+        idx = i;
+        break;
+      }
     }
-    ++first;
   }
 
   double res = DEFAULT_SELECTIVITY;
-  if (first != last) {
+  if (idx < num_common_vals) {
     // the target value for equality comparison (param value) is
     // found in most common values
-    size_t idx = first - most_common_vals.begin();
-
     res = most_common_freqs[idx] / (double)numrows;
   } else {
     // the target value for equality comparison (parm value) is
     // NOT found in most common values
     // (1 - sum(mvf))/(num_distinct - num_mcv)
     double sum_mvf = 0;
-    std::vector<double>::iterator first = most_common_freqs.begin(),
-                                  last = most_common_freqs.end();
-    while (first != last) {
-      sum_mvf += *first;
-      ++first;
+    for (double freq : most_common_freqs) {
+      sum_mvf += freq;
     }
 
-    if (numrows == 0 || column_stats->cardinality == most_common_vals.size()) {
+    if (numrows == 0 || column_stats->cardinality == num_common_vals) {
       LOG_TRACE("Equal selectivity division by 0.");
       return DEFAULT_SELECTIVITY;
     }
 
     res = (1 - sum_mvf / (double)numrows) /
-          (column_stats->cardinality - most_common_vals.size());
+          (column_stats->cardinality - num_common_vals);
   }
   PL_ASSERT(res >= 0);
   PL_ASSERT(res <= 1);
   return res;
 }
 
+double Selectivity::Equal(const MultiColumnStats &group_stats,
+                          const std::vector<const ValueCondition *> &conditions) {
+  std::vector<type::Value> values;
+  for (auto condition : conditions) {
+    values.push_back(condition->value);
+  }
+  std::string key = MultiColumnStats::MakeKey(values);
+
+  size_t numrows = group_stats.num_rows;
+  const std::vector<double> &most_common_freqs = group_stats.most_common_freqs;
+  size_t num_common_vals = most_common_freqs.size();
+  if (numrows == 0) {
+    LOG_TRACE("Equal selectivity division by 0.");
+    return DEFAULT_SELECTIVITY;
+  }
+
+  // Same estimate as for a single column, over combinations of values
+  double sum_mvf = 0;
+  for (size_t i = 0; i < num_common_vals; i++) {
+    if (group_stats.most_common_vals[i] == key) {
+      return std::min(most_common_freqs[i] / (double)numrows, 1.0);
+    }
+    sum_mvf += most_common_freqs[i];
+  }
+  if (group_stats.cardinality <= num_common_vals) {
+    // All combinations are common, so this one is rare if it occurs at all
+    return 1 / (double)numrows;
+  }
+  double res = (1 - sum_mvf / (double)numrows) /
+               (group_stats.cardinality - num_common_vals);
+  return std::max(std::min(res, 1.0), 0.0);
+}
+
 // Selectivity for 'LIKE' operator. The column type must be VARCHAR.
 // Complete implementation once we support LIKE operator.
 double Selectivity::Like(const std::shared_ptr<TableStats> &table_stats,
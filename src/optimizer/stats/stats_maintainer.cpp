@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_maintainer.cpp
+//
+// Identification: src/optimizer/stats/stats_maintainer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/stats_maintainer.h"
+
+#include "catalog/catalog_defaults.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/stats/stats_storage.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+#include "threadpool/mono_queue_pool.h"
+
+namespace peloton {
+namespace optimizer {
+
+bool StatsMaintainer::RecordModifications(storage::DataTable *table,
+                                          int64_t inserts, int64_t updates,
+                                          int64_t deletes) {
+  oid_t database_oid = table->GetDatabaseOid();
+  oid_t table_oid = table->GetOid();
+  if (database_oid == CATALOG_DATABASE_OID ||
+      !settings::SettingsManager::GetBool(settings::SettingId::auto_analyze)) {
+    return false;
+  }
+
+  std::function<void(std::function<void()>)> scheduler;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = table_entries_[table_oid];
+    entry.inserts = inserts;
+    entry.updates = updates;
+    entry.deletes = deletes;
+    if (entry.analysis_pending) {
+      return false;
+    }
+
+    int64_t modified = (inserts - entry.analyzed_inserts) +
+                       (updates - entry.analyzed_updates) +
+                       (deletes - entry.analyzed_deletes);
+    size_t num_rows = 0;
+    if (entry.table_stats_collector != nullptr) {
+      num_rows = entry.table_stats_collector->GetActiveTupleCount();
+    }
+    if (modified <= GetThreshold(num_rows)) {
+      return false;
+    }
+    entry.analysis_pending = true;
+    scheduler = scheduler_;
+  }
+
+  LOG_TRACE("Scheduling the analysis of table %u", table_oid);
+  auto analysis = [database_oid, table_oid] {
+    auto &stats_maintainer = StatsMaintainer::Instance();
+    storage::DataTable *table = nullptr;
+    try {
+      table = storage::StorageManager::GetInstance()->GetTableWithOid(
+          database_oid, table_oid);
+    } catch (CatalogException &e) {
+      // The table was dropped in the meantime
+      stats_maintainer.RemoveTable(table_oid);
+      return;
+    }
+    stats_maintainer.AnalyzeTable(table);
+  };
+  if (scheduler != nullptr) {
+    scheduler(analysis);
+  } else {
+    threadpool::MonoQueuePool::GetInstance().SubmitTask(
+        analysis, threadpool::TaskPriority::BATCH);
+  }
+  return true;
+}
+
+void StatsMaintainer::SetAnalyzed(
+    oid_t table_oid,
+    std::unique_ptr<TableStatsCollector> table_stats_collector) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &entry = table_entries_[table_oid];
+  ResetBaseline(entry, true);
+  entry.table_stats_collector = std::move(table_stats_collector);
+  entry.analysis_pending = false;
+}
+
+bool StatsMaintainer::AnalyzeTable(storage::DataTable *table) {
+  oid_t table_oid = table->GetOid();
+  std::unique_ptr<TableStatsCollector> table_stats_collector;
+  int64_t removals;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = table_entries_[table_oid];
+    removals = entry.updates + entry.deletes;
+
+    // Extend the stats of the last analysis, unless too many of the tuples
+    // they describe have been updated or deleted since the last full one
+    if (entry.table_stats_collector != nullptr &&
+        removals - entry.fully_analyzed_removals <=
+            GetThreshold(entry.table_stats_collector->GetActiveTupleCount())) {
+      table_stats_collector = std::move(entry.table_stats_collector);
+    }
+    ResetBaseline(entry, false);
+  }
+
+  bool incremental = table_stats_collector != nullptr &&
+                     table_stats_collector->CollectNewColumnStats();
+  if (!incremental) {
+    table_stats_collector.reset(new TableStatsCollector(table));
+    StatsStorage::GetInstance()->AddColumnGroups(table,
+                                                 table_stats_collector.get());
+    table_stats_collector->CollectColumnStats();
+  }
+  LOG_TRACE("Analyzed table %u (%s): %lu tuples", table_oid,
+            incremental ? "incremental" : "full",
+            table_stats_collector->GetActiveTupleCount());
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  StatsStorage::GetInstance()->InsertOrUpdateTableStats(
+      table, table_stats_collector.get(), txn);
+  txn_manager.CommitTransaction(txn);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &entry = table_entries_[table_oid];
+    if (!incremental) {
+      entry.fully_analyzed_removals = removals;
+    }
+    entry.table_stats_collector = std::move(table_stats_collector);
+    entry.analysis_pending = false;
+  }
+
+  num_analyses_++;
+  if (incremental) {
+    num_incremental_analyses_++;
+  }
+  return incremental;
+}
+
+void StatsMaintainer::RemoveTable(oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  table_entries_.erase(table_oid);
+}
+
+void StatsMaintainer::SetScheduler(
+    std::function<void(std::function<void()>)> scheduler) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  scheduler_ = scheduler;
+}
+
+double StatsMaintainer::GetThreshold(size_t num_rows) {
+  return settings::SettingsManager::GetInt(
+             settings::SettingId::auto_analyze_threshold) +
+         settings::SettingsManager::GetDouble(
+             settings::SettingId::auto_analyze_scale_factor) *
+             num_rows;
+}
+
+void StatsMaintainer::ResetBaseline(TableEntry &entry, bool full_analysis) {
+  entry.analyzed_inserts = entry.inserts;
+  entry.analyzed_updates = entry.updates;
+  entry.analyzed_deletes = entry.deletes;
+  if (full_analysis) {
+    entry.fully_analyzed_removals = entry.updates + entry.deletes;
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
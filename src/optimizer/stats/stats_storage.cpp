@@ -12,23 +12,38 @@
 
 #include "optimizer/stats/stats_storage.h"
 
+#include <algorithm>
+
 #include "catalog/catalog.h"
 #include "catalog/column_stats_catalog.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/multi_column_stats.h"
+#include "optimizer/stats/stats_maintainer.h"
+#include "optimizer/stats/stats_util.h"
 #include "optimizer/stats/table_stats.h"
 #include "storage/storage_manager.h"
 #include "type/ephemeral_pool.h"
+#include "type/serializeio.h"
 
 namespace peloton {
 namespace optimizer {
 
 // Get instance of the global stats storage
+std::mutex StatsStorage::hook_mutex_;
+std::function<void(oid_t, size_t)> StatsStorage::table_stats_hook_;
+
 StatsStorage *StatsStorage::GetInstance() {
   static StatsStorage global_stats_storage;
   return &global_stats_storage;
 }
 
+void StatsStorage::SetTableStatsHook(
+    std::function<void(oid_t, size_t)> hook) {
+  std::lock_guard<std::mutex> lock(hook_mutex_);
+  table_stats_hook_ = hook;
+}
+
 /**
  * StatsStorage - Constructor of StatsStorage.
  * In the construcotr, `pg_column_stats` table and `samples_db` database are
@@ -62,38 +77,63 @@ void StatsStorage::InsertOrUpdateTableStats(
   oid_t table_id = table->GetOid();
   size_t num_rows = table_stats_collector->GetActiveTupleCount();
 
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  bool single_statement_txn = false;
+  if (txn == nullptr) {
+    single_statement_txn = true;
+    txn = txn_manager.BeginTransaction();
+  }
+
+  std::shared_ptr<ColumnStatsMap> column_stats_map(new ColumnStatsMap());
   oid_t column_count = table_stats_collector->GetColumnCount();
   for (oid_t column_id = 0; column_id < column_count; column_id++) {
     ColumnStatsCollector *column_stats_collector =
         table_stats_collector->GetColumnStats(column_id);
     double cardinality = column_stats_collector->GetCardinality();
     double frac_null = column_stats_collector->GetFracNull();
-    // Currently, we only store the most common <value, frequency> pairs for
-    // numeric values.
-    // Since Peloton doesn't support ARRAY type now, we conver the array to
-    // VARCHAR.
-    // TODO: Store common <value, freq> pairs for VARCHAR.
     std::vector<ValueFrequencyPair> most_common_val_freqs =
         column_stats_collector->GetCommonValueAndFrequency();
     std::vector<double> histogram_bounds =
         column_stats_collector->GetHistogramBound();
+    std::string column_name = column_stats_collector->GetColumnName();
+    bool has_index = column_stats_collector->HasIndex();
 
-    std::string most_common_vals_str, most_common_freqs_str,
-        histogram_bounds_str;
+    (*column_stats_map)[column_id] = WriteColumnStats(
+        database_id, table_id, column_id, num_rows, cardinality, frac_null,
+        most_common_val_freqs, histogram_bounds, column_name, has_index, txn);
+  }
 
-    auto val_freq_str = ConvertValueFreqArrayToStrings(most_common_val_freqs);
-    most_common_vals_str = val_freq_str.first;
-    most_common_freqs_str = val_freq_str.second;
+  std::vector<std::shared_ptr<MultiColumnStats>> new_multi_column_stats;
+  auto &column_groups = table_stats_collector->GetColumnGroups();
+  for (size_t group = 0; group < column_groups.size(); group++) {
+    MultiColumnStatsCollector *group_stats_collector =
+        table_stats_collector->GetColumnGroupStats(group);
+    std::vector<std::string> most_common_vals;
+    std::vector<double> most_common_freqs;
+    for (auto &val_freq : group_stats_collector->GetCommonValueAndFrequency()) {
+      std::string key = val_freq.first.ToString();
+      if (key.size() > kMaxCommonValueLength) {
+        continue;
+      }
+      most_common_vals.push_back(std::move(key));
+      most_common_freqs.push_back(val_freq.second);
+    }
+    new_multi_column_stats.emplace_back(new MultiColumnStats(
+        database_id, table_id, column_groups[group], num_rows,
+        group_stats_collector->GetCardinality(), most_common_vals,
+        most_common_freqs));
+  }
 
-    histogram_bounds_str = ConvertDoubleArrayToString(histogram_bounds);
+  // The new stats cover all the columns, so they replace the cached ones once
+  // they are committed
+  txn->AddOnCommitCallback([this, database_id, table_id, num_rows,
+                            column_stats_map, new_multi_column_stats]() {
+    PublishTableStats(database_id, table_id, num_rows, column_stats_map,
+                      new_multi_column_stats);
+  });
 
-    std::string column_name = column_stats_collector->GetColumnName();
-    bool has_index = column_stats_collector->HasIndex();
-
-    InsertOrUpdateColumnStats(database_id, table_id, column_id, num_rows,
-                              cardinality, frac_null, most_common_vals_str,
-                              most_common_freqs_str, histogram_bounds_str,
-                              column_name, has_index, txn);
+  if (single_statement_txn) {
+    txn_manager.CommitTransaction(txn);
   }
 }
 
@@ -102,49 +142,214 @@ void StatsStorage::InsertOrUpdateTableStats(
  */
 void StatsStorage::InsertOrUpdateColumnStats(
     oid_t database_id, oid_t table_id, oid_t column_id, int num_rows,
-    double cardinality, double frac_null, std::string most_common_vals,
-    std::string most_common_freqs, std::string histogram_bounds,
-    std::string column_name, bool has_index, concurrency::TransactionContext *txn) {
-  LOG_TRACE("InsertOrUpdateColumnStats, %d, %lf, %lf, %s, %s, %s", num_rows,
-            cardinality, frac_null, most_common_vals.c_str(),
-            most_common_freqs.c_str(), histogram_bounds.c_str());
-  auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
+    double cardinality, double frac_null,
+    const std::vector<ValueFrequencyPair> &most_common_val_freqs,
+    const std::vector<double> &histogram_bounds, std::string column_name,
+    bool has_index, concurrency::TransactionContext *txn) {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-
   bool single_statement_txn = false;
   if (txn == nullptr) {
     single_statement_txn = true;
     txn = txn_manager.BeginTransaction();
   }
+
+  auto column_stats = WriteColumnStats(
+      database_id, table_id, column_id, num_rows, cardinality, frac_null,
+      most_common_val_freqs, histogram_bounds, column_name, has_index, txn);
+
+  // Update the column in the cached stats of the table once it is committed
+  txn->AddOnCommitCallback([this, database_id, table_id, column_stats]() {
+    PublishColumnStats(database_id, table_id, column_stats);
+  });
+
+  if (single_statement_txn) {
+    txn_manager.CommitTransaction(txn);
+  }
+}
+
+void StatsStorage::PublishTableStats(
+    oid_t database_id, oid_t table_id, size_t num_rows,
+    std::shared_ptr<const ColumnStatsMap> column_stats_map,
+    const std::vector<std::shared_ptr<MultiColumnStats>> &new_multi_column_stats) {
+  cache_lock_.WriteLock();
+  TableKey key(database_id, table_id);
+  uint64_t version = ++stats_versions_[key];
+  stats_cache_[key] = {version, column_stats_map};
+  auto &multi_column_stats = multi_column_stats_[key];
+  for (auto &group_stats : new_multi_column_stats) {
+    auto it = std::find_if(
+        multi_column_stats.begin(), multi_column_stats.end(),
+        [&group_stats](const std::shared_ptr<MultiColumnStats> &stats) {
+          return stats->HasColumns(group_stats->column_ids);
+        });
+    if (it != multi_column_stats.end()) {
+      *it = group_stats;
+    } else {
+      multi_column_stats.push_back(group_stats);
+    }
+  }
+  cache_lock_.Unlock();
+
+  std::lock_guard<std::mutex> lock(hook_mutex_);
+  if (table_stats_hook_) {
+    table_stats_hook_(table_id, num_rows);
+  }
+}
+
+void StatsStorage::PublishColumnStats(
+    oid_t database_id, oid_t table_id,
+    std::shared_ptr<ColumnStats> column_stats) {
+  cache_lock_.WriteLock();
+  TableKey key(database_id, table_id);
+  uint64_t version = ++stats_versions_[key];
+  auto it = stats_cache_.find(key);
+  if (it != stats_cache_.end()) {
+    std::shared_ptr<ColumnStatsMap> column_stats_map(
+        new ColumnStatsMap(*it->second.column_stats));
+    (*column_stats_map)[column_stats->column_id] = column_stats;
+    it->second = {version, column_stats_map};
+  }
+  cache_lock_.Unlock();
+}
+
+/**
+ * RemoveTableStats - Drop the cached stats of a dropped table.
+ */
+void StatsStorage::RemoveTableStats(oid_t database_id, oid_t table_id) {
+  TableKey key(database_id, table_id);
+  cache_lock_.WriteLock();
+  stats_cache_.erase(key);
+  stats_versions_.erase(key);
+  multi_column_stats_.erase(key);
+  cache_lock_.Unlock();
+}
+
+std::shared_ptr<ColumnStats> StatsStorage::WriteColumnStats(
+    oid_t database_id, oid_t table_id, oid_t column_id, int num_rows,
+    double cardinality, double frac_null,
+    const std::vector<ValueFrequencyPair> &most_common_val_freqs,
+    const std::vector<double> &histogram_bounds, std::string column_name,
+    bool has_index, concurrency::TransactionContext *txn) {
+  auto common_vals = EncodeCommonValues(most_common_val_freqs);
+  std::string hist_bounds = EncodeDoubles(histogram_bounds);
+  LOG_TRACE("InsertOrUpdateColumnStats, %d, %lf, %lf, %lu common values, %lu "
+            "histogram bounds",
+            num_rows, cardinality, frac_null, most_common_val_freqs.size(),
+            histogram_bounds.size());
+
+  auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
   column_stats_catalog->DeleteColumnStats(database_id, table_id, column_id,
                                           txn);
   column_stats_catalog->InsertColumnStats(
       database_id, table_id, column_id, num_rows, cardinality, frac_null,
-      most_common_vals, most_common_freqs, histogram_bounds, column_name,
+      common_vals.first, common_vals.second, hist_bounds, column_name,
       has_index, pool_.get(), txn);
 
-  if (single_statement_txn) {
-    txn_manager.CommitTransaction(txn);
-  }
+  std::vector<double> val_array, freq_array, histogram_array;
+  std::vector<std::string> str_array;
+  DecodeCommonValues(common_vals.first.data(), common_vals.first.size(),
+                     val_array, str_array);
+  freq_array =
+      DecodeDoubles(common_vals.second.data(), common_vals.second.size());
+  histogram_array = DecodeDoubles(hist_bounds.data(), hist_bounds.size());
+  return std::make_shared<ColumnStats>(
+      database_id, table_id, column_id, column_name, has_index, num_rows,
+      cardinality, frac_null, val_array, freq_array, histogram_array,
+      str_array);
 }
 
 /**
- * GetColumnStatsByID - Query the 'pg_column_stats' table to get the column
- * stats by IDs.
+ * GetColumnStatsByID - Get the column stats by IDs, from the cache or from the
+ * 'pg_column_stats' table.
  */
 std::shared_ptr<ColumnStats> StatsStorage::GetColumnStatsByID(oid_t database_id,
                                                               oid_t table_id,
                                                               oid_t column_id) {
+  auto column_stats_map = GetColumnStatsMap(database_id, table_id);
+  auto it = column_stats_map->find(column_id);
+  if (it == column_stats_map->end()) {
+    LOG_TRACE(
+        "ColumnStatsCollector not found for db: %u, table: %u, column: %u",
+        database_id, table_id, column_id);
+    return nullptr;
+  }
+  return it->second;
+}
+
+/**
+ * GetColumnStatsMap - Get the decoded stats of all the columns of the table.
+ * On a cache miss, the stats are read from the 'pg_column_stats' table and
+ * cached, unless they were written in the meantime.
+ */
+std::shared_ptr<const StatsStorage::ColumnStatsMap>
+StatsStorage::GetColumnStatsMap(oid_t database_id, oid_t table_id) {
+  TableKey key(database_id, table_id);
+  uint64_t version = 0;
+  cache_lock_.ReadLock();
+  auto version_it = stats_versions_.find(key);
+  if (version_it != stats_versions_.end()) {
+    version = version_it->second;
+  }
+  auto cache_it = stats_cache_.find(key);
+  if (cache_it != stats_cache_.end() && cache_it->second.version == version) {
+    auto column_stats_map = cache_it->second.column_stats;
+    cache_lock_.Unlock();
+    return column_stats_map;
+  }
+  cache_lock_.Unlock();
+
   auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
-  // std::unique_ptr<std::vector<type::Value>> column_stats_vector
-  auto column_stats_vector = column_stats_catalog->GetColumnStats(
-      database_id, table_id, column_id, txn);
+  std::map<oid_t, std::unique_ptr<std::vector<type::Value>>> column_stats_map;
+  column_stats_catalog->GetTableStats(database_id, table_id, txn,
+                                      column_stats_map);
   txn_manager.CommitTransaction(txn);
 
-  return ConvertVectorToColumnStats(database_id, table_id, column_id,
-                                    column_stats_vector);
+  std::shared_ptr<ColumnStatsMap> decoded_stats_map(new ColumnStatsMap());
+  for (auto &column_stats : column_stats_map) {
+    (*decoded_stats_map)[column_stats.first] = ConvertVectorToColumnStats(
+        database_id, table_id, column_stats.first, column_stats.second);
+  }
+
+  cache_lock_.WriteLock();
+  if (stats_versions_[key] == version) {
+    stats_cache_[key] = {version, decoded_stats_map};
+  }
+  cache_lock_.Unlock();
+  return decoded_stats_map;
+}
+
+std::vector<std::shared_ptr<MultiColumnStats>>
+StatsStorage::GetMultiColumnStats(oid_t database_id, oid_t table_id) {
+  std::vector<std::shared_ptr<MultiColumnStats>> multi_column_stats;
+  cache_lock_.ReadLock();
+  auto it = multi_column_stats_.find(TableKey(database_id, table_id));
+  if (it != multi_column_stats_.end()) {
+    multi_column_stats = it->second;
+  }
+  cache_lock_.Unlock();
+  return multi_column_stats;
+}
+
+void StatsStorage::AddColumnGroups(storage::DataTable *table,
+                                   TableStatsCollector *table_stats_collector) {
+  for (auto &group_stats :
+       GetMultiColumnStats(table->GetDatabaseOid(), table->GetOid())) {
+    table_stats_collector->AddColumnGroup(group_stats->column_ids);
+  }
+}
+
+uint64_t StatsStorage::GetTableStatsVersion(oid_t database_id,
+                                            oid_t table_id) {
+  cache_lock_.ReadLock();
+  uint64_t version = 0;
+  auto it = stats_versions_.find(TableKey(database_id, table_id));
+  if (it != stats_versions_.end()) {
+    version = it->second;
+  }
+  cache_lock_.Unlock();
+  return version;
 }
 
 /**
@@ -173,24 +378,23 @@ std::shared_ptr<ColumnStats> StatsStorage::ConvertVectorToColumnStats(
           .GetAs<double>();
 
   std::vector<double> val_array, freq_array, histogram_bounds;
-  char *val_array_ptr =
-      (*column_stats_vector)[catalog::ColumnStatsCatalog::COMMON_VALS_OFF]
-          .GetAs<char *>();
-  if (val_array_ptr != nullptr) {
-    val_array = ConvertStringToDoubleArray(std::string(val_array_ptr));
+  std::vector<std::string> str_array;
+  auto &common_vals =
+      (*column_stats_vector)[catalog::ColumnStatsCatalog::COMMON_VALS_OFF];
+  if (!common_vals.IsNull()) {
+    DecodeCommonValues(common_vals.GetData(), common_vals.GetLength(),
+                       val_array, str_array);
   }
-  char *freq_array_ptr =
-      (*column_stats_vector)[catalog::ColumnStatsCatalog::COMMON_FREQS_OFF]
-          .GetAs<char *>();
-  if (freq_array_ptr != nullptr) {
-    freq_array = ConvertStringToDoubleArray(std::string(freq_array_ptr));
+  auto &common_freqs =
+      (*column_stats_vector)[catalog::ColumnStatsCatalog::COMMON_FREQS_OFF];
+  if (!common_freqs.IsNull()) {
+    freq_array = DecodeDoubles(common_freqs.GetData(), common_freqs.GetLength());
   }
-  char *hist_bounds_ptr =
-      (*column_stats_vector)[catalog::ColumnStatsCatalog::HIST_BOUNDS_OFF]
-          .GetAs<char *>();
-  if (hist_bounds_ptr != nullptr) {
-    LOG_TRACE("histgram bounds: %s", hist_bounds_ptr);
-    histogram_bounds = ConvertStringToDoubleArray(std::string(hist_bounds_ptr));
+  auto &hist_bounds =
+      (*column_stats_vector)[catalog::ColumnStatsCatalog::HIST_BOUNDS_OFF];
+  if (!hist_bounds.IsNull()) {
+    histogram_bounds =
+        DecodeDoubles(hist_bounds.GetData(), hist_bounds.GetLength());
   }
 
   char *column_name =
@@ -204,62 +408,61 @@ std::shared_ptr<ColumnStats> StatsStorage::ConvertVectorToColumnStats(
   std::shared_ptr<ColumnStats> column_stats(new ColumnStats(
       database_id, table_id, column_id, std::string(column_name), has_index,
       num_rows, cardinality, frac_null, val_array, freq_array,
-      histogram_bounds));
+      histogram_bounds, str_array));
 
   return column_stats;
 }
 
 /**
- * GetTableStats - This function queries the column_stats_catalog for the table
- *stats.
+ * GetTableStats - This function gets the stats of all the columns of the
+ * table.
  *
  * The return value is the shared_ptr of TableStats wrapper.
  */
 std::shared_ptr<TableStats> StatsStorage::GetTableStats(oid_t database_id,
                                                         oid_t table_id) {
-  auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
-  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-  auto txn = txn_manager.BeginTransaction();
-  std::map<oid_t, std::unique_ptr<std::vector<type::Value>>> column_stats_map;
-  column_stats_catalog->GetTableStats(database_id, table_id, txn,
-                                      column_stats_map);
-  txn_manager.CommitTransaction(txn);
+  auto column_stats_map = GetColumnStatsMap(database_id, table_id);
 
   std::vector<std::shared_ptr<ColumnStats>> column_stats_ptrs;
-  for (auto it = column_stats_map.begin(); it != column_stats_map.end(); ++it) {
-    column_stats_ptrs.push_back(ConvertVectorToColumnStats(
-        database_id, table_id, it->first, it->second));
+  for (auto &column_stats : *column_stats_map) {
+    column_stats_ptrs.push_back(column_stats.second);
   }
 
-  return std::shared_ptr<TableStats>(new TableStats(column_stats_ptrs));
+  std::shared_ptr<TableStats> table_stats(new TableStats(column_stats_ptrs));
+  for (auto &group_stats : GetMultiColumnStats(database_id, table_id)) {
+    table_stats->AddMultiColumnStats(group_stats);
+  }
+  return table_stats;
 }
 
 /**
- * GetTableStats - This function query the column_stats_catalog for the table
- *stats.
- * In this function, the column ids are specified.
+ * GetTableStats - This function gets the stats of the given columns of the
+ * table, and the joint stats of the groups among them.
  *
  * The return value is the shared_ptr of TableStats wrapper.
  */
 std::shared_ptr<TableStats> StatsStorage::GetTableStats(
     oid_t database_id, oid_t table_id, std::vector<oid_t> column_ids) {
-  auto column_stats_catalog = catalog::ColumnStatsCatalog::GetInstance(nullptr);
-  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-  auto txn = txn_manager.BeginTransaction();
-  std::map<oid_t, std::unique_ptr<std::vector<type::Value>>> column_stats_map;
-  column_stats_catalog->GetTableStats(database_id, table_id, txn,
-                                      column_stats_map);
+  auto column_stats_map = GetColumnStatsMap(database_id, table_id);
 
   std::vector<std::shared_ptr<ColumnStats>> column_stats_ptrs;
   for (oid_t col_id : column_ids) {
-    auto it = column_stats_map.find(col_id);
-    if (it != column_stats_map.end()) {
-      column_stats_ptrs.push_back(ConvertVectorToColumnStats(
-          database_id, table_id, col_id, it->second));
+    auto it = column_stats_map->find(col_id);
+    if (it != column_stats_map->end()) {
+      column_stats_ptrs.push_back(it->second);
     }
   }
 
-  return std::shared_ptr<TableStats>(new TableStats(column_stats_ptrs));
+  std::shared_ptr<TableStats> table_stats(new TableStats(column_stats_ptrs));
+  std::sort(column_ids.begin(), column_ids.end());
+  for (auto &group_stats : GetMultiColumnStats(database_id, table_id)) {
+    if (std::includes(column_ids.begin(), column_ids.end(),
+                      group_stats->column_ids.begin(),
+                      group_stats->column_ids.end())) {
+      table_stats->AddMultiColumnStats(group_stats);
+    }
+  }
+  return table_stats;
 }
 
 /**
@@ -288,8 +491,11 @@ ResultType StatsStorage::AnalyzeStatsForAllTables(
       LOG_TRACE("Analyzing table: %s", table->GetName().c_str());
       std::unique_ptr<TableStatsCollector> table_stats_collector(
           new TableStatsCollector(table));
+      AddColumnGroups(table, table_stats_collector.get());
       table_stats_collector->CollectColumnStats();
       InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+      StatsMaintainer::Instance().SetAnalyzed(
+          table->GetOid(), std::move(table_stats_collector));
     }
   }
   return ResultType::SUCCESS;
@@ -308,16 +514,169 @@ ResultType StatsStorage::AnalyzeStatsForTable(storage::DataTable *table,
   }
   std::unique_ptr<TableStatsCollector> table_stats_collector(
       new TableStatsCollector(table));
+  AddColumnGroups(table, table_stats_collector.get());
   table_stats_collector->CollectColumnStats();
   InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+  StatsMaintainer::Instance().SetAnalyzed(table->GetOid(),
+                                          std::move(table_stats_collector));
   return ResultType::SUCCESS;
 }
 
-// TODO: Implement it.
+/**
+ * AnalayzeStatsForColumns - This function analyzes the stats for one table,
+ * and from now on also the joint stats of the given group of columns.
+ */
 ResultType StatsStorage::AnalayzeStatsForColumns(
-    UNUSED_ATTRIBUTE storage::DataTable *table,
-    UNUSED_ATTRIBUTE std::vector<std::string> column_names) {
-  return ResultType::FAILURE;
+    storage::DataTable *table, std::vector<std::string> column_names,
+    concurrency::TransactionContext *txn) {
+  auto schema = table->GetSchema();
+  std::vector<oid_t> column_ids;
+  for (auto &column_name : column_names) {
+    oid_t column_id = schema->GetColumnID(column_name);
+    if (column_id == INVALID_OID) {
+      LOG_TRACE("Column %s not found in table %s", column_name.c_str(),
+                table->GetName().c_str());
+      return ResultType::FAILURE;
+    }
+    column_ids.push_back(column_id);
+  }
+
+  std::unique_ptr<TableStatsCollector> table_stats_collector(
+      new TableStatsCollector(table));
+  AddColumnGroups(table, table_stats_collector.get());
+  std::sort(column_ids.begin(), column_ids.end());
+  column_ids.erase(std::unique(column_ids.begin(), column_ids.end()),
+                   column_ids.end());
+  if (column_ids.size() > 1) {
+    table_stats_collector->AddColumnGroup(column_ids);
+  }
+  table_stats_collector->CollectColumnStats();
+  InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+  StatsMaintainer::Instance().SetAnalyzed(table->GetOid(),
+                                          std::move(table_stats_collector));
+  return ResultType::SUCCESS;
+}
+
+//===--------------------------------------------------------------------===//
+// Binary stats format
+//
+// Every encoded array starts with the format version (1 byte), the kind of
+// its values (1 byte) and the number of values (4 bytes). Numeric values
+// follow as doubles, and string values as length-prefixed strings.
+//===--------------------------------------------------------------------===//
+
+std::string StatsStorage::EncodeDoubles(
+    const std::vector<double> &double_array) {
+  if (double_array.empty()) {
+    return std::string();
+  }
+  CopySerializeOutput output;
+  output.WriteByte(kStatsFormatVersion);
+  output.WriteByte(kNumericValues);
+  output.WriteInt(static_cast<int32_t>(double_array.size()));
+  for (double value : double_array) {
+    output.WriteDouble(value);
+  }
+  return std::string(output.Data(), output.Size());
+}
+
+std::vector<double> StatsStorage::DecodeDoubles(const char *data,
+                                                size_t length) {
+  std::vector<double> double_array;
+  const size_t header_size = 2 * sizeof(int8_t) + sizeof(int32_t);
+  if (length < header_size) {
+    return double_array;
+  }
+  ReferenceSerializeInput input(data, length);
+  int8_t version = input.ReadByte();
+  int8_t kind = input.ReadByte();
+  int32_t count = input.ReadInt();
+  if (version != kStatsFormatVersion || kind != kNumericValues || count < 0 ||
+      header_size + count * sizeof(double) != length) {
+    LOG_DEBUG("Invalid encoded stats array (version %d, kind %d, count %d)",
+              version, kind, count);
+    return double_array;
+  }
+  double_array.reserve(count);
+  for (int32_t i = 0; i < count; i++) {
+    double_array.push_back(input.ReadDouble());
+  }
+  return double_array;
+}
+
+std::pair<std::string, std::string> StatsStorage::EncodeCommonValues(
+    const std::vector<ValueFrequencyPair> &val_freqs) {
+  if (val_freqs.empty()) {
+    return std::make_pair(std::string(), std::string());
+  }
+  auto type_id = val_freqs[0].first.GetTypeId();
+  bool is_string =
+      type_id == type::TypeId::VARCHAR || type_id == type::TypeId::VARBINARY;
+
+  std::vector<double> numeric_vals, freqs;
+  std::vector<std::string> string_vals;
+  for (auto &val_freq : val_freqs) {
+    if (val_freq.first.IsNull()) {
+      continue;
+    }
+    if (is_string) {
+      std::string value = val_freq.first.ToString();
+      // Wide values are rarely worth remembering
+      if (value.size() > kMaxCommonValueLength) {
+        continue;
+      }
+      string_vals.push_back(std::move(value));
+    } else {
+      numeric_vals.push_back(
+          StatsUtil::PelotonValueToNumericValue(val_freq.first));
+    }
+    freqs.push_back(val_freq.second);
+  }
+  if (freqs.empty()) {
+    return std::make_pair(std::string(), std::string());
+  }
+
+  std::string encoded_vals;
+  if (is_string) {
+    CopySerializeOutput output;
+    output.WriteByte(kStatsFormatVersion);
+    output.WriteByte(kStringValues);
+    output.WriteInt(static_cast<int32_t>(string_vals.size()));
+    for (auto &value : string_vals) {
+      output.WriteTextString(value);
+    }
+    encoded_vals = std::string(output.Data(), output.Size());
+  } else {
+    encoded_vals = EncodeDoubles(numeric_vals);
+  }
+  return std::make_pair(encoded_vals, EncodeDoubles(freqs));
+}
+
+void StatsStorage::DecodeCommonValues(const char *data, size_t length,
+                                      std::vector<double> &numeric_vals,
+                                      std::vector<std::string> &string_vals) {
+  const size_t header_size = 2 * sizeof(int8_t) + sizeof(int32_t);
+  if (length < header_size) {
+    return;
+  }
+  if (data[1] == kNumericValues) {
+    numeric_vals = DecodeDoubles(data, length);
+    return;
+  }
+
+  ReferenceSerializeInput input(data, length);
+  int8_t version = input.ReadByte();
+  int8_t kind = input.ReadByte();
+  int32_t count = input.ReadInt();
+  if (version != kStatsFormatVersion || kind != kStringValues || count < 0) {
+    LOG_DEBUG("Invalid encoded stats array (version %d, kind %d, count %d)",
+              version, kind, count);
+    return;
+  }
+  string_vals.reserve(count);
+  for (int32_t i = 0; i < count; i++) {
+    string_vals.push_back(input.ReadTextString());
+  }
 }
 
 }  // namespace optimizer
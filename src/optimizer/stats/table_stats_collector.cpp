@@ -12,11 +12,19 @@
 
 #include "optimizer/stats/table_stats_collector.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
 #include "common/macros.h"
+#include "optimizer/stats/tuple_sampler.h"
+#include "settings/settings_manager.h"
+#include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "threadpool/mono_queue_pool.h"
 #include "common/internal_types.h"
 #include "type/value.h"
 
@@ -27,10 +35,23 @@ TableStatsCollector::TableStatsCollector(storage::DataTable *table)
     : table_(table),
       column_stats_collectors_{},
       active_tuple_count_{0},
-      column_count_{0} {}
+      column_count_{0},
+      sampled_{false},
+      collected_recycled_slots_{0} {}
 
 TableStatsCollector::~TableStatsCollector() {}
 
+void TableStatsCollector::AddColumnGroup(std::vector<oid_t> column_ids) {
+  std::sort(column_ids.begin(), column_ids.end());
+  column_ids.erase(std::unique(column_ids.begin(), column_ids.end()),
+                   column_ids.end());
+  PL_ASSERT(column_ids.size() > 1);
+  if (std::find(column_groups_.begin(), column_groups_.end(), column_ids) ==
+      column_groups_.end()) {
+    column_groups_.push_back(column_ids);
+  }
+}
+
 void TableStatsCollector::CollectColumnStats() {
   schema_ = table_->GetSchema();
   column_count_ = schema_->GetColumnCount();
@@ -40,44 +61,259 @@ void TableStatsCollector::CollectColumnStats() {
     return;
   }
 
-  InitColumnStatsCollectors();
+  // Forget the groups of columns that were dropped
+  column_groups_.erase(
+      std::remove_if(column_groups_.begin(), column_groups_.end(),
+                     [this](const std::vector<oid_t> &column_ids) {
+                       return column_ids.back() >= column_count_;
+                     }),
+      column_groups_.end());
 
+  // Collect stats from all tile groups of small tables, and from a random
+  // sample of the tile groups of large ones
   size_t tile_group_count = table_->GetTileGroupCount();
-  // Collect stats for all tile groups.
+  size_t sample_count = static_cast<size_t>(std::max(
+      settings::SettingsManager::GetInt(
+          settings::SettingId::analyze_sample_tile_groups),
+      0));
+  std::vector<oid_t> tile_group_offsets;
+  sampled_ = sample_count > 0 && tile_group_count > sample_count;
+  if (sampled_) {
+    TupleSampler sampler(table_);
+    tile_group_offsets = sampler.SampleTileGroups(sample_count);
+  } else {
+    for (size_t offset = 0; offset < tile_group_count; offset++) {
+      tile_group_offsets.push_back(offset);
+    }
+  }
+
+  // Each thread collects stats from its share of the tile groups into its
+  // own collectors, which are merged afterwards
+  size_t num_threads = std::min(
+      static_cast<size_t>(std::max(settings::SettingsManager::GetInt(
+                                       settings::SettingId::analyze_parallelism),
+                                   1)),
+      std::max(tile_group_offsets.size(), static_cast<size_t>(1)));
+  std::vector<std::vector<std::unique_ptr<ColumnStatsCollector>>> collectors(
+      num_threads);
+  std::vector<std::vector<std::unique_ptr<MultiColumnStatsCollector>>>
+      group_collectors(num_threads);
+  std::vector<size_t> tuple_counts(num_threads, 0);
+  for (size_t thread_id = 0; thread_id < num_threads; thread_id++) {
+    InitColumnStatsCollectors(collectors[thread_id]);
+    InitColumnGroupStatsCollectors(group_collectors[thread_id]);
+  }
+
+  // Remember where the scan ends in every tile group, so that the tuples
+  // inserted later can be collected incrementally
+  collected_recycled_slots_ = table_->GetRecycledSlotCount();
+  collected_tuple_slots_.resize(tile_group_count);
   for (size_t offset = 0; offset < tile_group_count; offset++) {
-    std::shared_ptr<storage::TileGroup> tile_group =
-        table_->GetTileGroup(offset);
-    storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
-    oid_t tuple_count = tile_group->GetAllocatedTupleCount();
-    active_tuple_count_ += tile_group_header->GetActiveTupleCount();
-    // Collect stats for all tuples in the tile group.
-    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
-      txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
-      if (tuple_txn_id != INVALID_TXN_ID) {
-        // Collect stats for all columns.
-        for (oid_t column_id = 0; column_id < column_count_; column_id++) {
-          type::Value value = tile_group->GetValue(tuple_id, column_id);
-          column_stats_collectors_[column_id]->AddValue(value);
-        } /* column */
+    collected_tuple_slots_[offset] =
+        table_->GetTileGroup(offset)->GetHeader()->GetCurrentNextTupleSlot();
+  }
+
+  // The threads take tile groups from a shared cursor
+  std::atomic<size_t> next_offset(0);
+  auto collect = [this, &tile_group_offsets, &collectors, &group_collectors,
+                  &tuple_counts, &next_offset](size_t thread_id) {
+    for (size_t i = next_offset++; i < tile_group_offsets.size();
+         i = next_offset++) {
+      auto tile_group = table_->GetTileGroup(tile_group_offsets[i]);
+      tuple_counts[thread_id] += CollectTileGroupStats(
+          tile_group.get(), 0, collected_tuple_slots_[tile_group_offsets[i]],
+          collectors[thread_id], group_collectors[thread_id]);
+    }
+  };
+
+  // The helpers are batch tasks of the worker pool, which may be too busy to
+  // run them (e.g., with this very statement). This thread collects whatever
+  // the helpers haven't taken, and only waits for the helpers that started.
+  struct Helpers {
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool closed = false;
+    size_t next_thread_id = 1;
+    size_t running = 0;
+  };
+  auto helpers = std::make_shared<Helpers>();
+  auto &pool = threadpool::MonoQueuePool::GetInstance();
+  for (size_t thread_id = 1; thread_id < num_threads; thread_id++) {
+    pool.SubmitTask([helpers, collect] {
+      size_t thread_id;
+      {
+        std::lock_guard<std::mutex> lock(helpers->mutex);
+        if (helpers->closed) return;
+        thread_id = helpers->next_thread_id++;
+        helpers->running++;
       }
-    } /* tuple */
-  }   /* tile group */
+      collect(thread_id);
+      std::lock_guard<std::mutex> lock(helpers->mutex);
+      helpers->running--;
+      helpers->done_cv.notify_all();
+    }, threadpool::TaskPriority::BATCH);
+  }
+  collect(0);
+  {
+    std::unique_lock<std::mutex> lock(helpers->mutex);
+    helpers->closed = true;
+    helpers->done_cv.wait(lock, [&helpers] { return helpers->running == 0; });
+  }
+
+  column_stats_collectors_ = std::move(collectors[0]);
+  column_group_stats_collectors_ = std::move(group_collectors[0]);
+  size_t sampled_tuple_count = tuple_counts[0];
+  for (size_t thread_id = 1; thread_id < num_threads; thread_id++) {
+    for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+      column_stats_collectors_[column_id]->Merge(
+          *collectors[thread_id][column_id]);
+    }
+    for (size_t group = 0; group < column_groups_.size(); group++) {
+      column_group_stats_collectors_[group]->Merge(
+          *group_collectors[thread_id][group]);
+    }
+    sampled_tuple_count += tuple_counts[thread_id];
+  }
+
+  // Scale the sample up to the whole table
+  active_tuple_count_ = sampled_tuple_count;
+  if (tile_group_offsets.size() < tile_group_count) {
+    double sample_ratio =
+        static_cast<double>(tile_group_offsets.size()) / tile_group_count;
+    active_tuple_count_ =
+        static_cast<size_t>(sampled_tuple_count / sample_ratio);
+    for (auto &column_stats_collector : column_stats_collectors_) {
+      column_stats_collector->SetSampleRatio(sample_ratio);
+    }
+    for (auto &group_stats_collector : column_group_stats_collectors_) {
+      group_stats_collector->SetSampleRatio(sample_ratio);
+    }
+  }
+
+  // Set indexes in the column stats collectors.
+  for (auto &column_set : table_->GetIndexColumns()) {
+    auto column_id = *(column_set.begin());
+    column_stats_collectors_[column_id]->SetColumnIndexed();
+  }
 }
 
-void TableStatsCollector::InitColumnStatsCollectors() {
+bool TableStatsCollector::CollectNewColumnStats() {
+  // The stats of a sample can't be extended with those of single tuples
+  if (sampled_ || column_count_ == 0 ||
+      column_count_ != table_->GetSchema()->GetColumnCount() ||
+      column_groups_.size() != column_group_stats_collectors_.size()) {
+    return false;
+  }
+
+  // Tuples in recycled slots may be anywhere in the table
+  size_t recycled_slots = table_->GetRecycledSlotCount();
+  size_t tile_group_count = table_->GetTileGroupCount();
+  if (recycled_slots != collected_recycled_slots_ ||
+      tile_group_count < collected_tuple_slots_.size()) {
+    return false;
+  }
+
+  // Resume where the previous collection ended in every tile group
+  std::vector<std::unique_ptr<ColumnStatsCollector>> collectors;
+  std::vector<std::unique_ptr<MultiColumnStatsCollector>> group_collectors;
+  InitColumnStatsCollectors(collectors);
+  InitColumnGroupStatsCollectors(group_collectors);
+  size_t new_tuple_count = 0;
+  std::vector<oid_t> tuple_slots(tile_group_count);
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    auto tile_group = table_->GetTileGroup(offset);
+    oid_t begin = offset < collected_tuple_slots_.size()
+                      ? collected_tuple_slots_[offset]
+                      : 0;
+    tuple_slots[offset] = tile_group->GetHeader()->GetCurrentNextTupleSlot();
+    if (tuple_slots[offset] > begin) {
+      new_tuple_count +=
+          CollectTileGroupStats(tile_group.get(), begin, tuple_slots[offset],
+                                collectors, group_collectors);
+    }
+  }
+
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    column_stats_collectors_[column_id]->Merge(*collectors[column_id]);
+  }
+  for (size_t group = 0; group < column_groups_.size(); group++) {
+    column_group_stats_collectors_[group]->Merge(*group_collectors[group]);
+  }
+  active_tuple_count_ += new_tuple_count;
+  collected_tuple_slots_ = std::move(tuple_slots);
+  return true;
+}
+
+size_t TableStatsCollector::CollectTileGroupStats(
+    storage::TileGroup *tile_group, oid_t begin_tuple_id, oid_t end_tuple_id,
+    std::vector<std::unique_ptr<ColumnStatsCollector>> &collectors,
+    std::vector<std::unique_ptr<MultiColumnStatsCollector>>
+        &group_collectors) {
+  // Locate the numeric columns in the tiles so that their values can be read
+  // in place rather than boxed into type::Values
+  std::vector<storage::Tile *> tiles(column_count_, nullptr);
+  std::vector<size_t> tile_column_offsets(column_count_, 0);
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    if (!ColumnStatsCollector::SupportsRawValues(
+            schema_->GetType(column_id))) {
+      continue;
+    }
+    oid_t tile_offset, tile_column_id;
+    tile_group->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+    tiles[column_id] = tile_group->GetTile(tile_offset);
+    tile_column_offsets[column_id] =
+        tiles[column_id]->GetSchema()->GetOffset(tile_column_id);
+  }
+
+  storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
+  size_t active_tuple_count = 0;
+  std::vector<type::Value> group_values;
+  // Collect stats for all tuples in the range.
+  for (oid_t tuple_id = begin_tuple_id; tuple_id < end_tuple_id; tuple_id++) {
+    txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+    if (tuple_txn_id == INVALID_TXN_ID) {
+      continue;
+    }
+    active_tuple_count++;
+    // Collect stats for all columns.
+    for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+      if (tiles[column_id] != nullptr) {
+        collectors[column_id]->AddRawValue(
+            tiles[column_id]->GetTupleLocation(tuple_id) +
+            tile_column_offsets[column_id]);
+      } else {
+        type::Value value = tile_group->GetValue(tuple_id, column_id);
+        collectors[column_id]->AddValue(value);
+      }
+    } /* column */
+    for (size_t group = 0; group < column_groups_.size(); group++) {
+      group_values.clear();
+      for (oid_t column_id : column_groups_[group]) {
+        group_values.push_back(tile_group->GetValue(tuple_id, column_id));
+      }
+      group_collectors[group]->AddValues(group_values);
+    } /* column group */
+  }   /* tuple */
+  return active_tuple_count;
+}
+
+void TableStatsCollector::InitColumnStatsCollectors(
+    std::vector<std::unique_ptr<ColumnStatsCollector>> &collectors) {
   oid_t database_id = table_->GetDatabaseOid();
   oid_t table_id = table_->GetOid();
   for (oid_t column_id = 0; column_id < column_count_; column_id++) {
     std::unique_ptr<ColumnStatsCollector> colstats(new ColumnStatsCollector(
         database_id, table_id, column_id, schema_->GetType(column_id),
         schema_->GetColumn(column_id).GetName()));
-    column_stats_collectors_.push_back(std::move(colstats));
+    collectors.push_back(std::move(colstats));
   }
+}
 
-  // Set indexes in the column stats collectors.
-  for (auto &column_set : table_->GetIndexColumns()) {
-    auto column_id = *(column_set.begin());
-    column_stats_collectors_[column_id]->SetColumnIndexed();
+void TableStatsCollector::InitColumnGroupStatsCollectors(
+    std::vector<std::unique_ptr<MultiColumnStatsCollector>> &collectors) {
+  for (auto &column_ids : column_groups_) {
+    collectors.emplace_back(new MultiColumnStatsCollector(
+        table_->GetDatabaseOid(), table_->GetOid(), column_ids));
   }
 }
 
@@ -86,5 +322,11 @@ ColumnStatsCollector *TableStatsCollector::GetColumnStats(oid_t column_id) {
   return column_stats_collectors_[column_id].get();
 }
 
+MultiColumnStatsCollector *TableStatsCollector::GetColumnGroupStats(
+    size_t group_offset) {
+  PL_ASSERT(group_offset < column_group_stats_collectors_.size());
+  return column_group_stats_collectors_[group_offset].get();
+}
+
 }  // namespace optimizer
 }  // namespace peloton
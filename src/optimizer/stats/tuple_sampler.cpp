@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cinttypes>
+#include <random>
+
 #include "optimizer/stats/tuple_sampler.h"
 
 #include "storage/data_table.h"
@@ -69,6 +72,35 @@ size_t TupleSampler::AcquireSampleTuples(size_t target_sample_count) {
   return sampled_tuples.size();
 }
 
+/**
+ * SampleTileGroups - Reservoir sampling of tile groups. Every tile group of
+ * the table ends up in the sample with the same probability.
+ */
+std::vector<oid_t> TupleSampler::SampleTileGroups(size_t sample_count) {
+  size_t tile_group_count = table->GetTileGroupCount();
+  std::vector<oid_t> sample;
+  sample.reserve(std::min(sample_count, tile_group_count));
+
+  std::mt19937_64 rng(std::random_device{}());
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    if (sample.size() < sample_count) {
+      sample.push_back(offset);
+      continue;
+    }
+    // Replace a random sampled tile group with probability
+    // sample_count / (offset + 1)
+    std::uniform_int_distribution<size_t> dist(0, offset);
+    size_t slot = dist(rng);
+    if (slot < sample_count) {
+      sample[slot] = offset;
+    }
+  }
+
+  // Visit the tile groups in storage order
+  std::sort(sample.begin(), sample.end());
+  return sample;
+}
+
 /**
  * GetTupleInTileGroup - This function is a helper function to get a tuple in
  * a tile group.
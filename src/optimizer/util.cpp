@@ -14,10 +14,16 @@
 
 #include "concurrency/transaction_manager_factory.h"
 #include "catalog/query_metrics_catalog.h"
+#include "catalog/table_catalog.h"
+#include "common/exception.h"
 #include "expression/expression_util.h"
+#include "expression/function_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "index/index.h"
 #include "planner/copy_plan.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
+#include "storage/storage_manager.h"
 
 namespace peloton {
 namespace optimizer {
@@ -86,8 +92,9 @@ bool CheckIndexSearchable(storage::DataTable *target_table,
   auto index = target_table->GetIndex(index_id);
 
   // Check whether the index is visible
-  // This is for the IndexTuner demo
-  if (index->GetMetadata()->GetVisibility() == false) {
+  // This is for the IndexTuner demo. Indexes being built are incomplete.
+  if (index->GetMetadata()->GetVisibility() == false ||
+      index->IsBuilding() == true) {
     LOG_DEBUG("Index '%s.%s' is not visible. Skipping...",
               target_table->GetName().c_str(), index->GetName().c_str());
     return (false);
@@ -481,6 +488,90 @@ void ExtractEquiJoinKeys(
   }
 }
 
+std::unordered_map<oid_t, std::shared_ptr<index::Index>> GetStorageIndexes(
+    const std::shared_ptr<catalog::TableCatalogObject> &table) {
+  std::unordered_map<oid_t, std::shared_ptr<index::Index>> indexes;
+  storage::DataTable *storage_table = nullptr;
+  try {
+    storage_table = storage::StorageManager::GetInstance()->GetTableWithOid(
+        table->GetDatabaseOid(), table->GetTableOid());
+  } catch (CatalogException &e) {
+    LOG_TRACE("Can't find table %d in the storage layer", table->GetTableOid());
+    return indexes;
+  }
+
+  for (oid_t offset = 0; offset < storage_table->GetIndexCount(); offset++) {
+    auto index = storage_table->GetIndex(offset);
+    if (index != nullptr) {
+      indexes.emplace(index->GetOid(), index);
+    }
+  }
+  return indexes;
+}
+
+bool EqualIndexExpressions(const expression::AbstractExpression *expr,
+                           const expression::AbstractExpression *index_expr,
+                           oid_t table_oid) {
+  auto expr_type = expr->GetExpressionType();
+  if (expr_type != index_expr->GetExpressionType() ||
+      expr->GetChildrenSize() != index_expr->GetChildrenSize()) {
+    return false;
+  }
+
+  switch (expr_type) {
+    case ExpressionType::VALUE_TUPLE: {
+      // The query refers to the column by its bound oid
+      auto tv_expr =
+          static_cast<const expression::TupleValueExpression *>(expr);
+      auto index_tv_expr =
+          static_cast<const expression::TupleValueExpression *>(index_expr);
+      return std::get<1>(tv_expr->GetBoundOid()) == table_oid &&
+             static_cast<int>(std::get<2>(tv_expr->GetBoundOid())) ==
+                 index_tv_expr->GetColumnId();
+    }
+    case ExpressionType::FUNCTION: {
+      auto func_expr = static_cast<const expression::FunctionExpression *>(expr);
+      auto index_func_expr =
+          static_cast<const expression::FunctionExpression *>(index_expr);
+      if (func_expr->GetFuncName() != index_func_expr->GetFuncName()) {
+        return false;
+      }
+      break;
+    }
+    default:
+      if (expr->GetChildrenSize() == 0) {
+        return expr->ExactlyEquals(*index_expr);
+      }
+      break;
+  }
+
+  for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+    if (!EqualIndexExpressions(expr->GetChild(i), index_expr->GetChild(i),
+                               table_oid)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ImpliesIndexPredicate(
+    const std::vector<AnnotatedExpression> &predicates,
+    const expression::AbstractExpression *index_predicate, oid_t table_oid) {
+  if (index_predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    return ImpliesIndexPredicate(predicates, index_predicate->GetChild(0),
+                                 table_oid) &&
+           ImpliesIndexPredicate(predicates, index_predicate->GetChild(1),
+                                 table_oid);
+  }
+  for (auto &predicate : predicates) {
+    if (EqualIndexExpressions(predicate.expr.get(), index_predicate,
+                              table_oid)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace util
 }  // namespace optimizer
 }  // namespace peloton
@@ -50,13 +50,14 @@ void NestedLoopJoinPlan::HandleSubplanBinding(bool from_left,
 
 std::unique_ptr<AbstractPlan> NestedLoopJoinPlan::Copy() const {
   std::unique_ptr<const expression::AbstractExpression> predicate_copy(
-      GetPredicate()->Copy());
+      GetPredicate() != nullptr ? GetPredicate()->Copy() : nullptr);
 
   std::shared_ptr<const catalog::Schema> schema_copy(
       catalog::Schema::CopySchema(GetSchema()));
 
   NestedLoopJoinPlan *new_plan = new NestedLoopJoinPlan(
-      GetJoinType(), std::move(predicate_copy), GetProjInfo()->Copy(),
+      GetJoinType(), std::move(predicate_copy),
+      GetProjInfo() != nullptr ? GetProjInfo()->Copy() : nullptr,
       schema_copy, join_column_ids_left_, join_column_ids_right_);
 
   return std::unique_ptr<AbstractPlan>(new_plan);
@@ -50,6 +50,10 @@ void SettingsManager::SetInt(SettingId id, int32_t value) {
   GetInstance().SetValue(id, type::ValueFactory::GetIntegerValue(value));
 }
 
+void SettingsManager::SetDouble(SettingId id, double value) {
+  GetInstance().SetValue(id, type::ValueFactory::GetDecimalValue(value));
+}
+
 void SettingsManager::SetBool(SettingId id, bool value) {
   GetInstance().SetValue(id, type::ValueFactory::GetBooleanValue(value));
 }
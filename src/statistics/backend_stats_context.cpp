@@ -47,7 +47,9 @@ BackendStatsContext* BackendStatsContext::GetInstance() {
 
 BackendStatsContext::BackendStatsContext(size_t max_latency_history,
                                          bool regiser_to_aggregator)
-    : txn_latencies_(MetricType::LATENCY, max_latency_history) {
+    : txn_latencies_(MetricType::LATENCY, max_latency_history),
+      queue_wait_latencies_(MetricType::LATENCY, max_latency_history,
+                            "QUEUE WAIT LATENCY") {
   std::thread::id this_id = std::this_thread::get_id();
   thread_id_ = this_id;
 
@@ -107,6 +109,25 @@ LatencyMetric& BackendStatsContext::GetTxnLatencyMetric() {
   return txn_latencies_;
 }
 
+LatencyMetric& BackendStatsContext::GetQueueWaitLatencyMetric() {
+  return queue_wait_latencies_;
+}
+
+OptimizerMetric& BackendStatsContext::GetOptimizerMetric() {
+  return optimizer_metric_;
+}
+
+void BackendStatsContext::RecordOptimization(int64_t num_tasks,
+                                             int64_t num_groups,
+                                             int64_t num_group_exprs,
+                                             bool budget_exhausted) {
+  optimizer_metric_.RecordOptimization(num_tasks, num_groups, num_group_exprs,
+                                       budget_exhausted);
+  pending_optimizer_metric_.RecordOptimization(num_tasks, num_groups,
+                                               num_group_exprs,
+                                               budget_exhausted);
+}
+
 void BackendStatsContext::IncrementTableReads(oid_t tile_group_id) {
   oid_t table_id =
       catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
@@ -223,6 +244,11 @@ void BackendStatsContext::InitQueryMetric(
   // TODO currently all queries belong to DEFAULT_DB
   ongoing_query_metric_.reset(new QueryMetric(
       MetricType::QUERY, statement->GetQueryString(), params, DEFAULT_DB_ID));
+
+  // The statement was planned on this thread right before it is executed
+  ongoing_query_metric_->GetOptimizerMetric().Aggregate(
+      pending_optimizer_metric_);
+  pending_optimizer_metric_.Reset();
 }
 
 //===--------------------------------------------------------------------===//
@@ -233,6 +259,9 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
   // Aggregate all global metrics
   txn_latencies_.Aggregate(source.txn_latencies_);
   txn_latencies_.ComputeLatencies();
+  queue_wait_latencies_.Aggregate(source.queue_wait_latencies_);
+  queue_wait_latencies_.ComputeLatencies();
+  optimizer_metric_.Aggregate(source.optimizer_metric_);
 
   // Aggregate all per-database metrics
   for (auto& database_item : source.database_metrics_) {
@@ -267,6 +296,8 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
 
 void BackendStatsContext::Reset() {
   txn_latencies_.Reset();
+  queue_wait_latencies_.Reset();
+  optimizer_metric_.Reset();
 
   for (auto& database_item : database_metrics_) {
     database_item.second->Reset();
@@ -325,6 +356,8 @@ std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
   ss << txn_latencies_.GetInfo() << std::endl;
+  ss << queue_wait_latencies_.GetInfo() << std::endl;
+  ss << optimizer_metric_.GetInfo() << std::endl;
 
   for (auto& database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
@@ -18,8 +18,9 @@
 namespace peloton {
 namespace stats {
 
-LatencyMetric::LatencyMetric(MetricType type, size_t max_history)
-    : AbstractMetric(type) {
+LatencyMetric::LatencyMetric(MetricType type, size_t max_history,
+                             const std::string &name)
+    : AbstractMetric(type), name_(name) {
   max_history_ = max_history;
   latencies_.SetCapaciry(max_history_);
 }
@@ -54,7 +55,7 @@ CircularBuffer<double> LatencyMetric::Copy() {
 
 const std::string LatencyMetric::GetInfo() const {
   std::stringstream ss;
-  ss << "TXN LATENCY (ms): [ ";
+  ss << name_ << " (ms): [ ";
   ss << "average=" << latency_measurements_.average_;
   ss << ", min=" << latency_measurements_.min_;
   ss << ", 25th-%-tile=" << latency_measurements_.perc_25th_;
@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimizer_metric.cpp
+//
+// Identification: src/statistics/optimizer_metric.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/optimizer_metric.h"
+#include "common/macros.h"
+
+namespace peloton {
+namespace stats {
+
+void OptimizerMetric::Reset() {
+  num_optimizations_.Reset();
+  num_tasks_.Reset();
+  num_groups_.Reset();
+  num_group_exprs_.Reset();
+  num_budget_exhausted_.Reset();
+}
+
+void OptimizerMetric::Aggregate(AbstractMetric &source) {
+  PL_ASSERT(source.GetType() == MetricType::OPTIMIZER);
+
+  auto &optimizer_metric = static_cast<OptimizerMetric &>(source);
+  num_optimizations_.Aggregate(optimizer_metric.num_optimizations_);
+  num_tasks_.Aggregate(optimizer_metric.num_tasks_);
+  num_groups_.Aggregate(optimizer_metric.num_groups_);
+  num_group_exprs_.Aggregate(optimizer_metric.num_group_exprs_);
+  num_budget_exhausted_.Aggregate(optimizer_metric.num_budget_exhausted_);
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -19,6 +19,7 @@
 #include "catalog/index_metrics_catalog.h"
 #include "catalog/query_metrics_catalog.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "optimizer/stats/stats_maintainer.h"
 #include "storage/storage_manager.h"
 #include "type/ephemeral_pool.h"
 
@@ -241,6 +242,10 @@ void StatsAggregator::UpdateTableMetrics(storage::Database *database,
         pool_.get(), txn);
     LOG_TRACE("Table Metric Tuple inserted");
 
+    // Analyze the table again if enough of it changed
+    optimizer::StatsMaintainer::Instance().RecordModifications(
+        table, inserts, updates, deletes);
+
     UpdateIndexMetrics(database, table, time_stamp, txn);
   }
 }
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <atomic>
 #include <mutex>
 #include <utility>
 
@@ -229,6 +230,7 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   auto &gc_manager = gc::GCManagerFactory::GetInstance();
   auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
   if (free_item_pointer.IsNull() == false) {
+    recycled_slot_count_++;
     // when inserting a tuple
     if (tuple != nullptr) {
       auto tile_group =
@@ -308,6 +310,7 @@ ItemPointer DataTable::AcquireVersion() {
 bool DataTable::InstallVersion(const AbstractTuple *tuple,
                                const TargetList *targets_ptr,
                                concurrency::TransactionContext *transaction,
+                               ItemPointer location,
                                ItemPointer *index_entry_ptr) {
   if (CheckConstraints(tuple) == false) {
     LOG_TRACE("InsertVersion(): Constraint violated");
@@ -315,7 +318,7 @@ bool DataTable::InstallVersion(const AbstractTuple *tuple,
   }
 
   // Index checks and updates
-  if (InsertInSecondaryIndexes(tuple, targets_ptr, transaction,
+  if (InsertInSecondaryIndexes(tuple, targets_ptr, transaction, location,
                                index_entry_ptr) == false) {
     LOG_TRACE("Index constraint violated");
     return false;
@@ -357,13 +360,16 @@ bool DataTable::InsertTuple(const AbstractTuple *tuple,
 
   LOG_TRACE("Location: %u, %u", location.block, location.offset);
 
+  bool index_build_active = IsIndexBuildActive();
   auto index_count = GetIndexCount();
-  if (index_count == 0) {
+  if (index_count == 0 && index_build_active == false) {
     IncreaseTupleCount(1);
     return true;
   }
+
+  *index_entry_ptr = AllocateIndirection(location, true);
   // Index checks and updates
-  if (InsertInIndexes(tuple, location, transaction, index_entry_ptr) == false) {
+  if (InsertInIndexes(tuple, transaction, index_entry_ptr) == false) {
     LOG_TRACE("Index constraint violated");
     return false;
   }
@@ -399,6 +405,31 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple) {
   return location;
 }
 
+/**
+ * @brief Write the index entry of a new version into its header.
+ *
+ * The transaction manager writes it again when the version is linked into its
+ * chain, but an index-only scan of an all-visible tile group, or an index
+ * added after the writer read the indexes of the table, only learns about the
+ * version from the header. Clearing the all-visible bit with a store ordered
+ * after the header write is enough for TileGroupHeader::SetAllVisible(), which
+ * fences before it checks the tuples. The builder of an index reads the header
+ * after it adds the index, so while a build runs the writer also fences before
+ * it reads the index list, pairing with the fence in IndexBuilder::Build().
+ */
+void DataTable::PublishIndirection(ItemPointer location,
+                                   ItemPointer *index_entry_ptr) {
+  auto tile_group = GetTileGroupById(location.block);
+  PL_ASSERT(tile_group != nullptr);
+  auto tile_group_header = tile_group->GetHeader();
+  tile_group_header->SetIndirection(location.offset, index_entry_ptr);
+  tile_group_header->ResetAllVisible();
+
+  if (IsIndexBuildActive() == true) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
 /**
  * @brief Insert a tuple into all indexes. If index is primary/unique,
  * check visibility of existing
@@ -412,12 +443,21 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
                                 ItemPointer location,
                                 concurrency::TransactionContext *transaction,
                                 ItemPointer **index_entry_ptr) {
-  int index_count = GetIndexCount();
+  *index_entry_ptr = AllocateIndirection(location, true);
+  return InsertInIndexes(tuple, transaction, index_entry_ptr);
+}
 
+/**
+ * @brief Allocate the index entry of a new tuple, pointing to its location,
+ * and write it into the tuple's header if publish is set.
+ */
+ItemPointer *DataTable::AllocateIndirection(ItemPointer location,
+                                            bool publish) {
   size_t active_indirection_array_id =
       number_of_tuples_ % active_indirection_array_count_;
 
   size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+  ItemPointer *index_entry_ptr = nullptr;
 
   while (true) {
     auto active_indirection_array =
@@ -425,19 +465,49 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
     indirection_offset = active_indirection_array->AllocateIndirection();
 
     if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
+      index_entry_ptr =
           active_indirection_array->GetIndirectionByOffset(indirection_offset);
       break;
     }
   }
 
-  (*index_entry_ptr)->block = location.block;
-  (*index_entry_ptr)->offset = location.offset;
+  index_entry_ptr->block = location.block;
+  index_entry_ptr->offset = location.offset;
 
   if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
     AddDefaultIndirectionArray(active_indirection_array_id);
   }
 
+  if (publish == true) {
+    PublishIndirection(location, index_entry_ptr);
+  }
+  return index_entry_ptr;
+}
+
+ItemPointer *DataTable::GetOrCreateIndirection(ItemPointer location) {
+  auto tile_group_header = GetTileGroupById(location.block)->GetHeader();
+  ItemPointer *index_entry_ptr =
+      tile_group_header->GetIndirection(location.offset);
+  if (index_entry_ptr != nullptr ||
+      (GetIndexCount() == 0 && IsIndexBuildActive() == false)) {
+    return index_entry_ptr;
+  }
+
+  // An index builder may race to give the version its entry
+  ItemPointer *new_index_entry_ptr = AllocateIndirection(location, false);
+  index_entry_ptr = tile_group_header->SetAtomicIndirection(
+      location.offset, nullptr, new_index_entry_ptr);
+  if (index_entry_ptr != nullptr) {
+    return index_entry_ptr;
+  }
+  return new_index_entry_ptr;
+}
+
+bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
+                                concurrency::TransactionContext *transaction,
+                                ItemPointer **index_entry_ptr) {
+  int index_count = GetIndexCount();
+
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
 
@@ -452,10 +522,18 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
   for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
     auto index = GetIndex(index_itr);
     if (index == nullptr) continue;
+
+    // Partial indexes skip the tuples their predicate doesn't cover
+    if (index->CoversTuple(tuple) == false) continue;
+
     auto index_schema = index->GetKeySchema();
-    auto indexed_columns = index_schema->GetIndexedColumns();
     std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    index->BuildKey(tuple, key.get());
+
+    // The builder of the index inserts the entry, and checks its uniqueness
+    if (index->LogEntry(key.get(), *index_entry_ptr)) {
+      continue;
+    }
 
     switch (index->GetIndexType()) {
       case IndexConstraintType::PRIMARY_KEY:
@@ -491,7 +569,10 @@ bool DataTable::InsertInIndexes(const AbstractTuple *tuple,
 bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                          const TargetList *targets_ptr,
                                          concurrency::TransactionContext *transaction,
+                                         ItemPointer location,
                                          ItemPointer *index_entry_ptr) {
+  PublishIndirection(location, index_entry_ptr);
+
   int index_count = GetIndexCount();
   // Transform the target list into a hash set
   // when attempting to perform insertion to a secondary index,
@@ -517,15 +598,16 @@ bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
     auto index = GetIndex(index_itr);
     if (index == nullptr) continue;
     auto index_schema = index->GetKeySchema();
-    auto indexed_columns = index_schema->GetIndexedColumns();
 
     if (index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
       continue;
     }
 
-    // Check if we need to update the secondary index
+    // Check if we need to update the secondary index. The key of an
+    // expression index and the predicate of a partial index may read other
+    // columns than the indexed ones.
     bool updated = false;
-    for (auto col : indexed_columns) {
+    for (auto col : index->GetMetadata()->GetReferencedColumns()) {
       if (targets_set.find(col) != targets_set.end()) {
         updated = true;
         break;
@@ -537,15 +619,36 @@ bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
       continue;
     }
 
+    // Partial indexes skip the versions their predicate doesn't cover
+    if (index->CoversTuple(tuple) == false) {
+      continue;
+    }
+
     // Key attributes are updated, insert a new entry in all secondary index
     std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
 
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    index->BuildKey(tuple, key.get());
+
+    if (index->LogEntry(key.get(), index_entry_ptr)) {
+      continue;
+    }
 
     switch (index->GetIndexType()) {
       case IndexConstraintType::PRIMARY_KEY:
       case IndexConstraintType::UNIQUE: {
-        res = index->CondInsertEntry(key.get(), index_entry_ptr, fn);
+        // If only the columns of the predicate were updated, the tuple may
+        // have the entry already, which isn't a violation
+        bool present = false;
+        res = index->CondInsertEntry(
+                  key.get(), index_entry_ptr,
+                  [&fn, &present, index_entry_ptr](const void *other) {
+                    if (other == index_entry_ptr) {
+                      present = true;
+                      return true;
+                    }
+                    return fn(other);
+                  }) ||
+              present;
       } break;
       case IndexConstraintType::DEFAULT:
       default:
@@ -892,6 +995,9 @@ void DataTable::DropIndexWithOid(const oid_t &index_oid) {
 
   // Drop index column info
   indexes_columns_[index_offset].clear();
+
+  // Cached plans may scan the index
+  StorageManager::GetInstance()->InvalidateTable(table_oid);
 }
 
 void DataTable::DropIndexes() {
@@ -1034,6 +1140,24 @@ std::vector<catalog::Schema> TransformTileGroupSchema(
   return new_schema;
 }
 
+// Whether the data of no tuple of the tile group can change: the tile group
+// is full, none of its slots is free or being inserted into, and no version is
+// uncommitted, so writers only change its header
+bool IsTileGroupDataStable(storage::TileGroup *tile_group) {
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t tuple_count = tile_group->GetAllocatedTupleCount();
+  if (tile_group_header->GetCurrentNextTupleSlot() < tuple_count) {
+    return false;
+  }
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID ||
+        tile_group_header->GetBeginCommitId(tuple_id) == MAX_CID) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Set the transformed tile group column-at-a-time
 void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
                              storage::TileGroup *new_tile_group) {
@@ -1067,14 +1191,16 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
     }
   }
 
-  // Finally, copy over the tile header
-  auto header = orig_tile_group->GetHeader();
-  auto new_header = new_tile_group->GetHeader();
-  *new_header = *header;
+  // The tile groups share the header, and the bounds don't depend on the layout
+  new_tile_group->GetZoneMap()->CopyBounds(*orig_tile_group->GetZoneMap());
 }
 
 storage::TileGroup *DataTable::TransformTileGroup(
-    const oid_t &tile_group_offset, const double &theta) {
+    const oid_t &tile_group_offset, const double &theta, bool *busy) {
+  if (busy != nullptr) {
+    *busy = false;
+  }
+
   // First, check if the tile group is in this table
   if (tile_group_offset >= tile_groups_.GetSize()) {
     LOG_ERROR("Tile group offset not found in table : %u ", tile_group_offset);
@@ -1100,20 +1226,47 @@ storage::TileGroup *DataTable::TransformTileGroup(
   auto new_schema =
       TransformTileGroupSchema(tile_group.get(), default_partition_);
 
-  // Allocate space for the transformed tile group
-  std::shared_ptr<storage::TileGroup> new_tile_group(
-      TileGroupFactory::GetTileGroup(
-          tile_group->GetDatabaseId(), tile_group->GetTableId(),
-          tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
-          new_schema, default_partition_,
-          tile_group->GetAllocatedTupleCount()));
+  // Transactions keep running on the tile group while it is copied. They
+  // change the versions through the header that the new tile group shares,
+  // and only write the data of free slots and of their own uncommitted
+  // versions, so copy only tile groups without either. Marking the tile group
+  // immutable keeps the GC from recycling the slots it frees meanwhile.
+  auto tile_group_header = tile_group->GetHeader();
+  bool set_immutable = tile_group_header->SetImmutability();
+
+  std::shared_ptr<storage::TileGroup> new_tile_group;
+  bool stable = IsTileGroupDataStable(tile_group.get());
+  if (stable) {
+    // Allocate space for the transformed tile group
+    new_tile_group.reset(TileGroupFactory::GetTransformedTileGroup(
+        *tile_group, new_schema, default_partition_));
+
+    // Set the transformed tile group column-at-a-time
+    SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
+
+    // Check again for the versions that the GC freed during the copy
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    stable = IsTileGroupDataStable(tile_group.get());
+  }
 
-  // Set the transformed tile group column-at-a-time
-  SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
+  if (stable) {
+    // Set the location of the new tile group
+    // and clean up the orig tile group
+    tile_group_header->SetTileGroup(new_tile_group.get());
+    catalog_manager.AddTileGroup(tile_group_id, new_tile_group);
+  }
+
+  if (set_immutable) {
+    tile_group_header->ResetImmutability();
+  }
 
-  // Set the location of the new tile group
-  // and clean up the orig tile group
-  catalog_manager.AddTileGroup(tile_group_id, new_tile_group);
+  if (!stable) {
+    LOG_TRACE("Skipped transforming busy tile group : %u", tile_group_offset);
+    if (busy != nullptr) {
+      *busy = true;
+    }
+    return nullptr;
+  }
 
   return new_tile_group.get();
 }
@@ -18,7 +18,9 @@
 #include "common/logger.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "optimizer/stats/stats_maintainer.h"
 #include "storage/database.h"
+#include "storage/storage_manager.h"
 #include "storage/table_factory.h"
 
 namespace peloton {
@@ -86,6 +88,8 @@ void Database::DropTableWithOid(const oid_t table_oid) {
 
     // Deregister table from Query Cache manager
     codegen::QueryCache::Instance().Remove(table_oid);
+    StorageManager::GetInstance()->InvalidateTable(table_oid);
+    optimizer::StatsMaintainer::Instance().RemoveTable(table_oid);
 
     oid_t table_offset = 0;
     for (auto table : tables) {
@@ -102,6 +106,35 @@ void Database::DropTableWithOid(const oid_t table_oid) {
   }
 }
 
+std::vector<oid_t> Database::GetTableOids() {
+  std::lock_guard<std::mutex> lock(database_mutex);
+  std::vector<oid_t> table_oids;
+  for (auto table : tables) {
+    table_oids.push_back(table->GetOid());
+  }
+  return table_oids;
+}
+
+std::vector<std::shared_ptr<storage::TileGroup>>
+Database::GetTileGroupsWithTableOid(const oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(database_mutex);
+  std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+  for (auto table : tables) {
+    if (table->GetOid() != table_oid) {
+      continue;
+    }
+    size_t tile_group_count = table->GetTileGroupCount();
+    for (size_t offset = 0; offset < tile_group_count; offset++) {
+      auto tile_group = table->GetTileGroup(offset);
+      if (tile_group != nullptr) {
+        tile_groups.push_back(tile_group);
+      }
+    }
+    break;
+  }
+  return tile_groups;
+}
+
 storage::DataTable *Database::GetTable(const oid_t table_offset) const {
   PL_ASSERT(table_offset < tables.size());
   auto table = tables.at(table_offset);
@@ -0,0 +1,297 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_block.cpp
+//
+// Identification: src/storage/frozen_block.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/frozen_block.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "catalog/schema.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/limits.h"
+#include "type/type.h"
+
+namespace peloton {
+namespace storage {
+
+constexpr uint32_t DictionaryColumn::kInvalidCode;
+constexpr uint32_t DictionaryColumn::kNullCode;
+
+FrozenBlock::FrozenBlock(oid_t tuple_count, cid_t horizon_cid)
+    : tuple_count_(tuple_count),
+      visible_count_(0),
+      horizon_cid_(horizon_cid),
+      packed_size_(0),
+      unpacked_size_(0) {}
+
+bool FrozenBlock::CanPackType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::unique_ptr<FrozenBlock> FrozenBlock::Create(const TileGroup &tile_group,
+                                                 cid_t horizon_cid) {
+  oid_t tuple_count = tile_group.GetAllocatedTupleCount();
+  std::unique_ptr<FrozenBlock> frozen_block(
+      new FrozenBlock(tuple_count, horizon_cid));
+  if (!ClassifyTuples(tile_group, horizon_cid, frozen_block->visible_)) {
+    return nullptr;
+  }
+  for (auto word : frozen_block->visible_) {
+    frozen_block->visible_count_ += __builtin_popcountll(word);
+  }
+
+  oid_t column_count = tile_group.GetColumnMap().size();
+  frozen_block->packed_columns_.resize(column_count);
+  frozen_block->dictionary_columns_.resize(column_count);
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    frozen_block->PackColumn(tile_group, column_id);
+    frozen_block->EncodeColumn(tile_group, column_id);
+  }
+  return frozen_block;
+}
+
+bool FrozenBlock::ClassifyTuples(const TileGroup &tile_group,
+                                 cid_t horizon_cid,
+                                 std::vector<uint64_t> &visible) {
+  // New tuples can only go into recycled slots once the tile group is full,
+  // and inserting them thaws it
+  oid_t tuple_count = tile_group.GetAllocatedTupleCount();
+  if (tile_group.GetNextTupleSlot() < tuple_count) {
+    return false;
+  }
+
+  auto tile_group_header = tile_group.GetHeader();
+  visible.assign((tuple_count + 63) / 64, 0);
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    txn_id_t txn_id = tile_group_header->GetTransactionId(tuple_id);
+    if (txn_id == INVALID_TXN_ID) {
+      // An empty slot, unless a writer already published the index entry of
+      // the version it is inserting there
+      if (tile_group_header->GetIndirection(tuple_id) != nullptr) {
+        return false;
+      }
+      continue;
+    }
+    if (txn_id != INITIAL_TXN_ID) {
+      // Owned by a running transaction
+      return false;
+    }
+    cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+    cid_t end_cid = tile_group_header->GetEndCommitId(tuple_id);
+    if (begin_cid > horizon_cid) {
+      return false;
+    }
+    if (end_cid == MAX_CID) {
+      visible[tuple_id / 64] |= 1UL << (tuple_id % 64);
+    } else if (end_cid > horizon_cid) {
+      // Still visible to some transaction
+      return false;
+    }
+  }
+  return true;
+}
+
+bool FrozenBlock::IsValidFor(const TileGroup &tile_group) const {
+  std::vector<uint64_t> visible;
+  return ClassifyTuples(tile_group, horizon_cid_, visible) &&
+         visible == visible_;
+}
+
+void FrozenBlock::PackColumn(const TileGroup &tile_group, oid_t column_id) {
+  oid_t tile_offset, tile_column_id;
+  tile_group.LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+  const Tile *tile = tile_group.GetTile(tile_offset);
+  const catalog::Schema *schema = tile->GetSchema();
+  type::TypeId type_id = schema->GetType(tile_column_id);
+  if (!CanPackType(type_id)) {
+    return;
+  }
+  size_t column_offset = schema->GetOffset(tile_column_id);
+
+  // Encode every version, not only the visible ones, so that scans that fetch
+  // the layout of the tile group before it thaws still read the right values
+  auto tile_group_header = tile_group.GetHeader();
+  auto is_occupied = [&](oid_t tuple_id) {
+    return tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID;
+  };
+
+  auto read_value = [&](oid_t tuple_id, int64_t &value) {
+    const char *data = tile->GetTupleLocation(tuple_id) + column_offset;
+    switch (type_id) {
+      case type::TypeId::INTEGER: {
+        int32_t raw = *reinterpret_cast<const int32_t *>(data);
+        value = raw;
+        return raw != type::PELOTON_INT32_NULL;
+      }
+      case type::TypeId::BIGINT: {
+        value = *reinterpret_cast<const int64_t *>(data);
+        return value != type::PELOTON_INT64_NULL;
+      }
+      default: {
+        uint64_t raw = *reinterpret_cast<const uint64_t *>(data);
+        value = static_cast<int64_t>(raw);
+        return raw != type::PELOTON_TIMESTAMP_NULL;
+      }
+    }
+  };
+
+  // Find the range of the values
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count_; tuple_id++) {
+    if (!is_occupied(tuple_id)) {
+      continue;
+    }
+    int64_t value;
+    if (!read_value(tuple_id, value)) {
+      return;
+    }
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+  if (min > max) {
+    return;
+  }
+
+  // Only encode the column if that makes it smaller
+  uint64_t range = static_cast<uint64_t>(max) - static_cast<uint64_t>(min);
+  uint32_t width;
+  if (range <= std::numeric_limits<uint8_t>::max()) {
+    width = 1;
+  } else if (range <= std::numeric_limits<uint16_t>::max()) {
+    width = 2;
+  } else if (range <= std::numeric_limits<uint32_t>::max()) {
+    width = 4;
+  } else {
+    return;
+  }
+  size_t type_size = type::Type::GetTypeSize(type_id);
+  if (width >= type_size) {
+    return;
+  }
+
+  std::unique_ptr<PackedColumn> packed_column(new PackedColumn());
+  packed_column->base = min;
+  packed_column->mask = (1UL << (8 * width)) - 1;
+  packed_column->width = width;
+  packed_column->data.reset(new char[tuple_count_ * width + sizeof(uint64_t)]);
+  PL_MEMSET(packed_column->data.get(), 0,
+            tuple_count_ * width + sizeof(uint64_t));
+  for (oid_t tuple_id = 0; tuple_id < tuple_count_; tuple_id++) {
+    int64_t value;
+    if (!is_occupied(tuple_id)) {
+      continue;
+    }
+    read_value(tuple_id, value);
+    uint64_t delta =
+        static_cast<uint64_t>(value) - static_cast<uint64_t>(min);
+    // Little-endian, so the low bytes of the delta come first
+    PL_MEMCPY(packed_column->data.get() + tuple_id * width, &delta, width);
+  }
+
+  packed_size_ += tuple_count_ * width;
+  unpacked_size_ += tuple_count_ * type_size;
+  packed_columns_[column_id] = std::move(packed_column);
+}
+
+void FrozenBlock::EncodeColumn(const TileGroup &tile_group, oid_t column_id) {
+  oid_t tile_offset, tile_column_id;
+  tile_group.LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+  Tile *tile = tile_group.GetTile(tile_offset);
+  if (tile->GetSchema()->GetType(tile_column_id) != type::TypeId::VARCHAR) {
+    return;
+  }
+
+  // Like the packed columns, encode every version
+  auto tile_group_header = tile_group.GetHeader();
+  std::vector<type::Value> values(tuple_count_);
+  std::map<std::string, uint32_t> codes;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count_; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID) {
+      continue;
+    }
+    values[tuple_id] = tile->GetValue(tuple_id, tile_column_id);
+    if (values[tuple_id].IsNull()) {
+      continue;
+    }
+    codes.emplace(std::string(values[tuple_id].GetData(),
+                              values[tuple_id].GetLength()),
+                  0);
+    if (codes.size() > kMaxDictionarySize) {
+      return;
+    }
+  }
+
+  // Number the values in sorted order
+  std::unique_ptr<DictionaryColumn> dictionary_column(new DictionaryColumn());
+  for (auto &entry : codes) {
+    entry.second = dictionary_column->dictionary.size();
+    dictionary_column->dictionary.push_back(entry.first);
+  }
+
+  dictionary_column->codes.reset(new uint32_t[tuple_count_]);
+  for (oid_t tuple_id = 0; tuple_id < tuple_count_; tuple_id++) {
+    const type::Value &value = values[tuple_id];
+    if (value.GetTypeId() != type::TypeId::VARCHAR || value.IsNull()) {
+      dictionary_column->codes[tuple_id] = DictionaryColumn::kNullCode;
+      continue;
+    }
+    dictionary_column->codes[tuple_id] =
+        codes[std::string(value.GetData(), value.GetLength())];
+  }
+  dictionary_columns_[column_id] = std::move(dictionary_column);
+}
+
+uint32_t DictionaryColumn::Lookup(const char *data, uint32_t length) const {
+  if (data == nullptr) {
+    return kInvalidCode;
+  }
+  std::string value(data, length);
+  auto iter = std::lower_bound(dictionary.begin(), dictionary.end(), value);
+  if (iter == dictionary.end() || *iter != value) {
+    return kInvalidCode;
+  }
+  return static_cast<uint32_t>(iter - dictionary.begin());
+}
+
+int64_t FrozenBlock::GetPackedValue(oid_t column_id, oid_t tuple_id) const {
+  const PackedColumn *packed_column = GetPackedColumn(column_id);
+  PL_ASSERT(packed_column != nullptr && tuple_id < tuple_count_);
+  uint64_t raw;
+  PL_MEMCPY(&raw, packed_column->data.get() + tuple_id * packed_column->width,
+            sizeof(raw));
+  return static_cast<int64_t>(static_cast<uint64_t>(packed_column->base) +
+                              (raw & packed_column->mask));
+}
+
+uint32_t FrozenBlock::GetVisibleTuples(uint32_t tid_start, uint32_t tid_end,
+                                       uint32_t *selection_vector) const {
+  uint32_t out_idx = 0;
+  for (uint32_t i = tid_start; i < tid_end; i++) {
+    selection_vector[out_idx] = i;
+    out_idx += IsVisible(i);
+  }
+  return out_idx;
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,358 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_builder.cpp
+//
+// Identification: src/storage/index_builder.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index_builder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/container_tuple.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "index/index.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace storage {
+
+// Whether the version is the empty one a delete installs
+static bool IsDeleteVersion(const TileGroupHeader *tile_group_header,
+                            oid_t tuple_id) {
+  cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+  cid_t end_cid = tile_group_header->GetEndCommitId(tuple_id);
+  return end_cid == INVALID_CID ||
+         (begin_cid != MAX_CID && begin_cid == end_cid);
+}
+
+// Whether the version is the committed newest version of its tuple, and holds
+// a tuple
+static bool IsCommittedHead(const TileGroupHeader *tile_group_header,
+                            oid_t tuple_id) {
+  return tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID &&
+         tile_group_header->GetBeginCommitId(tuple_id) != MAX_CID &&
+         tile_group_header->GetEndCommitId(tuple_id) == MAX_CID;
+}
+
+// Whether the newest version of the tuple with the index entry holds a tuple,
+// as far as any running or future transaction may be concerned
+static bool IsLiveTuple(const void *index_entry_ptr) {
+  ItemPointer location = *static_cast<const ItemPointer *>(index_entry_ptr);
+  auto tile_group =
+      catalog::Manager::GetInstance().GetTileGroup(location.block);
+  if (tile_group == nullptr) {
+    return false;
+  }
+  auto tile_group_header = tile_group->GetHeader();
+  return tile_group_header->GetTransactionId(location.offset) !=
+             INVALID_TXN_ID &&
+         IsDeleteVersion(tile_group_header, location.offset) == false;
+}
+
+IndexBuilder::IndexBuilder(DataTable *table,
+                           std::shared_ptr<index::Index> index)
+    : table_(table), index_(index), indexed_version_count_(0) {}
+
+bool IndexBuilder::Build(concurrency::TransactionContext *txn) {
+  // The transactions that start from now on see the active build. Wait for
+  // the ones that may not have, and whose versions may have no index entry in
+  // their header yet.
+  table_->BeginIndexBuild();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t epoch_id = epoch_manager.GetCurrentEpochId();
+  size_t own_txn_count = (txn != nullptr) ? 1 : 0;
+  while (epoch_manager.GetRunningTransactionCount(epoch_id) > own_txn_count) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  index_->StartBuild();
+  table_->AddIndex(index_);
+
+  // Pairs with the fence in DataTable::PublishIndirection(): either the
+  // writer sees the index and logs its entry, or the scan sees the version
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  bool success = Populate();
+  table_->EndIndexBuild();
+  return success;
+}
+
+bool IndexBuilder::Populate() {
+  PL_ASSERT(index_->IsBuilding() == true);
+
+  // The versions in tile groups added from now on are written by writers
+  // that see the index
+  size_t tile_group_count = table_->GetTileGroupCount();
+  size_t num_threads = std::min(
+      static_cast<size_t>(std::max(settings::SettingsManager::GetInt(
+                                       settings::SettingId::index_build_parallelism),
+                                   1)),
+      std::max(tile_group_count, static_cast<size_t>(1)));
+
+  // Every thread collects a sorted run of entries
+  auto entry_less = [](const ScannedEntry &entry1, const ScannedEntry &entry2) {
+    int cmp = entry1.key.Compare(entry2.key);
+    if (cmp != 0) {
+      return cmp < 0;
+    }
+    return entry1.index_entry_ptr < entry2.index_entry_ptr;
+  };
+  size_t key_length = index_->GetKeySchema()->GetLength();
+  size_t run_tuple_count = table_->GetTupleCount() / num_threads + 1;
+  std::vector<ScannedRun> runs(num_threads);
+  std::atomic<size_t> next_offset(0);
+  auto scan = [this, &next_offset, &runs, &entry_less, tile_group_count,
+               key_length, run_tuple_count](size_t thread_id) {
+    ScannedRun &run = runs[thread_id];
+    run.key_data.reserve(run_tuple_count * key_length);
+    run.entries.reserve(run_tuple_count);
+    for (size_t offset = next_offset++; offset < tile_group_count;
+         offset = next_offset++) {
+      auto tile_group = table_->GetTileGroup(offset);
+      if (tile_group == nullptr) {
+        continue;
+      }
+      ScanTileGroup(tile_group.get(), run);
+    }
+    FinishRun(run);
+    std::sort(run.entries.begin(), run.entries.end(), entry_less);
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t thread_id = 1; thread_id < num_threads; thread_id++) {
+    threads.emplace_back(scan, thread_id);
+  }
+  scan(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Merge the runs at once, taking the smallest head of the runs left
+  std::vector<size_t> run_offsets(num_threads, 0);
+  auto run_greater = [&runs, &run_offsets, &entry_less](size_t run_id1,
+                                                        size_t run_id2) {
+    return entry_less(runs[run_id2].entries[run_offsets[run_id2]],
+                      runs[run_id1].entries[run_offsets[run_id1]]);
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(run_greater)>
+      run_heap(run_greater);
+  size_t scanned_entry_count = 0;
+  for (size_t run_id = 0; run_id < num_threads; run_id++) {
+    scanned_entry_count += runs[run_id].entries.size();
+    if (runs[run_id].entries.empty() == false) {
+      run_heap.push(run_id);
+    }
+  }
+
+  std::vector<ScannedEntry> scanned_entries;
+  scanned_entries.reserve(scanned_entry_count);
+  while (run_heap.empty() == false) {
+    size_t run_id = run_heap.top();
+    run_heap.pop();
+    scanned_entries.push_back(runs[run_id].entries[run_offsets[run_id]++]);
+    if (run_offsets[run_id] < runs[run_id].entries.size()) {
+      run_heap.push(run_id);
+    }
+  }
+
+  // The keys stay in the key data of the runs until the index is loaded
+  for (auto &run : runs) {
+    std::vector<ScannedEntry>().swap(run.entries);
+  }
+
+  bool success = HasDuplicateKeys(scanned_entries) == false;
+  if (success == true) {
+    // The versions of a tuple that share its key share its entry
+    std::vector<index::IndexEntryRef> entries;
+    entries.reserve(scanned_entries.size());
+    for (size_t i = 0; i < scanned_entries.size(); i++) {
+      if (i > 0 &&
+          scanned_entries[i].index_entry_ptr ==
+              scanned_entries[i - 1].index_entry_ptr &&
+          scanned_entries[i].key.Compare(scanned_entries[i - 1].key) == 0) {
+        continue;
+      }
+      entries.emplace_back(&scanned_entries[i].key,
+                           scanned_entries[i].index_entry_ptr);
+    }
+    index_->BulkLoad(entries);
+  }
+  scanned_entries.clear();
+  runs.clear();
+
+  // Writers use the index themselves once the logged entries are applied
+  bool applied = index_->FinishBuild(
+      [this](const Tuple *key, ItemPointer *index_entry_ptr) {
+        return InsertEntry(key, index_entry_ptr, true);
+      });
+  success = success && applied;
+
+  if (success == false) {
+    LOG_TRACE("Tuples of table %s violate the uniqueness of index %s",
+              table_->GetName().c_str(), index_->GetName().c_str());
+    table_->DropIndexWithOid(index_->GetOid());
+    return false;
+  }
+
+  LOG_TRACE("Built index %s with %lu versions using %lu threads",
+            index_->GetName().c_str(), indexed_version_count_.load(),
+            num_threads);
+  return true;
+}
+
+void IndexBuilder::DeferIndexes(DataTable *table) {
+  for (oid_t offset = 0; offset < table->GetIndexCount(); offset++) {
+    auto index = table->GetIndex(offset);
+    if (index != nullptr) {
+      index->StartBuild(false);
+    }
+  }
+}
+
+bool IndexBuilder::BuildDeferredIndexes(DataTable *table) {
+  bool success = true;
+  for (oid_t offset = 0; offset < table->GetIndexCount(); offset++) {
+    auto index = table->GetIndex(offset);
+    if (index == nullptr || index->IsBuilding() == false) {
+      continue;
+    }
+    IndexBuilder index_builder(table, index);
+    if (index_builder.Populate() == false) {
+      success = false;
+    }
+  }
+  return success;
+}
+
+bool IndexBuilder::BuildTileGroup(TileGroup *tile_group, bool check_unique) {
+  ScannedRun run;
+  ScanTileGroup(tile_group, run);
+  FinishRun(run);
+
+  bool success = true;
+  for (auto &entry : run.entries) {
+    if (InsertEntry(&entry.key, entry.index_entry_ptr,
+                    check_unique && entry.is_head) == false) {
+      success = false;
+    }
+  }
+  return success;
+}
+
+void IndexBuilder::ScanTileGroup(TileGroup *tile_group, ScannedRun &run) {
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto index_schema = index_->GetKeySchema();
+  size_t key_length = index_schema->GetLength();
+
+  oid_t tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    // Empty slots and versions whose index entries are being unlinked. The
+    // versions of running writers have no transaction id yet, but already
+    // have their index entry, and the writers may not see the index.
+    ItemPointer *index_entry_ptr = tile_group_header->GetIndirection(tuple_id);
+    if (index_entry_ptr == nullptr && IsCommittedHead(tile_group_header, tuple_id)) {
+      // The newest version of a tuple written while the table had no indexes
+      index_entry_ptr = table_->GetOrCreateIndirection(
+          ItemPointer(tile_group_id, tuple_id));
+    }
+    if (index_entry_ptr == nullptr ||
+        IsDeleteVersion(tile_group_header, tuple_id)) {
+      continue;
+    }
+
+    // Partial indexes skip the versions their predicate doesn't cover
+    ContainerTuple<TileGroup> tuple(tile_group, tuple_id);
+    if (index_->CoversTuple(&tuple) == false) {
+      continue;
+    }
+    size_t key_offset = run.key_data.size();
+    run.key_data.resize(key_offset + key_length);
+    Tuple key(index_schema, run.key_data.data() + key_offset);
+    index_->BuildKey(&tuple, &key);
+
+    // Older versions keep their entries, like they do when writers change
+    // the key, but only the newest one has to be unique
+    ItemPointer head = *index_entry_ptr;
+    bool is_head = head.block == tile_group_id && head.offset == tuple_id;
+    run.entries.push_back(ScannedEntry{key, index_entry_ptr, is_head});
+    indexed_version_count_++;
+  }
+}
+
+void IndexBuilder::FinishRun(ScannedRun &run) const {
+  size_t key_length = index_->GetKeySchema()->GetLength();
+  for (size_t i = 0; i < run.entries.size(); i++) {
+    run.entries[i].key.Move(run.key_data.data() + i * key_length);
+  }
+}
+
+bool IndexBuilder::HasDuplicateKeys(
+    const std::vector<ScannedEntry> &entries) const {
+  if (index_->HasUniqueKeys() == false) {
+    return false;
+  }
+
+  // The entries with equal keys are next to each other, ordered by their
+  // index entry, so every tuple whose newest version has the key shows up once
+  ItemPointer *live_index_entry_ptr = nullptr;
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (i > 0 && entries[i].key.Compare(entries[i - 1].key) != 0) {
+      live_index_entry_ptr = nullptr;
+    }
+    ItemPointer *index_entry_ptr = entries[i].index_entry_ptr;
+    if (entries[i].is_head == false || index_entry_ptr == live_index_entry_ptr ||
+        IsLiveTuple(index_entry_ptr) == false) {
+      continue;
+    }
+    if (live_index_entry_ptr != nullptr) {
+      return true;
+    }
+    live_index_entry_ptr = index_entry_ptr;
+  }
+  return false;
+}
+
+bool IndexBuilder::InsertEntry(const Tuple *key, ItemPointer *index_entry_ptr,
+                               bool check_unique) {
+  if (check_unique == false || index_->HasUniqueKeys() == false) {
+    // Fails if the entry is in the index already, which is fine
+    index_->InsertEntry(key, index_entry_ptr);
+    return true;
+  }
+
+  // A version may be found both by the scan and in the log
+  bool violated = false;
+  index_->CondInsertEntry(key, index_entry_ptr,
+                          [index_entry_ptr, &violated](const void *other) {
+                            if (other == index_entry_ptr) {
+                              return true;
+                            }
+                            if (IsLiveTuple(other)) {
+                              violated = true;
+                              return true;
+                            }
+                            return false;
+                          });
+  return violated == false;
+}
+
+}  // namespace storage
+}  // namespace peloton
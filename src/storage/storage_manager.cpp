@@ -113,5 +113,18 @@ bool StorageManager::RemoveDatabaseFromStorageManager(oid_t database_oid) {
   return false;
 }
 
+void StorageManager::SetTableInvalidationHook(
+    std::function<void(oid_t)> hook) {
+  std::lock_guard<std::mutex> lock(hook_mutex_);
+  table_invalidation_hook_ = hook;
+}
+
+void StorageManager::InvalidateTable(oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(hook_mutex_);
+  if (table_invalidation_hook_) {
+    table_invalidation_hook_(table_oid);
+  }
+}
+
 }  // namespace storage
 }  // namespace peloton
@@ -12,6 +12,7 @@
 
 #include "storage/tile_group.h"
 
+#include <atomic>
 #include <numeric>
 
 #include "catalog/manager.h"
@@ -20,6 +21,7 @@
 #include "common/platform.h"
 #include "common/internal_types.h"
 #include "storage/abstract_table.h"
+#include "storage/frozen_block.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
@@ -29,7 +31,8 @@ namespace peloton {
 namespace storage {
 
 TileGroup::TileGroup(BackendType backend_type,
-                     TileGroupHeader *tile_group_header, AbstractTable *table,
+                     std::shared_ptr<TileGroupHeader> tile_group_header,
+                     AbstractTable *table,
                      const std::vector<catalog::Schema> &schemas,
                      const column_map_type &column_map, int tuple_count)
     : database_id(INVALID_OID),
@@ -49,18 +52,51 @@ TileGroup::TileGroup(BackendType backend_type,
 
     std::shared_ptr<Tile> tile(storage::TileFactory::GetTile(
         backend_type, database_id, table_id, tile_group_id, tile_id,
-        tile_group_header, tile_schemas[tile_itr], this, tuple_count));
+        tile_group_header.get(), tile_schemas[tile_itr], this, tuple_count));
 
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
   }
+
+  zone_map.reset(new ZoneMap(*this));
 }
 
 TileGroup::~TileGroup() {
   // Drop references on all tiles
+}
 
-  // clean up tile group header
-  delete tile_group_header;
+FrozenBlock *TileGroup::GetFrozenBlock() const {
+  return tile_group_header->GetFrozenBlock();
+}
+
+bool TileGroup::Freeze(cid_t horizon_cid) {
+  if (GetFrozenBlock() != nullptr) {
+    return false;
+  }
+  std::unique_ptr<FrozenBlock> new_block =
+      FrozenBlock::Create(*this, horizon_cid);
+  if (new_block == nullptr) {
+    return false;
+  }
+  if (!tile_group_header->InstallFrozenBlock(new_block.get())) {
+    return false;
+  }
+  FrozenBlock *installed = new_block.release();
+
+  // A writer that changed a tuple before the block was installed didn't thaw
+  // it, so check the tuples again now that writers see it
+  if (!installed->IsValidFor(*this)) {
+    Thaw();
+    return false;
+  }
+  LOG_TRACE("Froze tile group %u: %u visible tuples", tile_group_id,
+            installed->GetVisibleTupleCount());
+  return true;
+}
+
+void TileGroup::Thaw() {
+  tile_group_header->Thaw();
+  LOG_TRACE("Thawed tile group %u", tile_group_id);
 }
 
 oid_t TileGroup::GetTileId(const oid_t tile_id) const {
@@ -216,6 +252,10 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
   tile_group_header->SetEndCommitId(tuple_slot_id, MAX_CID);
   tile_group_header->SetNextItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
 
+  zone_map->UpdateTuple(*this, tuple_slot_id);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  Thaw();
+
   tile_group_header->GetHeaderLock().Unlock();
 
   return tuple_slot_id;
@@ -316,6 +356,10 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
   tile_group_header->SetEndCommitId(tuple_slot_id, MAX_CID);
   tile_group_header->SetNextItemPointer(tuple_slot_id, INVALID_ITEMPOINTER);
 
+  zone_map->UpdateTuple(*this, tuple_slot_id);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  Thaw();
+
   return tuple_slot_id;
 }
 
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.cpp
+//
+// Identification: src/storage/tile_group_freezer.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_freezer.h"
+
+#include <chrono>
+
+#include "catalog/catalog_defaults.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/frozen_block.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupFreezer &TileGroupFreezer::GetInstance() {
+  static TileGroupFreezer tile_group_freezer;
+  return tile_group_freezer;
+}
+
+TileGroupFreezer::TileGroupFreezer()
+    : freezer_stop_(true), frozen_count_(0), packed_size_(0),
+      unpacked_size_(0) {}
+
+void TileGroupFreezer::Start() {
+  // Set signal
+  freezer_stop_ = false;
+
+  // Launch thread
+  freezer_thread_ = std::thread(&TileGroupFreezer::Run, this);
+
+  LOG_INFO("Started tile group freezer");
+}
+
+void TileGroupFreezer::Stop() {
+  // Stop freezing
+  freezer_stop_ = true;
+
+  // Stop thread
+  freezer_thread_.join();
+
+  LOG_INFO("Stopped tile group freezer");
+}
+
+void TileGroupFreezer::Run() {
+  while (freezer_stop_ == false) {
+    FreezeAll();
+
+    // Sleep in short steps, so that stopping doesn't wait for the interval
+    auto interval = std::chrono::milliseconds(settings::SettingsManager::GetInt(
+        settings::SettingId::tile_group_freezer_interval));
+    auto wake_up = std::chrono::steady_clock::now() + interval;
+    while (freezer_stop_ == false &&
+           std::chrono::steady_clock::now() < wake_up) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+}
+
+void TileGroupFreezer::FreezeAll() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t expired_eid = epoch_manager.GetExpiredEpochId();
+  if (expired_eid == MAX_EID) {
+    // No transaction has finished yet
+    return;
+  }
+  cid_t horizon_cid = epoch_manager.GetExpiredCid();
+
+  // GC threads may drop tables meanwhile, so the tile groups of each table
+  // are taken under the lock of its database, and outlive the table
+  size_t reclaimed_count = 0;
+  auto storage_manager = StorageManager::GetInstance();
+  for (oid_t db_offset = 0; db_offset < storage_manager->GetDatabaseCount();
+       db_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(db_offset);
+    if (database->GetOid() == CATALOG_DATABASE_OID) {
+      continue;
+    }
+    for (auto table_oid : database->GetTableOids()) {
+      auto tile_groups = database->GetTileGroupsWithTableOid(table_oid);
+      for (auto &tile_group : tile_groups) {
+        reclaimed_count +=
+            tile_group->GetHeader()->ReclaimThawedBlocks(expired_eid);
+      }
+      FreezeTileGroups(tile_groups, horizon_cid);
+    }
+  }
+  LOG_TRACE("Freed %lu thawed blocks", reclaimed_count);
+}
+
+size_t TileGroupFreezer::FreezeTable(DataTable *table, cid_t horizon_cid) {
+  std::vector<std::shared_ptr<TileGroup>> tile_groups;
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    if (tile_group != nullptr) {
+      tile_groups.push_back(tile_group);
+    }
+  }
+  size_t frozen_count = FreezeTileGroups(tile_groups, horizon_cid);
+
+  LOG_TRACE("Froze %lu tile groups of table %u", frozen_count,
+            table->GetOid());
+  return frozen_count;
+}
+
+size_t TileGroupFreezer::FreezeTileGroups(
+    const std::vector<std::shared_ptr<TileGroup>> &tile_groups,
+    cid_t horizon_cid) {
+  size_t frozen_count = 0;
+  for (auto &tile_group : tile_groups) {
+    if (tile_group->GetFrozenBlock() != nullptr) {
+      continue;
+    }
+    if (!tile_group->Freeze(horizon_cid)) {
+      continue;
+    }
+
+    frozen_count++;
+    FrozenBlock *frozen_block = tile_group->GetFrozenBlock();
+    if (frozen_block != nullptr) {
+      packed_size_ += frozen_block->GetPackedSize();
+      unpacked_size_ += frozen_block->GetUnpackedSize();
+    }
+  }
+  frozen_count_ += frozen_count;
+  return frozen_count;
+}
+
+}  // namespace storage
+}  // namespace peloton
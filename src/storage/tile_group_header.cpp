@@ -12,6 +12,7 @@
 #include "storage/tile_group_header.h"
 
 #include <iomanip>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -20,10 +21,12 @@
 #include "common/macros.h"
 #include "common/platform.h"
 #include "common/printable.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager.h"
 #include "logging/log_manager.h"
 #include "storage/backend_manager.h"
+#include "storage/frozen_block.h"
 #include "type/value.h"
 #include "storage/tuple.h"
 
@@ -37,7 +40,10 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
       data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
+      tile_header_lock(),
+      frozen_block(nullptr),
+      all_visible_cid(INVALID_CID),
+      all_visible_retry_cid(0) {
   header_size = num_tuple_slots * header_entry_size;
 
   // allocate storage space for header
@@ -65,6 +71,8 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
 }
 
 TileGroupHeader::~TileGroupHeader() {
+  delete frozen_block.load();
+
   // reclaim the space
   // auto &storage_manager = storage::StorageManager::GetInstance();
   // storage_manager.Release(backend_type, data);
@@ -72,6 +80,84 @@ TileGroupHeader::~TileGroupHeader() {
   data = nullptr;
 }
 
+void TileGroupHeader::Thaw() {
+  ClearAllVisible();
+  if (frozen_block.load() == nullptr) {
+    return;
+  }
+  FrozenBlock *thawed = frozen_block.exchange(nullptr);
+  if (thawed == nullptr) {
+    return;
+  }
+
+  // Scans of the transactions running now may still read the block
+  eid_t thawed_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  std::lock_guard<std::mutex> lock(thawed_blocks_mutex);
+  thawed_blocks.emplace_back(thawed_eid, std::unique_ptr<FrozenBlock>(thawed));
+}
+
+size_t TileGroupHeader::ReclaimThawedBlocks(eid_t expired_eid) {
+  std::lock_guard<std::mutex> lock(thawed_blocks_mutex);
+  size_t thawed_count = thawed_blocks.size();
+  thawed_blocks.erase(
+      std::remove_if(thawed_blocks.begin(), thawed_blocks.end(),
+                     [expired_eid](const ThawedBlock &thawed_block) {
+                       return thawed_block.first <= expired_eid;
+                     }),
+      thawed_blocks.end());
+  return thawed_count - thawed_blocks.size();
+}
+
+bool TileGroupHeader::SetAllVisible(cid_t horizon_cid) {
+  if (horizon_cid < all_visible_retry_cid.load()) {
+    return false;
+  }
+
+  // A committed tuple that is too new only becomes visible at its commit,
+  // while the other tuples may settle at any horizon
+  auto all_visible = [this, horizon_cid]() {
+    oid_t tuple_count = GetCurrentNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      txn_id_t txn_id = GetTransactionId(tuple_id);
+      if (txn_id == INVALID_TXN_ID) {
+        // An empty slot, unless the index entries of an aborted version may
+        // still point to it
+        if (GetIndirection(tuple_id) != nullptr) {
+          return false;
+        }
+        continue;
+      }
+      cid_t begin_cid = GetBeginCommitId(tuple_id);
+      if (txn_id == INITIAL_TXN_ID && begin_cid != MAX_CID &&
+          begin_cid > horizon_cid) {
+        all_visible_retry_cid.store(begin_cid);
+        return false;
+      }
+      if (txn_id != INITIAL_TXN_ID || begin_cid > horizon_cid ||
+          GetEndCommitId(tuple_id) != MAX_CID) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  if (all_visible() == false) {
+    return false;
+  }
+  all_visible_cid.store(horizon_cid);
+
+  // A writer that changed a tuple before the bit was set didn't clear it, so
+  // check the tuples again now that writers see it, like TileGroup::Freeze()
+  // does
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (all_visible() == false) {
+    ClearAllVisible();
+    return false;
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
@@ -0,0 +1,412 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.cpp
+//
+// Identification: src/storage/zone_map.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/zone_map.h"
+
+#include <cstring>
+#include <limits>
+
+#include "catalog/schema.h"
+#include "common/platform.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/zone_map_manager.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+inline int64_t DoubleToBits(double value) {
+  int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double BitsToDouble(int64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// Atomically lower the bound to the value, if it is smaller
+inline void AtomicMin(int64_t *bound, int64_t value) {
+  int64_t current = *bound;
+  while (value < current &&
+         !__sync_bool_compare_and_swap(bound, current, value)) {
+    current = *bound;
+  }
+}
+
+inline void AtomicMax(int64_t *bound, int64_t value) {
+  int64_t current = *bound;
+  while (value > current &&
+         !__sync_bool_compare_and_swap(bound, current, value)) {
+    current = *bound;
+  }
+}
+
+inline void AtomicMinDouble(int64_t *bound, double value) {
+  int64_t current = *bound;
+  while (value < BitsToDouble(current) &&
+         !__sync_bool_compare_and_swap(bound, current, DoubleToBits(value))) {
+    current = *bound;
+  }
+}
+
+inline void AtomicMaxDouble(int64_t *bound, double value) {
+  int64_t current = *bound;
+  while (value > BitsToDouble(current) &&
+         !__sync_bool_compare_and_swap(bound, current, DoubleToBits(value))) {
+    current = *bound;
+  }
+}
+
+}  // namespace
+
+ZoneMap::ZoneMap(const TileGroup &tile_group) : frozen_(false) {
+  auto &column_map = tile_group.GetColumnMap();
+  size_t column_count = column_map.size();
+  column_types_.resize(column_count, type::TypeId::INVALID);
+  column_locations_.resize(column_count);
+  for (auto &entry : column_map) {
+    oid_t column_id = entry.first;
+    oid_t tile_offset = entry.second.first;
+    oid_t tile_column_id = entry.second.second;
+    const catalog::Schema *schema =
+        tile_group.GetTile(tile_offset)->GetSchema();
+    column_types_[column_id] = schema->GetType(tile_column_id);
+    column_locations_[column_id] =
+        std::make_pair(tile_offset, schema->GetOffset(tile_column_id));
+  }
+
+  column_zone_maps_.reset(new ColumnZoneMap[column_count]);
+  ResetBounds(column_zone_maps_.get(), column_types_);
+}
+
+bool ZoneMap::SupportsType(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ZoneMap::ResetBounds(ColumnZoneMap *column_zone_maps,
+                          const std::vector<type::TypeId> &column_types) {
+  for (size_t column_id = 0; column_id < column_types.size(); column_id++) {
+    auto &column_zone_map = column_zone_maps[column_id];
+    type::TypeId type_id = column_types[column_id];
+    column_zone_map.null_count = 0;
+    column_zone_map.tracked = SupportsType(type_id) ? 1 : 0;
+    if (type_id == type::TypeId::DECIMAL) {
+      column_zone_map.min =
+          DoubleToBits(std::numeric_limits<double>::infinity());
+      column_zone_map.max =
+          DoubleToBits(-std::numeric_limits<double>::infinity());
+    } else if (column_zone_map.tracked) {
+      column_zone_map.min = std::numeric_limits<int64_t>::max();
+      column_zone_map.max = std::numeric_limits<int64_t>::min();
+    } else {
+      // Never excludes anything
+      column_zone_map.min = std::numeric_limits<int64_t>::min();
+      column_zone_map.max = std::numeric_limits<int64_t>::max();
+    }
+  }
+}
+
+const char *ZoneMap::GetColumnData(TileGroup &tile_group, oid_t tuple_id,
+                                   oid_t column_id) const {
+  auto &location = column_locations_[column_id];
+  return tile_group.GetTile(location.first)->GetTupleLocation(tuple_id) +
+         location.second;
+}
+
+void ZoneMap::WidenBounds(ColumnZoneMap &column_zone_map, type::TypeId type_id,
+                          const char *data) {
+  int64_t value;
+  switch (type_id) {
+    case type::TypeId::TINYINT: {
+      int8_t raw = *reinterpret_cast<const int8_t *>(data);
+      if (raw == type::PELOTON_INT8_NULL) {
+        __sync_fetch_and_add(&column_zone_map.null_count, 1);
+        return;
+      }
+      value = raw;
+      break;
+    }
+    case type::TypeId::SMALLINT: {
+      int16_t raw = *reinterpret_cast<const int16_t *>(data);
+      if (raw == type::PELOTON_INT16_NULL) {
+        __sync_fetch_and_add(&column_zone_map.null_count, 1);
+        return;
+      }
+      value = raw;
+      break;
+    }
+    case type::TypeId::INTEGER: {
+      int32_t raw = *reinterpret_cast<const int32_t *>(data);
+      if (raw == type::PELOTON_INT32_NULL) {
+        __sync_fetch_and_add(&column_zone_map.null_count, 1);
+        return;
+      }
+      value = raw;
+      break;
+    }
+    case type::TypeId::BIGINT: {
+      int64_t raw = *reinterpret_cast<const int64_t *>(data);
+      if (raw == type::PELOTON_INT64_NULL) {
+        __sync_fetch_and_add(&column_zone_map.null_count, 1);
+        return;
+      }
+      value = raw;
+      break;
+    }
+    case type::TypeId::TIMESTAMP: {
+      uint64_t raw = *reinterpret_cast<const uint64_t *>(data);
+      if (raw == type::PELOTON_TIMESTAMP_NULL) {
+        __sync_fetch_and_add(&column_zone_map.null_count, 1);
+        return;
+      }
+      value = static_cast<int64_t>(raw);
+      break;
+    }
+    case type::TypeId::DECIMAL: {
+      double raw = *reinterpret_cast<const double *>(data);
+      if (raw == type::PELOTON_DECIMAL_NULL) {
+        __sync_fetch_and_add(&column_zone_map.null_count, 1);
+        return;
+      }
+      AtomicMinDouble(&column_zone_map.min, raw);
+      AtomicMaxDouble(&column_zone_map.max, raw);
+      return;
+    }
+    default:
+      return;
+  }
+  AtomicMin(&column_zone_map.min, value);
+  AtomicMax(&column_zone_map.max, value);
+}
+
+void ZoneMap::UpdateTuple(TileGroup &tile_group, oid_t tuple_id) {
+  for (oid_t column_id = 0; column_id < column_types_.size(); column_id++) {
+    if (column_zone_maps_[column_id].tracked) {
+      WidenBounds(column_zone_maps_[column_id], column_types_[column_id],
+                  GetColumnData(tile_group, tuple_id, column_id));
+    }
+  }
+}
+
+void ZoneMap::Freeze(TileGroup &tile_group) {
+  auto tile_group_header = tile_group.GetHeader();
+  if (frozen_ || !tile_group_header->GetImmutability()) {
+    return;
+  }
+
+  // Writers widen the bounds after writing their tuple, so the tuples
+  // written before this snapshot are visible to the scan below, and the
+  // bounds of columns widened after it are left alone
+  size_t column_count = column_types_.size();
+  std::unique_ptr<ColumnZoneMap[]> snapshot(new ColumnZoneMap[column_count]);
+  std::unique_ptr<ColumnZoneMap[]> tight(new ColumnZoneMap[column_count]);
+  for (size_t column_id = 0; column_id < column_count; column_id++) {
+    snapshot[column_id] = column_zone_maps_[column_id];
+  }
+  COMPILER_MEMORY_FENCE;
+  ResetBounds(tight.get(), column_types_);
+
+  // Versions that some transaction may still see are kept until they are
+  // garbage collected, so they all count
+  oid_t end_tuple_id = tile_group_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < end_tuple_id; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID) {
+      continue;
+    }
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      if (tight[column_id].tracked) {
+        WidenBounds(tight[column_id], column_types_[column_id],
+                    GetColumnData(tile_group, tuple_id, column_id));
+      }
+    }
+  }
+
+  for (size_t column_id = 0; column_id < column_count; column_id++) {
+    auto &column_zone_map = column_zone_maps_[column_id];
+    __sync_bool_compare_and_swap(&column_zone_map.min, snapshot[column_id].min,
+                                 tight[column_id].min);
+    __sync_bool_compare_and_swap(&column_zone_map.max, snapshot[column_id].max,
+                                 tight[column_id].max);
+    __sync_bool_compare_and_swap(&column_zone_map.null_count,
+                                 snapshot[column_id].null_count,
+                                 tight[column_id].null_count);
+  }
+  frozen_ = true;
+}
+
+void ZoneMap::CopyBounds(const ZoneMap &other) {
+  PL_ASSERT(column_types_ == other.column_types_);
+  for (size_t column_id = 0; column_id < column_types_.size(); column_id++) {
+    column_zone_maps_[column_id] = other.column_zone_maps_[column_id];
+  }
+  frozen_ = other.frozen_;
+}
+
+bool ZoneMap::GetNumericConstant(const type::Value &value, bool &is_decimal,
+                                 int64_t &integer_value,
+                                 double &decimal_value) {
+  if (value.IsNull()) {
+    return false;
+  }
+  is_decimal = false;
+  switch (value.GetTypeId()) {
+    case type::TypeId::TINYINT:
+      integer_value = value.GetAs<int8_t>();
+      return true;
+    case type::TypeId::SMALLINT:
+      integer_value = value.GetAs<int16_t>();
+      return true;
+    case type::TypeId::INTEGER:
+      integer_value = value.GetAs<int32_t>();
+      return true;
+    case type::TypeId::BIGINT:
+      integer_value = value.GetAs<int64_t>();
+      return true;
+    case type::TypeId::TIMESTAMP:
+      integer_value = static_cast<int64_t>(value.GetAs<uint64_t>());
+      return true;
+    case type::TypeId::DECIMAL:
+      is_decimal = true;
+      decimal_value = value.GetAs<double>();
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ZoneMap::MayMatch(oid_t column_id, ExpressionType comparison,
+                       const type::Value &value) const {
+  if (column_id >= column_types_.size() ||
+      !column_zone_maps_[column_id].tracked) {
+    return true;
+  }
+  bool is_decimal;
+  int64_t integer_value;
+  double decimal_value;
+  if (!GetNumericConstant(value, is_decimal, integer_value, decimal_value)) {
+    return true;
+  }
+
+  // Compare as integers if both sides are, and as doubles otherwise
+  auto &column_zone_map = column_zone_maps_[column_id];
+  bool column_is_decimal = column_types_[column_id] == type::TypeId::DECIMAL;
+  int min_cmp, max_cmp;
+  if (!is_decimal && !column_is_decimal) {
+    min_cmp = (column_zone_map.min > integer_value) -
+              (column_zone_map.min < integer_value);
+    max_cmp = (column_zone_map.max > integer_value) -
+              (column_zone_map.max < integer_value);
+  } else {
+    double constant = is_decimal ? decimal_value : integer_value;
+    double min = column_is_decimal ? BitsToDouble(column_zone_map.min)
+                                   : column_zone_map.min;
+    double max = column_is_decimal ? BitsToDouble(column_zone_map.max)
+                                   : column_zone_map.max;
+    min_cmp = (min > constant) - (min < constant);
+    max_cmp = (max > constant) - (max < constant);
+  }
+
+  switch (comparison) {
+    case ExpressionType::COMPARE_EQUAL:
+      return min_cmp <= 0 && max_cmp >= 0;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return min_cmp < 0;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return min_cmp <= 0;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return max_cmp > 0;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return max_cmp >= 0;
+    default:
+      return true;
+  }
+}
+
+bool ZoneMap::ShouldScan(const PredicateInfo *predicates,
+                         int32_t num_predicates) const {
+  for (int32_t i = 0; i < num_predicates; i++) {
+    if (!MayMatch(predicates[i].col_id,
+                  static_cast<ExpressionType>(
+                      predicates[i].comparison_operator),
+                  predicates[i].predicate_value)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ZoneMap::GetBounds(oid_t column_id, type::Value &min,
+                        type::Value &max) const {
+  PL_ASSERT(column_id < column_types_.size());
+  auto &column_zone_map = column_zone_maps_[column_id];
+  if (!column_zone_map.tracked) {
+    return false;
+  }
+  type::TypeId type_id = column_types_[column_id];
+  if (type_id == type::TypeId::DECIMAL) {
+    double min_value = BitsToDouble(column_zone_map.min);
+    double max_value = BitsToDouble(column_zone_map.max);
+    if (min_value > max_value) {
+      return false;
+    }
+    min = type::ValueFactory::GetDecimalValue(min_value);
+    max = type::ValueFactory::GetDecimalValue(max_value);
+    return true;
+  }
+  if (column_zone_map.min > column_zone_map.max) {
+    return false;
+  }
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+      min = type::ValueFactory::GetTinyIntValue(column_zone_map.min);
+      max = type::ValueFactory::GetTinyIntValue(column_zone_map.max);
+      break;
+    case type::TypeId::SMALLINT:
+      min = type::ValueFactory::GetSmallIntValue(column_zone_map.min);
+      max = type::ValueFactory::GetSmallIntValue(column_zone_map.max);
+      break;
+    case type::TypeId::INTEGER:
+      min = type::ValueFactory::GetIntegerValue(column_zone_map.min);
+      max = type::ValueFactory::GetIntegerValue(column_zone_map.max);
+      break;
+    case type::TypeId::TIMESTAMP:
+      min = type::ValueFactory::GetTimestampValue(column_zone_map.min);
+      max = type::ValueFactory::GetTimestampValue(column_zone_map.max);
+      break;
+    default:
+      min = type::ValueFactory::GetBigIntValue(column_zone_map.min);
+      max = type::ValueFactory::GetBigIntValue(column_zone_map.max);
+      break;
+  }
+  return true;
+}
+
+}  // namespace storage
+}  // namespace peloton
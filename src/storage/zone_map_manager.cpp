@@ -17,6 +17,7 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/storage_manager.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
 #include "type/ephemeral_pool.h"
 #include "storage/zone_map_manager.h"
 
@@ -88,6 +89,9 @@ void ZoneMapManager::CreateOrUpdateZoneMapForTileGroup(
   size_t num_columns = schema->GetColumnCount();
   auto tile_group = table->GetTileGroup(tile_group_idx);
 
+  // Also tighten the in-memory bounds, now that the tile group is immutable
+  tile_group->GetZoneMap()->Freeze(*tile_group);
+
   for (oid_t col_itr = 0; col_itr < num_columns; col_itr++) {
     // Set temp min and temp max as the first value.
     type::Value min = tile_group->GetValue(0, col_itr);
@@ -189,8 +193,8 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 }
 
 /**
- * @brief   The function compares the predicate against the zone map for
- *          the column present in catalog
+ * @brief   The function compares the predicate against the in-memory zone
+ *          map of the tile group
  * @param   parsed predicates array, number of predicates, table_ptr and 
  *          tile_group_index
  * @return  True if tile group needs to be scanned.
@@ -199,51 +203,12 @@ ZoneMapManager::GetResultVectorAsZoneMap(
 bool ZoneMapManager::ShouldScanTileGroup(
     storage::PredicateInfo *parsed_predicates, int32_t num_predicates,
     storage::DataTable *table, int64_t tile_group_idx) {
-  for (int32_t i = 0; i < num_predicates; i++) {
-    // Extract the col_id, operator and predicate_value
-    int col_id = parsed_predicates[i].col_id;
-    int comparison_operator = parsed_predicates[i].comparison_operator;
-    type::Value predicate_value = parsed_predicates[i].predicate_value;
-
-    oid_t database_id = table->GetDatabaseOid();
-    oid_t table_id = table->GetOid();
-
-    std::unique_ptr<ZoneMapManager::ColumnStatistics> stats =
-        GetZoneMapFromCatalog(database_id, table_id, tile_group_idx, col_id);
-
-    if (stats == nullptr) {
-      return true;
-    }
-    switch (comparison_operator) {
-      case (int)ExpressionType::COMPARE_EQUAL:
-        if (!checkEqual(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_LESSTHAN:
-        if (!checkLessThan(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_LESSTHANOREQUALTO:
-        if (!checkLessThanEquals(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_GREATERTHAN:
-        if (!checkGreaterThan(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      case (int)ExpressionType::COMPARE_GREATERTHANOREQUALTO:
-        if (!checkGreaterThanEquals(predicate_value, stats.get())) {
-          return false;
-        }
-        break;
-      default: { throw Exception{"Invalid expression type for translation "}; }
-    }
+  auto tile_group = table->GetTileGroup(tile_group_idx);
+  if (tile_group == nullptr) {
+    return true;
   }
-  return true;
+  return tile_group->GetZoneMap()->ShouldScan(parsed_predicates,
+                                              num_predicates);
 }
 
 /**
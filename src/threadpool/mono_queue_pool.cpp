@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// mono_queue_pool.cpp
+//
+// Identification: src/threadpool/mono_queue_pool.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "threadpool/mono_queue_pool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "settings/settings_manager.h"
+#include "statistics/backend_stats_context.h"
+
+namespace peloton {
+namespace threadpool {
+
+namespace {
+
+// The number of latency-sensitive workers. Zero means one per hardware thread.
+size_t GetLatencyWorkerCount() {
+  auto num_workers = static_cast<size_t>(std::max(
+      0, settings::SettingsManager::GetInt(
+             settings::SettingId::worker_pool_size)));
+  if (num_workers == 0) {
+    num_workers = std::thread::hardware_concurrency();
+  }
+  return num_workers == 0 ? kDefaultWorkerPoolSize : num_workers;
+}
+
+size_t GetBatchWorkerCount() {
+  return static_cast<size_t>(std::max(
+      0, settings::SettingsManager::GetInt(
+             settings::SettingId::batch_worker_pool_size)));
+}
+
+size_t GetTaskQueueSize() {
+  auto queue_size = settings::SettingsManager::GetInt(
+      settings::SettingId::task_queue_size);
+  return queue_size > 0 ? static_cast<size_t>(queue_size)
+                        : kDefaultTaskQueueSize;
+}
+
+}  // namespace
+
+MonoQueuePool::MonoQueuePool()
+    : latency_queue_(GetTaskQueueSize()),
+      batch_queue_(GetTaskQueueSize()),
+      latency_workers_(GetLatencyWorkerCount(), &latency_queue_),
+      batch_workers_(GetBatchWorkerCount(),
+                     std::vector<TaskQueue *>{&batch_queue_, &latency_queue_}),
+      is_running_(false) {
+  LOG_DEBUG("Worker pool with %zu latency-sensitive and %zu batch workers",
+            latency_workers_.GetNumWorkers(), batch_workers_.GetNumWorkers());
+}
+
+void MonoQueuePool::SubmitTask(std::function<void()> func,
+                               TaskPriority priority) {
+  if (!is_running_) {
+    Startup();
+  }
+
+  // Without batch workers, batch tasks share the latency-sensitive lane
+  auto &task_queue =
+      (priority == TaskPriority::BATCH && batch_workers_.GetNumWorkers() > 0)
+          ? batch_queue_
+          : latency_queue_;
+
+  // Record how long the task waits in the queue before a worker picks it up
+  if (static_cast<StatsType>(settings::SettingsManager::GetInt(
+          settings::SettingId::stats_mode)) != StatsType::INVALID) {
+    auto enqueue_time = std::chrono::steady_clock::now();
+    task_queue.Enqueue([ func = std::move(func), enqueue_time ] {
+      std::chrono::duration<double, std::milli> wait_time =
+          std::chrono::steady_clock::now() - enqueue_time;
+      stats::BackendStatsContext::GetInstance()
+          ->GetQueueWaitLatencyMetric()
+          .RecordLatency(wait_time.count());
+      func();
+    });
+    return;
+  }
+
+  task_queue.Enqueue(std::move(func));
+}
+
+}  // namespace threadpool
+}  // namespace peloton
@@ -15,14 +15,38 @@
 namespace peloton {
 namespace threadpool {
 
-void WorkerFunc(std::atomic_bool *should_shutdown, TaskQueue *task_queue) {
+namespace {
+
+bool AllEmpty(const std::vector<TaskQueue *> &task_queues) {
+  for (auto *task_queue : task_queues) {
+    if (!task_queue->IsEmpty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DequeueTask(const std::vector<TaskQueue *> &task_queues,
+                 std::function<void()> &task) {
+  for (auto *task_queue : task_queues) {
+    if (task_queue->Dequeue(task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+void WorkerFunc(std::atomic_bool *should_shutdown,
+                const std::vector<TaskQueue *> *task_queues) {
   constexpr auto kMinPauseTime = std::chrono::microseconds(1);
   constexpr auto kMaxPauseTime = std::chrono::microseconds(1000);
 
   auto pause_time = kMinPauseTime;
-  while (!should_shutdown->load() || !task_queue->IsEmpty()) {
+  while (!should_shutdown->load() || !AllEmpty(*task_queues)) {
     std::function<void()> task;
-    if (!task_queue->Dequeue(task)) {
+    if (!DequeueTask(*task_queues, task)) {
       // Polling with exponential backoff
       std::this_thread::sleep_for(pause_time);
       pause_time = std::min(pause_time * 2, kMaxPauseTime);
@@ -0,0 +1,434 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.cpp
+//
+// Identification: src/traffic_cop/plan_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "traffic_cop/plan_cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+#include "common/logger.h"
+#include "optimizer/stats/stats_storage.h"
+#include "settings/settings_manager.h"
+#include "storage/storage_manager.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace tcop {
+
+namespace {
+
+enum class TokenType { WORD, QUOTED_WORD, NUMBER, STRING, OPERATOR };
+
+struct Token {
+  TokenType type;
+  // The token as it appears in the query
+  std::string text;
+  // Whether the token was preceded by whitespace
+  bool space_before;
+};
+
+bool IsWordChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool IsKeyword(const Token &token, const char *keyword) {
+  if (token.type != TokenType::WORD) return false;
+  size_t len = std::char_traits<char>::length(keyword);
+  if (token.text.size() != len) return false;
+  for (size_t i = 0; i < len; i++) {
+    if (std::tolower(static_cast<unsigned char>(token.text[i])) != keyword[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsComparison(const Token &token) {
+  if (token.type != TokenType::OPERATOR) return false;
+  const auto &op = token.text;
+  return op == "=" || op == "<" || op == ">" || op == "<=" || op == ">=" ||
+         op == "<>" || op == "!=";
+}
+
+// Split the query into tokens. Returns false for queries we don't want to
+// cache: queries with comments, existing parameters, or special literals.
+bool Tokenize(const std::string &query, std::vector<Token> &tokens) {
+  size_t pos = 0, len = query.size();
+  bool space_before = false;
+  while (pos < len) {
+    char c = query[pos];
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      space_before = true;
+      pos++;
+      continue;
+    }
+
+    size_t start = pos;
+    TokenType type;
+    if ((c == '-' && pos + 1 < len && query[pos + 1] == '-') ||
+        (c == '/' && pos + 1 < len && query[pos + 1] == '*') || c == '$') {
+      return false;
+    } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+               (c == '.' && pos + 1 < len &&
+                std::isdigit(static_cast<unsigned char>(query[pos + 1])))) {
+      type = TokenType::NUMBER;
+      while (pos < len && std::isdigit(static_cast<unsigned char>(query[pos])))
+        pos++;
+      if (pos < len && query[pos] == '.') {
+        pos++;
+        while (pos < len &&
+               std::isdigit(static_cast<unsigned char>(query[pos])))
+          pos++;
+      }
+      if (pos < len && (query[pos] == 'e' || query[pos] == 'E')) {
+        pos++;
+        if (pos < len && (query[pos] == '+' || query[pos] == '-')) pos++;
+        if (pos == len || !std::isdigit(static_cast<unsigned char>(query[pos])))
+          return false;
+        while (pos < len &&
+               std::isdigit(static_cast<unsigned char>(query[pos])))
+          pos++;
+      }
+      if (pos < len && IsWordChar(query[pos])) return false;
+    } else if (IsWordChar(c)) {
+      type = TokenType::WORD;
+      while (pos < len && IsWordChar(query[pos])) pos++;
+      // Prefixed strings (E'...', B'...', X'...')
+      if (pos < len && query[pos] == '\'') return false;
+    } else if (c == '\'' || c == '"') {
+      type = c == '\'' ? TokenType::STRING : TokenType::QUOTED_WORD;
+      pos++;
+      while (true) {
+        if (pos == len) return false;
+        if (query[pos] == c) {
+          // A doubled quote is an escaped quote
+          if (pos + 1 < len && query[pos + 1] == c) {
+            pos += 2;
+            continue;
+          }
+          pos++;
+          break;
+        }
+        pos++;
+      }
+    } else {
+      type = TokenType::OPERATOR;
+      pos++;
+      if (pos < len) {
+        char next = query[pos];
+        if ((c == '<' && (next == '=' || next == '>')) ||
+            ((c == '>' || c == '!') && next == '=') ||
+            (c == ':' && next == ':') || (c == '|' && next == '|')) {
+          pos++;
+        }
+      }
+    }
+    tokens.push_back(Token{type, query.substr(start, pos - start),
+                           space_before});
+    space_before = false;
+  }
+  return true;
+}
+
+type::Value LiteralToValue(const Token &token) {
+  if (token.type == TokenType::STRING) {
+    // Strip the quotes and unescape doubled quotes
+    std::string str;
+    for (size_t i = 1; i + 1 < token.text.size(); i++) {
+      str.push_back(token.text[i]);
+      if (token.text[i] == '\'') i++;
+    }
+    return type::ValueFactory::GetVarcharValue(str);
+  }
+
+  // Integers that don't fit into 32 bits are decimals, like in the parser
+  const auto &text = token.text;
+  if (text.find_first_of(".eE") == std::string::npos && text.size() <= 10) {
+    int64_t val = std::stoll(text);
+    if (val <= std::numeric_limits<int32_t>::max()) {
+      return type::ValueFactory::GetIntegerValue(static_cast<int32_t>(val));
+    }
+  }
+  return type::ValueFactory::GetDecimalValue(std::stod(text));
+}
+
+}  // namespace
+
+PlanCache::PlanCache() {
+  storage::StorageManager::GetInstance()->SetTableInvalidationHook(
+      [this](oid_t table_oid) { Remove(table_oid); });
+  optimizer::StatsStorage::SetTableStatsHook(
+      [this](oid_t table_oid, size_t num_rows) {
+        UpdateTableStats(table_oid, num_rows);
+      });
+}
+
+PlanCache::~PlanCache() {
+  storage::StorageManager::GetInstance()->SetTableInvalidationHook(nullptr);
+  optimizer::StatsStorage::SetTableStatsHook(nullptr);
+}
+
+bool PlanCache::Normalize(const std::string &query,
+                          std::string &normalized_query,
+                          std::vector<type::Value> &param_values) {
+  std::vector<Token> tokens;
+  if (!Tokenize(query, tokens) || tokens.empty()) return false;
+
+  // Only plain SELECT, UPDATE and DELETE queries
+  if (!IsKeyword(tokens[0], "select") && !IsKeyword(tokens[0], "update") &&
+      !IsKeyword(tokens[0], "delete")) {
+    return false;
+  }
+
+  normalized_query.clear();
+  param_values.clear();
+  bool in_clause = false;
+  for (size_t i = 0; i < tokens.size(); i++) {
+    const auto &token = tokens[i];
+    // Don't bother with subqueries and set operations
+    if (i > 0 && IsKeyword(token, "select")) return false;
+    if (IsKeyword(token, "where") || IsKeyword(token, "set")) {
+      in_clause = true;
+    }
+
+    if (i > 0 && token.space_before) normalized_query.push_back(' ');
+
+    // Only extract literals that a column is directly compared against or
+    // assigned to, e.g. "a = 1", but not "a = 1 + b" or "LIMIT 1"
+    bool is_param = false;
+    if (in_clause && i > 0 && IsComparison(tokens[i - 1]) &&
+        (token.type == TokenType::NUMBER || token.type == TokenType::STRING)) {
+      is_param = true;
+      if (i + 1 < tokens.size()) {
+        const auto &next = tokens[i + 1];
+        is_param = next.type == TokenType::WORD ||
+                   (next.type == TokenType::OPERATOR &&
+                    (next.text == "," || next.text == ")" || next.text == ";"));
+      }
+    }
+
+    if (is_param) {
+      param_values.push_back(LiteralToValue(token));
+      normalized_query.append("$" + std::to_string(param_values.size()));
+    } else {
+      normalized_query.append(token.text);
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<Statement> PlanCache::Find(
+    const std::string &database_name, const std::string &normalized_query,
+    const std::vector<type::Value> &param_values,
+    const std::string &statement_name, const std::string &query_string) {
+  auto key = MakeKey(database_name, normalized_query, param_values);
+
+  // Finding an entry only marks it as referenced, so that hits don't exclude
+  // each other
+  cache_lock_.ReadLock();
+  auto it = cache_map_.find(key);
+  if (it == cache_map_.end()) {
+    num_misses_++;
+    cache_lock_.Unlock();
+    return nullptr;
+  }
+  auto &entry = *it->second;
+  entry.referenced.store(true, std::memory_order_relaxed);
+
+  // Add() made sure that the plan can be copied
+  std::shared_ptr<planner::AbstractPlan> plan(CopyPlanTree(entry.plan.get()));
+  PL_ASSERT(plan != nullptr);
+
+  auto statement = std::make_shared<Statement>(
+      statement_name, entry.query_type, query_string, nullptr);
+  statement->SetPlanTree(plan);
+  statement->SetReferencedTables(entry.table_oids);
+  statement->SetTupleDescriptor(entry.tuple_descriptor);
+  num_hits_++;
+  cache_lock_.Unlock();
+  return statement;
+}
+
+void PlanCache::Add(const std::string &database_name,
+                    const std::string &normalized_query,
+                    const std::vector<type::Value> &param_values,
+                    const Statement &statement, uint64_t version) {
+  const auto &plan = statement.GetPlanTree();
+  if (plan == nullptr) return;
+
+  // Make sure that copies of the plan are identical to the plan
+  auto plan_copy = CopyPlanTree(plan.get());
+  if (plan_copy == nullptr || plan_copy->Hash() != plan->Hash() ||
+      *plan_copy != *plan) {
+    LOG_DEBUG("Not caching plan that can't be copied: %s",
+              normalized_query.c_str());
+    return;
+  }
+
+  auto key = MakeKey(database_name, normalized_query, param_values);
+  const auto &table_oids = statement.GetReferencedTables();
+
+  auto capacity = static_cast<size_t>(std::max(
+      settings::SettingsManager::GetInt(settings::SettingId::plan_cache_size),
+      0));
+
+  cache_lock_.WriteLock();
+  if (version != version_) {
+    // The plan may have been built from the catalog before some DDL
+    LOG_TRACE("Not caching plan built before DDL: %s",
+              normalized_query.c_str());
+    cache_lock_.Unlock();
+    return;
+  }
+  // Another thread may have planned the same query in the meantime
+  auto it = cache_map_.find(key);
+  if (it != cache_map_.end()) {
+    Erase(it->second);
+  }
+
+  entry_list_.emplace_front();
+  auto &entry = entry_list_.front();
+  entry.key = key;
+  entry.query_type = statement.GetQueryType();
+  entry.plan = std::move(plan_copy);
+  entry.tuple_descriptor = statement.GetTupleDescriptor();
+  entry.table_oids = table_oids;
+  for (oid_t table_oid : table_oids) {
+    auto rows_it = table_rows_.find(table_oid);
+    if (rows_it != table_rows_.end()) {
+      entry.table_rows.emplace(table_oid, rows_it->second);
+    }
+  }
+  cache_map_.emplace(entry.key, entry_list_.begin());
+
+  while (cache_map_.size() > capacity) {
+    EvictOne();
+  }
+  cache_lock_.Unlock();
+}
+
+void PlanCache::Clear() {
+  cache_lock_.WriteLock();
+  version_++;
+  cache_map_.clear();
+  entry_list_.clear();
+  cache_lock_.Unlock();
+}
+
+void PlanCache::Remove(oid_t table_oid) {
+  cache_lock_.WriteLock();
+  for (auto it = entry_list_.begin(); it != entry_list_.end();) {
+    auto next = std::next(it);
+    if (it->table_oids.count(table_oid) != 0) {
+      Erase(it);
+    }
+    it = next;
+  }
+  table_rows_.erase(table_oid);
+  cache_lock_.Unlock();
+}
+
+void PlanCache::UpdateTableStats(oid_t table_oid, size_t num_rows) {
+  cache_lock_.WriteLock();
+  table_rows_[table_oid] = num_rows;
+  for (auto it = entry_list_.begin(); it != entry_list_.end();) {
+    auto next = std::next(it);
+    if (it->table_oids.count(table_oid) != 0) {
+      // Plans built before the table had statistics are always rebuilt
+      auto rows_it = it->table_rows.find(table_oid);
+      if (rows_it == it->table_rows.end() ||
+          NeedsReplan(rows_it->second, num_rows)) {
+        LOG_TRACE("Invalidating cached plan: %s", it->key.c_str());
+        Erase(it);
+      }
+    }
+    it = next;
+  }
+  cache_lock_.Unlock();
+}
+
+size_t PlanCache::GetCount() const {
+  cache_lock_.ReadLock();
+  size_t count = cache_map_.size();
+  cache_lock_.Unlock();
+  return count;
+}
+
+std::unique_ptr<planner::AbstractPlan> PlanCache::CopyPlanTree(
+    const planner::AbstractPlan *plan) {
+  // Only the plans whose Copy() carries over all of their state
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN:
+    case PlanNodeType::NESTLOOP:
+    case PlanNodeType::HASHJOIN:
+    case PlanNodeType::HASH:
+    case PlanNodeType::UPDATE:
+    case PlanNodeType::DELETE:
+    case PlanNodeType::AGGREGATE_V2:
+    case PlanNodeType::ORDERBY:
+    case PlanNodeType::PROJECTION:
+    case PlanNodeType::LIMIT:
+      break;
+    default:
+      return nullptr;
+  }
+
+  auto copy = plan->Copy();
+  if (copy == nullptr) return nullptr;
+  for (const auto &child : plan->GetChildren()) {
+    auto child_copy = CopyPlanTree(child.get());
+    if (child_copy == nullptr) return nullptr;
+    copy->AddChild(std::move(child_copy));
+  }
+  return copy;
+}
+
+std::string PlanCache::MakeKey(const std::string &database_name,
+                               const std::string &normalized_query,
+                               const std::vector<type::Value> &param_values) {
+  std::string key = database_name;
+  key.append("\n");
+  key.append(normalized_query);
+  for (const auto &value : param_values) {
+    key.append("\n");
+    key.append(TypeIdToString(value.GetTypeId()));
+  }
+  return key;
+}
+
+bool PlanCache::NeedsReplan(size_t planned_rows, size_t num_rows) {
+  double smaller = std::min(planned_rows, num_rows) + 1;
+  double larger = std::max(planned_rows, num_rows) + 1;
+  return larger / smaller > kReplanRowRatio;
+}
+
+void PlanCache::Erase(EntryList::iterator it) {
+  cache_map_.erase(it->key);
+  entry_list_.erase(it);
+}
+
+void PlanCache::EvictOne() {
+  // Every entry loses its mark when passed over, so this ends within a round
+  while (!entry_list_.empty()) {
+    auto it = std::prev(entry_list_.end());
+    if (!it->referenced.exchange(false)) {
+      Erase(it);
+      return;
+    }
+    entry_list_.splice(entry_list_.begin(), entry_list_, it);
+  }
+}
+
+}  // namespace tcop
+}  // namespace peloton
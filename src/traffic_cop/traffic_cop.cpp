@@ -12,6 +12,7 @@
 
 #include "traffic_cop/traffic_cop.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "binder/bind_node_visitor.h"
@@ -19,10 +20,15 @@
 #include "concurrency/transaction_manager_factory.h"
 #include "common/internal_types.h"
 #include "expression/expression_util.h"
+#include "index/index.h"
 #include "optimizer/optimizer.h"
+#include "parser/postgresparser.h"
+#include "planner/index_scan_plan.h"
 #include "planner/plan_util.h"
+#include "storage/data_table.h"
 #include "settings/settings_manager.h"
 #include "threadpool/mono_queue_pool.h"
+#include "traffic_cop/plan_cache.h"
 
 namespace peloton {
 namespace tcop {
@@ -104,13 +110,16 @@ ResultType TrafficCop::CommitQueryHelper() {
   // If this exception if caused by a query in a transaction,
   // I will block following queries in that transaction until 'COMMIT' or
   // 'ROLLBACK' After receive 'COMMIT', see if it is rollback or really commit.
+  ResultType result;
   if (curr_state.second != ResultType::ABORTED) {
     // txn committed
-    return txn_manager.CommitTransaction(txn);
+    result = txn_manager.CommitTransaction(txn);
   } else {
     // otherwise, rollback
-    return txn_manager.AbortTransaction(txn);
+    result = txn_manager.AbortTransaction(txn);
   }
+  ClearPlanCacheAfterDDL();
+  return result;
 }
 
 ResultType TrafficCop::AbortQueryHelper() {
@@ -123,14 +132,23 @@ ResultType TrafficCop::AbortQueryHelper() {
     auto txn = curr_state.first;
     auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
     auto result = txn_manager.AbortTransaction(txn);
+    ClearPlanCacheAfterDDL();
     return result;
   } else {
     delete curr_state.first;
+    ClearPlanCacheAfterDDL();
     // otherwise, the txn has already been aborted
     return ResultType::ABORTED;
   }
 }
 
+void TrafficCop::ClearPlanCacheAfterDDL() {
+  if (clear_plan_cache_) {
+    PlanCache::Instance().Clear();
+    clear_plan_cache_ = false;
+  }
+}
+
 ResultType TrafficCop::ExecuteStatementGetResult() {
   LOG_TRACE("Statement executed. Result: %s",
             ResultTypeToString(p_status_.m_result).c_str());
@@ -180,6 +198,24 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
     return p_status_;
   }
 
+  // In run-to-completion mode, execute cheap plans on this thread and finish
+  // the transaction right away. There is no task to wait for. Everything else
+  // goes to the pool, so that it doesn't stall the other connections of this
+  // thread.
+  if (settings::SettingsManager::GetBool(
+          settings::SettingId::inline_execution) &&
+      IsInlinePlan(plan.get())) {
+    executor::PlanExecutor::ExecutePlan(
+        plan, txn, params, result_format,
+        [&result, this](executor::ExecutionResult p_status,
+                        std::vector<ResultValue> &&values) {
+          this->p_status_ = p_status;
+          result = std::move(values);
+        });
+    ExecuteStatementPlanGetResult();
+    return p_status_;
+  }
+
   auto on_complete = [&result, this](executor::ExecutionResult p_status,
                                      std::vector<ResultValue> &&values) {
     this->p_status_ = p_status;
@@ -187,11 +223,25 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
     task_callback_(task_callback_arg_);
   };
 
+  // Long-running statements go to the batch lane so that they don't hold up
+  // short statements
+  auto priority = GetTaskPriority(plan.get());
+
+  // Rows are sent to the client while the query runs rather than handed over
+  // at the end
+  std::function<void(std::vector<ResultValue> &)> on_result_batch;
+  if (result_callback_ != nullptr) {
+    on_result_batch = [this](std::vector<ResultValue> &batch) {
+      result_callback_(result_callback_arg_, batch);
+    };
+  }
+
   auto &pool = threadpool::MonoQueuePool::GetInstance();
-  pool.SubmitTask([plan, txn, &params, &result, &result_format, on_complete] {
+  pool.SubmitTask([plan, txn, &params, &result, &result_format, on_complete,
+                   on_result_batch] {
     executor::PlanExecutor::ExecutePlan(plan, txn, params, result_format,
-                                        on_complete);
-  });
+                                        on_complete, on_result_batch);
+  }, priority);
 
   is_queuing_ = true;
 
@@ -200,6 +250,105 @@ executor::ExecutionResult TrafficCop::ExecuteHelper(
   return p_status_;
 }
 
+// Whether the index scan looks a single key up by equality on all its columns
+static bool IsPointLookup(const planner::IndexScanPlan *index_scan) {
+  const auto &expr_types = index_scan->GetExprTypes();
+  if (expr_types.size() <
+      index_scan->GetIndex()->GetMetadata()->GetKeyAttrs().size()) {
+    return false;
+  }
+  for (auto expr_type : expr_types) {
+    if (expr_type != ExpressionType::COMPARE_EQUAL) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The number of tuples the plan may read from its tables. Scans count the
+// tuples of their table unless they look a single key up, and nested loop
+// joins read the inner side once per outer tuple.
+static size_t EstimateReadTuples(const planner::AbstractPlan *plan) {
+  size_t tuple_count = 0;
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN: {
+      auto table = static_cast<const planner::AbstractScan *>(plan)->GetTable();
+      tuple_count = table != nullptr ? table->GetTupleCount() : 0;
+      break;
+    }
+    case PlanNodeType::INDEXSCAN: {
+      auto *index_scan = static_cast<const planner::IndexScanPlan *>(plan);
+      tuple_count = IsPointLookup(index_scan)
+                        ? 1
+                        : index_scan->GetTable()->GetTupleCount();
+      break;
+    }
+    case PlanNodeType::NESTLOOP: {
+      const auto &children = plan->GetChildren();
+      if (children.size() == 2) {
+        size_t outer_count = EstimateReadTuples(children[0].get());
+        size_t inner_count = EstimateReadTuples(children[1].get());
+        return outer_count +
+               std::max(outer_count, static_cast<size_t>(1)) * inner_count;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+
+  for (const auto &child : plan->GetChildren()) {
+    tuple_count += EstimateReadTuples(child.get());
+  }
+  return tuple_count;
+}
+
+threadpool::TaskPriority TrafficCop::GetTaskPriority(
+    const planner::AbstractPlan *plan) {
+  if (plan == nullptr) {
+    return threadpool::TaskPriority::LATENCY_SENSITIVE;
+  }
+
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::ANALYZE:
+    case PlanNodeType::COPY:
+    case PlanNodeType::CREATE:
+    case PlanNodeType::POPULATE_INDEX:
+      return threadpool::TaskPriority::BATCH;
+    default:
+      break;
+  }
+
+  auto min_tuple_count = static_cast<size_t>(std::max(
+      0, settings::SettingsManager::GetInt(
+             settings::SettingId::batch_task_min_tuples)));
+  return EstimateReadTuples(plan) >= min_tuple_count
+             ? threadpool::TaskPriority::BATCH
+             : threadpool::TaskPriority::LATENCY_SENSITIVE;
+}
+
+bool TrafficCop::IsInlinePlan(const planner::AbstractPlan *plan) {
+  if (plan == nullptr) {
+    return false;
+  }
+  const auto &children = plan->GetChildren();
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::INSERT:
+      // INSERT ... SELECT has a child scanning the source
+      return children.empty();
+    case PlanNodeType::UPDATE:
+    case PlanNodeType::DELETE:
+    case PlanNodeType::PROJECTION:
+    case PlanNodeType::LIMIT:
+      return children.size() == 1 && IsInlinePlan(children[0].get());
+    case PlanNodeType::INDEXSCAN:
+      return children.empty() &&
+             IsPointLookup(static_cast<const planner::IndexScanPlan *>(plan));
+    default:
+      return false;
+  }
+}
+
 void TrafficCop::ExecuteStatementPlanGetResult() {
   bool init_failure = false;
   if (p_status_.m_result == ResultType::FAILURE) {
@@ -385,6 +534,87 @@ bool TrafficCop::BindParamsForCachePlan(
   return true;
 }
 
+/*
+ * Prepare a simple query using the plan cache. The query is normalized by
+ * replacing the literals it compares against with parameters. On a miss, the
+ * normalized query is planned and added to the cache. Either way, the
+ * extracted literals are bound to the plan as its parameter values.
+ */
+bool TrafficCop::PrepareCachedStatement(const std::string &query_string,
+                                        std::string &error_message,
+                                        const size_t thread_id) {
+  if (!settings::SettingsManager::GetBool(settings::SettingId::plan_cache)) {
+    return false;
+  }
+
+  std::string normalized_query;
+  std::vector<type::Value> param_values;
+  if (!PlanCache::Normalize(query_string, normalized_query, param_values)) {
+    return false;
+  }
+
+  const std::string stmt_name = "unamed";
+  auto &plan_cache = PlanCache::Instance();
+  auto statement = plan_cache.Find(default_database_name_, normalized_query,
+                                   param_values, stmt_name, query_string);
+  if (statement != nullptr) {
+    LOG_TRACE("Plan cache hit: %s", normalized_query.c_str());
+    if (tcop_txn_state_.empty()) {
+      single_statement_txn_ = true;
+      auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+      auto txn = txn_manager.BeginTransaction(thread_id);
+      // this shouldn't happen
+      if (txn == nullptr) {
+        LOG_ERROR("Begin txn failed");
+      }
+      // initialize the current result as success
+      tcop_txn_state_.emplace(txn, ResultType::SUCCESS);
+    } else {
+      single_statement_txn_ = false;
+    }
+  } else {
+    // Plan the normalized query. If it doesn't parse into something we can
+    // cache, fall back to planning the query as is.
+    auto cache_version = plan_cache.GetVersion();
+    std::unique_ptr<parser::SQLStatementList> sql_stmt_list;
+    try {
+      auto &peloton_parser = parser::PostgresParser::GetInstance();
+      sql_stmt_list = peloton_parser.BuildParseTree(normalized_query);
+    } catch (Exception &e) {
+      return false;
+    }
+    if (sql_stmt_list.get() == nullptr || !sql_stmt_list->is_valid ||
+        sql_stmt_list->GetNumStatements() != 1) {
+      return false;
+    }
+    auto *sql_stmt = sql_stmt_list->GetStatement(0);
+    auto query_type = StatementTypeToQueryType(sql_stmt->GetType(), sql_stmt);
+    if (query_type != QueryType::QUERY_SELECT &&
+        query_type != QueryType::QUERY_UPDATE &&
+        query_type != QueryType::QUERY_DELETE) {
+      return false;
+    }
+
+    statement = PrepareStatement(stmt_name, query_string,
+                                 std::move(sql_stmt_list), error_message,
+                                 thread_id);
+    if (statement.get() == nullptr) {
+      SetStatement(nullptr);
+      return true;
+    }
+    // Cache the plan before binding the parameters to it
+    plan_cache.Add(default_database_name_, normalized_query, param_values,
+                   *statement, cache_version);
+  }
+
+  if (param_values.size() > 0 && statement->GetPlanTree() != nullptr) {
+    statement->GetPlanTree()->SetParameterValues(&param_values);
+  }
+  SetStatement(statement);
+  SetParamVal(std::move(param_values));
+  return true;
+}
+
 void TrafficCop::GetTableColumns(parser::TableRef *from_table,
                                  std::vector<catalog::Column> &target_columns) {
   if (from_table == nullptr) return;
@@ -550,6 +780,22 @@ ResultType TrafficCop::ExecuteStatement(
             static_cast<int>(statement->GetQueryType()));
 
   try {
+    switch (statement->GetQueryType()) {
+      case QueryType::QUERY_CREATE_TABLE:
+      case QueryType::QUERY_CREATE_INDEX:
+      case QueryType::QUERY_DROP:
+      case QueryType::QUERY_ALTER:
+      case QueryType::QUERY_RENAME:
+        // The cached plans may no longer be valid (or best) after DDL. Clear
+        // them again once the transaction has finished, since other
+        // connections may plan with the old catalog until then.
+        PlanCache::Instance().Clear();
+        clear_plan_cache_ = true;
+        break;
+      default:
+        break;
+    }
+
     switch (statement->GetQueryType()) {
       case QueryType::QUERY_BEGIN: {
         return BeginQueryHelper(thread_id);
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_scan_test.cpp
+//
+// Identification: test/codegen/frozen_scan_test.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/frozen_block.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_freezer.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Scans over frozen tile groups, reading visibility from the bitmaps, the
+// integer columns from their packed copies and filtering the VARCHAR column
+// by its dictionary codes
+//===--------------------------------------------------------------------===//
+
+class FrozenScanTest : public PelotonCodeGenTest {
+ public:
+  FrozenScanTest() : PelotonCodeGenTest(5), num_rows_to_insert(20) {
+    LoadTestTable(TestTableId(), num_rows_to_insert);
+
+    // Every tuple is older than a horizon taken after the load
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction();
+    cid_t horizon_cid = txn->GetReadId();
+    txn_manager.CommitTransaction(txn);
+    num_frozen = storage::TileGroupFreezer::GetInstance().FreezeTable(
+        &GetTestTable(TestTableId()), horizon_cid);
+  }
+
+  oid_t TestTableId() { return test_table_oids[0]; }
+
+  ExpressionPtr ConstVarcharExpr(const std::string &str) {
+    return ExpressionPtr{new expression::ConstantValueExpression(
+        type::ValueFactory::GetVarcharValue(str))};
+  }
+
+  uint32_t num_rows_to_insert;
+  size_t num_frozen;
+};
+
+TEST_F(FrozenScanTest, PackedColumnPredicate) {
+  EXPECT_EQ(4, num_frozen);
+  auto &table = GetTestTable(TestTableId());
+  auto *frozen_block = table.GetTileGroup(0)->GetFrozenBlock();
+  ASSERT_NE(nullptr, frozen_block);
+  EXPECT_NE(nullptr, frozen_block->GetPackedColumn(0));
+  EXPECT_NE(nullptr, frozen_block->GetDictionaryColumn(3));
+
+  //
+  // SELECT a, b FROM table where a >= 50;
+  //
+  ExpressionPtr a_gte_50 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(50));
+  planner::SeqScanPlan scan{&table, a_gte_50.release(), {0, 1}};
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(scan, buffer);
+
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(15, results.size());
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(0).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(50)));
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(1).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(51)));
+  EXPECT_EQ(CmpBool::TRUE, results[14].GetValue(0).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(190)));
+}
+
+TEST_F(FrozenScanTest, DictionaryPredicate) {
+  auto &table = GetTestTable(TestTableId());
+
+  //
+  // SELECT a, d FROM table where d = '123';
+  //
+  ExpressionPtr d_eq_123 =
+      CmpEqExpr(ColRefExpr(type::TypeId::VARCHAR, 3), ConstVarcharExpr("123"));
+  planner::SeqScanPlan scan{&table, d_eq_123.release(), {0, 3}};
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(scan, buffer);
+
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(0).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(120)));
+  EXPECT_EQ(CmpBool::TRUE, results[0].GetValue(1).CompareEquals(
+                               type::ValueFactory::GetVarcharValue("123")));
+}
+
+TEST_F(FrozenScanTest, DictionaryPredicateWithoutMatch) {
+  auto &table = GetTestTable(TestTableId());
+
+  //
+  // SELECT a FROM table where d = 'none' AND a >= 0;
+  //
+  ExpressionPtr d_eq_none = CmpEqExpr(ColRefExpr(type::TypeId::VARCHAR, 3),
+                                      ConstVarcharExpr("none"));
+  ExpressionPtr a_gte_0 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(0));
+  ExpressionPtr predicate{new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND, d_eq_none.release(),
+      a_gte_0.release())};
+  planner::SeqScanPlan scan{&table, predicate.release(), {0}};
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+  codegen::BufferingConsumer buffer{{0}, context};
+  CompileAndExecute(scan, buffer);
+
+  EXPECT_EQ(0, buffer.GetOutputTuples().size());
+}
+
+}  // namespace test
+}  // namespace peloton
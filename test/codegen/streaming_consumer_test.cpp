@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// streaming_consumer_test.cpp
+//
+// Identification: test/codegen/streaming_consumer_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "codegen/streaming_consumer.h"
+#include "common/harness.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class StreamingConsumerTest : public PelotonCodeGenTest {
+ public:
+  StreamingConsumerTest() : PelotonCodeGenTest(), num_rows_to_insert(64) {
+    LoadTestTable(TestTableId(), num_rows_to_insert);
+  }
+
+  uint32_t NumRowsInTestTable() const { return num_rows_to_insert; }
+
+  oid_t TestTableId() { return test_table_oids[0]; }
+
+ private:
+  uint32_t num_rows_to_insert = 64;
+};
+
+TEST_F(StreamingConsumerTest, BatchesRows) {
+  //
+  // SELECT a, b FROM table;
+  //
+
+  planner::SeqScanPlan scan{&GetTestTable(TestTableId()), nullptr, {0, 1}};
+
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // Collect the size of each batch, and all the rows
+  std::vector<uint32_t> batch_sizes;
+  std::vector<ResultValue> rows;
+  codegen::StreamingConsumer consumer{
+      {0, 1},
+      context,
+      [&batch_sizes, &rows](std::vector<ResultValue> &batch) {
+        batch_sizes.push_back(static_cast<uint32_t>(batch.size() / 2));
+        rows.insert(rows.end(), batch.begin(), batch.end());
+      },
+      10};
+
+  CompileAndExecute(scan, consumer);
+  consumer.Finish();
+
+  // Six full batches of ten rows, then the remaining four
+  ASSERT_EQ(7, batch_sizes.size());
+  for (uint32_t i = 0; i < 6; i++) {
+    EXPECT_EQ(10, batch_sizes[i]);
+  }
+  EXPECT_EQ(4, batch_sizes[6]);
+
+  EXPECT_EQ(NumRowsInTestTable(), consumer.GetNumRows());
+  ASSERT_EQ(NumRowsInTestTable() * 2, rows.size());
+  EXPECT_EQ("0", rows[0]);
+  EXPECT_EQ("1", rows[1]);
+  EXPECT_TRUE(consumer.ReleaseResults().empty());
+}
+
+TEST_F(StreamingConsumerTest, KeepsRowsWithoutSink) {
+  //
+  // SELECT a FROM table where a >= 600;
+  //
+
+  ExpressionPtr a_gte_600 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(600));
+  planner::SeqScanPlan scan{&GetTestTable(TestTableId()), a_gte_600.release(),
+                            {0}};
+
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  codegen::StreamingConsumer consumer{{0}, context};
+  CompileAndExecute(scan, consumer);
+  consumer.Finish();
+
+  auto results = consumer.ReleaseResults();
+  ASSERT_EQ(4, results.size());
+  EXPECT_EQ("600", results[0]);
+  EXPECT_EQ("630", results[3]);
+}
+
+TEST_F(StreamingConsumerTest, BinaryResultFormat) {
+  //
+  // SELECT a, b FROM table where a = 300;
+  //
+  // Column a is requested in binary, column b in text.
+  //
+
+  ExpressionPtr a_eq_300 =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(300));
+  planner::SeqScanPlan scan{&GetTestTable(TestTableId()), a_eq_300.release(),
+                            {0, 1}};
+
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  codegen::StreamingConsumer consumer{{0, 1}, context};
+  consumer.SetResultFormat({1, 0});
+  CompileAndExecute(scan, consumer);
+  consumer.Finish();
+
+  auto results = consumer.ReleaseResults();
+  ASSERT_EQ(2, results.size());
+
+  // 300 as a big-endian 32-bit integer
+  EXPECT_EQ(std::string("\x00\x00\x01\x2c", 4), results[0]);
+  EXPECT_EQ("301", results[1]);
+}
+
+}  // namespace test
+}  // namespace peloton
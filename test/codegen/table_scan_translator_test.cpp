@@ -12,12 +12,15 @@
 
 #include "storage/storage_manager.h"
 #include "catalog/catalog.h"
+#include "catalog/table_catalog.h"
+#include "codegen/operator/table_scan_translator.h"
 #include "codegen/query_compiler.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "expression/conjunction_expression.h"
 #include "expression/operator_expression.h"
 #include "planner/seq_scan_plan.h"
+#include "storage/table_factory.h"
 
 #include "codegen/testing_codegen_util.h"
 
@@ -94,6 +97,20 @@ class TableScanTranslatorTest : public PelotonCodeGenTest {
     return *GetDatabase().GetTableWithName(all_cols_table_name);
   }
 
+  // Create and load a copy of the test table whose tile groups use a pure
+  // column layout, i.e., every column is contiguous
+  oid_t CreateAndLoadColumnarTable() {
+    oid_t table_oid = catalog::TableCatalog::GetInstance()->GetNextOid();
+    auto *table = storage::TableFactory::GetDataTable(
+        GetDatabase().GetOid(), table_oid, CreateTestSchema().release(),
+        "columnar_table", DEFAULT_TUPLES_PER_TILEGROUP, true, false, false,
+        LayoutType::COLUMN);
+    GetDatabase().AddTable(table);
+
+    LoadTestTable(table_oid, num_rows_to_insert);
+    return table_oid;
+  }
+
  private:
   uint32_t num_rows_to_insert = 64;
 };
@@ -297,6 +314,57 @@ TEST_F(TableScanTranslatorTest, ScanWithConjunctionPredicate) {
                                      type::ValueFactory::GetIntegerValue(21)));
 }
 
+TEST_F(TableScanTranslatorTest, ScanWithSIMDPredicate) {
+  //
+  // SELECT a, b FROM columnar_table where a < 100 OR c >= 602;
+  //
+  // Run with and without the vectorized predicate, the results must match.
+  //
+
+  oid_t table_oid = CreateAndLoadColumnarTable();
+
+  auto run_query = [this, table_oid](bool use_simd) {
+    codegen::TableScanTranslator::use_simd_predicate = use_simd;
+
+    // a < 100
+    ExpressionPtr a_lt_100 =
+        CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(100));
+
+    // c >= 602
+    ExpressionPtr c_gte_602 =
+        CmpGteExpr(ColRefExpr(type::TypeId::DECIMAL, 2), ConstIntExpr(602));
+
+    // a < 100 OR c >= 602
+    auto *disj = new expression::ConjunctionExpression(
+        ExpressionType::CONJUNCTION_OR, a_lt_100.release(),
+        c_gte_602.release());
+
+    planner::SeqScanPlan scan{&GetTestTable(table_oid), disj, {0, 1}};
+
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+
+    // The predicate is vectorized, unless disabled
+    EXPECT_EQ(use_simd, codegen::TableScanTranslator::UseSIMDPredicate(scan));
+
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    CompileAndExecute(scan, buffer);
+    return buffer.GetOutputTuples();
+  };
+
+  auto simd_results = run_query(true);
+  auto scalar_results = run_query(false);
+  codegen::TableScanTranslator::use_simd_predicate = true;
+
+  // Ten rows with a < 100, four rows with c >= 602
+  ASSERT_EQ(14, simd_results.size());
+  ASSERT_EQ(scalar_results.size(), simd_results.size());
+  for (uint32_t i = 0; i < simd_results.size(); i++) {
+    EXPECT_EQ(CmpBool::TRUE, simd_results[i].GetValue(0).CompareEquals(
+                                 scalar_results[i].GetValue(0)));
+  }
+}
+
 TEST_F(TableScanTranslatorTest, ScanWithAddPredicate) {
   //
   // SELECT a, b FROM table where b = a + 1;
@@ -326,6 +394,9 @@ TEST_F(TableScanTranslatorTest, ScanWithAddPredicate) {
   planner::BindingContext context;
   scan.PerformBinding(context);
 
+  // Arithmetic isn't vectorized
+  EXPECT_FALSE(codegen::TableScanTranslator::UseSIMDPredicate(scan));
+
   // We collect the results of the query into an in-memory buffer
   codegen::BufferingConsumer buffer{{0, 1}, context};
 
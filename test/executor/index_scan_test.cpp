@@ -28,6 +28,7 @@
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/plan_executor.h"
+#include "gc/transaction_level_gc_manager.h"
 #include "planner/create_plan.h"
 #include "planner/delete_plan.h"
 #include "planner/index_scan_plan.h"
@@ -171,5 +172,64 @@ TEST_F(IndexScanTests, MultiColumnPredicateTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Index-only scan that reads the column from the primary key
+TEST_F(IndexScanTests, CoveringScanTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateAndPopulateTable());
+
+  //===--------------------------------------------------------------------===//
+  // ATTR 0 <= 110
+  //===--------------------------------------------------------------------===//
+
+  auto index = data_table->GetIndex(0);
+  std::vector<oid_t> key_column_ids({0});
+  std::vector<ExpressionType> expr_types(
+      {ExpressionType::COMPARE_LESSTHANOREQUALTO});
+  std::vector<type::Value> values(
+      {type::ValueFactory::GetIntegerValue(110).Copy()});
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      index, key_column_ids, expr_types, values, runtime_keys);
+
+  planner::IndexScanPlan node(data_table.get(), nullptr, {0},
+                              index_scan_desc);
+  node.SetCovering(true);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto scan = [&](IsolationLevelType isolation_level) {
+    auto txn = txn_manager.BeginTransaction(isolation_level);
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    executor::IndexScanExecutor executor(&node, context.get());
+    EXPECT_TRUE(executor.Init());
+
+    // The keys are returned in a single tile, in order
+    EXPECT_TRUE(executor.Execute());
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    ASSERT_THAT(result_tile, NotNull());
+    EXPECT_FALSE(executor.Execute());
+    ASSERT_EQ(12, result_tile->GetTupleCount());
+    for (oid_t tuple_id = 0; tuple_id < 12; tuple_id++) {
+      type::Value value = result_tile->GetValue(tuple_id, 0);
+      EXPECT_EQ(CmpBool::TRUE,
+                value.CompareEquals(
+                    type::ValueFactory::GetIntegerValue(10 * tuple_id)));
+    }
+    txn_manager.CommitTransaction(txn);
+  };
+
+  // The version chains are walked until the tile groups are marked
+  scan(IsolationLevelType::SERIALIZABLE);
+
+  auto txn = txn_manager.BeginTransaction();
+  cid_t horizon_cid = txn->GetReadId();
+  txn_manager.CommitTransaction(txn);
+  EXPECT_LT(0, gc::TransactionLevelGCManager::GetInstance().MarkAllVisible(
+                   data_table.get(), horizon_cid));
+
+  scan(IsolationLevelType::SERIALIZABLE);
+  scan(IsolationLevelType::READ_ONLY);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -486,5 +486,58 @@ TEST_F(TransactionLevelGCManagerTests, ImmutabilityTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(TransactionLevelGCManagerTests, AllVisibleTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+
+  auto database = TestingExecutorUtil::InitializeDatabase("AllVisibleDB");
+  oid_t db_id = database->GetOid();
+
+  const int num_key = 25;
+  const size_t tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(TestingTransactionUtil::CreateTable(
+      num_key, "TABLE2", db_id, INVALID_OID, 1234, true, tuples_per_tilegroup));
+  oid_t num_tile_groups = table->GetTileGroupCount();
+
+  // Every tuple is older than a horizon taken after the load
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  cid_t horizon_cid = txn->GetReadId();
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ(num_tile_groups, gc_manager.MarkAllVisible(table.get(), horizon_cid));
+  auto tile_group_header = table->GetTileGroup(0)->GetHeader();
+  EXPECT_TRUE(tile_group_header->IsAllVisibleTo(horizon_cid));
+  EXPECT_FALSE(tile_group_header->IsAllVisibleTo(horizon_cid - 1));
+
+  // Marked tile groups aren't marked again
+  EXPECT_EQ(0, gc_manager.MarkAllVisible(table.get(), horizon_cid));
+
+  // Writers clear the bit, and the old version keeps the tile group from being
+  // marked until it is reclaimed
+  auto ret = UpdateTuple(table.get(), 2);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_FALSE(tile_group_header->IsAllVisibleTo(MAX_CID));
+  txn = txn_manager.BeginTransaction();
+  horizon_cid = txn->GetReadId();
+  txn_manager.CommitTransaction(txn);
+  gc_manager.MarkAllVisible(table.get(), horizon_cid);
+  EXPECT_FALSE(tile_group_header->IsAllVisibleTo(MAX_CID));
+
+  ret = DeleteTuple(table.get(), 7);
+  EXPECT_TRUE(ret == ResultType::SUCCESS);
+  EXPECT_FALSE(table->GetTileGroup(1)->GetHeader()->IsAllVisibleTo(MAX_CID));
+
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  table.release();
+  TestingExecutorUtil::DeleteDatabase("AllVisibleDB");
+}
+
 }  // namespace test
 }  // namespace peloton
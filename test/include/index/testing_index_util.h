@@ -50,6 +50,12 @@ class TestingIndexUtil {
 
   static void NonUniqueKeyMultiThreadedStressTest2(const IndexType index_type);
 
+  static void BulkLoadTest(const IndexType index_type);
+
+  static void ScanKeyBatchTest(const IndexType index_type);
+
+  static void MaintenanceStatsTest(const IndexType index_type);
+
   //===--------------------------------------------------------------------===//
   // Utility Methods
   //===--------------------------------------------------------------------===//
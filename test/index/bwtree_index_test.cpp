@@ -65,5 +65,17 @@ TEST_F(BwTreeIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
   TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::BWTREE);
 }
 
+TEST_F(BwTreeIndexTests, BulkLoadTest) {
+  TestingIndexUtil::BulkLoadTest(IndexType::BWTREE);
+}
+
+TEST_F(BwTreeIndexTests, ScanKeyBatchTest) {
+  TestingIndexUtil::ScanKeyBatchTest(IndexType::BWTREE);
+}
+
+TEST_F(BwTreeIndexTests, MaintenanceStatsTest) {
+  TestingIndexUtil::MaintenanceStatsTest(IndexType::BWTREE);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -12,6 +12,8 @@
 
 #include "index/testing_index_util.h"
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 
 #include "common/harness.h"
@@ -22,6 +24,7 @@
 #include "index/index_util.h"
 #include "storage/tuple.h"
 #include "common/internal_types.h"
+#include "concurrency/epoch_manager_factory.h"
 #include "type/value_factory.h"
 
 namespace peloton {
@@ -634,6 +637,191 @@ void TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(const IndexType inde
 }
 
 
+void TestingIndexUtil::BulkLoadTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer *> location_ptrs;
+
+  // INDEX
+  std::unique_ptr<index::Index, void(*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(index_type, false), DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // Enough keys for two levels of inner nodes, every tenth one with two
+  // values, in descending order
+  const int key_count = 10000;
+  std::vector<ItemPointer> items;
+  items.reserve(key_count + key_count / 10);
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<index::IndexEntryRef> entries;
+  for (int i = key_count - 1; i >= 0; i--) {
+    int value_count = (i % 10 == 0) ? 2 : 1;
+    for (int j = 0; j < value_count; j++) {
+      keys.emplace_back(new storage::Tuple(key_schema, true));
+      keys.back()->SetValue(0, type::ValueFactory::GetIntegerValue(i), pool);
+      keys.back()->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+      items.emplace_back(i, j);
+      entries.emplace_back(keys.back().get(), &items.back());
+    }
+  }
+  EXPECT_TRUE(index->BulkLoad(entries));
+
+  // Checks
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(items.size(), location_ptrs.size());
+  for (size_t i = 1; i < location_ptrs.size(); i++) {
+    EXPECT_LE(location_ptrs[i - 1]->block, location_ptrs[i]->block);
+  }
+  location_ptrs.clear();
+
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  key0->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+  for (int i : {0, 95, 96, 5000, 9999}) {
+    key0->SetValue(0, type::ValueFactory::GetIntegerValue(i), pool);
+    index->ScanKey(key0.get(), location_ptrs);
+    EXPECT_EQ((i % 10 == 0) ? 2 : 1, location_ptrs.size());
+    location_ptrs.clear();
+  }
+
+  // The loaded tree takes inserts and deletes like any other
+  key0->SetValue(0, type::ValueFactory::GetIntegerValue(key_count), pool);
+  EXPECT_TRUE(index->InsertEntry(key0.get(), TestingIndexUtil::item0.get()));
+  key0->SetValue(0, type::ValueFactory::GetIntegerValue(5001), pool);
+  auto item = std::find_if(items.begin(), items.end(),
+                           [](const ItemPointer &item) {
+                             return item.block == 5001;
+                           });
+  EXPECT_TRUE(index->DeleteEntry(key0.get(), &*item));
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(items.size(), location_ptrs.size());
+  location_ptrs.clear();
+
+  // A tree that isn't empty anymore gets the entries inserted one by one,
+  // which only adds the deleted one back
+  EXPECT_FALSE(index->BulkLoad(entries));
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(items.size() + 1, location_ptrs.size());
+  location_ptrs.clear();
+}
+
+void TestingIndexUtil::ScanKeyBatchTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer *> location_ptrs;
+
+  // INDEX
+  std::unique_ptr<index::Index, void(*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(index_type, false), DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  size_t scale_factor = 100;
+  LaunchParallelTest(1, TestingIndexUtil::InsertHelper, index.get(), pool,
+                     scale_factor);
+
+  // Keys with several values, with none, and beyond the inserted ones, in
+  // descending order
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  for (int scale_itr = 120; scale_itr >= 1; scale_itr--) {
+    for (const char *suffix : {"b", "f"}) {
+      keys.emplace_back(new storage::Tuple(key_schema, true));
+      keys.back()->SetValue(0, type::ValueFactory::GetIntegerValue(
+                                   ((suffix[0] == 'b') ? 100 : 1000) * scale_itr),
+                            pool);
+      keys.back()->SetValue(1, type::ValueFactory::GetVarcharValue(suffix),
+                            pool);
+    }
+  }
+  std::vector<const storage::Tuple *> key_ptrs;
+  for (auto &key : keys) {
+    key_ptrs.push_back(key.get());
+  }
+
+  std::vector<std::vector<ItemPointer *>> results;
+  index->ScanKeyBatch(key_ptrs, results);
+  ASSERT_EQ(keys.size(), results.size());
+
+  // Checks
+  for (size_t i = 0; i < keys.size(); i++) {
+    index->ScanKey(keys[i].get(), location_ptrs);
+    EXPECT_EQ(location_ptrs.size(), results[i].size());
+    location_ptrs.clear();
+  }
+  EXPECT_EQ(3, results[2 * (120 - 1)].size());
+  EXPECT_EQ(0, results[2 * (120 - 1) + 1].size());
+  EXPECT_EQ(0, results[0].size());
+}
+
+void TestingIndexUtil::MaintenanceStatsTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer *> location_ptrs;
+
+  // Nodes are unlinked in epoch 1, which has not expired yet
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  // INDEX
+  std::unique_ptr<index::Index, void(*)(index::Index *)> index(
+      TestingIndexUtil::BuildIndex(index_type, false), DestroyIndex);
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // Enough keys to split and consolidate the nodes
+  int key_count = 10000;
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (int i = 0; i < key_count; i++) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(i), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    EXPECT_TRUE(index->InsertEntry(key.get(), TestingIndexUtil::item0.get()));
+  }
+
+  auto stats = index->GetMaintenanceStats();
+  EXPECT_GT(stats.split_count, 0);
+  EXPECT_GT(stats.consolidation_count, 0);
+  EXPECT_EQ(0, stats.delta_chain_sample_count);
+  EXPECT_EQ(0U, stats.reclaimed_node_count);
+
+  // The unlinked nodes are freed once their epoch has expired
+  epoch_manager.SetCurrentEpochId(3);
+  index->PerformGC();
+  stats = index->GetMaintenanceStats();
+  EXPECT_GT(stats.reclaimed_node_count, 0U);
+  EXPECT_GT(stats.reclaimed_byte_count, 0U);
+
+  // Lookups sample the delta chains they go through
+  for (int i = 0; i < key_count; i++) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(i), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    index->ScanKey(key.get(), location_ptrs);
+    EXPECT_EQ(1, location_ptrs.size());
+    location_ptrs.clear();
+  }
+
+  stats = index->GetMaintenanceStats();
+  EXPECT_GE(stats.delta_chain_sample_count, key_count / 256);
+  EXPECT_LE(stats.delta_chain_length_sum,
+            stats.delta_chain_sample_count * stats.max_delta_chain_length);
+
+  // A leaf that is only written keeps its deltas, but once it is read often
+  // its threshold drops and the next write consolidates it
+  std::unique_ptr<index::Index, void(*)(index::Index *)> hot_index(
+      TestingIndexUtil::BuildIndex(index_type, false), DestroyIndex);
+  for (int i = 0; i < 8; i++) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(i), pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    EXPECT_TRUE(
+        hot_index->InsertEntry(key.get(), TestingIndexUtil::item0.get()));
+  }
+  EXPECT_EQ(0U, hot_index->GetMaintenanceStats().consolidation_count);
+
+  key->SetValue(0, type::ValueFactory::GetIntegerValue(0), pool);
+  for (int i = 0; i < 1000; i++) {
+    hot_index->ScanKey(key.get(), location_ptrs);
+    EXPECT_EQ(1, location_ptrs.size());
+    location_ptrs.clear();
+  }
+
+  key->SetValue(0, type::ValueFactory::GetIntegerValue(8), pool);
+  EXPECT_TRUE(hot_index->InsertEntry(key.get(), TestingIndexUtil::item0.get()));
+  EXPECT_GT(hot_index->GetMaintenanceStats().consolidation_count, 0U);
+}
+
 index::Index *TestingIndexUtil::BuildIndex(const IndexType index_type,
                                            const bool unique_keys) {
   LOG_DEBUG("Build index type: %s", IndexTypeToString(index_type).c_str());
@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// pipeline_test.cpp
+//
+// Identification: test/network/pipeline_test.cpp
+//
+// Copyright (c) 2016-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "common/harness.h"
+#include "common/logger.h"
+#include "gtest/gtest.h"
+#include "network/network_manager.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Pipelined Extended Protocol Tests
+//===--------------------------------------------------------------------===//
+
+class PipelineTests : public PelotonTest {};
+
+static void *LaunchServer(peloton::network::NetworkManager network_manager,
+                          int port) {
+  try {
+    network_manager.SetPort(port);
+    network_manager.StartServer();
+  } catch (peloton::ConnectionException exception) {
+    LOG_INFO("[LaunchServer] exception in thread");
+  }
+  return NULL;
+}
+
+// Appends a 32-bit integer in network byte order
+static void PutInt32(std::string &buf, int32_t value) {
+  uint32_t nb = htonl(static_cast<uint32_t>(value));
+  buf.append(reinterpret_cast<char *>(&nb), sizeof(nb));
+}
+
+// Appends a 16-bit integer in network byte order
+static void PutInt16(std::string &buf, int16_t value) {
+  uint16_t nb = htons(static_cast<uint16_t>(value));
+  buf.append(reinterpret_cast<char *>(&nb), sizeof(nb));
+}
+
+// Appends a null-terminated string
+static void PutString(std::string &buf, const std::string &str) {
+  buf.append(str);
+  buf.push_back('\0');
+}
+
+// Appends a message of the given type to the buffer
+static void PutMessage(std::string &buf, char type, const std::string &body) {
+  buf.push_back(type);
+  PutInt32(buf, static_cast<int32_t>(body.size() + sizeof(int32_t)));
+  buf.append(body);
+}
+
+static bool SendAll(int fd, const std::string &buf) {
+  size_t sent = 0;
+  while (sent < buf.size()) {
+    auto n = write(fd, buf.data() + sent, buf.size() - sent);
+    if (n <= 0) return false;
+    sent += n;
+  }
+  return true;
+}
+
+static bool ReceiveAll(int fd, char *buf, size_t len) {
+  size_t received = 0;
+  while (received < len) {
+    auto n = read(fd, buf + received, len - received);
+    if (n <= 0) return false;
+    received += n;
+  }
+  return true;
+}
+
+// Reads the next message from the server
+static bool ReceiveMessage(int fd, char &type, std::string &body) {
+  char header[1 + sizeof(int32_t)];
+  if (!ReceiveAll(fd, header, sizeof(header))) return false;
+  type = header[0];
+  uint32_t nb;
+  memcpy(&nb, header + 1, sizeof(nb));
+  body.resize(ntohl(nb) - sizeof(int32_t));
+  return ReceiveAll(fd, &body[0], body.size());
+}
+
+// Reads messages until the server is ready for the next query, returning
+// their types in order
+static std::string ReceiveUntilReady(int fd,
+                                     std::vector<std::string> *data_rows) {
+  std::string types;
+  char type;
+  std::string body;
+  while (ReceiveMessage(fd, type, body)) {
+    types.push_back(type);
+    if (type == 'D' && data_rows != nullptr) {
+      // one column: count, then length and value
+      uint32_t nb;
+      memcpy(&nb, body.data() + sizeof(int16_t), sizeof(nb));
+      data_rows->push_back(
+          body.substr(sizeof(int16_t) + sizeof(int32_t), ntohl(nb)));
+    }
+    if (type == 'Z') break;
+  }
+  return types;
+}
+
+static void SimpleQuery(int fd, const std::string &query) {
+  std::string buf, body;
+  PutString(body, query);
+  PutMessage(buf, 'Q', body);
+  EXPECT_TRUE(SendAll(fd, buf));
+  auto types = ReceiveUntilReady(fd, nullptr);
+  EXPECT_EQ(std::string::npos, types.find('E')) << query;
+}
+
+/**
+ * Several Parse/Bind/Execute sequences sent before a single Sync are all
+ * answered in order, and the responses reach the client in one flush
+ */
+void PipelinedExecuteTest(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(fd, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+  ASSERT_EQ(0, connect(fd, reinterpret_cast<struct sockaddr *>(&addr),
+                       sizeof(addr)));
+
+  // Startup message of protocol version 3.0
+  std::string startup, params;
+  PutInt32(params, 196608);
+  PutString(params, "user");
+  PutString(params, "postgres");
+  PutString(params, "database");
+  PutString(params, "postgres");
+  params.push_back('\0');
+  PutInt32(startup, static_cast<int32_t>(params.size() + sizeof(int32_t)));
+  startup.append(params);
+  ASSERT_TRUE(SendAll(fd, startup));
+  ReceiveUntilReady(fd, nullptr);
+
+  SimpleQuery(fd, "DROP TABLE IF EXISTS employee;");
+  SimpleQuery(fd, "CREATE TABLE employee(id INT, name VARCHAR(100));");
+  SimpleQuery(fd, "INSERT INTO employee VALUES (1, 'Han LI');");
+  SimpleQuery(fd, "INSERT INTO employee VALUES (2, 'Shaokun ZOU');");
+  SimpleQuery(fd, "INSERT INTO employee VALUES (3, 'Yilei CHU');");
+
+  auto conn = peloton::network::NetworkManager::GetConnection(
+      peloton::network::NetworkManager::recent_connfd);
+  auto flush_count = conn->GetFlushCount();
+
+  // Parse, Bind and Execute one unnamed statement per id, then Sync once
+  const int num_queries = 3;
+  std::string batch;
+  for (int id = 1; id <= num_queries; id++) {
+    std::string parse, bind, execute;
+    PutString(parse, "");
+    PutString(parse, "SELECT name FROM employee WHERE id=" +
+                         std::to_string(id) + ";");
+    PutInt16(parse, 0);
+    PutMessage(batch, 'P', parse);
+
+    PutString(bind, "");
+    PutString(bind, "");
+    PutInt16(bind, 0);
+    PutInt16(bind, 0);
+    PutInt16(bind, 0);
+    PutMessage(batch, 'B', bind);
+
+    PutString(execute, "");
+    PutInt32(execute, 0);
+    PutMessage(batch, 'E', execute);
+  }
+  PutMessage(batch, 'S', "");
+  ASSERT_TRUE(SendAll(fd, batch));
+
+  std::vector<std::string> names;
+  auto types = ReceiveUntilReady(fd, &names);
+  EXPECT_EQ("12DC12DC12DCZ", types);
+  EXPECT_EQ(std::vector<std::string>({"Han LI", "Shaokun ZOU", "Yilei CHU"}),
+            names);
+  EXPECT_EQ(flush_count + 1, conn->GetFlushCount());
+
+  std::string terminate;
+  PutMessage(terminate, 'X', "");
+  SendAll(fd, terminate);
+  close(fd);
+}
+
+TEST_F(PipelineTests, PipelinedExecuteTest) {
+  peloton::PelotonInit::Initialize();
+  LOG_INFO("Server initialized");
+  peloton::network::NetworkManager network_manager;
+  int port = 15721;
+  std::thread serverThread(LaunchServer, network_manager, port);
+  while (!network_manager.GetIsStarted()) {
+    sleep(1);
+  }
+
+  PipelinedExecuteTest(port);
+
+  network_manager.CloseServer();
+  serverThread.join();
+  peloton::PelotonInit::Shutdown();
+  LOG_INFO("Peloton has shut down");
+}
+
+}  // namespace test
+}  // namespace peloton
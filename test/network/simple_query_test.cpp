@@ -18,6 +18,7 @@
 #include "util/string_util.h"
 #include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
 #include "network/postgres_protocol_handler.h"
+#include "settings/settings_manager.h"
 
 #define NUM_THREADS 1
 
@@ -230,6 +231,35 @@ TEST_F(SimpleQueryTests, SimpleQueryTest) {
 //  peloton::PelotonInit::Shutdown();
 //  LOG_INFO("[ScalabilityTest] Peloton has shut down");
 //}
+/**
+ * The same queries, with every network thread listening on its own socket and
+ * running the cheap statements itself
+ */
+TEST_F(SimpleQueryTests, ReusePortInlineExecutionTest) {
+  peloton::PelotonInit::Initialize();
+  settings::SettingsManager::SetBool(
+      settings::SettingId::reuse_port_listeners, true);
+  settings::SettingsManager::SetBool(settings::SettingId::inline_execution,
+                                     true);
+  peloton::network::NetworkManager network_manager;
+
+  int port = 15721;
+  std::thread serverThread(LaunchServer, network_manager, port);
+  while (!network_manager.GetIsStarted()) {
+    sleep(1);
+  }
+
+  SimpleQueryTest(port);
+
+  network_manager.CloseServer();
+  serverThread.join();
+  settings::SettingsManager::SetBool(settings::SettingId::inline_execution,
+                                     false);
+  settings::SettingsManager::SetBool(
+      settings::SettingId::reuse_port_listeners, false);
+  peloton::PelotonInit::Shutdown();
+}
+
 
 }  // namespace test
 }  // namespace peloton
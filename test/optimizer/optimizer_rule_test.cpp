@@ -16,6 +16,8 @@
 
 #include "optimizer/operator_expression.h"
 #include "optimizer/operators.h"
+#include "optimizer/optimize_context.h"
+#include "optimizer/optimizer_metadata.h"
 #include "optimizer/optimizer.h"
 #include "optimizer/rule.h"
 #include "optimizer/rule_impls.h"
@@ -28,6 +30,8 @@
 #include "executor/insert_executor.h"
 #include "executor/plan_executor.h"
 #include "executor/update_executor.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "planner/create_plan.h"
 #include "planner/delete_plan.h"
 #include "planner/insert_plan.h"
@@ -64,5 +68,86 @@ TEST_F(OptimizerRuleTests, SimpleRuleApplyTest) {
   EXPECT_EQ(outputs.size(), 1);
 }
 
+namespace {
+
+// Build the annotated predicate l_table.id = r_table.id
+AnnotatedExpression MakeJoinPredicate(std::string l_table, std::string r_table) {
+  std::shared_ptr<expression::AbstractExpression> expr(
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_EQUAL,
+          new expression::TupleValueExpression("id", std::string(l_table)),
+          new expression::TupleValueExpression("id", std::string(r_table))));
+  std::unordered_set<std::string> aliases{l_table, r_table};
+  return AnnotatedExpression(expr, aliases);
+}
+
+}  // namespace
+
+TEST_F(OptimizerRuleTests, JoinAssociativityTest) {
+  OptimizerMetadata metadata;
+  OptimizeContext context(&metadata, nullptr);
+
+  // Groups for the three base tables
+  std::vector<GroupID> table_groups;
+  for (std::string table : {"a", "b", "c"}) {
+    auto get = std::make_shared<OperatorExpression>(
+        LogicalGet::make(table_groups.size() + 1, {}, nullptr, table));
+    std::shared_ptr<GroupExpression> gexpr;
+    metadata.RecordTransformedExpression(get, gexpr);
+    table_groups.push_back(gexpr->GetGroupID());
+  }
+
+  auto make_input = [&table_groups](std::vector<AnnotatedExpression> top_preds,
+                                    std::vector<AnnotatedExpression> left_preds) {
+    // (a join b) join c
+    auto left_join = std::make_shared<OperatorExpression>(
+        LogicalInnerJoin::make(left_preds));
+    left_join->PushChild(std::make_shared<OperatorExpression>(
+        LeafOperator::make(table_groups[0])));
+    left_join->PushChild(std::make_shared<OperatorExpression>(
+        LeafOperator::make(table_groups[1])));
+    auto join = std::make_shared<OperatorExpression>(
+        LogicalInnerJoin::make(top_preds));
+    join->PushChild(left_join);
+    join->PushChild(std::make_shared<OperatorExpression>(
+        LeafOperator::make(table_groups[2])));
+    return join;
+  };
+
+  InnerJoinAssociativity rule;
+
+  // a.id = b.id and b.id = c.id, b and c can be joined first
+  auto input = make_input({MakeJoinPredicate("b", "c")},
+                          {MakeJoinPredicate("a", "b")});
+  EXPECT_TRUE(rule.Check(input, &context));
+
+  std::vector<std::shared_ptr<OperatorExpression>> outputs;
+  rule.Transform(input, outputs, &context);
+  ASSERT_EQ(1, outputs.size());
+
+  auto output = outputs[0];
+  ASSERT_EQ(2, output->Children().size());
+  EXPECT_EQ(table_groups[0],
+            output->Children()[0]->Op().As<LeafOperator>()->origin_group);
+  auto top_join = output->Op().As<LogicalInnerJoin>();
+  ASSERT_EQ(1, top_join->join_predicates.size());
+  EXPECT_EQ(1, top_join->join_predicates[0].table_alias_set.count("a"));
+
+  auto child = output->Children()[1];
+  ASSERT_EQ(OpType::InnerJoin, child->Op().type());
+  EXPECT_EQ(table_groups[1],
+            child->Children()[0]->Op().As<LeafOperator>()->origin_group);
+  EXPECT_EQ(table_groups[2],
+            child->Children()[1]->Op().As<LeafOperator>()->origin_group);
+  auto child_join = child->Op().As<LogicalInnerJoin>();
+  ASSERT_EQ(1, child_join->join_predicates.size());
+  EXPECT_EQ(0, child_join->join_predicates[0].table_alias_set.count("a"));
+
+  // a.id = b.id and a.id = c.id, joining b and c first is a cross product
+  input = make_input({MakeJoinPredicate("a", "c")},
+                     {MakeJoinPredicate("a", "b")});
+  EXPECT_FALSE(rule.Check(input, &context));
+}
+
 }  // namespace test
 }  // namespace peloton
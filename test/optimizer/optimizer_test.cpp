@@ -15,6 +15,7 @@
 #include "planner/delete_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/update_plan.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
 #include "planner/seq_scan_plan.h"
 #include "planner/abstract_join_plan.h"
@@ -446,5 +447,101 @@ TEST_F(OptimizerTests, PredicatePushDownRewriteTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(OptimizerTests, OptimizationBudgetTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test2(a INT PRIMARY KEY, b INT, c INT);");
+
+  // Optimize the query and return the number of memo groups created, and
+  // whether the budget was used up
+  auto optimize = [&txn_manager](bool &budget_exhausted) {
+    auto &peloton_parser = parser::PostgresParser::GetInstance();
+    auto stmt = peloton_parser.BuildParseTree(
+        "SELECT * FROM test, test1, test2 WHERE test.a = test1.a AND "
+        "test1.b = test2.b");
+    auto parse_tree = stmt->GetStatements().at(0).get();
+
+    auto txn = txn_manager.BeginTransaction();
+    auto bind_node_visitor =
+        std::make_shared<binder::BindNodeVisitor>(txn, DEFAULT_DB_NAME);
+    bind_node_visitor->BindNameToNode(parse_tree);
+
+    optimizer::Optimizer optimizer;
+    optimizer.metadata_.catalog_cache = &txn->catalog_cache;
+    auto gexpr = optimizer.InsertQueryTree(parse_tree, txn);
+    auto query_info = optimizer.GetQueryInfo(parse_tree);
+    optimizer.OptimizeLoop(gexpr->GetGroupID(), query_info.physical_props);
+
+    // Even when stopped early there is a complete plan
+    auto plan = optimizer.ChooseBestPlan(gexpr->GetGroupID(),
+                                         query_info.physical_props,
+                                         query_info.output_exprs);
+    EXPECT_NE(nullptr, plan);
+    txn_manager.CommitTransaction(txn);
+
+    budget_exhausted = optimizer.metadata_.budget_exhausted;
+    return optimizer.metadata_.memo.GetNumGroups();
+  };
+
+  bool budget_exhausted;
+  auto num_groups = optimize(budget_exhausted);
+  EXPECT_FALSE(budget_exhausted);
+
+  settings::SettingsManager::SetInt(settings::SettingId::optimizer_task_limit,
+                                    5);
+  auto num_budget_groups = optimize(budget_exhausted);
+  EXPECT_TRUE(budget_exhausted);
+  EXPECT_LT(num_budget_groups, num_groups);
+  settings::SettingsManager::SetInt(settings::SettingId::optimizer_task_limit,
+                                    0);
+}
+
+TEST_F(OptimizerTests, ParallelOptimizationTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  for (std::string table : {"t1", "t2", "t3", "t4"}) {
+    TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE " + table +
+                                    "(a INT PRIMARY KEY, b INT);");
+  }
+
+  auto optimize = [&txn_manager]() {
+    auto &peloton_parser = parser::PostgresParser::GetInstance();
+    auto stmt = peloton_parser.BuildParseTree(
+        "SELECT * FROM t1, t2, t3, t4 WHERE t1.a = t2.a AND t2.b = t3.b AND "
+        "t3.a = t4.a");
+    auto txn = txn_manager.BeginTransaction();
+    optimizer::Optimizer optimizer;
+    auto plan = optimizer.BuildPelotonPlanTree(stmt, DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    return plan;
+  };
+
+  auto serial_plan = optimize();
+  ASSERT_NE(nullptr, serial_plan);
+
+  // Independent join inputs are optimized on separate threads
+  settings::SettingsManager::SetInt(settings::SettingId::optimizer_parallelism,
+                                    4);
+  auto parallel_plan = optimize();
+  settings::SettingsManager::SetInt(settings::SettingId::optimizer_parallelism,
+                                    1);
+  ASSERT_NE(nullptr, parallel_plan);
+
+  // The threads pick the same plan, down to the join order and access paths
+  EXPECT_EQ(serial_plan->Hash(), parallel_plan->Hash());
+  EXPECT_TRUE(*serial_plan == *parallel_plan);
+}
+
 }  // namespace test
 }  // namespace peloton
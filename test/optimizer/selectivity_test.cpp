@@ -18,6 +18,7 @@
 #include "common/logger.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/testing_executor_util.h"
+#include "optimizer/stats/cost.h"
 #include "optimizer/stats/selectivity.h"
 #include "optimizer/stats/tuple_samples_storage.h"
 #include "optimizer/stats/stats_storage.h"
@@ -249,5 +250,80 @@ TEST_F(SelectivityTests, EqualSelectivityTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Test equality selectivity and GROUP BY cardinality of correlated columns
+// with and without their joint stats
+TEST_F(SelectivityTests, CorrelatedColumnsTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // b and c always have the same value
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(id INT PRIMARY KEY, b INT, c INT);");
+  int nrow = 100;
+  for (int i = 0; i < nrow; i++) {
+    std::stringstream ss;
+    ss << "INSERT INTO test VALUES (" << i << ", " << i % 10 << ", " << i % 10
+       << ");";
+    TestingSQLUtil::ExecuteSQLQuery(ss.str());
+  }
+
+  txn = txn_manager.BeginTransaction();
+  auto catalog = catalog::Catalog::GetInstance();
+  auto database = catalog->GetDatabaseWithName(DEFAULT_DB_NAME, txn);
+  auto table = catalog->GetTableWithName(DEFAULT_DB_NAME, TEST_TABLE_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+  oid_t db_id = database->GetOid();
+  oid_t table_id = table->GetOid();
+  auto stats_storage = StatsStorage::GetInstance();
+
+  std::vector<ValueCondition> conditions{
+      {1, ExpressionType::COMPARE_EQUAL, type::ValueFactory::GetIntegerValue(3)},
+      {2, ExpressionType::COMPARE_EQUAL,
+       type::ValueFactory::GetIntegerValue(3)}};
+  std::vector<oid_t> group_by_columns{1, 2};
+
+  // The stats of the single columns assume that they are independent
+  TestingSQLUtil::ExecuteSQLQuery("ANALYZE test");
+  auto table_stats = stats_storage->GetTableStats(db_id, table_id);
+  EXPECT_EQ(0, table_stats->GetMultiColumnStats().size());
+  ExpectSelectivityEqual(
+      Selectivity::ComputeConjunctionSelectivity(table_stats, conditions),
+      0.01, 0.005);
+  EXPECT_GE(Cost::GetEstimatedGroupByRows(table_stats, group_by_columns), 100);
+
+  // Unknown columns can't be analyzed
+  EXPECT_EQ(ResultType::FAILURE,
+            stats_storage->AnalayzeStatsForColumns(table, {"b", "d"}));
+
+  // The joint stats know better
+  TestingSQLUtil::ExecuteSQLQuery("ANALYZE test (b, c)");
+  table_stats = stats_storage->GetTableStats(db_id, table_id);
+  ASSERT_EQ(1, table_stats->GetMultiColumnStats().size());
+  auto group_stats = table_stats->GetMultiColumnStats()[0];
+  EXPECT_EQ(std::vector<oid_t>({1, 2}), group_stats->column_ids);
+  EXPECT_NEAR(10, group_stats->cardinality, 1);
+  ExpectSelectivityEqual(
+      Selectivity::ComputeConjunctionSelectivity(table_stats, conditions),
+      0.1, 0.02);
+  EXPECT_LE(Cost::GetEstimatedGroupByRows(table_stats, group_by_columns), 20);
+
+  // Combinations that never occur are rare
+  conditions[1].value = type::ValueFactory::GetIntegerValue(4);
+  EXPECT_LT(Selectivity::ComputeConjunctionSelectivity(table_stats, conditions),
+            0.02);
+
+  // Later analyses of the table keep the joint stats
+  TestingSQLUtil::ExecuteSQLQuery("ANALYZE test");
+  table_stats = stats_storage->GetTableStats(db_id, table_id);
+  EXPECT_EQ(1, table_stats->GetMultiColumnStats().size());
+
+  // Free the database
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,212 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_maintainer_test.cpp
+//
+// Identification: test/optimizer/stats_maintainer_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "catalog/catalog.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "gc/gc_manager_factory.h"
+#include "gc/transaction_level_gc_manager.h"
+#include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/stats_maintainer.h"
+#include "optimizer/stats/stats_storage.h"
+#include "settings/settings_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class StatsMaintainerTests : public PelotonTest {};
+
+// Insert num_rows more tuples into the table
+void InsertTuples(storage::DataTable *data_table, int num_rows) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table, num_rows, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(StatsMaintainerTests, IncrementalAnalysisTest) {
+  auto catalog = catalog::Catalog::GetInstance();
+  (void)catalog;
+  auto stats_storage = StatsStorage::GetInstance();
+  auto &stats_maintainer = StatsMaintainer::Instance();
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(10, false));
+  InsertTuples(data_table.get(), 55);
+  auto database_oid = data_table->GetDatabaseOid();
+  auto table_oid = data_table->GetOid();
+
+  // The first analysis scans the whole table
+  EXPECT_FALSE(stats_maintainer.AnalyzeTable(data_table.get()));
+  auto column_stats =
+      stats_storage->GetColumnStatsByID(database_oid, table_oid, 0);
+  ASSERT_NE(nullptr, column_stats);
+  EXPECT_EQ(55, column_stats->num_rows);
+
+  // The next one only the tuples inserted since, which partly share a tile
+  // group with the old ones. The first column repeats the same values.
+  InsertTuples(data_table.get(), 40);
+  EXPECT_TRUE(stats_maintainer.AnalyzeTable(data_table.get()));
+  column_stats = stats_storage->GetColumnStatsByID(database_oid, table_oid, 0);
+  ASSERT_NE(nullptr, column_stats);
+  EXPECT_EQ(95, column_stats->num_rows);
+
+  // The merged stats match those of a full analysis
+  TableStatsCollector table_stats_collector(data_table.get());
+  table_stats_collector.CollectColumnStats();
+  EXPECT_EQ(95, table_stats_collector.GetActiveTupleCount());
+  for (oid_t column_id = 0; column_id < 4; column_id++) {
+    column_stats =
+        stats_storage->GetColumnStatsByID(database_oid, table_oid, column_id);
+    ASSERT_NE(nullptr, column_stats);
+    EXPECT_EQ(
+        table_stats_collector.GetColumnStats(column_id)->GetCardinality(),
+        column_stats->cardinality);
+  }
+
+  stats_maintainer.RemoveTable(table_oid);
+}
+
+TEST_F(StatsMaintainerTests, ActiveTileGroupsAnalysisTest) {
+  auto stats_storage = StatsStorage::GetInstance();
+  auto &stats_maintainer = StatsMaintainer::Instance();
+
+  // Inserts go round-robin into three tile groups, none of which is the last
+  storage::DataTable::SetActiveTileGroupCount(3);
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(10, false));
+  storage::DataTable::SetActiveTileGroupCount(1);
+  InsertTuples(data_table.get(), 16);
+  auto database_oid = data_table->GetDatabaseOid();
+  auto table_oid = data_table->GetOid();
+
+  EXPECT_FALSE(stats_maintainer.AnalyzeTable(data_table.get()));
+  InsertTuples(data_table.get(), 20);
+  EXPECT_TRUE(stats_maintainer.AnalyzeTable(data_table.get()));
+  auto column_stats =
+      stats_storage->GetColumnStatsByID(database_oid, table_oid, 0);
+  ASSERT_NE(nullptr, column_stats);
+  EXPECT_EQ(36, column_stats->num_rows);
+
+  stats_maintainer.RemoveTable(table_oid);
+}
+
+TEST_F(StatsMaintainerTests, RecycledSlotAnalysisTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  gc_manager.Reset();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &stats_maintainer = StatsMaintainer::Instance();
+
+  auto database = TestingExecutorUtil::InitializeDatabase("RecycledSlotDB");
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingTransactionUtil::CreateTable(10, "TABLE1", database->GetOid(),
+                                          INVALID_OID, 1234, true, 5));
+  EXPECT_FALSE(stats_maintainer.AnalyzeTable(data_table.get()));
+
+  // Delete a tuple and let GC reclaim its slot
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, data_table.get(), 2));
+  txn_manager.CommitTransaction(txn);
+  for (eid_t epoch_id = 2; epoch_id <= 3; epoch_id++) {
+    epoch_manager.SetCurrentEpochId(epoch_id);
+    auto expired_eid = epoch_manager.GetExpiredEpochId();
+    gc_manager.Reclaim(0, expired_eid);
+    gc_manager.Unlink(0, expired_eid);
+  }
+
+  // The next insert goes into the reclaimed slot, in the middle of the
+  // table, so the next analysis has to scan all of it
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(
+      TestingTransactionUtil::ExecuteInsert(txn, data_table.get(), 10, 0));
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(1, data_table->GetRecycledSlotCount());
+  EXPECT_FALSE(stats_maintainer.AnalyzeTable(data_table.get()));
+
+  TableStatsCollector table_stats_collector(data_table.get());
+  table_stats_collector.CollectColumnStats();
+  auto column_stats = StatsStorage::GetInstance()->GetColumnStatsByID(
+      database->GetOid(), data_table->GetOid(), 0);
+  ASSERT_NE(nullptr, column_stats);
+  EXPECT_EQ(table_stats_collector.GetActiveTupleCount(),
+            column_stats->num_rows);
+
+  stats_maintainer.RemoveTable(data_table->GetOid());
+  gc_manager.StopGC();
+  gc::GCManagerFactory::Configure(0);
+
+  data_table.release();
+  TestingExecutorUtil::DeleteDatabase("RecycledSlotDB");
+}
+
+TEST_F(StatsMaintainerTests, ModificationThresholdTest) {
+  auto &stats_maintainer = StatsMaintainer::Instance();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(10, false));
+  InsertTuples(data_table.get(), 100);
+
+  // Keep the scheduled analyses instead of running them
+  size_t num_scheduled = 0;
+  stats_maintainer.SetScheduler(
+      [&num_scheduled](std::function<void()>) { num_scheduled++; });
+
+  settings::SettingsManager::SetBool(settings::SettingId::auto_analyze, true);
+  settings::SettingsManager::SetInt(settings::SettingId::auto_analyze_threshold,
+                                    50);
+  settings::SettingsManager::SetDouble(
+      settings::SettingId::auto_analyze_scale_factor, 0.1);
+
+  // 100 tuples were analyzed, so more than 50 + 0.1 * 100 modified tuples
+  // trigger the next analysis. The analysis makes the reported counters the
+  // baseline, even if it was scheduled by them.
+  std::unique_ptr<TableStatsCollector> table_stats_collector(
+      new TableStatsCollector(data_table.get()));
+  table_stats_collector->CollectColumnStats();
+  EXPECT_TRUE(
+      stats_maintainer.RecordModifications(data_table.get(), 100, 0, 0));
+  stats_maintainer.SetAnalyzed(data_table->GetOid(),
+                               std::move(table_stats_collector));
+  EXPECT_EQ(1, num_scheduled);
+
+  EXPECT_FALSE(
+      stats_maintainer.RecordModifications(data_table.get(), 140, 10, 0));
+  EXPECT_FALSE(
+      stats_maintainer.RecordModifications(data_table.get(), 140, 10, 10));
+  EXPECT_TRUE(
+      stats_maintainer.RecordModifications(data_table.get(), 141, 10, 10));
+
+  // An analysis is scheduled only once
+  EXPECT_FALSE(
+      stats_maintainer.RecordModifications(data_table.get(), 500, 10, 10));
+  EXPECT_EQ(2, num_scheduled);
+
+  settings::SettingsManager::SetBool(settings::SettingId::auto_analyze, false);
+  stats_maintainer.SetScheduler(nullptr);
+  stats_maintainer.RemoveTable(data_table->GetOid());
+}
+
+}  // namespace test
+}  // namespace peloton
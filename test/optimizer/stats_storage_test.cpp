@@ -26,6 +26,7 @@
 #include "catalog/column_stats_catalog.h"
 #include "executor/testing_executor_util.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace test {
@@ -124,14 +125,14 @@ TEST_F(StatsStorageTests, InsertAndGetColumnStatsTest) {
   int num_rows = 10;
   double cardinality = 8;
   double frac_null = 0.56;
-  std::string most_common_vals = "12";
-  std::string most_common_freqs = "3";
-  std::string histogram_bounds = "1,5,7";
+  std::vector<ValueFrequencyPair> most_common_val_freqs = {
+      {type::ValueFactory::GetIntegerValue(12), 3}};
+  std::vector<double> histogram_bounds = {1, 5, 7};
   std::string column_name = "random";
 
   stats_storage->InsertOrUpdateColumnStats(
       database_id, table_id, column_id, num_rows, cardinality, frac_null,
-      most_common_vals, most_common_freqs, histogram_bounds, column_name);
+      most_common_val_freqs, histogram_bounds, column_name);
 
   auto column_stats_ptr =
       stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
@@ -144,6 +145,9 @@ TEST_F(StatsStorageTests, InsertAndGetColumnStatsTest) {
   EXPECT_EQ(column_stats_ptr->frac_null, frac_null);
 
   EXPECT_EQ(column_stats_ptr->column_name, column_name);
+  EXPECT_EQ(std::vector<double>({12}), column_stats_ptr->most_common_vals);
+  EXPECT_EQ(std::vector<double>({3}), column_stats_ptr->most_common_freqs);
+  EXPECT_EQ(histogram_bounds, column_stats_ptr->histogram_bounds);
 
   // Should return nullptr
   auto column_stats_ptr2 =
@@ -163,27 +167,25 @@ TEST_F(StatsStorageTests, UpdateColumnStatsTest) {
   int num_row_0 = 10;
   double cardinality_0 = 8;
   double frac_null_0 = 0.56;
-  std::string most_common_vals_0 = "12";
-  std::string most_common_freqs_0 = "3";
-  std::string histogram_bounds_0 = "1,5,7";
+  std::vector<ValueFrequencyPair> most_common_val_freqs_0 = {
+      {type::ValueFactory::GetIntegerValue(12), 3}};
+  std::vector<double> histogram_bounds_0 = {1, 5, 7};
   std::string column_name_0 = "random0";
 
   int num_row_1 = 20;
   double cardinality_1 = 16;
   double frac_null_1 = 1.56;
-  std::string most_common_vals_1 = "24";
-  std::string most_common_freqs_1 = "6";
-  std::string histogram_bounds_1 = "2,10,14";
+  std::vector<ValueFrequencyPair> most_common_val_freqs_1 = {
+      {type::ValueFactory::GetIntegerValue(24), 6}};
+  std::vector<double> histogram_bounds_1 = {2, 10, 14};
   std::string column_name_1 = "random1";
 
   stats_storage->InsertOrUpdateColumnStats(
       database_id, table_id, column_id, num_row_0, cardinality_0, frac_null_0,
-      most_common_vals_0, most_common_freqs_0, histogram_bounds_0,
-      column_name_0);
+      most_common_val_freqs_0, histogram_bounds_0, column_name_0);
   stats_storage->InsertOrUpdateColumnStats(
       database_id, table_id, column_id, num_row_1, cardinality_1, frac_null_1,
-      most_common_vals_1, most_common_freqs_1, histogram_bounds_1,
-      column_name_1);
+      most_common_val_freqs_1, histogram_bounds_1, column_name_1);
 
   auto column_stats_ptr =
       stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
@@ -196,6 +198,108 @@ TEST_F(StatsStorageTests, UpdateColumnStatsTest) {
   EXPECT_EQ(column_stats_ptr->frac_null, frac_null_1);
 
   EXPECT_EQ(column_stats_ptr->column_name, column_name_1);
+  EXPECT_EQ(std::vector<double>({24}), column_stats_ptr->most_common_vals);
+  EXPECT_EQ(histogram_bounds_1, column_stats_ptr->histogram_bounds);
+}
+
+TEST_F(StatsStorageTests, StringCommonValuesTest) {
+  auto catalog = catalog::Catalog::GetInstance();
+  (void)catalog;
+  StatsStorage *stats_storage = StatsStorage::GetInstance();
+
+  oid_t database_id = 1;
+  oid_t table_id = 3;
+  oid_t column_id = 0;
+  std::vector<ValueFrequencyPair> most_common_val_freqs = {
+      {type::ValueFactory::GetVarcharValue("even"), 6},
+      {type::ValueFactory::GetVarcharValue(std::string(2000, 'x')), 3},
+      {type::ValueFactory::GetVarcharValue("odd, or not"), 4}};
+
+  auto version = stats_storage->GetTableStatsVersion(database_id, table_id);
+  stats_storage->InsertOrUpdateColumnStats(database_id, table_id, column_id,
+                                           10, 3, 0, most_common_val_freqs, {},
+                                           "name");
+  EXPECT_LT(version,
+            stats_storage->GetTableStatsVersion(database_id, table_id));
+
+  // Wide values are dropped, the others survive the round trip
+  auto column_stats_ptr =
+      stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
+  ASSERT_NE(nullptr, column_stats_ptr);
+  EXPECT_EQ(std::vector<std::string>({"even", "odd, or not"}),
+            column_stats_ptr->most_common_strs);
+  EXPECT_EQ(std::vector<double>({6, 4}), column_stats_ptr->most_common_freqs);
+  EXPECT_TRUE(column_stats_ptr->most_common_vals.empty());
+  EXPECT_TRUE(column_stats_ptr->histogram_bounds.empty());
+
+  // Lookups are served from the cache until the stats change
+  EXPECT_EQ(column_stats_ptr,
+            stats_storage->GetColumnStatsByID(database_id, table_id, column_id));
+  stats_storage->InsertOrUpdateColumnStats(database_id, table_id, column_id,
+                                           20, 3, 0, most_common_val_freqs, {},
+                                           "name");
+  column_stats_ptr =
+      stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
+  ASSERT_NE(nullptr, column_stats_ptr);
+  EXPECT_EQ(20, column_stats_ptr->num_rows);
+}
+
+TEST_F(StatsStorageTests, UncommittedStatsTest) {
+  auto catalog = catalog::Catalog::GetInstance();
+  (void)catalog;
+  StatsStorage *stats_storage = StatsStorage::GetInstance();
+
+  oid_t database_id = 1;
+  oid_t table_id = 4;
+  oid_t column_id = 0;
+  stats_storage->InsertOrUpdateColumnStats(database_id, table_id, column_id,
+                                           10, 5, 0, {}, {}, "name");
+  auto version = stats_storage->GetTableStatsVersion(database_id, table_id);
+  EXPECT_LT(0U, version);
+
+  // Stats are only published once their transaction commits
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  stats_storage->InsertOrUpdateColumnStats(database_id, table_id, column_id,
+                                           20, 5, 0, {}, {}, "name", false,
+                                           txn);
+  EXPECT_EQ(version,
+            stats_storage->GetTableStatsVersion(database_id, table_id));
+  txn_manager.AbortTransaction(txn);
+  EXPECT_EQ(version,
+            stats_storage->GetTableStatsVersion(database_id, table_id));
+  auto column_stats_ptr =
+      stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
+  ASSERT_NE(nullptr, column_stats_ptr);
+  EXPECT_EQ(10, column_stats_ptr->num_rows);
+
+  txn = txn_manager.BeginTransaction();
+  stats_storage->InsertOrUpdateColumnStats(database_id, table_id, column_id,
+                                           20, 5, 0, {}, {}, "name", false,
+                                           txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_LT(version,
+            stats_storage->GetTableStatsVersion(database_id, table_id));
+  column_stats_ptr =
+      stats_storage->GetColumnStatsByID(database_id, table_id, column_id);
+  ASSERT_NE(nullptr, column_stats_ptr);
+  EXPECT_EQ(20, column_stats_ptr->num_rows);
+
+  // The cached stats of a dropped table are forgotten
+  stats_storage->RemoveTableStats(database_id, table_id);
+  EXPECT_EQ(0U, stats_storage->GetTableStatsVersion(database_id, table_id));
+}
+
+TEST_F(StatsStorageTests, EncodeDoublesTest) {
+  std::vector<double> values = {-1.5, 0, 3.25, 1e100};
+  std::string encoded = StatsStorage::EncodeDoubles(values);
+  EXPECT_EQ(values, StatsStorage::DecodeDoubles(encoded.data(), encoded.size()));
+
+  // Empty arrays are encoded as nothing, and malformed arrays decode to
+  // nothing
+  EXPECT_TRUE(StatsStorage::EncodeDoubles({}).empty());
+  EXPECT_TRUE(
+      StatsStorage::DecodeDoubles(encoded.data(), encoded.size() - 1).empty());
 }
 
 TEST_F(StatsStorageTests, AnalyzeStatsForTableTest) {
@@ -21,6 +21,7 @@
 #include "executor/testing_executor_util.h"
 #include "optimizer/stats/table_stats_collector.h"
 #include "optimizer/stats/column_stats_collector.h"
+#include "settings/settings_manager.h"
 #include "sql/testing_sql_util.h"
 #include "storage/data_table.h"
 #include "storage/tuple.h"
@@ -145,5 +146,70 @@ TEST_F(TableStatsCollectorTests, MultiColumnTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(TableStatsCollectorTests, ParallelCollectionTest) {
+  // 200 tuples in 20 tile groups
+  int nrow = 200;
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(10, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Collecting with one thread and with several threads gives the same stats
+  settings::SettingsManager::SetInt(settings::SettingId::analyze_parallelism,
+                                    1);
+  TableStatsCollector serial_stats{data_table.get()};
+  serial_stats.CollectColumnStats();
+
+  settings::SettingsManager::SetInt(settings::SettingId::analyze_parallelism,
+                                    4);
+  TableStatsCollector parallel_stats{data_table.get()};
+  parallel_stats.CollectColumnStats();
+
+  EXPECT_EQ(nrow, serial_stats.GetActiveTupleCount());
+  EXPECT_EQ(nrow, parallel_stats.GetActiveTupleCount());
+  for (oid_t column_id = 0; column_id < 4; column_id++) {
+    EXPECT_EQ(serial_stats.GetColumnStats(column_id)->GetCardinality(),
+              parallel_stats.GetColumnStats(column_id)->GetCardinality());
+    EXPECT_EQ(serial_stats.GetColumnStats(column_id)->GetFracNull(),
+              parallel_stats.GetColumnStats(column_id)->GetFracNull());
+  }
+}
+
+TEST_F(TableStatsCollectorTests, SampledCollectionTest) {
+  // 200 tuples in 20 tile groups, of which 5 are sampled
+  int nrow = 200;
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(10, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), nrow, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  settings::SettingsManager::SetInt(
+      settings::SettingId::analyze_sample_tile_groups, 5);
+  TableStatsCollector stats{data_table.get()};
+  stats.CollectColumnStats();
+  settings::SettingsManager::SetInt(
+      settings::SettingId::analyze_sample_tile_groups, 300);
+
+  // Every sampled tile group but (maybe) the last one of the table is full,
+  // so the tuple count is extrapolated from 40 to 50 sampled tuples
+  double scale = data_table->GetTileGroupCount() / 5.0;
+  EXPECT_GE(stats.GetActiveTupleCount(), 40 * scale);
+  EXPECT_LE(stats.GetActiveTupleCount(), 50 * scale);
+
+  // The first column is unique, so its cardinality scales with the sample
+  auto column_stats_collector = stats.GetColumnStats(0);
+  double estimated_rows = stats.GetActiveTupleCount();
+  uint64_t cardinality = column_stats_collector->GetCardinality();
+  double cardinality_error = column_stats_collector->GetCardinalityError();
+  EXPECT_GE(cardinality, estimated_rows * (1 - 2 * cardinality_error));
+  EXPECT_LE(cardinality, estimated_rows * (1 + 2 * cardinality_error));
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -13,6 +13,7 @@
 #include "common/harness.h"
 #include "gtest/gtest.h"
 
+#include <random>
 #include <thread>
 #include <vector>
 
@@ -365,6 +366,97 @@ static void TestIndexPerformance(const IndexType &index_type) {
   return;
 }
 
+/*
+ * TestBatchLookupPerformance() - Compares batched lookups with single ones
+ *
+ * This function looks up random keys, half of which are in the index, once
+ * key by key through ScanKey() and once in batches through ScanKeyBatch(),
+ * and reports the lookups per second of both
+ */
+static void TestBatchLookupPerformance(const IndexType &index_type) {
+  std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
+
+  // Only even keys are in the index
+  size_t num_key = 1024 * 1024;
+  size_t num_lookup = 1024 * 1024;
+  size_t batch_size = 256;
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  for (size_t i = 0; i < num_key; i++) {
+    auto key_value = type::ValueFactory::GetIntegerValue(2 * i);
+    key->SetValue(0, key_value, nullptr);
+    key->SetValue(1, key_value, nullptr);
+    index->InsertEntry(key.get(), item.get());
+  }
+
+  std::vector<std::unique_ptr<storage::Tuple>> lookup_keys;
+  std::mt19937 rng(0);
+  for (size_t i = 0; i < num_lookup; i++) {
+    auto key_value = type::ValueFactory::GetIntegerValue(rng() % (2 * num_key));
+    lookup_keys.emplace_back(new storage::Tuple(key_schema, true));
+    lookup_keys.back()->SetValue(0, key_value, nullptr);
+    lookup_keys.back()->SetValue(1, key_value, nullptr);
+  }
+
+  Timer<> timer;
+
+  ///////////////////////////////////////////////////////////////////
+  // Single-key lookups
+  ///////////////////////////////////////////////////////////////////
+
+  timer.Start();
+
+  size_t single_found = 0;
+  std::vector<ItemPointer *> location_ptrs;
+  for (auto &lookup_key : lookup_keys) {
+    index->ScanKey(lookup_key.get(), location_ptrs);
+    single_found += location_ptrs.size();
+    location_ptrs.clear();
+  }
+
+  timer.Stop();
+  LOG_INFO("SingleLookup :: Type=%s; Lookups/sec=%.0lf",
+           IndexTypeToString(index_type).c_str(),
+           num_lookup / timer.GetDuration());
+  timer.Reset();
+
+  ///////////////////////////////////////////////////////////////////
+  // Batched lookups
+  ///////////////////////////////////////////////////////////////////
+
+  timer.Start();
+
+  size_t batch_found = 0;
+  std::vector<const storage::Tuple *> batch_keys;
+  std::vector<std::vector<ItemPointer *>> results;
+  for (size_t start = 0; start < num_lookup; start += batch_size) {
+    batch_keys.clear();
+    for (size_t i = start; i < std::min(start + batch_size, num_lookup); i++) {
+      batch_keys.push_back(lookup_keys[i].get());
+    }
+    results.clear();
+    index->ScanKeyBatch(batch_keys, results);
+    for (auto &result : results) {
+      batch_found += result.size();
+    }
+  }
+
+  timer.Stop();
+  LOG_INFO("BatchLookup :: Type=%s; Batch=%lu; Lookups/sec=%.0lf",
+           IndexTypeToString(index_type).c_str(), batch_size,
+           num_lookup / timer.GetDuration());
+
+  EXPECT_EQ(single_found, batch_found);
+
+  delete tuple_schema;
+
+  return;
+}
+
+TEST_F(IndexPerformanceTests, BwTreeBatchLookupTest) {
+  TestBatchLookupPerformance(IndexType::BWTREE);
+}
+
 TEST_F(IndexPerformanceTests, BwTreeMultiThreadedTest) {
   TestIndexPerformance(IndexType::BWTREE);
 }
@@ -14,9 +14,11 @@
 
 #include "sql/testing_sql_util.h"
 #include "catalog/catalog.h"
+#include "codegen/query_compiler.h"
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/create_executor.h"
+#include "optimizer/optimizer.h"
 #include "planner/create_plan.h"
 
 namespace peloton {
@@ -184,5 +186,32 @@ TEST_F(DistinctSQLTests, DistinctDateTimeTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(DistinctSQLTests, DistinctCompiledTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+
+  // DISTINCT is planned as a hash on the output columns, which is compiled
+  std::string query = "SELECT DISTINCT b, c FROM test WHERE a > 1;";
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::Optimizer());
+  txn = txn_manager.BeginTransaction();
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_TRUE(codegen::QueryCompiler::IsSupported(*plan));
+
+  ExecuteSQLQueryAndCheckUnorderedResult(query, {"22|333", "11|222"});
+  ExecuteSQLQueryAndCheckUnorderedResult(
+      "SELECT DISTINCT b + 1 FROM test WHERE c > 0;", {"23", "12"});
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
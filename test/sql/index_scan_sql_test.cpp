@@ -17,7 +17,17 @@
 #include "common/harness.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/create_executor.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "index/index.h"
+#include "optimizer/optimizer.h"
+#include "optimizer/util.h"
 #include "planner/create_plan.h"
+#include "planner/index_scan_plan.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace test {
@@ -231,5 +241,199 @@ TEST_F(IndexScanSQLTests, SQLTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Create an index on column a of the test table, and return it
+static std::shared_ptr<index::Index> CreateIndexOnA(
+    const std::string &index_name,
+    std::shared_ptr<expression::AbstractExpression> predicate,
+    const std::vector<std::shared_ptr<expression::AbstractExpression>>
+        &key_expressions,
+    IndexConstraintType index_constraint = IndexConstraintType::DEFAULT) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto catalog = catalog::Catalog::GetInstance();
+  auto table = catalog->GetTableWithName(DEFAULT_DB_NAME, "test", txn);
+  EXPECT_EQ(ResultType::SUCCESS,
+            catalog->CreateIndex(
+                table->GetDatabaseOid(), table->GetOid(), {0}, index_name,
+                IndexType::BWTREE, index_constraint,
+                index_constraint != IndexConstraintType::DEFAULT, txn, false,
+                predicate, key_expressions));
+  txn_manager.CommitTransaction(txn);
+  return table->GetIndex(table->GetIndexCount() - 1);
+}
+
+// Check that the optimizer scans the test table through the given index, or
+// sequentially if no index is given
+static void CheckScanIndex(const std::string &query,
+                           const std::string &index_name) {
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::Optimizer());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto *scan = plan.get();
+  while (!scan->GetChildren().empty()) {
+    scan = scan->GetChildren()[0].get();
+  }
+  if (index_name.empty()) {
+    EXPECT_EQ(PlanNodeType::SEQSCAN, scan->GetPlanNodeType());
+    return;
+  }
+  ASSERT_EQ(PlanNodeType::INDEXSCAN, scan->GetPlanNodeType());
+  EXPECT_EQ(index_name,
+            static_cast<planner::IndexScanPlan *>(scan)->GetIndex()->GetName());
+}
+
+TEST_F(IndexScanSQLTests, PartialIndexTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+
+  // CREATE INDEX i1 ON test(a) WHERE b > 15
+  std::shared_ptr<expression::AbstractExpression> predicate(
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_GREATERTHAN,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(15))));
+  auto index = CreateIndexOnA("i1", predicate, {});
+  EXPECT_TRUE(index->GetMetadata()->IsPartial());
+
+  // Only the tuples the predicate covers are indexed, by the build and by
+  // writers
+  std::vector<ItemPointer *> result;
+  index->ScanAllKeys(result);
+  EXPECT_EQ(2, result.size());
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test VALUES (4, 5, 444, 'abc');");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test VALUES (5, 55, 555, 'cba');");
+  result.clear();
+  index->ScanAllKeys(result);
+  EXPECT_EQ(3, result.size());
+
+  // Queries that only select tuples the predicate covers use the index, and
+  // the others don't
+  CheckScanIndex("SELECT c FROM test WHERE b > 15 AND a = 5;", "i1");
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT c FROM test WHERE b > 15 AND a = 5;", {"555"});
+  CheckScanIndex("SELECT c FROM test WHERE a = 4;", "");
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT c FROM test WHERE a = 4;", {"444"});
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(IndexScanSQLTests, UniquePartialIndexTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+
+  // CREATE UNIQUE INDEX i1 ON test(a) WHERE b > 15
+  std::shared_ptr<expression::AbstractExpression> predicate(
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_GREATERTHAN,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(15))));
+  CreateIndexOnA("i1", predicate, {}, IndexConstraintType::UNIQUE);
+
+  // Updating only a column of the predicate re-inserts the tuple's key, which
+  // finds the tuple's own entry rather than a duplicate
+  EXPECT_EQ(ResultType::SUCCESS, TestingSQLUtil::ExecuteSQLQuery(
+                                     "UPDATE test SET b = 44 WHERE a = 2;"));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT b FROM test WHERE a = 2;", {"44"});
+
+  // A tuple the predicate doesn't cover may repeat a key, one it covers may not
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "INSERT INTO test VALUES (2, 5, 444, 'abc');"));
+  EXPECT_NE(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "INSERT INTO test VALUES (2, 55, 555, 'cba');"));
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(IndexScanSQLTests, ExpressionIndexTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  CreateAndLoadTable();
+
+  // CREATE INDEX i1 ON test((a + b))
+  std::shared_ptr<expression::AbstractExpression> key_expression(
+      new expression::OperatorExpression(
+          ExpressionType::OPERATOR_PLUS, type::TypeId::INTEGER,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0),
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)));
+  auto index = CreateIndexOnA("i1", nullptr, {key_expression});
+  TestingSQLUtil::ExecuteSQLQuery(
+      "INSERT INTO test VALUES (4, 5, 444, 'abc');");
+
+  // The keys are computed from the tuples
+  std::unique_ptr<storage::Tuple> key(
+      new storage::Tuple(index->GetKeySchema(), true));
+  for (int value : {23, 35, 14, 9}) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(value), nullptr);
+    std::vector<ItemPointer *> result;
+    index->ScanKey(key.get(), result);
+    EXPECT_EQ(1, result.size());
+  }
+
+  // Only references to the columns of the indexed table match the expression
+  oid_t table_oid = index->GetMetadata()->GetTableOid();
+  auto query_column_a =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  auto query_column_b =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1);
+  query_column_a->SetBoundOid(index->GetMetadata()->GetDatabaseOid(),
+                              table_oid, 0);
+  query_column_b->SetBoundOid(index->GetMetadata()->GetDatabaseOid(),
+                              table_oid, 1);
+  expression::OperatorExpression query_expression(
+      ExpressionType::OPERATOR_PLUS, type::TypeId::INTEGER, query_column_a,
+      query_column_b);
+  EXPECT_TRUE(optimizer::util::EqualIndexExpressions(
+      &query_expression, key_expression.get(), table_oid));
+  EXPECT_FALSE(optimizer::util::EqualIndexExpressions(
+      &query_expression, key_expression.get(), table_oid + 1));
+
+  // Queries on the expression look it up, and queries on column a don't
+  CheckScanIndex("SELECT c FROM test WHERE a + b = 35;", "i1");
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT c FROM test WHERE a + b = 35;", {"111"});
+  CheckScanIndex("SELECT c FROM test WHERE a = 4;", "");
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT c FROM test WHERE a = 4;", {"444"});
+
+  // Updating column b moves the tuple to another key
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET b = 6 WHERE a = 4;");
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT c FROM test WHERE a + b = 10;", {"444"});
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
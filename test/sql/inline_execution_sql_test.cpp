@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// inline_execution_sql_test.cpp
+//
+// Identification: test/sql/inline_execution_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "settings/settings_manager.h"
+#include "threadpool/mono_queue_pool.h"
+#include "traffic_cop/traffic_cop.h"
+
+namespace peloton {
+namespace test {
+
+class InlineExecutionSQLTests : public PelotonTest {};
+
+static std::shared_ptr<planner::AbstractPlan> GeneratePlan(
+    const std::string &query) {
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::Optimizer());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn);
+  txn_manager.CommitTransaction(txn);
+  return plan;
+}
+
+// Whether the optimized plan of the query would run on the network thread
+static bool IsInlineQuery(const std::string &query) {
+  return tcop::TrafficCop::IsInlinePlan(GeneratePlan(query).get());
+}
+
+// The worker pool lane the optimized plan of the query would run in
+static threadpool::TaskPriority GetQueryPriority(const std::string &query) {
+  return tcop::TrafficCop::GetTaskPriority(GeneratePlan(query).get());
+}
+
+TEST_F(InlineExecutionSQLTests, InlinePlanTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 33, 111);");
+
+  // Point reads and writes run inline, scans and maintenance don't
+  EXPECT_TRUE(IsInlineQuery("INSERT INTO test VALUES (3, 11, 222);"));
+  EXPECT_TRUE(IsInlineQuery("SELECT b FROM test WHERE a = 1;"));
+  EXPECT_TRUE(IsInlineQuery("UPDATE test SET b = 44 WHERE a = 2;"));
+  EXPECT_TRUE(IsInlineQuery("DELETE FROM test WHERE a = 2;"));
+  EXPECT_FALSE(IsInlineQuery("SELECT b FROM test WHERE a > 1;"));
+  EXPECT_FALSE(IsInlineQuery("SELECT a FROM test WHERE b = 22;"));
+  EXPECT_FALSE(IsInlineQuery("UPDATE test SET c = 0 WHERE b = 22;"));
+  EXPECT_FALSE(IsInlineQuery("ANALYZE test;"));
+  EXPECT_FALSE(tcop::TrafficCop::IsInlinePlan(nullptr));
+
+  // Both kinds of statements execute correctly in run-to-completion mode
+  settings::SettingsManager::SetBool(settings::SettingId::inline_execution,
+                                     true);
+  EXPECT_EQ(ResultType::SUCCESS, TestingSQLUtil::ExecuteSQLQuery(
+                                     "INSERT INTO test VALUES (3, 11, 222);"));
+  EXPECT_EQ(ResultType::SUCCESS, TestingSQLUtil::ExecuteSQLQuery(
+                                     "UPDATE test SET b = 44 WHERE a = 2;"));
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT b FROM test WHERE a = 2;", {"44"});
+  TestingSQLUtil::ExecuteSQLQueryAndCheckResult(
+      "SELECT a FROM test WHERE b > 20;", {"1", "2"}, false);
+  settings::SettingsManager::SetBool(settings::SettingId::inline_execution,
+                                     false);
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(InlineExecutionSQLTests, TaskPriorityTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 33, 111);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 11, 222);");
+
+  // Statements that scan as many tuples as the table has go to the batch
+  // lane, point statements don't
+  settings::SettingsManager::SetInt(settings::SettingId::batch_task_min_tuples,
+                                    3);
+  EXPECT_EQ(threadpool::TaskPriority::BATCH,
+            GetQueryPriority("SELECT a FROM test WHERE b > 0;"));
+  EXPECT_EQ(threadpool::TaskPriority::BATCH,
+            GetQueryPriority("UPDATE test SET c = 0 WHERE b = 22;"));
+  EXPECT_EQ(threadpool::TaskPriority::LATENCY_SENSITIVE,
+            GetQueryPriority("SELECT b FROM test WHERE a = 1;"));
+  EXPECT_EQ(threadpool::TaskPriority::LATENCY_SENSITIVE,
+            GetQueryPriority("INSERT INTO test VALUES (4, 44, 444);"));
+  EXPECT_EQ(threadpool::TaskPriority::BATCH, GetQueryPriority("ANALYZE test;"));
+
+  // Scans of small tables stay in the latency-sensitive lane
+  settings::SettingsManager::SetInt(settings::SettingId::batch_task_min_tuples,
+                                    4);
+  EXPECT_EQ(threadpool::TaskPriority::LATENCY_SENSITIVE,
+            GetQueryPriority("SELECT a FROM test WHERE b > 0;"));
+  settings::SettingsManager::SetInt(settings::SettingId::batch_task_min_tuples,
+                                    100000);
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache_sql_test.cpp
+//
+// Identification: test/sql/plan_cache_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "settings/settings_manager.h"
+#include "traffic_cop/plan_cache.h"
+
+namespace peloton {
+namespace test {
+
+class PlanCacheSQLTests : public PelotonTest {};
+
+// Execute a query through the plan cache
+ResultType ExecuteCachedQuery(const std::string &query,
+                              std::vector<ResultValue> &result) {
+  auto &traffic_cop = TestingSQLUtil::traffic_cop_;
+  std::string error_message;
+  result.clear();
+  EXPECT_TRUE(traffic_cop.PrepareCachedStatement(query, error_message));
+  auto statement = traffic_cop.GetStatement();
+  if (statement.get() == nullptr) {
+    return ResultType::FAILURE;
+  }
+
+  std::vector<int> result_format(statement->GetTupleDescriptor().size(), 0);
+  TestingSQLUtil::counter_.store(1);
+  auto status = traffic_cop.ExecuteStatement(
+      statement, traffic_cop.GetParamVal(), false, nullptr, result_format,
+      result, error_message);
+  if (traffic_cop.GetQueuing()) {
+    TestingSQLUtil::ContinueAfterComplete();
+    traffic_cop.ExecuteStatementPlanGetResult();
+    status = traffic_cop.ExecuteStatementGetResult();
+    traffic_cop.SetQueuing(false);
+  }
+  return status;
+}
+
+TEST_F(PlanCacheSQLTests, NormalizeTest) {
+  std::string normalized;
+  std::vector<type::Value> params;
+
+  // Literals compared against columns become parameters
+  EXPECT_TRUE(tcop::PlanCache::Normalize(
+      "SELECT b FROM test  WHERE a = 1 AND d = 'it''s';", normalized, params));
+  EXPECT_EQ("SELECT b FROM test WHERE a = $1 AND d = $2;", normalized);
+  ASSERT_EQ(2, params.size());
+  EXPECT_EQ(type::TypeId::INTEGER, params[0].GetTypeId());
+  EXPECT_EQ("1", params[0].ToString());
+  EXPECT_EQ(type::TypeId::VARCHAR, params[1].GetTypeId());
+  EXPECT_EQ("it's", params[1].ToString());
+
+  EXPECT_TRUE(tcop::PlanCache::Normalize(
+      "UPDATE test SET c = 2.5 WHERE a >= 10000000000", normalized, params));
+  EXPECT_EQ("UPDATE test SET c = $1 WHERE a >= $2", normalized);
+  ASSERT_EQ(2, params.size());
+  EXPECT_EQ(type::TypeId::DECIMAL, params[0].GetTypeId());
+  EXPECT_EQ(type::TypeId::DECIMAL, params[1].GetTypeId());
+
+  // Other literals stay part of the query
+  EXPECT_TRUE(tcop::PlanCache::Normalize(
+      "SELECT a + 1 FROM test WHERE b = c + 2 LIMIT 3", normalized, params));
+  EXPECT_EQ("SELECT a + 1 FROM test WHERE b = c + 2 LIMIT 3", normalized);
+  EXPECT_EQ(0, params.size());
+
+  // Queries that are not cached
+  EXPECT_FALSE(tcop::PlanCache::Normalize("INSERT INTO test VALUES (1);",
+                                          normalized, params));
+  EXPECT_FALSE(tcop::PlanCache::Normalize(
+      "SELECT a FROM test WHERE b = $1", normalized, params));
+  EXPECT_FALSE(tcop::PlanCache::Normalize(
+      "SELECT a FROM test WHERE b = 1 -- comment", normalized, params));
+  EXPECT_FALSE(tcop::PlanCache::Normalize(
+      "SELECT a FROM test WHERE b IN (SELECT c FROM test)", normalized,
+      params));
+}
+
+TEST_F(PlanCacheSQLTests, CachedQueryTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 33, 111);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 11, 222);");
+
+  settings::SettingsManager::SetBool(settings::SettingId::plan_cache, true);
+  auto &plan_cache = tcop::PlanCache::Instance();
+  plan_cache.Clear();
+  auto num_hits = plan_cache.GetNumHits();
+
+  // The first query plans and caches, the second one reuses its plan
+  std::vector<ResultValue> result;
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecuteCachedQuery("SELECT b FROM test WHERE a = 1;", result));
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("22", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(1, plan_cache.GetCount());
+
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecuteCachedQuery("SELECT b FROM test WHERE a = 3;", result));
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("11", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(num_hits + 1, plan_cache.GetNumHits());
+
+  // Updates are cached just the same
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecuteCachedQuery("UPDATE test SET b = 44 WHERE a = 2;", result));
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecuteCachedQuery("UPDATE test SET b = 55 WHERE a = 3;", result));
+  EXPECT_EQ(num_hits + 2, plan_cache.GetNumHits());
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecuteCachedQuery("SELECT b FROM test WHERE a = 2;", result));
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("44", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(ResultType::SUCCESS,
+            ExecuteCachedQuery("SELECT b FROM test WHERE a = 3;", result));
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ("55", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(2, plan_cache.GetCount());
+
+  // New statistics for a table of about the same size keep the plans, but
+  // very different ones don't. The plans were built before the table had
+  // any statistics, so the first statistics invalidate them as well.
+  txn = txn_manager.BeginTransaction();
+  auto table_oid = catalog::Catalog::GetInstance()
+                       ->GetTableWithName(DEFAULT_DB_NAME, "test", txn)
+                       ->GetOid();
+  txn_manager.CommitTransaction(txn);
+  plan_cache.UpdateTableStats(table_oid, 3);
+  EXPECT_EQ(0, plan_cache.GetCount());
+  ExecuteCachedQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ(1, plan_cache.GetCount());
+  plan_cache.UpdateTableStats(table_oid, 4);
+  EXPECT_EQ(1, plan_cache.GetCount());
+  plan_cache.UpdateTableStats(table_oid, 1000);
+  EXPECT_EQ(0, plan_cache.GetCount());
+
+  // DDL invalidates the cache
+  ExecuteCachedQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ(1, plan_cache.GetCount());
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX idx_b ON test(b);");
+  EXPECT_EQ(0, plan_cache.GetCount());
+  ExecuteCachedQuery("SELECT a FROM test WHERE b = 22;", result);
+  EXPECT_EQ(1, plan_cache.GetCount());
+  TestingSQLUtil::ExecuteSQLQuery("DROP INDEX idx_b;");
+  EXPECT_EQ(0, plan_cache.GetCount());
+
+  // Plans built before the cache was cleared aren't added
+  const std::string query = "SELECT b FROM test WHERE a = 1;";
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::Optimizer());
+  Statement statement("stale", QueryType::QUERY_SELECT, query, nullptr);
+  txn = txn_manager.BeginTransaction();
+  statement.SetPlanTree(
+      TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query, txn));
+  txn_manager.CommitTransaction(txn);
+  auto version = plan_cache.GetVersion();
+  plan_cache.Clear();
+  plan_cache.Add(DEFAULT_DB_NAME, query, {}, statement, version);
+  EXPECT_EQ(0, plan_cache.GetCount());
+  plan_cache.Add(DEFAULT_DB_NAME, query, {}, statement,
+                 plan_cache.GetVersion());
+  EXPECT_EQ(1, plan_cache.GetCount());
+
+  // The same query on another database doesn't find the plan
+  EXPECT_NE(nullptr,
+            plan_cache.Find(DEFAULT_DB_NAME, query, {}, "hit", query));
+  EXPECT_EQ(nullptr, plan_cache.Find("other_db", query, {}, "miss", query));
+
+  settings::SettingsManager::SetBool(settings::SettingId::plan_cache, false);
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -16,7 +16,9 @@
 
 #include "executor/testing_executor_util.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/database.h"
+#include "type/value_factory.h"
 
 #include "concurrency/transaction_manager_factory.h"
 
@@ -72,6 +74,44 @@ TEST_F(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+TEST_F(DataTableTests, TransformTileGroupConcurrentTest) {
+  // A full tile group of 5 tuples, and one with a single tuple
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(5, false, 1));
+  TestingExecutorUtil::PopulateTable(data_table.get(), 6, false, false, false,
+                                     txn);
+  txn_manager.CommitTransaction(txn);
+  auto tile_group = data_table->GetTileGroup(0);
+
+  // Delete a tuple of the full tile group. The deleting transaction owns the
+  // old version, and its new version lands in the other tile group.
+  txn = txn_manager.BeginTransaction();
+  ItemPointer location(tile_group->GetTileGroupId(), 3);
+  EXPECT_TRUE(txn_manager.PerformRead(txn, location, true));
+  ItemPointer new_location = data_table->InsertEmptyVersion();
+  EXPECT_EQ(data_table->GetTileGroup(1)->GetTileGroupId(), new_location.block);
+  txn_manager.PerformDelete(txn, location, new_location);
+
+  // The committed data of the full tile group is copied, the other tile group
+  // holds an uncommitted version and free slots
+  bool busy;
+  auto new_tile_group = data_table->TransformTileGroup(0, 0.0, &busy);
+  ASSERT_NE(nullptr, new_tile_group);
+  EXPECT_FALSE(busy);
+  EXPECT_EQ(nullptr, data_table->TransformTileGroup(1, 0.0, &busy));
+  EXPECT_TRUE(busy);
+
+  // The transformed tile group sees the delete commit
+  EXPECT_EQ(tile_group->GetHeader(), new_tile_group->GetHeader());
+  EXPECT_FALSE(new_tile_group->GetHeader()->GetImmutability());
+  txn_manager.CommitTransaction(txn);
+  EXPECT_NE(MAX_CID, new_tile_group->GetHeader()->GetEndCommitId(3));
+  EXPECT_EQ(new_tile_group, data_table->GetTileGroup(0).get());
+  EXPECT_EQ(CmpBool::TRUE, new_tile_group->GetValue(3, 0).CompareEquals(
+                               type::ValueFactory::GetIntegerValue(30)));
+}
 
 TEST_F(DataTableTests, GlobalTableTest) {
   const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
@@ -0,0 +1,247 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_builder_test.cpp
+//
+// Identification: test/storage/index_builder_test.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "index/index.h"
+#include "index/index_factory.h"
+#include "storage/data_table.h"
+#include "storage/index_builder.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Index Builder Tests
+//===--------------------------------------------------------------------===//
+
+class IndexBuilderTests : public PelotonTest {};
+
+// An index on column A of the testing table
+static std::shared_ptr<index::Index> CreateIndex(storage::DataTable *table,
+                                                 bool unique) {
+  std::vector<oid_t> key_attrs = {0};
+  auto tuple_schema = table->GetSchema();
+  auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+  auto index_metadata = new index::IndexMetadata(
+      "built_index", 125, table->GetOid(), INVALID_OID, IndexType::BWTREE,
+      unique ? IndexConstraintType::UNIQUE : IndexConstraintType::DEFAULT,
+      tuple_schema, key_schema, key_attrs, unique);
+  return std::shared_ptr<index::Index>(
+      index::IndexFactory::GetIndex(index_metadata));
+}
+
+// Insert tuples whose column A counts up from the first value, one per
+// transaction
+static void InsertTuples(storage::DataTable *table, int first_value,
+                         int count) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  for (int value = first_value; value < first_value + count; value++) {
+    auto txn = txn_manager.BeginTransaction();
+    storage::Tuple tuple(table->GetSchema(), true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(value), testing_pool);
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(value), testing_pool);
+    tuple.SetValue(2, type::ValueFactory::GetDecimalValue(value), testing_pool);
+    tuple.SetValue(3, type::ValueFactory::GetVarcharValue(std::to_string(value)),
+                   testing_pool);
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+    EXPECT_TRUE(location.block != INVALID_OID);
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+    txn_manager.CommitTransaction(txn);
+  }
+}
+
+TEST_F(IndexBuilderTests, BuildWithConcurrentInsertsTest) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5, false));
+  InsertTuples(table.get(), 0, 50);
+
+  // Writers keep inserting while the index is built
+  auto index = CreateIndex(table.get(), true);
+  std::thread writer(InsertTuples, table.get(), 1000, 50);
+  storage::IndexBuilder index_builder(table.get(), index);
+  EXPECT_TRUE(index_builder.Build());
+  writer.join();
+
+  EXPECT_FALSE(index->IsBuilding());
+  EXPECT_EQ(1, table->GetValidIndexCount());
+  EXPECT_GE(index_builder.GetIndexedVersionCount(), 50);
+
+  // Every tuple is in the index, whether the builder or its writer inserted
+  // its entry
+  std::vector<ItemPointer *> result;
+  index->ScanAllKeys(result);
+  EXPECT_EQ(100, result.size());
+
+  std::unique_ptr<storage::Tuple> key(
+      new storage::Tuple(index->GetKeySchema(), true));
+  for (int value : {0, 49, 1000, 1049}) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(value), nullptr);
+    result.clear();
+    index->ScanKey(key.get(), result);
+    EXPECT_EQ(1, result.size());
+  }
+}
+
+TEST_F(IndexBuilderTests, IndexEntryOnlyWithIndexesTest) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  storage::Tuple tuple(table->GetSchema(), true);
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(1), nullptr);
+
+  // Tables without indexes don't allocate index entries
+  auto txn = txn_manager.BeginTransaction();
+  ItemPointer *index_entry_ptr = nullptr;
+  ItemPointer location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+  EXPECT_TRUE(index_entry_ptr == nullptr);
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_FALSE(table->IsIndexBuildActive());
+
+  // The builder gives the version its entry
+  auto index = CreateIndex(table.get(), false);
+  storage::IndexBuilder index_builder(table.get(), index);
+  EXPECT_TRUE(index_builder.Build());
+  EXPECT_FALSE(table->IsIndexBuildActive());
+  auto tile_group_header = table->GetTileGroupById(location.block)->GetHeader();
+  EXPECT_TRUE(tile_group_header->GetIndirection(location.offset) != nullptr);
+
+  std::vector<ItemPointer *> result;
+  index->ScanAllKeys(result);
+  EXPECT_EQ(1, result.size());
+
+  // Later inserts allocate their entries again
+  txn = txn_manager.BeginTransaction();
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(2), nullptr);
+  index_entry_ptr = nullptr;
+  location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+  EXPECT_TRUE(index_entry_ptr != nullptr);
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(IndexBuilderTests, LogEntriesWhileBuildingTest) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5, false));
+  auto index = CreateIndex(table.get(), false);
+
+  // The entries of writers are logged until the build finishes
+  index->StartBuild();
+  table->AddIndex(index);
+  InsertTuples(table.get(), 0, 3);
+  std::vector<ItemPointer *> result;
+  index->ScanAllKeys(result);
+  EXPECT_EQ(0, result.size());
+
+  size_t applied_count = 0;
+  EXPECT_TRUE(index->FinishBuild(
+      [&index, &applied_count](const storage::Tuple *key,
+                               ItemPointer *index_entry_ptr) {
+        applied_count++;
+        return index->InsertEntry(key, index_entry_ptr);
+      }));
+  EXPECT_EQ(3, applied_count);
+  index->ScanAllKeys(result);
+  EXPECT_EQ(3, result.size());
+
+  // Afterwards, writers insert their entries themselves
+  InsertTuples(table.get(), 3, 2);
+  result.clear();
+  index->ScanAllKeys(result);
+  EXPECT_EQ(5, result.size());
+}
+
+TEST_F(IndexBuilderTests, LogDeletesWhileBuildingTest) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5, false));
+  auto index = CreateIndex(table.get(), false);
+  std::unique_ptr<storage::Tuple> key(
+      new storage::Tuple(index->GetKeySchema(), true));
+  key->SetValue(0, type::ValueFactory::GetIntegerValue(7), nullptr);
+  ItemPointer location(1, 1);
+
+  // Removals are applied after the entries logged before them
+  EXPECT_FALSE(index->LogDeleteEntry(key.get(), &location));
+  index->StartBuild();
+  EXPECT_TRUE(index->LogEntry(key.get(), &location));
+  EXPECT_TRUE(index->LogDeleteEntry(key.get(), &location));
+  EXPECT_TRUE(index->FinishBuild(
+      [&index](const storage::Tuple *key, ItemPointer *index_entry_ptr) {
+        return index->InsertEntry(key, index_entry_ptr);
+      }));
+  std::vector<ItemPointer *> result;
+  index->ScanAllKeys(result);
+  EXPECT_EQ(0, result.size());
+}
+
+TEST_F(IndexBuilderTests, UniqueViolationTest) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5, false));
+  InsertTuples(table.get(), 0, 10);
+  InsertTuples(table.get(), 5, 1);
+
+  // The duplicate key fails the build, and the index is dropped
+  auto index = CreateIndex(table.get(), true);
+  storage::IndexBuilder index_builder(table.get(), index);
+  EXPECT_FALSE(index_builder.Build());
+  EXPECT_FALSE(index->IsBuilding());
+  EXPECT_EQ(0, table->GetValidIndexCount());
+
+  // The same keys don't violate a non-unique index
+  auto non_unique_index = CreateIndex(table.get(), false);
+  storage::IndexBuilder non_unique_builder(table.get(), non_unique_index);
+  EXPECT_TRUE(non_unique_builder.Build());
+  std::vector<ItemPointer *> result;
+  non_unique_index->ScanAllKeys(result);
+  EXPECT_EQ(11, result.size());
+}
+
+TEST_F(IndexBuilderTests, DeferredIndexesTest) {
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(5, false));
+  auto index = CreateIndex(table.get(), true);
+  table->AddIndex(index);
+
+  // Writers skip the deferred index until it is bulk loaded
+  storage::IndexBuilder::DeferIndexes(table.get());
+  EXPECT_TRUE(index->IsBuilding());
+  InsertTuples(table.get(), 0, 200);
+  std::vector<ItemPointer *> result;
+  index->ScanAllKeys(result);
+  EXPECT_EQ(0, result.size());
+
+  EXPECT_TRUE(storage::IndexBuilder::BuildDeferredIndexes(table.get()));
+  EXPECT_FALSE(index->IsBuilding());
+  index->ScanAllKeys(result);
+  EXPECT_EQ(200, result.size());
+
+  std::unique_ptr<storage::Tuple> key(
+      new storage::Tuple(index->GetKeySchema(), true));
+  key->SetValue(0, type::ValueFactory::GetIntegerValue(150), nullptr);
+  result.clear();
+  index->ScanKey(key.get(), result);
+  EXPECT_EQ(1, result.size());
+}
+
+}  // namespace test
+}  // namespace peloton
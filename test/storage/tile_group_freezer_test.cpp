@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer_test.cpp
+//
+// Identification: test/storage/tile_group_freezer_test.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/frozen_block.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Freezer Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupFreezerTests : public PelotonTest {};
+
+TEST_F(TileGroupFreezerTests, FreezeAndThawTest) {
+  // Two full tile groups of 5 tuples, and one with 2
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(5, false, 1));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), 12, false, false, false,
+                                     txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Nothing is cold with respect to a horizon before the inserts
+  auto &freezer = storage::TileGroupFreezer::GetInstance();
+  EXPECT_EQ(0, freezer.FreezeTable(data_table.get(), 0));
+
+  // Only the full tile groups can be frozen
+  txn = txn_manager.BeginTransaction();
+  cid_t horizon_cid = txn->GetReadId();
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(2, freezer.FreezeTable(data_table.get(), horizon_cid));
+  EXPECT_EQ(nullptr, data_table->GetTileGroup(2)->GetFrozenBlock());
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto frozen_block = tile_group->GetFrozenBlock();
+  ASSERT_NE(nullptr, frozen_block);
+  EXPECT_TRUE(frozen_block->IsValidFor(*tile_group));
+  EXPECT_TRUE(frozen_block->IsVisibleTo(horizon_cid));
+  EXPECT_FALSE(frozen_block->IsVisibleTo(horizon_cid - 1));
+  EXPECT_EQ(5, frozen_block->GetVisibleTupleCount());
+
+  // A = 0..40 and B = 1..41 fit in a byte, the decimals and VARCHARs aren't
+  // packed
+  ASSERT_NE(nullptr, frozen_block->GetPackedColumn(0));
+  ASSERT_NE(nullptr, frozen_block->GetPackedColumn(1));
+  EXPECT_EQ(nullptr, frozen_block->GetPackedColumn(2));
+  EXPECT_EQ(nullptr, frozen_block->GetPackedColumn(3));
+  EXPECT_EQ(1, frozen_block->GetPackedColumn(0)->width);
+  for (oid_t tuple_id = 0; tuple_id < 5; tuple_id++) {
+    EXPECT_EQ(tuple_id * 10, frozen_block->GetPackedValue(0, tuple_id));
+    EXPECT_EQ(tuple_id * 10 + 1, frozen_block->GetPackedValue(1, tuple_id));
+  }
+  EXPECT_EQ(2 * 5, frozen_block->GetPackedSize());
+  EXPECT_EQ(2 * 5 * sizeof(int32_t), frozen_block->GetUnpackedSize());
+
+  uint32_t selection_vector[5];
+  EXPECT_EQ(5, frozen_block->GetVisibleTuples(0, 5, selection_vector));
+  EXPECT_EQ(4, selection_vector[4]);
+
+  // Locking a tuple keeps the tile group frozen, deleting it thaws it
+  txn = txn_manager.BeginTransaction();
+  ItemPointer location(tile_group->GetTileGroupId(), 2);
+  EXPECT_TRUE(txn_manager.PerformRead(txn, location, true));
+  EXPECT_EQ(frozen_block, tile_group->GetFrozenBlock());
+  ItemPointer new_location = data_table->InsertEmptyVersion();
+  txn_manager.PerformDelete(txn, location, new_location);
+  EXPECT_EQ(nullptr, tile_group->GetFrozenBlock());
+  txn_manager.CommitTransaction(txn);
+
+  // The thawed block is only freed once its epoch has expired
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto tile_group_header = tile_group->GetHeader();
+  EXPECT_EQ(0, tile_group_header->ReclaimThawedBlocks(0));
+  EXPECT_EQ(1, tile_group_header->ReclaimThawedBlocks(
+                   epoch_manager.GetCurrentEpochId()));
+
+  // Once the delete is older than the horizon, the tile group freezes again
+  // without the deleted tuple
+  txn = txn_manager.BeginTransaction();
+  horizon_cid = txn->GetReadId();
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(1, freezer.FreezeTable(data_table.get(), horizon_cid));
+  frozen_block = tile_group->GetFrozenBlock();
+  ASSERT_NE(nullptr, frozen_block);
+  EXPECT_EQ(4, frozen_block->GetVisibleTupleCount());
+  EXPECT_FALSE(frozen_block->IsVisible(2));
+  EXPECT_EQ(4, frozen_block->GetVisibleTuples(0, 5, selection_vector));
+  EXPECT_EQ(3, selection_vector[2]);
+  EXPECT_EQ(30, frozen_block->GetPackedValue(0, 3));
+}
+
+}  // namespace test
+}  // namespace peloton
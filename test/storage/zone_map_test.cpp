@@ -418,6 +418,68 @@ TEST_F(ZoneMapTests, ZoneMapMultiColumnConjunctionPredicateTest) {
   pred4->ClearParsedPredicates();
   delete conj_pred;
 }
+
+TEST_F(ZoneMapTests, ZoneMapIncrementalMaintenanceTest) {
+  // The in-memory zone maps follow the inserts, without any catalog zone maps
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(5, false, 1));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), 12, false, false, false,
+                                     txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Tile group 2 only holds A = 100 and A = 110 so far
+  auto tile_group = data_table->GetTileGroup(2);
+  auto zone_map = tile_group->GetZoneMap();
+  type::Value min, max;
+  EXPECT_TRUE(zone_map->GetBounds(0, min, max));
+  EXPECT_EQ(100, min.GetAs<int>());
+  EXPECT_EQ(110, max.GetAs<int>());
+  EXPECT_TRUE(zone_map->GetBounds(2, min, max));
+  EXPECT_EQ(102.0, min.GetAs<double>());
+  EXPECT_EQ(112.0, max.GetAs<double>());
+  // VARCHARs aren't tracked
+  EXPECT_FALSE(zone_map->GetBounds(3, min, max));
+
+  std::vector<storage::PredicateInfo> predicates{
+      {0, static_cast<int>(ExpressionType::COMPARE_GREATERTHAN),
+       type::ValueFactory::GetIntegerValue(110)}};
+  storage::ZoneMapManager *zone_map_manager =
+      storage::ZoneMapManager::GetInstance();
+  EXPECT_FALSE(zone_map_manager->ShouldScanTileGroup(predicates.data(), 1,
+                                                     data_table.get(), 2));
+
+  // Integer columns compared to decimals
+  predicates[0].predicate_value = type::ValueFactory::GetDecimalValue(109.5);
+  EXPECT_TRUE(zone_map_manager->ShouldScanTileGroup(predicates.data(), 1,
+                                                    data_table.get(), 2));
+
+  // The bounds widen as soon as more tuples are inserted: A = 0, 30 and 60
+  txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), 3, true, false, false,
+                                     txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_TRUE(zone_map->GetBounds(0, min, max));
+  EXPECT_EQ(0, min.GetAs<int>());
+  EXPECT_EQ(110, max.GetAs<int>());
+  predicates[0].comparison_operator =
+      static_cast<int>(ExpressionType::COMPARE_EQUAL);
+  predicates[0].predicate_value = type::ValueFactory::GetIntegerValue(60);
+  EXPECT_TRUE(zone_map_manager->ShouldScanTileGroup(predicates.data(), 1,
+                                                    data_table.get(), 2));
+  EXPECT_FALSE(zone_map_manager->ShouldScanTileGroup(predicates.data(), 1,
+                                                     data_table.get(), 0));
+
+  // Freezing keeps the bounds of the tuples in the tile group
+  EXPECT_FALSE(zone_map->IsFrozen());
+  tile_group->GetHeader()->SetImmutability();
+  zone_map->Freeze(*tile_group);
+  EXPECT_TRUE(zone_map->IsFrozen());
+  EXPECT_TRUE(zone_map->GetBounds(0, min, max));
+  EXPECT_EQ(0, min.GetAs<int>());
+  EXPECT_EQ(110, max.GetAs<int>());
+}
 }
 }  // End test namespace
 }  // End peloton namespace
\ No newline at end of file
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_pool_test.cpp
+//
+// Identification: test/threadpool/worker_pool_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>
+
+#include "common/harness.h"
+#include "threadpool/worker_pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Worker Pool Tests
+//===--------------------------------------------------------------------===//
+
+class WorkerPoolTests : public PelotonTest {};
+
+// Wait until the counter reaches the count, for at most a few seconds
+static void WaitForCount(const std::atomic<int> &counter, int count) {
+  for (int i = 0; i < 5000 && counter.load() < count; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+TEST_F(WorkerPoolTests, IdleBatchWorkersStealTest) {
+  threadpool::TaskQueue latency_queue(8);
+  threadpool::TaskQueue batch_queue(8);
+
+  // Batch workers without batch work run the latency-sensitive tasks
+  threadpool::WorkerPool batch_workers(
+      1, std::vector<threadpool::TaskQueue *>{&batch_queue, &latency_queue});
+  batch_workers.Startup();
+  std::atomic<int> latency_count(0);
+  for (int i = 0; i < 2; i++) {
+    latency_queue.Enqueue([&latency_count] { latency_count++; });
+  }
+  WaitForCount(latency_count, 2);
+  EXPECT_EQ(2, latency_count.load());
+  batch_workers.Shutdown();
+
+  // Latency-sensitive workers never run batch tasks
+  threadpool::WorkerPool latency_workers(1, &latency_queue);
+  latency_workers.Startup();
+  std::atomic<int> batch_count(0);
+  batch_queue.Enqueue([&batch_count] { batch_count++; });
+  latency_queue.Enqueue([&latency_count] { latency_count++; });
+  WaitForCount(latency_count, 3);
+  EXPECT_EQ(3, latency_count.load());
+  EXPECT_EQ(0, batch_count.load());
+  latency_workers.Shutdown();
+
+  // The batch task is still queued for the batch workers
+  batch_workers.Startup();
+  WaitForCount(batch_count, 1);
+  EXPECT_EQ(1, batch_count.load());
+  batch_workers.Shutdown();
+}
+
+}  // namespace test
+}  // namespace peloton